@@ -24,9 +24,13 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch_all.hpp>
 #include "asset_validator.hpp"
+#include "obj_validator.hpp"
+#include "image_integrity.hpp"
+#include "crc32.hpp"
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <zlib.h>
 
 using namespace AssetManager;
 
@@ -207,6 +211,206 @@ f 1 1 1
     }
 }
 
+TEST_CASE_METHOD(AssetValidatorTestFixture, "Deep OBJ Validation", "[obj]") {
+    AssetValidator validator;
+    
+    auto findIssue = [](const ValidationResult& result, const std::string& text) -> const ValidationIssue* {
+        for (const auto& issue : result.issues) {
+            if (issue.description.find(text) != std::string::npos) {
+                return &issue;
+            }
+        }
+        return nullptr;
+    };
+    
+    SECTION("Broken indices and values are reported with line numbers") {
+        std::string obj_content =
+            "v 0 0 0\n"
+            "v 1 0 0\n"
+            "v 0 1 nan\n"
+            "vt 0 0\n"
+            "f 1 2 3\n"
+            "f 1 2 5\n"
+            "f 1/2 2/1 3/1\n"
+            "f 0 1 2\n"
+            "f 1 2\n"
+            "f 1 1 2\n"
+            "v 1e400 0 0\n";
+        std::string obj_file = createTestFile("broken.obj", obj_content);
+        ValidationResult result = validator.validateAsset(obj_file);
+        
+        REQUIRE(result.is_valid == false);
+        const ValidationIssue* range = findIssue(result, "index out of range");
+        REQUIRE(range != nullptr);
+        REQUIRE(range->context.find("Line 6: vertex index 5 with 3 defined") == 0);
+        REQUIRE(range->context.find("2 occurrences; lines 6, 7") != std::string::npos);
+        REQUIRE(findIssue(result, "index 0") != nullptr);
+        const ValidationIssue* non_finite = findIssue(result, "NaN or infinite");
+        REQUIRE(non_finite != nullptr);
+        REQUIRE(non_finite->context.find("lines 3, 11") != std::string::npos);
+        REQUIRE(findIssue(result, "fewer than 3 vertices")->context.find("Line 9") == 0);
+        REQUIRE(findIssue(result, "Degenerate face")->severity == ValidationSeverity::WARNING);
+        REQUIRE(findIssue(result, "unused vertices")->context.find("first: vertex 4") != std::string::npos);
+    }
+    
+    SECTION("Relative indices resolve against the elements defined so far") {
+        std::string obj_content =
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\n"
+            "f -3//-1 -2//-1 -1//-1\n"
+            "v 5 5 5\n"
+            "f -4 -3 -5\n";
+        std::string obj_file = createTestFile("relative.obj", obj_content);
+        OBJScanReport report = OBJStreamValidator::scan(obj_file);
+        
+        REQUIRE(report.faces == 2);
+        REQUIRE(report.index_out_of_range.count == 1);
+        REQUIRE(report.index_out_of_range.lines == std::vector<uint64_t>{7});
+        REQUIRE(report.unused_vertices == 1);
+        REQUIRE(report.first_unused_vertex == 4);
+    }
+    
+    SECTION("Mapped scans match in-memory scans on larger files") {
+        std::string obj_content = "mtllib grid.mtl\n";
+        for (int i = 0; i < 20000; ++i) {
+            obj_content += "v " + std::to_string(i) + ".5 -" + std::to_string(i) + "e-3 0.25\r\n";
+        }
+        for (int i = 1; i + 2 <= 20000; i += 3) {
+            obj_content += "f " + std::to_string(i) + " " + std::to_string(i + 1) + " " + std::to_string(i + 2) + "\n";
+        }
+        std::string obj_file = createTestFile("grid.obj", obj_content);
+        OBJScanReport mapped = OBJStreamValidator::scan(obj_file);
+        OBJScanReport buffered = OBJStreamValidator::scanBuffer(obj_content.data(), obj_content.data() + obj_content.size());
+        
+        REQUIRE(mapped.bytes == obj_content.size());
+        REQUIRE(mapped.vertices == 20000);
+        REQUIRE(mapped.faces == buffered.faces);
+        REQUIRE(mapped.lines == buffered.lines);
+        REQUIRE(mapped.unused_vertices == 2);
+        REQUIRE(mapped.malformed.count == 0);
+        REQUIRE(mapped.material_libraries == std::vector<std::string>{"grid.mtl"});
+    }
+    
+    SECTION("One mtllib statement can name several libraries") {
+        std::string obj_content = "mtllib hull.mtl\tdeck.mtl  trim.mtl # shared\nmtllib\nv 0 0 0\n";
+        OBJScanReport report = OBJStreamValidator::scanBuffer(obj_content.data(), obj_content.data() + obj_content.size());
+        
+        REQUIRE(report.material_libraries == std::vector<std::string>{"hull.mtl", "deck.mtl", "trim.mtl"});
+    }
+}
+
+TEST_CASE_METHOD(AssetValidatorTestFixture, "Image Structure Validation", "[texture]") {
+    AssetValidator validator;
+    
+    // Minimal PNG: signature, IHDR, one IDAT, IEND, with real chunk CRCs
+    auto chunk = [](const std::string& type, const std::string& data) {
+        std::string body = type + data;
+        uint32_t crc = Crc32::update(0, reinterpret_cast<const unsigned char*>(body.data()), body.size());
+        std::string out;
+        auto putBE = [&out](uint32_t value) {
+            for (int shift = 24; shift >= 0; shift -= 8) out += static_cast<char>((value >> shift) & 0xFF);
+        };
+        putBE(static_cast<uint32_t>(data.size()));
+        out += body;
+        putBE(crc);
+        return out;
+    };
+    std::string png = std::string("\x89PNG\r\n\x1a\n", 8) +
+                      chunk("IHDR", std::string("\0\0\0\1\0\0\0\1\x08\x02\0\0\0", 13)) +
+                      chunk("IDAT", std::string(100, 'x')) + chunk("IEND", "");
+    
+    SECTION("Shared CRC matches zlib") {
+        std::string data;
+        for (int i = 0; i < 5000; ++i) data += static_cast<char>((i * 131) ^ (i >> 3));
+        for (size_t size : {0u, 1u, 7u, 8u, 15u, 63u, 64u, 100u, 4096u, 5000u}) {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+            REQUIRE(Crc32::update(7, bytes, size) == crc32(7, bytes, static_cast<uInt>(size)));
+        }
+    }
+    
+    SECTION("Intact PNG passes, truncated and corrupted copies do not") {
+        ValidationResult intact = validator.validateAsset(createTestFile("ok.png", png));
+        REQUIRE(intact.is_valid == true);
+        REQUIRE(intact.error_count == 0);
+        
+        ValidationResult cut = validator.validateAsset(createTestFile("cut.png", png.substr(0, 60)));
+        REQUIRE(cut.is_valid == false);
+        REQUIRE(cut.issues[0].description == "Texture file is truncated");
+        REQUIRE(cut.issues[0].context.find("'IDAT' chunk") != std::string::npos);
+        
+        std::string flipped = png;
+        flipped[50] ^= 0x01;
+        ImageIntegrityReport report = ImageIntegrityChecker::check(createTestFile("flip.png", flipped));
+        REQUIRE(report.truncated == false);
+        REQUIRE(report.segments == 3);
+        REQUIRE(report.problems.size() == 1);
+        REQUIRE(report.problems[0].find("CRC mismatch in PNG 'IDAT'") == 0);
+    }
+    
+    SECTION("EXR offset tables are checked without overflowing") {
+        auto le = [](int64_t value, int bytes) {
+            std::string out;
+            for (int i = 0; i < bytes; ++i) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+            return out;
+        };
+        auto attribute = [&le](const std::string& name, const std::string& type, const std::string& value) {
+            return name + '\0' + type + '\0' + le(static_cast<int64_t>(value.size()), 4) + value;
+        };
+        auto tiledExr = [&](int32_t x_min, int32_t x_max, int32_t y_max, uint32_t tile) {
+            return std::string("\x76\x2F\x31\x01\x02\x02\0\0", 8) +
+                   attribute("dataWindow", "box2i", le(x_min, 4) + le(0, 4) + le(x_max, 4) + le(y_max, 4)) +
+                   attribute("compression", "compression", std::string(1, '\0')) +
+                   attribute("tiles", "tiledesc", le(tile, 4) + le(tile, 4) + std::string(1, '\0')) +
+                   std::string(1, '\0');
+        };
+        
+        // One 4x4 tile: offset table, then tile x, y, level x, level y, data size and 16 bytes of data
+        std::string exr = tiledExr(0, 3, 3, 4);
+        exr += le(static_cast<int64_t>(exr.size()) + 8, 8) + le(0, 16) + le(16, 4) + std::string(16, 'p');
+        ImageIntegrityReport whole = ImageIntegrityChecker::checkBuffer(
+            reinterpret_cast<const unsigned char*>(exr.data()), exr.size(), ".exr");
+        REQUIRE(whole.checked == true);
+        REQUIRE(whole.segments == 1);
+        REQUIRE(whole.problems.empty());
+        
+        ImageIntegrityReport cut = ImageIntegrityChecker::checkBuffer(
+            reinterpret_cast<const unsigned char*>(exr.data()), exr.size() - 1, ".exr");
+        REQUIRE(cut.truncated == true);
+        
+        // 2^32 x 2^29 window of 1x1 tiles: 2^61 chunks, whose 8-byte table size wraps to 0 in 64 bits
+        std::string huge = tiledExr(INT32_MIN, INT32_MAX, (1 << 29) - 1, 1) + le(0, 8);
+        ImageIntegrityReport overflow = ImageIntegrityChecker::checkBuffer(
+            reinterpret_cast<const unsigned char*>(huge.data()), huge.size(), ".exr");
+        REQUIRE(overflow.truncated == true);
+        REQUIRE(overflow.problems.size() == 1);
+        REQUIRE(overflow.problems[0].find("EXR offset table") == 0);
+    }
+    
+    SECTION("JPEG, TGA and BMP files cut short are reported") {
+        std::string jpeg = std::string("\xFF\xD8\xFF\xC0\0\x0B\x08\0\1\0\1\1\1\x11\0\xFF\xDA\0\x08\1\1\0\0\x3F\0", 25) +
+                           std::string("\x12\xFF\0\x34", 4);
+        REQUIRE(ImageIntegrityChecker::checkBuffer(reinterpret_cast<const unsigned char*>(jpeg.data()), jpeg.size(),
+                                                   ".jpg").truncated == true);
+        jpeg += "\xFF\xD9";
+        ImageIntegrityReport complete = ImageIntegrityChecker::checkBuffer(
+            reinterpret_cast<const unsigned char*>(jpeg.data()), jpeg.size(), ".jpg");
+        REQUIRE(complete.problems.empty());
+        
+        // 2x2 24-bit uncompressed TGA with one pixel missing
+        std::string tga(18, '\0');
+        tga[2] = 2; tga[12] = 2; tga[14] = 2; tga[16] = 24;
+        tga += std::string(9, '\x7f');
+        ValidationResult short_tga = validator.validateAsset(createTestFile("short.tga", tga));
+        REQUIRE(short_tga.error_count == 1);
+        REQUIRE(short_tga.issues[0].context.find("TGA pixel data needs 30 bytes") == 0);
+        
+        // BMP whose size field says more than the file holds
+        std::string bmp = std::string("BM\x80\0\0\0\0\0\0\0\x1A\0\0\0\x0C\0\0\0\1\0\1\0\1\0\x18\0", 26) + "abcd";
+        ImageIntegrityReport short_bmp = ImageIntegrityChecker::checkBuffer(
+            reinterpret_cast<const unsigned char*>(bmp.data()), bmp.size(), ".bmp");
+        REQUIRE(short_bmp.truncated == true);
+    }
+}
+
 TEST_CASE_METHOD(AssetValidatorTestFixture, "FBX File Validation", "[fbx]") {
     AssetValidator validator;
     
@@ -334,6 +538,29 @@ map_Kd missing_texture.jpg
         }
         REQUIRE(found_texture_error == true);
     }
+    
+    SECTION("Every texture statement is captured with its options skipped") {
+        std::string mtl_content = R"(
+newmtl panel
+map_Ka ambient.png
+map_d -imfchan m alpha.png
+bump -bm 1.0 height.png
+disp -mm 0 0.5 displacement.png
+norm normal.png
+map_Pr -clamp on roughness.png
+map_Pm -o 0.5 0.5 -s 2 2 1 metallic map.png
+Kd 0.8 0.8 0.8
+)";
+        std::string mtl_file = createTestFile("statements.mtl", mtl_content);
+        ValidationResult result = validator.validateAsset(mtl_file);
+        
+        std::vector<std::string> names;
+        for (const auto& dependency : result.dependencies) {
+            names.push_back(std::filesystem::path(dependency).filename().string());
+        }
+        REQUIRE(names == std::vector<std::string>{"ambient.png", "alpha.png", "height.png", "displacement.png",
+                                                  "normal.png", "roughness.png", "metallic map.png"});
+    }
 }
 
 TEST_CASE_METHOD(AssetValidatorTestFixture, "Batch Validation", "[batch]") {
@@ -365,6 +592,108 @@ TEST_CASE_METHOD(AssetValidatorTestFixture, "Batch Validation", "[batch]") {
     }
 }
 
+TEST_CASE_METHOD(AssetValidatorTestFixture, "Parallel Validation", "[batch][parallel]") {
+    AssetValidator validator;
+    
+    SECTION("Parallel batches match sequential ones, in input order") {
+        std::vector<std::string> files;
+        for (int i = 0; i < 32; ++i) {
+            files.push_back(i % 4 == 0 ? createEmptyFile("empty" + std::to_string(i) + ".obj")
+                                       : createTestFile("mesh" + std::to_string(i) + ".obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n"));
+        }
+        
+        std::vector<ValidationResult> sequential = validator.validateAssets(files);
+        validator.setThreadCount(4);
+        std::vector<ValidationResult> parallel = validator.validateAssets(files);
+        
+        REQUIRE(parallel.size() == files.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            REQUIRE(parallel[i].asset_path == files[i]);
+            REQUIRE(parallel[i].is_valid == sequential[i].is_valid);
+            REQUIRE(parallel[i].total_issues == sequential[i].total_issues);
+        }
+    }
+    
+    SECTION("Per-thread counters are merged into the statistics") {
+        createTestFile("a.obj", "v 0 0 0\n");
+        createEmptyFile("b.obj");
+        createTestFile("c.mtl", "newmtl test\n");
+        
+        std::map<std::string, std::any> options;
+        options["threads"] = size_t(0);
+        validator.setValidationOptions(options);
+        REQUIRE(validator.getThreadCount() == 0);
+        
+        auto before = validator.getValidationStats();
+        std::vector<ValidationResult> results = validator.validateDirectory(temp_dir_);
+        auto stats = validator.getValidationStats();
+        auto added = [&](const std::string& key) {
+            return std::any_cast<size_t>(stats[key]) - std::any_cast<size_t>(before[key]);
+        };
+        size_t with_errors = 0;
+        size_t issues = 0;
+        for (const auto& result : results) {
+            with_errors += result.error_count > 0 ? 1 : 0;
+            issues += result.total_issues;
+        }
+        
+        REQUIRE(added("total_files_validated") == results.size());
+        REQUIRE(added("files_with_errors") == with_errors);
+        REQUIRE(added("total_issues_found") == issues);
+    }
+}
+
+TEST_CASE_METHOD(AssetValidatorTestFixture, "Incremental Validation Cache", "[cache]") {
+    SECTION("Reruns reuse results of unchanged files and revalidate changed references") {
+        std::string cache_path = temp_dir_ + "/cache/validation_cache.json";
+        std::string assets = temp_dir_ + "/assets";
+        std::filesystem::create_directories(assets);
+        createTestFile("assets/rock.mtl", "newmtl rock\nmap_Kd rock.png\n");
+        createTestFile("assets/rock.obj", "mtllib rock.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+        createTestFile("assets/tree.obj", "v 0 0 0\n");
+        
+        {
+            AssetValidator first;
+            first.setCachePath(cache_path);
+            std::vector<ValidationResult> results = first.validateDirectory(assets);
+            REQUIRE(results.size() == 3);
+            REQUIRE(std::any_cast<size_t>(first.getValidationStats()["cache_hits"]) == 0);
+            REQUIRE(std::filesystem::exists(cache_path));
+        }
+        
+        // A new validator (a new run) reuses everything, with the same findings
+        AssetValidator second;
+        second.setCachePath(cache_path);
+        std::vector<ValidationResult> reused = second.validateDirectory(assets);
+        REQUIRE(std::any_cast<size_t>(second.getValidationStats()["cache_hits"]) == 3);
+        for (const auto& result : reused) {
+            if (result.asset_path.find("rock.mtl") != std::string::npos) {
+                REQUIRE(result.error_count == 1);   // rock.png is missing
+                REQUIRE(result.issues[0].severity == ValidationSeverity::ERROR);
+                REQUIRE(result.issues[0].file_path == result.asset_path);
+            }
+        }
+        
+        // Adding the missing texture invalidates the MTL that references it, and nothing else
+        createTestFile("assets/rock.png", "\x89PNG");
+        AssetValidator third;
+        third.setCachePath(cache_path);
+        std::vector<ValidationResult> rerun = third.validateAssets({assets + "/rock.mtl", assets + "/rock.obj",
+                                                                    assets + "/tree.obj"});
+        auto stats = third.getValidationStats();
+        REQUIRE(std::any_cast<size_t>(stats["cache_hits"]) == 2);
+        REQUIRE(std::any_cast<size_t>(stats["dependency_invalidations"]) == 1);
+        REQUIRE(rerun[0].error_count == 0);
+        
+        // Changing a result-relevant option discards the cache
+        std::map<std::string, std::any> options;
+        options["check_texture_dependencies"] = false;
+        third.setValidationOptions(options);
+        third.validateAssets({assets + "/tree.obj"});
+        REQUIRE(std::any_cast<size_t>(third.getValidationStats()["cache_hits"]) == 2);
+    }
+}
+
 TEST_CASE_METHOD(AssetValidatorTestFixture, "Report Generation", "[report]") {
     AssetValidator validator;
     
@@ -13,9 +13,37 @@
 #include <iostream>
 #include <memory>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace TestHarness;
 
+// Runs body with a stub `blender` first on PATH; the stub copies each script it is given to
+// <dir>/script_<n>.py and reports success
+static void withStubBlender(const std::string& dir, const std::function<void()>& body) {
+    std::filesystem::create_directories(dir + "/stub");
+    std::string scripts = std::filesystem::absolute(dir).string();
+    std::ofstream(dir + "/stub/blender")
+        << "#!/bin/sh\nn=$(ls '" << scripts << "' | grep -c '^script_')\n"
+        << "cp \"$4\" '" << scripts << "/script_'$n'.py'\necho SUCCESS\n";
+    std::filesystem::permissions(dir + "/stub/blender", std::filesystem::perms::owner_all);
+
+    const char* old_path = std::getenv("PATH");
+    std::string saved_path = old_path ? old_path : "";
+    setenv("PATH", (std::filesystem::absolute(dir + "/stub").string() + ":" + saved_path).c_str(), 1);
+    body();
+    setenv("PATH", saved_path.c_str(), 1);
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
 int main() {
     TestRunner runner;
     
@@ -142,14 +170,25 @@ int main() {
         entry.message = "Import successful";
         entry.imported_objects = {"TestObject"};
         
+        // Objects without a recorded scene file cannot be removed, so there is nothing to undo yet
+        history.addEntry(entry);
+        if (history.canUndo() || !history.getUndoableEntries().empty()) {
+            return false;
+        }
+        
+        entry.id = "test_008";
+        entry.metadata["scene_file"] = "/tmp/scene.blend";
         history.addEntry(entry);
         
         // Now should be able to undo
-        return history.canUndo();
+        return history.canUndo() && history.getUndoableEntries() == std::vector<std::string>{"test_008"};
     });
     
     // Test 7: Undo last import
     runner.runTest("Undo Last Import", []() -> bool {
+        std::filesystem::remove_all("undo_test");
+        std::filesystem::create_directories("undo_test");
+        std::ofstream("undo_test/scene.blend") << "BLENDER";
         AssetManager::ImportHistory history;
         
         AssetManager::ImportHistoryEntry entry;
@@ -160,17 +199,27 @@ int main() {
         entry.success = true;
         entry.message = "Import successful";
         entry.imported_objects = {"TestObject"};
+        entry.metadata["scene_file"] = "undo_test/scene.blend";
         
         history.addEntry(entry);
         
-        auto undo_result = history.undoLastImport();
+        AssetManager::UndoResult undo_result;
+        withStubBlender("undo_test", [&]() { undo_result = history.undoLastImport(); });
         
-        // Should succeed (even if Blender objects don't exist in test environment)
-        return undo_result.success && history.getHistorySize() == 0;
+        // The removal runs against the scene the objects were imported into, which is saved afterwards
+        std::string script = readFile("undo_test/script_0.py");
+        bool valid = undo_result.success && history.getHistorySize() == 0;
+        valid &= script.find("open_mainfile") != std::string::npos && script.find("save_mainfile") != std::string::npos;
+        valid &= script.find(std::filesystem::absolute("undo_test/scene.blend").string()) != std::string::npos;
+        std::filesystem::remove_all("undo_test");
+        return valid;
     });
     
     // Test 8: Undo specific import
     runner.runTest("Undo Specific Import", []() -> bool {
+        std::filesystem::remove_all("undo_test");
+        std::filesystem::create_directories("undo_test");
+        std::ofstream("undo_test/scene.blend") << "BLENDER";
         AssetManager::ImportHistory history;
         
         AssetManager::ImportHistoryEntry entry;
@@ -181,12 +230,17 @@ int main() {
         entry.success = true;
         entry.message = "Import successful";
         entry.imported_objects = {"TestObject"};
+        entry.metadata["scene_file"] = "undo_test/scene.blend";
         
         history.addEntry(entry);
         
-        auto undo_result = history.undoImport("test_009");
+        AssetManager::UndoResult undo_result;
+        withStubBlender("undo_test", [&]() { undo_result = history.undoImport("test_009"); });
         
-        return undo_result.success && history.getHistorySize() == 0;
+        bool valid = undo_result.success && history.getHistorySize() == 0;
+        valid &= undo_result.removed_objects == std::vector<std::string>{"TestObject"};
+        std::filesystem::remove_all("undo_test");
+        return valid;
     });
     
     // Test 9: Undo non-existent import
@@ -593,6 +647,755 @@ int main() {
                json.find("test_asset.fbx") != std::string::npos;
     });
     
+    // Test 25: Journaled changes survive a restart
+    runner.runTest("Journal Recover After Restart", []() -> bool {
+        std::filesystem::remove_all("history_journal_test");
+        std::string path = "history_journal_test/history.json";
+        {
+            AssetManager::ImportHistory history;
+            history.setHistoryFilePath(path);
+            for (int i = 0; i < 3; ++i) {
+                AssetManager::ImportHistoryEntry entry;
+                entry.id = "journal_" + std::to_string(i);
+                entry.asset_path = i == 1 ? "props/crate.fbx" : "props/chair.fbx";
+                entry.import_type = "import";
+                entry.timestamp = std::chrono::system_clock::now();
+                entry.success = true;
+                entry.message = "Imported \"chair\"\n";
+                entry.options["scale"] = "1.0";
+                entry.imported_objects = {"Chair", "Chair.001"};
+                entry.metadata["telemetry.total_ms"] = "12.5";
+                history.addEntry(entry);
+            }
+            history.clearHistoryByAsset("props/crate.fbx");
+        }
+        
+        AssetManager::ImportHistory restored;
+        restored.setHistoryFilePath(path);
+        bool valid = restored.recoverHistory();
+        valid &= restored.getHistorySize() == 2 && !restored.entryExists("journal_1");
+        auto entry = restored.getEntry("journal_2");
+        valid &= entry.has_value() && entry->message == "Imported \"chair\"\n";
+        valid &= entry && entry->options.at("scale") == "1.0" && entry->imported_objects.size() == 2;
+        valid &= entry && entry->metadata.at("telemetry.total_ms") == "12.5";
+        
+        std::filesystem::remove_all("history_journal_test");
+        return valid;
+    });
+    
+    // Test 26: A torn trailing record from a crash is discarded
+    runner.runTest("Journal Discards Torn Record", []() -> bool {
+        std::filesystem::remove_all("history_journal_test");
+        std::string path = "history_journal_test/history.json";
+        {
+            AssetManager::ImportHistory history;
+            history.setHistoryFilePath(path);
+            for (int i = 0; i < 2; ++i) {
+                AssetManager::ImportHistoryEntry entry;
+                entry.id = "torn_" + std::to_string(i);
+                entry.asset_path = "asset.fbx";
+                entry.import_type = "link";
+                entry.success = true;
+                history.addEntry(entry);
+            }
+        }
+        // Simulate a crash in the middle of writing a third record
+        std::ofstream(path + ".journal", std::ios::app) << "0badf00d {\"op\":\"add\",\"entry\":{\"id\":\"to";
+        
+        bool valid = true;
+        {
+            AssetManager::ImportHistory history;
+            history.setHistoryFilePath(path);
+            valid &= history.recoverHistory() && history.getHistorySize() == 2;
+            valid &= history.getJournalStats().torn_records_discarded == 1;
+            
+            AssetManager::ImportHistoryEntry entry;
+            entry.id = "torn_2";
+            entry.asset_path = "asset.fbx";
+            entry.import_type = "link";
+            entry.success = true;
+            history.addEntry(entry);
+        }
+        AssetManager::ImportHistory restored;
+        restored.setHistoryFilePath(path);
+        valid &= restored.recoverHistory() && restored.getHistorySize() == 3 && restored.entryExists("torn_2");
+        
+        std::filesystem::remove_all("history_journal_test");
+        return valid;
+    });
+    
+    // Test 27: Background compaction folds the journal into a snapshot
+    runner.runTest("Journal Compaction", []() -> bool {
+        std::filesystem::remove_all("history_journal_test");
+        std::string path = "history_journal_test/history.json";
+        bool valid = true;
+        {
+            AssetManager::ImportHistory history;
+            history.setHistoryFilePath(path);
+            history.setCompactionThreshold(8);
+            for (int i = 0; i < 20; ++i) {
+                AssetManager::ImportHistoryEntry entry;
+                entry.id = "compact_" + std::to_string(i);
+                entry.asset_path = "asset" + std::to_string(i) + ".blend";
+                entry.import_type = "import";
+                entry.success = i % 2 == 0;
+                history.addEntry(entry);
+            }
+            history.clearFailedImports();
+            valid &= history.compactHistory();
+            valid &= history.getJournalStats().compactions >= 2;
+            valid &= std::filesystem::exists(path + ".snapshot");
+            valid &= !std::filesystem::exists(path + ".journal");
+        }
+        AssetManager::ImportHistory restored;
+        restored.setHistoryFilePath(path);
+        valid &= restored.recoverHistory() && restored.getHistorySize() == 10;
+        valid &= restored.entryExists("compact_18") && !restored.entryExists("compact_19");
+        
+        std::filesystem::remove_all("history_journal_test");
+        return valid;
+    });
+    
+    // Test 28: Export/import round trip restores every field, escaped strings included
+    runner.runTest("JSON Round Trip Restores All Fields", []() -> bool {
+        AssetManager::ImportHistory history;
+        history.setHistoryFilePath("");
+        
+        AssetManager::ImportHistoryEntry entry;
+        entry.id = "roundtrip_1";
+        entry.asset_path = "C:\\assets\\\"quoted\" chair.fbx";
+        entry.import_type = "link";
+        entry.timestamp = std::chrono::system_clock::now();
+        entry.success = true;
+        entry.message = "line one\nline two\ttabbed \x01 caf\xC3\xA9";
+        entry.collection_name = "Props";
+        entry.options["link"] = "true";
+        entry.options["note \"x\""] = "back\\slash";
+        entry.imported_objects = {"Chair", "Chair \"Seat\""};
+        entry.metadata["telemetry.total_ms"] = "42.0";
+        history.addEntry(entry);
+        
+        std::string json = history.exportHistoryAsJSON();
+        
+        AssetManager::ImportHistory restored;
+        restored.setHistoryFilePath("");
+        if (!restored.importHistoryFromJSON(json) || restored.getHistorySize() != 1) {
+            return false;
+        }
+        auto loaded = restored.getEntry("roundtrip_1");
+        return loaded.has_value() &&
+               loaded->asset_path == entry.asset_path &&
+               loaded->import_type == "link" &&
+               loaded->timestamp == std::chrono::time_point_cast<std::chrono::microseconds>(entry.timestamp) &&
+               loaded->success &&
+               loaded->message == entry.message &&
+               loaded->collection_name == "Props" &&
+               loaded->options == entry.options &&
+               loaded->imported_objects == entry.imported_objects &&
+               loaded->metadata == entry.metadata;
+    });
+    
+    // Test 29: Legacy exports (string timestamps, no metadata) still load
+    runner.runTest("Import Legacy JSON Export", []() -> bool {
+        std::string legacy =
+            "{\n  \"history\": [\n    {\n      \"id\": \"legacy_1\",\n"
+            "      \"asset_path\": \"old.blend\",\n      \"import_type\": \"import\",\n"
+            "      \"timestamp\": \"1700000000\",\n      \"success\": false,\n"
+            "      \"message\": \"failed\",\n      \"collection_name\": \"\",\n"
+            "      \"options\": {\n        \"scale\": \"2.0\"\n      },\n"
+            "      \"imported_objects\": [\"A\", \"B\"]\n    }\n  ]\n}\n";
+        
+        AssetManager::ImportHistory history;
+        history.setHistoryFilePath("");
+        if (!history.importHistoryFromJSON(legacy)) {
+            return false;
+        }
+        auto entry = history.getEntry("legacy_1");
+        return entry.has_value() && !entry->success &&
+               std::chrono::system_clock::to_time_t(entry->timestamp) == 1700000000 &&
+               entry->options.at("scale") == "2.0" && entry->imported_objects.size() == 2;
+    });
+    
+    // Test 30: Malformed JSON is rejected without touching the current history
+    runner.runTest("Import Malformed JSON", []() -> bool {
+        AssetManager::ImportHistory history;
+        history.setHistoryFilePath("");
+        AssetManager::ImportHistoryEntry entry;
+        entry.id = "keep_me";
+        entry.asset_path = "asset.fbx";
+        entry.import_type = "import";
+        entry.success = true;
+        history.addEntry(entry);
+        
+        bool rejected = !history.importHistoryFromJSON("{\"history\": [{\"id\": \"broken\"");
+        return rejected && history.getHistorySize() == 1 && history.entryExists("keep_me");
+    });
+    
+    // Test 31: Save and load a large history file through the streaming loader
+    runner.runTest("Save And Load Large History File", []() -> bool {
+        AssetManager::ImportHistory history;
+        history.setHistoryFilePath("");
+        history.setMaxHistorySize(50000);
+        for (int i = 0; i < 20000; ++i) {
+            AssetManager::ImportHistoryEntry entry;
+            entry.id = "bulk_" + std::to_string(i);
+            entry.asset_path = "library/asset_" + std::to_string(i % 500) + ".fbx";
+            entry.import_type = i % 3 == 0 ? "link" : "import";
+            entry.timestamp = std::chrono::system_clock::now();
+            entry.success = i % 7 != 0;
+            entry.imported_objects = {"Object_" + std::to_string(i)};
+            entry.metadata["index"] = std::to_string(i);
+            history.addEntry(entry);
+        }
+        if (!history.saveHistory("bulk_history_test.json")) {
+            return false;
+        }
+        
+        AssetManager::ImportHistory restored;
+        restored.setHistoryFilePath("");
+        bool valid = restored.loadHistory("bulk_history_test.json");
+        valid &= restored.getHistorySize() == 20000;
+        auto last = restored.getEntry("bulk_19999");
+        valid &= last.has_value() && last->metadata.at("index") == "19999" && last->import_type == "import";
+        valid &= !restored.loadHistory("missing_history_file.json") && restored.getHistorySize() == 20000;
+        
+        std::filesystem::remove("bulk_history_test.json");
+        return valid;
+    });
+    
+    // Test 32: Back-dated entries keep newest-first order; time ranges and pages come from the index
+    runner.runTest("Indexed Time Order, Range And Page Queries", []() -> bool {
+        AssetManager::ImportHistory history;
+        history.setHistoryFilePath("");
+        history.enableAutoCleanup(false);
+        
+        auto base = std::chrono::system_clock::now() - std::chrono::hours(10);
+        const int order[] = {3, 0, 4, 1, 2};
+        for (int hour : order) {
+            AssetManager::ImportHistoryEntry entry;
+            entry.id = "indexed_" + std::to_string(hour);
+            entry.asset_path = hour % 2 == 0 ? "even.fbx" : "odd.obj";
+            entry.import_type = hour % 2 == 0 ? "import" : "link";
+            entry.timestamp = base + std::chrono::hours(hour);
+            entry.success = true;
+            history.addEntry(entry);
+        }
+        
+        auto all = history.getHistory();
+        bool valid = all.size() == 5 && all.front().id == "indexed_4" && all.back().id == "indexed_0";
+        
+        auto range = history.getHistoryByTimeRange(base + std::chrono::hours(1), base + std::chrono::hours(3));
+        valid &= range.size() == 3 && range[0].id == "indexed_3" && range[2].id == "indexed_1";
+        
+        auto page = history.getHistoryPage(1, 2);
+        valid &= page.size() == 2 && page[0].id == "indexed_3" && page[1].id == "indexed_2";
+        valid &= history.getHistoryPage(5, 10).empty();
+        
+        auto evens = history.getHistoryByAsset("even.fbx");
+        valid &= evens.size() == 3 && evens[0].id == "indexed_4";
+        valid &= history.getHistoryByType("link").size() == 2;
+        
+        history.clearHistoryByAsset("odd.obj");
+        valid &= history.getHistorySize() == 3 && !history.entryExists("indexed_1");
+        valid &= history.getEntry("indexed_2").has_value();
+        
+        size_t visited = 0;
+        history.forEachEntry([&visited](const AssetManager::ImportHistoryEntry&) {
+            return ++visited < 2;
+        });
+        valid &= visited == 2;
+        
+        // Max size drops the oldest entries
+        history.setMaxHistorySize(2);
+        valid &= history.getHistorySize() == 2 && !history.entryExists("indexed_0");
+        return valid;
+    });
+    
+    // Test 33: Generated IDs are unique and sort in generation order
+    runner.runTest("Monotonic Entry IDs", []() -> bool {
+        AssetManager::ImportHistory history;
+        std::string previous = history.generateEntryId();
+        for (int i = 0; i < 10000; ++i) {
+            std::string next = history.generateEntryId();
+            if (!(previous < next)) {
+                return false;
+            }
+            previous = next;
+        }
+        return previous.size() == std::string("import_").size() + 26;
+    });
+    
+    // Test 34: Rollups follow adds and removals; windows and top assets come from pre-aggregated counters
+    runner.runTest("Rollup Window Stats And Top Assets", []() -> bool {
+        AssetManager::ImportHistory history;
+        history.setHistoryFilePath("");
+        history.enableAutoCleanup(false);
+        
+        // Align to an hour boundary three days back so bucket edges are predictable
+        auto hours_now = std::chrono::duration_cast<std::chrono::hours>(
+            std::chrono::system_clock::now().time_since_epoch());
+        auto base = std::chrono::system_clock::time_point(hours_now - std::chrono::hours(72));
+        
+        for (int i = 0; i < 60; ++i) {
+            AssetManager::ImportHistoryEntry entry;
+            entry.id = "rollup_" + std::to_string(i);
+            entry.asset_path = i % 3 == 0 ? "tree.fbx" : (i % 3 == 1 ? "rock.obj" : "tree.fbx");
+            entry.import_type = i % 4 == 0 ? "link" : "import";
+            entry.timestamp = base + std::chrono::hours(i) + std::chrono::minutes(30);
+            entry.success = i % 5 != 0;
+            history.addEntry(entry);
+        }
+        
+        auto stats = history.getStats();
+        bool valid = stats.total_imports == 60 && stats.failed_imports == 12 && stats.linked_assets == 15;
+        valid &= stats.asset_types[".fbx"] == 40 && stats.asset_types[".obj"] == 20;
+        valid &= stats.first_import == base + std::chrono::minutes(30);
+        
+        auto top = history.getMostImportedAssets(1);
+        valid &= top.size() == 1 && top[0] == "tree.fbx";
+        
+        // Hours 10..39 span one full day plus partial edges
+        auto window = history.getStatsInRange(base + std::chrono::hours(10), base + std::chrono::hours(39) + std::chrono::minutes(59));
+        valid &= window.total_imports == 30;
+        valid &= window.first_import == base + std::chrono::hours(10) + std::chrono::minutes(30);
+        valid &= window.last_import == base + std::chrono::hours(39) + std::chrono::minutes(30);
+        
+        history.clearHistoryByAsset("tree.fbx");
+        stats = history.getStats();
+        valid &= stats.total_imports == 20 && stats.asset_types.count(".fbx") == 0;
+        top = history.getMostImportedAssets(5);
+        valid &= top.size() == 1 && top[0] == "rock.obj";
+        valid &= history.getImportTypeDistribution()["import"] + history.getImportTypeDistribution()["link"] == 20;
+        return valid;
+    });
+    
+    // Test 35: Size eviction pops the oldest entries off the ring and survives a restart
+    runner.runTest("Ring Retention Evicts Oldest", []() -> bool {
+        std::filesystem::remove_all("history_ring_test");
+        std::string path = "history_ring_test/history.json";
+        bool valid = true;
+        {
+            AssetManager::ImportHistory history;
+            history.setHistoryFilePath(path);
+            history.setMaxHistorySize(100);
+            auto base = std::chrono::system_clock::now() - std::chrono::minutes(30);
+            for (int i = 0; i < 1000; ++i) {
+                AssetManager::ImportHistoryEntry entry;
+                entry.id = "ring_" + std::to_string(i);
+                entry.asset_path = i % 2 == 0 ? "ring_even.fbx" : "ring_odd.fbx";
+                entry.import_type = "import";
+                entry.timestamp = base + std::chrono::milliseconds(i);
+                entry.success = true;
+                history.addEntry(entry);
+                if (i == 500) {
+                    history.clearHistoryByAsset("ring_odd.fbx");
+                }
+            }
+            valid &= history.getHistorySize() == 100 && !history.entryExists("ring_899");
+            valid &= history.entryExists("ring_900") && history.getHistory().back().id == "ring_900";
+            valid &= history.getHistoryByAsset("ring_even.fbx").size() == 50;
+            valid &= history.getStats().total_imports == 100;
+        }
+        
+        AssetManager::ImportHistory restored;
+        restored.setHistoryFilePath(path);
+        restored.setMaxHistorySize(100);
+        valid &= restored.recoverHistory() && restored.getHistorySize() == 100;
+        valid &= restored.entryExists("ring_999") && !restored.entryExists("ring_899");
+        
+        std::filesystem::remove_all("history_ring_test");
+        return valid;
+    });
+    
+    // Test 36: Expiry drops whole hour segments older than the retention period
+    runner.runTest("Segment Expiry", []() -> bool {
+        AssetManager::ImportHistory history;
+        history.setHistoryFilePath("");
+        auto now = std::chrono::system_clock::now();
+        const int ages[] = {50, 49, 30, 2};
+        for (int age : ages) {
+            AssetManager::ImportHistoryEntry entry;
+            entry.id = "aged_" + std::to_string(age);
+            entry.asset_path = "aged.fbx";
+            entry.import_type = "import";
+            entry.timestamp = now - std::chrono::hours(age);
+            entry.success = true;
+            history.addEntry(entry);
+        }
+        
+        history.setRetentionPeriod(std::chrono::hours(24));
+        bool valid = history.getHistorySize() == 1 && history.entryExists("aged_2");
+        
+        // A newly added expired entry goes on the next add once its segment has aged out
+        AssetManager::ImportHistoryEntry stale;
+        stale.id = "aged_stale";
+        stale.asset_path = "aged.fbx";
+        stale.import_type = "import";
+        stale.timestamp = now - std::chrono::hours(72);
+        stale.success = true;
+        history.addEntry(stale);
+        valid &= !history.entryExists("aged_stale") && history.getHistorySize() == 1;
+        return valid;
+    });
+    
+    // Test 37: Processes sharing one store lose no records, and refresh picks up another writer's changes
+    runner.runTest("Shared Store Across Processes", []() -> bool {
+        std::filesystem::remove_all("history_journal_test");
+        std::string path = "history_journal_test/history.json";
+        auto writeEntries = [&path](const std::string& prefix) {
+            AssetManager::ImportHistory history;
+            history.setHistoryFilePath(path);
+            history.setCompactionThreshold(32);
+            for (int i = 0; i < 200; ++i) {
+                AssetManager::ImportHistoryEntry entry;
+                entry.id = prefix + std::to_string(i);
+                entry.asset_path = prefix + ".fbx";
+                entry.import_type = "import";
+                entry.timestamp = std::chrono::system_clock::now();
+                entry.success = true;
+                history.addEntry(entry);
+            }
+        };
+        
+        pid_t child = fork();
+        if (child == 0) {
+            writeEntries("child_");
+            _exit(0);
+        }
+        writeEntries("parent_");
+        int status = 0;
+        bool valid = child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status);
+        
+        AssetManager::ImportHistory reader;
+        reader.setHistoryFilePath(path);
+        valid &= reader.recoverHistory() && reader.getHistorySize() == 400;
+        valid &= reader.entryExists("child_199") && reader.entryExists("parent_0");
+        
+        // A second writer's appends arrive through the journal tail ...
+        AssetManager::ImportHistory writer;
+        writer.setHistoryFilePath(path);
+        valid &= writer.recoverHistory();
+        AssetManager::ImportHistoryEntry entry;
+        entry.id = "shared_new";
+        entry.asset_path = "shared.fbx";
+        entry.import_type = "link";
+        entry.timestamp = std::chrono::system_clock::now();
+        entry.success = true;
+        writer.addEntry(entry);
+        writer.clearHistoryByAsset("child_.fbx");
+        valid &= reader.refreshHistory() && reader.getHistorySize() == 201 && reader.entryExists("shared_new");
+        valid &= reader.getJournalStats().records_tailed == 2;
+        // The writer's own records are already applied, so its refresh skips them
+        valid &= writer.refreshHistory() && writer.getJournalStats().records_tailed == 0;
+        valid &= writer.getHistorySize() == 201;
+        
+        // ... and after the writer compacts, through a full recover
+        valid &= writer.compactHistory();
+        entry.id = "shared_after_compaction";
+        writer.addEntry(entry);
+        valid &= reader.refreshHistory() && reader.getHistorySize() == 202;
+        valid &= reader.entryExists("shared_after_compaction") && !reader.entryExists("child_5");
+        
+        std::filesystem::remove_all("history_journal_test");
+        return valid;
+    });
+    
+    // Test 38: Batched undo removes every found entry with a single history update
+    runner.runTest("Batched Undo Commits One Removal", []() -> bool {
+        std::filesystem::remove_all("history_journal_test");
+        std::string path = "history_journal_test/history.json";
+        AssetManager::ImportHistory history;
+        history.setHistoryFilePath(path);
+        for (int i = 0; i < 5; ++i) {
+            AssetManager::ImportHistoryEntry entry;
+            entry.id = "batch_" + std::to_string(i);
+            entry.asset_path = "scatter.blend";
+            entry.import_type = "link";
+            entry.timestamp = std::chrono::system_clock::now();
+            entry.success = true;
+            history.addEntry(entry);
+        }
+        
+        size_t appended = history.getJournalStats().records_appended;
+        auto result = history.undoImports({"batch_0", "batch_2", "batch_4", "batch_missing"});
+        bool valid = !result.success && result.metadata.at("undone_entries") == "3";
+        valid &= result.metadata.at("failed_entries") == "1";
+        valid &= history.getHistorySize() == 2 && history.entryExists("batch_3") && !history.entryExists("batch_2");
+        valid &= history.getJournalStats().records_appended == appended + 1;
+        
+        std::filesystem::remove_all("history_journal_test");
+        return valid;
+    });
+    
+    // Test 39: Setting the path recovers the store and evicts aged-out and surplus entries on disk
+    runner.runTest("Opening A Store Evicts Persisted Entries", []() -> bool {
+        std::filesystem::remove_all("history_journal_test");
+        std::string path = "history_journal_test/history.json";
+        auto now = std::chrono::system_clock::now();
+        {
+            AssetManager::ImportHistory history;
+            history.setHistoryFilePath(path);
+            for (int i = 0; i < 5; ++i) {
+                AssetManager::ImportHistoryEntry entry;
+                entry.id = (i < 2 ? "old_" : "new_") + std::to_string(i);
+                entry.asset_path = "kept.fbx";
+                entry.import_type = "import";
+                entry.timestamp = i < 2 ? now - std::chrono::hours(72) : now - std::chrono::minutes(5 - i);
+                entry.success = true;
+                history.addEntry(entry);
+            }
+        }
+        
+        bool valid = true;
+        {
+            AssetManager::ImportHistory history;
+            history.setRetentionPeriod(std::chrono::hours(24));
+            history.setMaxHistorySize(2);
+            history.setHistoryFilePath(path);
+            valid &= history.getHistorySize() == 2;
+        }
+        AssetManager::ImportHistory restored;
+        restored.setHistoryFilePath(path);
+        valid &= restored.getHistorySize() == 2 && restored.entryExists("new_3") && restored.entryExists("new_4");
+        valid &= !restored.entryExists("old_0") && !restored.entryExists("new_2");
+
+        std::filesystem::remove_all("history_journal_test");
+        return valid;
+    });
+
+    // Test 40: A legacy JSON history at the store path is adopted once; default instances open no store
+    runner.runTest("Legacy JSON History Migrated Once", []() -> bool {
+        std::filesystem::remove_all("history_journal_test");
+        std::filesystem::create_directories("history_journal_test");
+        std::string path = "history_journal_test/history.json";
+        auto now = std::chrono::system_clock::now();
+        {
+            AssetManager::ImportHistory legacy;
+            for (int i = 0; i < 3; ++i) {
+                AssetManager::ImportHistoryEntry entry;
+                entry.id = "legacy_" + std::to_string(i);
+                entry.asset_path = "legacy.fbx";
+                entry.import_type = "import";
+                entry.timestamp = now - std::chrono::minutes(3 - i);
+                entry.success = true;
+                legacy.addEntry(entry);
+            }
+            legacy.saveHistory(path);
+        }
+
+        bool valid = true;
+        {
+            AssetManager::ImportHistory history;
+            valid &= history.getJournalStats().records_appended == 0;
+            history.setHistoryFilePath(path);
+            valid &= history.getHistorySize() == 3 && history.entryExists("legacy_0");
+            valid &= !std::filesystem::exists(path) && std::filesystem::exists(path + ".migrated");
+            history.clearHistoryByAsset("missing.fbx");
+            history.undoImport("legacy_2");
+        }
+        AssetManager::ImportHistory restored;
+        restored.setHistoryFilePath(path);
+        valid &= restored.getHistorySize() == 2 && !restored.entryExists("legacy_2");
+        valid &= restored.getJournalStats().records_appended == 0;
+
+        std::filesystem::remove_all("history_journal_test");
+        return valid;
+    });
+
+    // Test 41: Assets removed after the top-k sketch evicted counters are not reported
+    runner.runTest("Most Imported Ignores Removed Assets After Eviction", []() -> bool {
+        auto make_entry = [](const std::string& asset, bool success) {
+            AssetManager::ImportHistoryEntry entry;
+            entry.asset_path = asset;
+            entry.import_type = "import";
+            entry.timestamp = std::chrono::system_clock::now();
+            entry.success = success;
+            return entry;
+        };
+
+        bool valid = true;
+        {
+            AssetManager::ImportHistory history;
+            for (int i = 0; i < 300; ++i) {
+                history.addEntry(make_entry("x" + std::to_string(i) + ".obj", true));
+            }
+            history.clearSuccessfulImports();
+            history.addEntry(make_entry("only.obj", true));
+            auto top = history.getMostImportedAssets(10);
+            valid &= top.size() == 1 && top[0] == "only.obj";
+        }
+        {
+            AssetManager::ImportHistory history;
+            history.addEntry(make_entry("keeper.obj", true));
+            for (int i = 0; i < 300; ++i) {
+                history.addEntry(make_entry("x" + std::to_string(i) + ".obj", false));
+            }
+            history.clearFailedImports();
+            auto top = history.getMostImportedAssets(10);
+            valid &= top.size() == 1 && top[0] == "keeper.obj";
+        }
+        return valid;
+    });
+
+    // Test 42: Without a recorded scene file undo is reported as unsupported and the entry is kept
+    runner.runTest("Undo Without Scene File Is Unsupported", []() -> bool {
+        std::filesystem::remove_all("undo_test");
+        AssetManager::ImportHistory history;
+        AssetManager::ImportHistoryEntry entry;
+        entry.id = "no_scene";
+        entry.asset_path = "crate.fbx";
+        entry.import_type = "import";
+        entry.timestamp = std::chrono::system_clock::now();
+        entry.success = true;
+        entry.imported_objects = {"Crate"};
+        history.addEntry(entry);
+        
+        AssetManager::UndoResult single;
+        AssetManager::UndoResult batch;
+        withStubBlender("undo_test", [&]() {
+            single = history.undoImport("no_scene");
+            batch = history.undoImports({"no_scene"});
+        });
+        
+        bool valid = !single.success && single.message.find("not supported") != std::string::npos;
+        valid &= !batch.success && batch.metadata.at("unsupported_entries") == "1";
+        valid &= history.entryExists("no_scene");
+        valid &= !std::filesystem::exists("undo_test/script_0.py");   // Blender was never run
+        std::filesystem::remove_all("undo_test");
+        return valid;
+    });
+    
+    // Test 43: Batched undo runs once per scene file and purges only the removed objects' data
+    runner.runTest("Batched Undo Runs Per Scene File", []() -> bool {
+        std::filesystem::remove_all("undo_test");
+        std::filesystem::create_directories("undo_test");
+        std::ofstream("undo_test/a.blend") << "BLENDER";
+        std::ofstream("undo_test/b.blend") << "BLENDER";
+        AssetManager::ImportHistory history;
+        const char* scenes[] = {"undo_test/a.blend", "undo_test/b.blend", "undo_test/a.blend"};
+        for (int i = 0; i < 3; ++i) {
+            AssetManager::ImportHistoryEntry entry;
+            entry.id = "scene_" + std::to_string(i);
+            entry.asset_path = "prop_" + std::to_string(i) + ".fbx";
+            entry.import_type = "import";
+            entry.timestamp = std::chrono::system_clock::now();
+            entry.success = true;
+            entry.imported_objects = {"Prop_" + std::to_string(i)};
+            entry.metadata["scene_file"] = scenes[i];
+            history.addEntry(entry);
+        }
+        
+        AssetManager::UndoResult result;
+        withStubBlender("undo_test", [&]() { result = history.undoImports({"scene_0", "scene_1", "scene_2"}); });
+        
+        std::string first = readFile("undo_test/script_0.py");
+        std::string second = readFile("undo_test/script_1.py");
+        std::string a_path = std::filesystem::absolute("undo_test/a.blend").string();
+        std::string& a_script = first.find(a_path) != std::string::npos ? first : second;
+        bool valid = result.success && history.isEmpty() && result.removed_objects.size() == 3;
+        valid &= !std::filesystem::exists("undo_test/script_2.py");
+        valid &= a_script.find("\"Prop_0\"") != std::string::npos && a_script.find("\"Prop_2\"") != std::string::npos;
+        valid &= a_script.find("\"Prop_1\"") == std::string::npos;
+        valid &= a_script.find("datablocks.get(name)") != std::string::npos;
+        valid &= a_script.find("for b in datablocks") == std::string::npos;   // no sweep of every orphan
+        std::filesystem::remove_all("undo_test");
+        return valid;
+    });
+
+    // Test 44: A damaged record mid-journal is skipped; later records from other writers survive
+    runner.runTest("Journal Resynchronises Past Damaged Records", []() -> bool {
+        std::filesystem::remove_all("history_journal_test");
+        std::string path = "history_journal_test/history.json";
+        auto makeEntry = [](const std::string& id) {
+            AssetManager::ImportHistoryEntry entry;
+            entry.id = id;
+            entry.asset_path = id + ".fbx";
+            entry.import_type = "import";
+            entry.timestamp = std::chrono::system_clock::now();
+            entry.success = true;
+            return entry;
+        };
+        
+        bool valid = true;
+        AssetManager::ImportHistory reader;
+        reader.setHistoryFilePath(path);
+        {
+            AssetManager::ImportHistory writer;
+            writer.setHistoryFilePath(path);
+            writer.addEntry(makeEntry("before"));
+            valid &= reader.recoverHistory() && reader.getHistorySize() == 1;
+            
+            // A failed write left an unterminated fragment; the next append lands on the same line
+            std::ofstream(path + ".journal", std::ios::app) << "0badf00d {\"op\":\"add\",\"entry\":{\"id\":\"lo";
+            writer.addEntry(makeEntry("merged"));
+            // A terminated fragment followed by further records
+            std::ofstream(path + ".journal", std::ios::app) << "deadbeef {\"op\":\"clear\"}\n";
+            writer.addEntry(makeEntry("after"));
+        }
+        
+        // The tail moves past the damage and keeps delivering
+        valid &= reader.refreshHistory() && reader.getHistorySize() == 3;
+        valid &= reader.entryExists("merged") && reader.entryExists("after");
+        valid &= reader.getJournalStats().damaged_records_skipped == 2;
+        
+        // Recovery (run when the store is opened) skips the same records and truncates nothing
+        auto size_before = std::filesystem::file_size(path + ".journal");
+        AssetManager::ImportHistory restored;
+        restored.setHistoryFilePath(path);
+        valid &= restored.getHistorySize() == 3 && restored.entryExists("after");
+        valid &= restored.getJournalStats().damaged_records_skipped == 2;
+        valid &= restored.getJournalStats().torn_records_discarded == 0;
+        valid &= std::filesystem::file_size(path + ".journal") == size_before;
+        
+        std::filesystem::remove_all("history_journal_test");
+        return valid;
+    });
+
+    // Test 45: Back-dated records from another writer are merged in time order on refresh
+    runner.runTest("Refresh Merges Back-Dated Records", []() -> bool {
+        std::filesystem::remove_all("history_tail_test");
+        std::string path = "history_tail_test/history.json";
+        auto now = std::chrono::system_clock::now();
+        auto makeEntry = [now](const std::string& id, int minutes_ago) {
+            AssetManager::ImportHistoryEntry entry;
+            entry.id = id;
+            entry.asset_path = id + ".fbx";
+            entry.import_type = "import";
+            entry.timestamp = now - std::chrono::minutes(minutes_ago);
+            entry.success = true;
+            return entry;
+        };
+        
+        bool valid = true;
+        AssetManager::ImportHistory reader;
+        reader.setHistoryFilePath(path);
+        reader.addEntry(makeEntry("local", 10));
+        {
+            AssetManager::ImportHistory writer;
+            writer.setHistoryFilePath(path);
+            writer.addEntry(makeEntry("c", 5));
+            writer.addEntry(makeEntry("a", 30));
+            writer.addEntry(makeEntry("b", 20));
+            writer.addEntry(makeEntry("d", 40));
+            auto moved = makeEntry("a", 1);   // re-recorded later; the newest record for an id wins
+            moved.asset_path = "moved.fbx";
+            writer.addEntry(moved);
+        }
+        
+        valid &= reader.refreshHistory() && reader.getHistorySize() == 5;
+        auto history = reader.getHistory();
+        std::vector<std::string> order;
+        for (const auto& entry : history) {
+            order.push_back(entry.id);
+        }
+        valid &= order == std::vector<std::string>({"a", "c", "local", "b", "d"});
+        valid &= reader.getEntry("a") && reader.getEntry("a")->asset_path == "moved.fbx";
+        valid &= reader.getHistoryByAsset("a.fbx").empty();
+        
+        std::filesystem::remove_all("history_tail_test");
+        return valid;
+    });
+
     runner.printSummary();
     
     return runner.getFailedCount() == 0 ? 0 : 1;
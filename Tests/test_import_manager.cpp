@@ -16,6 +16,11 @@
 #include <iostream>
 #include <memory>
 #include <cmath>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 
 using namespace TestHarness;
 
@@ -392,6 +397,588 @@ int main() {
         return !result.success && result.message.find("does not exist") != std::string::npos;
     });
     
+    // Test 25: Telemetry attached to every result
+    runner.runTest("Import Telemetry Attached to Result", []() -> bool {
+        AssetManager::ImportManager manager;
+        AssetManager::ImportResult result = manager.importAsset("nonexistent_file.FBX");
+        
+        auto it = result.metadata.find("telemetry");
+        if (it == result.metadata.end()) return false;
+        auto telemetry = std::any_cast<AssetManager::ImportTelemetry>(it->second);
+        
+        bool valid = telemetry.asset_type == "fbx";
+        valid &= telemetry.total_ms >= 0.0;
+        valid &= result.metadata.count("telemetry.library_load_ms") == 1;
+        valid &= result.metadata.count("telemetry.peak_worker_rss_kb") == 1;
+        // Runs that never reached Blender are not recorded in the histograms
+        valid &= manager.getTelemetrySummary("fbx", "total_ms").count == 0;
+        return valid;
+    });
+    
+    // Test 26: Rolling histogram window and percentiles
+    runner.runTest("Telemetry Rolling Histogram", []() -> bool {
+        AssetManager::RollingHistogram histogram(100);
+        for (int i = 1; i <= 150; ++i) {
+            histogram.add(static_cast<double>(i));
+        }
+        
+        AssetManager::TelemetrySummary summary = histogram.summarize();
+        size_t bucketed = 0;
+        for (size_t c : summary.bucket_counts) bucketed += c;
+        
+        bool valid = summary.count == 100;
+        valid &= bucketed == 100;
+        valid &= summary.min == 51.0 && summary.max == 150.0;
+        valid &= summary.p50 == 100.0;
+        valid &= summary.p90 == 140.0;
+        valid &= summary.p99 == 149.0;
+        valid &= std::abs(summary.mean - 100.5) < 1e-9;
+        return valid;
+    });
+    
+    // Test 27: Telemetry registry per asset type
+    runner.runTest("Telemetry Registry Per Asset Type", []() -> bool {
+        AssetManager::ImportTelemetryRegistry registry(8);
+        for (int i = 0; i < 4; ++i) {
+            AssetManager::ImportTelemetry blend;
+            blend.asset_type = "blend";
+            blend.library_load_ms = 100.0 + i;
+            registry.record(blend);
+        }
+        AssetManager::ImportTelemetry obj;
+        obj.asset_type = "obj";
+        obj.library_load_ms = 5.0;
+        registry.record(obj);
+        
+        bool valid = registry.getAssetTypes().size() == 2;
+        valid &= registry.getSummary("blend", "library_load_ms").count == 4;
+        valid &= registry.getSummary("blend", "library_load_ms").max == 103.0;
+        valid &= registry.getSummary("obj", "library_load_ms").p50 == 5.0;
+        valid &= registry.getSummary("fbx", "library_load_ms").count == 0;
+        valid &= !registry.getSummaries("blend").empty();
+        return valid;
+    });
+    
+    // Test 28: Prefetcher warms each file once until it changes
+    runner.runTest("Dependency Prefetcher Skips Warm Files", []() -> bool {
+        std::filesystem::create_directories("prefetch_test_assets");
+        std::ofstream("prefetch_test_assets/rock.obj") << "mtllib rock.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+        std::ofstream("prefetch_test_assets/rock.mtl") << "newmtl rock\nmap_Kd rock_albedo.png\nmap_Bump -bm 0.5 rock_normal.png\n";
+        std::ofstream("prefetch_test_assets/rock_albedo.png") << "albedo";
+        std::ofstream("prefetch_test_assets/rock_normal.png") << "normal";
+        
+        AssetManager::DependencyPrefetcher prefetcher(2);
+        prefetcher.enqueue("prefetch_test_assets/rock.obj");
+        prefetcher.waitIdle();
+        prefetcher.enqueue(std::vector<std::string>{"prefetch_test_assets/rock.obj", "prefetch_test_assets/missing.obj"});
+        prefetcher.waitIdle();
+        AssetManager::PrefetchStats stats = prefetcher.getStats();
+        
+        std::filesystem::remove_all("prefetch_test_assets");
+        bool valid = stats.assets_enqueued == 3;
+        valid &= stats.files_advised == 4;
+        valid &= stats.files_skipped == 4;
+        valid &= stats.failures == 1;
+        return valid;
+    });
+    
+    // Test 29: Dependency closure resolved through the index
+    runner.runTest("AssetManager Dependency Closure", []() -> bool {
+        std::filesystem::create_directories("closure_test_library/Assets/Props");
+        std::ofstream("closure_test_library/Assets/Props/barrel.obj") << "v 0 0 0\n";
+        std::ofstream("closure_test_library/Assets/Props/barrel.mtl") << "newmtl barrel\nmap_Kd barrel_diffuse.png\n";
+        std::ofstream("closure_test_library/Assets/Props/barrel_diffuse.png") << "png";
+        
+        bool valid = false;
+        {
+            AssetManager::AssetManager asset_manager;
+            asset_manager.initialize("closure_test_library");
+            asset_manager.scan_assets(true);
+            auto closure = asset_manager.get_dependency_closure("Assets/Props/barrel.obj");
+            valid = closure.size() == 3;
+            valid &= closure.size() > 0 && closure[0].find("barrel.obj") != std::string::npos;
+            valid &= std::any_of(closure.begin(), closure.end(), [](const std::string& p) {
+                return p.find("barrel_diffuse.png") != std::string::npos;
+            });
+        }
+        std::filesystem::remove_all("closure_test_library");
+        return valid;
+    });
+    
+    // Test 30: Hot cache serves fresh copies and drops stale ones
+    runner.runTest("Hot Asset Cache Resolve And Staleness", []() -> bool {
+        std::filesystem::create_directories("hot_cache_src");
+        std::ofstream("hot_cache_src/chair.obj") << "mtllib chair.mtl\nv 0 0 0\n";
+        std::ofstream("hot_cache_src/chair.mtl") << "newmtl chair\nmap_Kd chair_albedo.png\n";
+        std::ofstream("hot_cache_src/chair_albedo.png") << "png";
+        
+        bool valid = true;
+        {
+            AssetManager::HotAssetCache cache("hot_cache_root", 1 << 20);
+            valid &= cache.admit("hot_cache_src/chair.obj");
+            std::string resolved = cache.resolve("hot_cache_src/chair.obj");
+            valid &= resolved != "hot_cache_src/chair.obj" && resolved.find("hot_cache_root") != std::string::npos;
+            valid &= std::filesystem::exists(resolved);
+            valid &= std::filesystem::exists(std::filesystem::path(resolved).parent_path() / "chair_albedo.png");
+            
+            std::ofstream("hot_cache_src/chair.obj") << "mtllib chair.mtl\nv 0 0 0\nv 1 1 1\n";
+            valid &= cache.resolve("hot_cache_src/chair.obj") == "hot_cache_src/chair.obj";
+            
+            // A changed dependency makes the copy stale too
+            valid &= cache.admit("hot_cache_src/chair.obj");
+            std::ofstream("hot_cache_src/chair_albedo.png") << "png, re-exported";
+            valid &= cache.resolve("hot_cache_src/chair.obj") == "hot_cache_src/chair.obj";
+            
+            AssetManager::HotCacheStats stats = cache.getStats();
+            valid &= stats.hits == 1 && stats.misses == 2 && stats.stale == 2 && stats.entries == 0;
+            valid &= std::abs(stats.hit_rate - 1.0 / 3.0) < 1e-9;
+        }
+        std::filesystem::remove_all("hot_cache_src");
+        std::filesystem::remove_all("hot_cache_root");
+        return valid;
+    });
+    
+    // Test 31: LRU eviction keeps the cache under its size cap
+    runner.runTest("Hot Asset Cache LRU Eviction", []() -> bool {
+        std::filesystem::create_directories("hot_cache_src");
+        for (const char* name : {"a.fbx", "b.fbx", "c.fbx"}) {
+            std::ofstream(std::string("hot_cache_src/") + name) << std::string(100, 'x');
+        }
+        
+        bool valid = true;
+        {
+            AssetManager::HotAssetCache cache("hot_cache_root", 250, AssetManager::CacheEvictionPolicy::LRU);
+            valid &= cache.admit("hot_cache_src/a.fbx");
+            valid &= cache.admit("hot_cache_src/b.fbx");
+            cache.resolve("hot_cache_src/a.fbx");
+            valid &= cache.admit("hot_cache_src/c.fbx");
+            
+            valid &= cache.contains("hot_cache_src/a.fbx");
+            valid &= !cache.contains("hot_cache_src/b.fbx");
+            valid &= cache.contains("hot_cache_src/c.fbx");
+            AssetManager::HotCacheStats stats = cache.getStats();
+            valid &= stats.bytes_cached == 200 && stats.evictions == 1;
+        }
+        {
+            // Manifest survives a restart, recency included: c was used after a, so a goes first
+            AssetManager::HotAssetCache reopened("hot_cache_root", 250);
+            valid &= reopened.contains("hot_cache_src/a.fbx") && reopened.getStats().entries == 2;
+            valid &= reopened.admit("hot_cache_src/b.fbx");
+            valid &= !reopened.contains("hot_cache_src/a.fbx") && reopened.contains("hot_cache_src/c.fbx");
+        }
+        std::filesystem::remove_all("hot_cache_src");
+        std::filesystem::remove_all("hot_cache_root");
+        return valid;
+    });
+    
+    // Test 32: History-driven prediction and admission
+    runner.runTest("Hot Asset Cache Predictive Admission", []() -> bool {
+        std::filesystem::create_directories("hot_cache_src");
+        for (const char* name : {"wall.fbx", "door.fbx", "lamp.fbx"}) {
+            std::ofstream(std::string("hot_cache_src/") + name) << name;
+        }
+        
+        std::vector<AssetManager::ImportHistoryEntry> history;
+        auto now = std::chrono::system_clock::now();
+        const char* sequence[] = {"wall.fbx", "door.fbx", "wall.fbx", "door.fbx", "wall.fbx", "lamp.fbx"};
+        for (int i = 0; i < 6; ++i) {
+            AssetManager::ImportHistoryEntry entry;
+            entry.asset_path = std::string("hot_cache_src/") + sequence[i];
+            entry.timestamp = now - std::chrono::minutes(10 - i);
+            entry.success = true;
+            history.push_back(entry);
+        }
+        
+        bool valid = true;
+        {
+            AssetManager::HotAssetCache cache("hot_cache_root", 1 << 20);
+            cache.setPredictionFanout(1);
+            cache.warmFromHistory(history, 1);
+            cache.waitIdle();
+            auto predicted = cache.predictNext("hot_cache_src/wall.fbx", 1);
+            valid &= predicted.size() == 1 && predicted[0].find("door.fbx") != std::string::npos;
+            valid &= cache.contains("hot_cache_src/wall.fbx");
+            valid &= !cache.contains("hot_cache_src/door.fbx");
+            
+            // Importing the wall queues its likely successor
+            cache.recordImport("hot_cache_src/wall.fbx");
+            cache.waitIdle();
+            valid &= cache.contains("hot_cache_src/door.fbx");
+            valid &= !cache.contains("hot_cache_src/lamp.fbx");
+        }
+        std::filesystem::remove_all("hot_cache_src");
+        std::filesystem::remove_all("hot_cache_root");
+        return valid;
+    });
+    
+    // Test 33: Texture-memory budget substitutes cached variants for the largest textures
+    runner.runTest("Texture Budget Plan Substitutes Variants", []() -> bool {
+        std::filesystem::create_directories("budget_test_library");
+        auto writeTexture = [](const std::string& path, int size) {
+            AssetManager::ImageBuffer image;
+            image.width = size;
+            image.height = size;
+            image.channels = 3;
+            image.bytes.assign(image.sampleCount(), 128);
+            std::string error;
+            return AssetManager::TextureProcessor::encode(path, image, error);
+        };
+        std::ofstream("budget_test_library/crate.obj") << "v 0 0 0\n";
+        std::ofstream("budget_test_library/crate.mtl") << "newmtl crate\nmap_Kd crate_albedo.png\nmap_Bump shared_grunge.png\n";
+        std::ofstream("budget_test_library/barrel.obj") << "v 0 0 0\n";
+        std::ofstream("budget_test_library/barrel.mtl") << "newmtl barrel\nmap_Kd barrel_albedo.png\nmap_Bump shared_grunge.png\n";
+        bool valid = writeTexture("budget_test_library/crate_albedo.png", 64);
+        valid &= writeTexture("budget_test_library/shared_grunge.png", 32);
+        valid &= writeTexture("budget_test_library/barrel_albedo.png", 16);
+        
+        {
+            AssetManager::AssetManager asset_manager;
+            asset_manager.initialize("budget_test_library");
+            asset_manager.scan_assets(true);
+            AssetManager::TextureVariantOptions options;
+            options.cache_root = "budget_test_variants";
+            options.max_sizes = {32, 16};
+            asset_manager.generate_texture_variants(options);
+            
+            // RGBA texels plus a third for mips: 64x64 = 21845, 32x32 = 5461, 16x16 = 1365 bytes
+            std::vector<std::string> batch = {"crate.obj", "barrel.obj"};
+            auto estimate = asset_manager.plan_texture_budget(batch, 0);
+            valid &= estimate.estimated_bytes == 21845 + 5461 + 1365 && estimate.within_budget;
+            valid &= estimate.textures.size() == 3 && estimate.substitutions.empty();
+            valid &= estimate.textures.size() == 3 && estimate.textures[1].used_by.size() == 2;
+            
+            auto plan = asset_manager.plan_texture_budget(batch, 20000);
+            valid &= plan.within_budget && plan.planned_bytes == 5461 + 5461 + 1365;
+            valid &= plan.substitutions.size() == 1 && plan.downgraded_assets.size() == 1;
+            valid &= plan.downgraded_assets.count("crate.obj") == 1 && plan.textures[0].planned_width == 32;
+            valid &= plan.substitutions.size() == 1 && plan.substitutions.begin()->second.find("budget_test_variants") != std::string::npos;
+            
+            auto too_small = asset_manager.plan_texture_budget(batch, 1000);
+            valid &= !too_small.within_budget && too_small.planned_bytes == 3 * 1365;
+            
+            // The import fails (Blender loads .blend libraries only), so nothing is reported as downgraded
+            asset_manager.set_texture_memory_budget(20000);
+            auto result = asset_manager.importAsset("budget_test_library/crate.obj");
+            auto downgraded = result.metadata.find("downgraded_textures");
+            valid &= !result.success && downgraded != result.metadata.end() &&
+                     std::any_cast<std::vector<std::string>>(downgraded->second).empty();
+            valid &= asset_manager.get_last_texture_budget_plan().substitutions.size() == 1;
+        }
+        std::filesystem::remove_all("budget_test_library");
+        std::filesystem::remove_all("budget_test_variants");
+        return valid;
+    });
+    
+    // Test 34: Budgeted .blend imports swap their own images, matched by full path
+    runner.runTest("Texture Budget Swaps Blend Images", []() -> bool {
+        std::filesystem::create_directories("budget_blend_library/hero/textures");
+        std::filesystem::create_directories("budget_blend_library/prop");
+        std::filesystem::create_directories("budget_blend_stub");
+        auto writeTexture = [](const std::string& path, int size) {
+            AssetManager::ImageBuffer image;
+            image.width = size;
+            image.height = size;
+            image.channels = 3;
+            image.bytes.assign(image.sampleCount(), 128);
+            std::string error;
+            return AssetManager::TextureProcessor::encode(path, image, error);
+        };
+        // Minimal .blend: header, one Image block (ID name, then filepath) and ENDB
+        auto writeBlend = [](const std::string& path, const std::string& image_path) {
+            std::string image(66, '\0');
+            image.replace(0, 12, "IMalbedo.png");
+            image += image_path + std::string(1024 - image_path.size(), '\0');
+            auto block = [](const char* code, const std::string& data) {
+                std::string header(code, 4);
+                uint32_t length = static_cast<uint32_t>(data.size());
+                header.append(reinterpret_cast<const char*>(&length), 4);
+                header.append(16, '\0');
+                return header + data;
+            };
+            std::ofstream(path, std::ios::binary) << "BLENDER-v300" << block("IM\0\0", image) << block("ENDB", "");
+        };
+        bool valid = writeTexture("budget_blend_library/hero/textures/albedo.png", 64);
+        valid &= writeTexture("budget_blend_library/prop/albedo.png", 16);
+        writeBlend("budget_blend_library/hero/hero.blend", "//textures/albedo.png");
+        writeBlend("budget_blend_library/prop/prop.blend", "//albedo.png");
+        
+        // Stand-in Blender: runs the import script with a bpy that appends the .blend's images
+        std::ofstream("budget_blend_stub/blender") << "#!/bin/sh\nPYTHONPATH=\"$(dirname \"$0\")\" exec python3 \"$4\" -- \"$6\"\n";
+        std::filesystem::permissions("budget_blend_stub/blender", std::filesystem::perms::owner_all);
+        std::ofstream("budget_blend_stub/mathutils.py") << "Vector = list\n";
+        std::ofstream("budget_blend_stub/bpy.py") <<
+            "import os, re, sys, types\n"
+            "class _Image:\n"
+            "    def __init__(self, filepath):\n"
+            "        self.source, self.filepath, self.library = 'FILE', filepath, None\n"
+            "class _Load:\n"
+            "    def __init__(self, path, link=False):\n"
+            "        self.path = path\n"
+            "    def __enter__(self):\n"
+            "        blob = open(self.path, 'rb').read()\n"
+            "        for rel in re.findall(rb'//[^\\x00]+', blob):\n"
+            "            data.images.append(_Image(os.path.join(os.path.dirname(self.path), rel[2:].decode())))\n"
+            "        empty = types.SimpleNamespace(collections=[], objects=[])\n"
+            "        return empty, types.SimpleNamespace(collections=[], objects=[])\n"
+            "    def __exit__(self, *args):\n"
+            "        return False\n"
+            "data = types.SimpleNamespace(images=[], libraries=types.SimpleNamespace(load=_Load))\n"
+            "path = types.SimpleNamespace(abspath=lambda p, library=None: p)\n";
+        
+        const char* old_path = std::getenv("PATH");
+        std::string saved_path = old_path ? old_path : "";
+        setenv("PATH", (std::filesystem::absolute("budget_blend_stub").string() + ":" + saved_path).c_str(), 1);
+        {
+            AssetManager::AssetManager asset_manager;
+            asset_manager.initialize("budget_blend_library");
+            asset_manager.scan_assets(true);
+            AssetManager::TextureVariantOptions options;
+            options.cache_root = "budget_blend_variants";
+            options.max_sizes = {32};
+            asset_manager.generate_texture_variants(options);
+            
+            // The .blend's image is part of its closure, so the planner can downgrade it
+            std::string hero_albedo = std::filesystem::absolute("budget_blend_library/hero/textures/albedo.png").lexically_normal().string();
+            std::string prop_albedo = std::filesystem::absolute("budget_blend_library/prop/albedo.png").lexically_normal().string();
+            auto closure = asset_manager.get_dependency_closure("hero/hero.blend");
+            valid &= closure.size() == 2;
+            
+            // Only the hero's 64x64 albedo fits a variant under budget; the prop's albedo shares its name
+            asset_manager.set_texture_memory_budget(10000);
+            auto results = asset_manager.importAssetsLine({"budget_blend_library/hero/hero.blend",
+                                                           "budget_blend_library/prop/prop.blend"}, {}, 1.0f);
+            valid &= results.size() == 2 && results[0].success && results[1].success;
+            auto substituted = [](const AssetManager::ImportResult& result) {
+                auto it = result.metadata.find("substituted_textures");
+                return it == result.metadata.end() ? std::vector<std::string>()
+                                                   : std::any_cast<std::vector<std::string>>(it->second);
+            };
+            auto downgraded = [](const AssetManager::ImportResult& result) {
+                return std::any_cast<std::vector<std::string>>(result.metadata.at("downgraded_textures"));
+            };
+            if (results.size() == 2) {
+                valid &= substituted(results[0]) == std::vector<std::string>{hero_albedo};
+                valid &= downgraded(results[0]) == std::vector<std::string>{hero_albedo};
+                valid &= substituted(results[1]).empty() && downgraded(results[1]).empty();
+            }
+            valid &= prop_albedo != hero_albedo;
+        }
+        setenv("PATH", saved_path.c_str(), 1);
+        std::filesystem::remove_all("budget_blend_library");
+        std::filesystem::remove_all("budget_blend_variants");
+        std::filesystem::remove_all("budget_blend_stub");
+        return valid;
+    });
+    
+    // Test 35: Bulk imports queue readahead for each asset exactly once
+    runner.runTest("Bulk Import Prefetches Once Per Asset", []() -> bool {
+        std::filesystem::create_directories("bulk_prefetch_assets");
+        std::ofstream("bulk_prefetch_assets/a.obj") << "v 0 0 0\n";
+        std::ofstream("bulk_prefetch_assets/b.obj") << "v 0 0 0\n";
+        
+        auto prefetcher = std::make_shared<AssetManager::DependencyPrefetcher>(2);
+        AssetManager::ImportManager manager;
+        manager.setPrefetcher(prefetcher);
+        manager.importAssetsLine({"bulk_prefetch_assets/a.obj", "bulk_prefetch_assets/b.obj"}, {}, 1.0f);
+        prefetcher->waitIdle();
+        size_t bulk_enqueued = prefetcher->getStats().assets_enqueued;
+        manager.importAsset("bulk_prefetch_assets/a.obj");
+        prefetcher->waitIdle();
+        size_t single_enqueued = prefetcher->getStats().assets_enqueued - bulk_enqueued;
+        
+        std::filesystem::remove_all("bulk_prefetch_assets");
+        return bulk_enqueued == 2 && single_enqueued == 1;
+    });
+    
+    // Test 36: Only runs whose script started are recorded, and unmeasured bytes stay unreported
+    runner.runTest("Telemetry Recorded Only After Worker Start", []() -> bool {
+        std::filesystem::create_directories("telemetry_stub");
+        std::ofstream("telemetry_stub/crate.fbx") << "fbx";
+        auto writeStub = [](const std::string& body) {
+            std::ofstream("telemetry_stub/blender") << "#!/bin/sh\n" << body;
+            std::filesystem::permissions("telemetry_stub/blender", std::filesystem::perms::owner_all);
+        };
+        const char* old_path = std::getenv("PATH");
+        std::string saved_path = old_path ? old_path : "";
+        setenv("PATH", (std::filesystem::absolute("telemetry_stub").string() + ":" + saved_path).c_str(), 1);
+        
+        AssetManager::ImportManager manager;
+        writeStub("echo 'Segmentation fault'\nexit 139\n");
+        AssetManager::ImportResult crashed = manager.importAsset("telemetry_stub/crate.fbx");
+        bool valid = !crashed.success && manager.getTelemetrySummary("fbx", "total_ms").count == 0;
+        
+        writeStub("echo TELEMETRY:start=0\necho TELEMETRY:library_load_ms=2.5\necho SUCCESS\n");
+        AssetManager::ImportResult imported = manager.importAsset("telemetry_stub/crate.fbx");
+        valid &= imported.success && manager.getTelemetrySummary("fbx", "total_ms").count == 1;
+        valid &= manager.getTelemetrySummary("fbx", "library_load_ms").max == 2.5;
+        valid &= manager.getTelemetrySummary("fbx", "bytes_read").count == 0;
+        valid &= imported.metadata.count("telemetry.bytes_read") == 0;
+        
+        setenv("PATH", saved_path.c_str(), 1);
+        std::filesystem::remove_all("telemetry_stub");
+        return valid;
+    });
+    
+    // Test 37: Atlas remap moves only the render UV layer and skips tiling or multi-material meshes
+    runner.runTest("Atlas Remap Skips Unsafe Meshes", []() -> bool {
+        std::filesystem::create_directories("atlas_stub");
+        std::ofstream("atlas_stub/props.blend") << "BLENDER-v300";
+        std::ofstream("atlas_stub/blender") << "#!/bin/sh\nPYTHONPATH=\"$(dirname \"$0\")\" exec python3 \"$4\" -- \"$6\"\n";
+        std::filesystem::permissions("atlas_stub/blender", std::filesystem::perms::owner_all);
+        std::ofstream("atlas_stub/mathutils.py") << "Vector = list\n";
+        // Stand-in bpy: three meshes, written back to uvs.txt when the script exits
+        std::ofstream("atlas_stub/bpy.py") <<
+            "import atexit, os, types\n"
+            "class _Data(list):\n"
+            "    def foreach_get(self, key, out):\n"
+            "        out[:] = [c for uv in self for c in uv]\n"
+            "    def foreach_set(self, key, values):\n"
+            "        self[:] = [tuple(values[i:i + 2]) for i in range(0, len(values), 2)]\n"
+            "class _Layers(list):\n"
+            "    active = None\n"
+            "def _mesh(name, layers, materials):\n"
+            "    uv_layers = _Layers()\n"
+            "    for render, uvs in layers:\n"
+            "        uv_layers.append(types.SimpleNamespace(active_render=render, data=_Data(uvs)))\n"
+            "    mesh = types.SimpleNamespace(name=name, library=None, uv_layers=uv_layers, materials=list(materials))\n"
+            "    return types.SimpleNamespace(name=name, type='MESH', data=mesh, material_slots=list(materials))\n"
+            "_objects = [\n"
+            "    _mesh('Rock', [(False, [(0.25, 0.5)]), (True, [(0.0, 1.0)])], ['Stone']),\n"
+            "    _mesh('Tiled', [(True, [(0.5, 2.0)])], ['Floor']),\n"
+            "    _mesh('Layered', [(True, [(0.5, 0.5)])], ['Bark', 'Leaves'])]\n"
+            "class _Load:\n"
+            "    def __init__(self, path, link=False):\n"
+            "        pass\n"
+            "    def __enter__(self):\n"
+            "        props = types.SimpleNamespace(objects=_objects)\n"
+            "        return types.SimpleNamespace(collections=[props], objects=[]), types.SimpleNamespace(collections=[], objects=[])\n"
+            "    def __exit__(self, *args):\n"
+            "        return False\n"
+            "def _dump():\n"
+            "    with open(os.path.join(os.path.dirname(__file__), 'uvs.txt'), 'w') as f:\n"
+            "        for o in _objects:\n"
+            "            layers = ' '.join('%g,%g' % o.data.uv_layers[i].data[0] for i in range(len(o.data.uv_layers)))\n"
+            "            f.write('%s %s %s\\n' % (o.name, layers, '+'.join(o.data.materials)))\n"
+            "atexit.register(_dump)\n"
+            "_link = types.SimpleNamespace(link=lambda *a: None)\n"
+            "context = types.SimpleNamespace(scene=types.SimpleNamespace(collection=types.SimpleNamespace(objects=_link, children=_link)))\n"
+            "data = types.SimpleNamespace(images=[], materials={'Atlas': 'Atlas'}, libraries=types.SimpleNamespace(load=_Load))\n"
+            "path = types.SimpleNamespace(abspath=lambda p, library=None: p)\n";
+        
+        const char* old_path = std::getenv("PATH");
+        std::string saved_path = old_path ? old_path : "";
+        setenv("PATH", (std::filesystem::absolute("atlas_stub").string() + ":" + saved_path).c_str(), 1);
+        AssetManager::ImportOptions options;
+        AssetManager::AtlasRemap remap;
+        remap.material_name = "Atlas";
+        remap.u_scale = 0.5f;
+        remap.v_scale = 0.25f;
+        remap.u_offset = 0.5f;
+        remap.v_offset = 0.0f;
+        options.atlas_remaps[std::filesystem::absolute("atlas_stub/props.blend").lexically_normal().string()] = remap;
+        AssetManager::ImportManager manager;
+        AssetManager::ImportResult result = manager.importAsset("atlas_stub/props.blend", options);
+        setenv("PATH", saved_path.c_str(), 1);
+        
+        std::ifstream dump("atlas_stub/uvs.txt");
+        std::string rock, tiled, layered;
+        std::getline(dump, rock);
+        std::getline(dump, tiled);
+        std::getline(dump, layered);
+        bool valid = result.success;
+        valid &= rock == "Rock 0.25,0.5 0.5,0.25 Atlas";
+        valid &= tiled == "Tiled 0.5,2 Floor";
+        valid &= layered == "Layered 0.5,0.5 Bark+Leaves";
+        auto list = [&result](const char* key) {
+            auto it = result.metadata.find(key);
+            return it == result.metadata.end() ? std::vector<std::string>()
+                                               : std::any_cast<std::vector<std::string>>(it->second);
+        };
+        valid &= list("atlas_remapped_objects") == std::vector<std::string>{"Rock"};
+        valid &= list("atlas_skipped_objects") == std::vector<std::string>{"Tiled", "Layered"};
+        
+        std::filesystem::remove_all("atlas_stub");
+        return valid;
+    });
+    
+    // Test 38: Default closure follows the OBJ's mtllib statements rather than its file name
+    runner.runTest("Default Closure Follows mtllib", []() -> bool {
+        std::filesystem::create_directories("mtllib_closure_test/shared");
+        std::ofstream("mtllib_closure_test/ship.obj") << "mtllib shared/hull.mtl trim.mtl\nv 0 0 0\n";
+        std::ofstream("mtllib_closure_test/ship.mtl") << "newmtl unused\nmap_Kd unused.png\n";
+        std::ofstream("mtllib_closure_test/shared/hull.mtl") << "newmtl hull\nmap_Kd hull_albedo.png\n";
+        std::ofstream("mtllib_closure_test/shared/hull_albedo.png") << "png";
+        std::ofstream("mtllib_closure_test/trim.mtl") << "newmtl trim\nnorm trim_normal.png\n";
+        std::ofstream("mtllib_closure_test/trim_normal.png") << "png";
+        std::ofstream("mtllib_closure_test/unused.png") << "png";
+        
+        auto closure = AssetManager::DependencyPrefetcher::defaultClosure("mtllib_closure_test/ship.obj");
+        std::vector<std::string> names;
+        for (const auto& file : closure) {
+            names.push_back(std::filesystem::path(file).filename().string());
+        }
+        
+        std::filesystem::remove_all("mtllib_closure_test");
+        return names == std::vector<std::string>{"ship.obj", "hull.mtl", "hull_albedo.png", "trim.mtl", "trim_normal.png"};
+    });
+    
+    // Test 39: Closure reads only the OBJ header and keeps texture names that contain spaces
+    runner.runTest("Default Closure Reads Header And Spaced Names", []() -> bool {
+        std::filesystem::create_directories("mtllib_header_test");
+        std::ofstream("mtllib_header_test/crate.obj") << "# crate\nmtllib crate.mtl\nv 0 0 0\nmtllib late.mtl\nf 1 1 1\n";
+        std::ofstream("mtllib_header_test/crate.mtl") << "newmtl crate\nmap_Kd -s 1 1 1 crate albedo.png # wood\r\n";
+        std::ofstream("mtllib_header_test/crate albedo.png") << "png";
+        std::ofstream("mtllib_header_test/late.mtl") << "newmtl late\n";
+        
+        auto closure = AssetManager::DependencyPrefetcher::defaultClosure("mtllib_header_test/crate.obj");
+        std::vector<std::string> names;
+        for (const auto& file : closure) {
+            names.push_back(std::filesystem::path(file).filename().string());
+        }
+        
+        std::filesystem::remove_all("mtllib_header_test");
+        return names == std::vector<std::string>{"crate.obj", "crate.mtl", "crate albedo.png"};
+    });
+    
+    // Test 40: Imports saved into a scene read the source file, never the hot-cache copy
+    runner.runTest("Scene Import Bypasses Hot Cache", []() -> bool {
+        std::filesystem::create_directories("hot_scene_test/stub");
+        std::ofstream("hot_scene_test/chair.obj") << "mtllib chair.mtl\nv 0 0 0\n";
+        std::ofstream("hot_scene_test/chair.mtl") << "newmtl chair\nmap_Kd chair_albedo.png\n";
+        std::ofstream("hot_scene_test/chair_albedo.png") << "png";
+        std::string read_log = std::filesystem::absolute("hot_scene_test/read.txt").string();
+        std::ofstream("hot_scene_test/stub/blender") << "#!/bin/sh\necho \"$6\" >> '" << read_log << "'\necho SUCCESS\n";
+        std::filesystem::permissions("hot_scene_test/stub/blender", std::filesystem::perms::owner_all);
+        
+        bool valid = true;
+        {
+            auto cache = std::make_shared<AssetManager::HotAssetCache>("hot_scene_test/cache", 1 << 20);
+            valid &= cache->admit("hot_scene_test/chair.obj");
+            AssetManager::ImportManager manager;
+            manager.setHotAssetCache(cache);
+            AssetManager::ImportOptions options;
+            
+            const char* old_path = std::getenv("PATH");
+            std::string saved_path = old_path ? old_path : "";
+            setenv("PATH", (std::filesystem::absolute("hot_scene_test/stub").string() + ":" + saved_path).c_str(), 1);
+            AssetManager::ImportResult discarded = manager.importAsset("hot_scene_test/chair.obj", options);
+            options.scene_file = "hot_scene_test/scene.blend";
+            AssetManager::ImportResult saved = manager.importAsset("hot_scene_test/chair.obj", options);
+            setenv("PATH", saved_path.c_str(), 1);
+            
+            std::ifstream log_in(read_log);
+            std::string first, second;
+            std::getline(log_in, first);
+            std::getline(log_in, second);
+            valid &= discarded.success && std::any_cast<bool>(discarded.metadata.at("hot_cache_hit"));
+            valid &= first.find("hot_scene_test/cache") != std::string::npos;
+            valid &= saved.success && !std::any_cast<bool>(saved.metadata.at("hot_cache_hit"));
+            valid &= second == "hot_scene_test/chair.obj";
+        }
+        std::filesystem::remove_all("hot_scene_test");
+        return valid;
+    });
+    
     runner.printSummary();
     
     return runner.getFailedCount() == 0 ? 0 : 1;
@@ -0,0 +1,364 @@
+/**
+ * @file test_ingest_pipeline.cpp
+ * @author KleaSCM
+ * @email KleaSCM@gmail.com
+ * @brief Unit tests for the IngestPipeline job-graph executor using simple test harness
+ *
+ * Tests stage ordering, failure propagation, overlap between stages,
+ * bounded-queue backpressure and per-stage metrics. Stage functions are
+ * replaced with stubs so the tests do not require Blender.
+ */
+
+#include "test_harness.hpp"
+#include "../include/ingest_pipeline.hpp"
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <fstream>
+#include <filesystem>
+#include <cstdlib>
+#include <set>
+
+using namespace TestHarness;
+using AssetManager::IngestJob;
+using AssetManager::IngestPipeline;
+using AssetManager::IngestStage;
+using AssetManager::StageConfig;
+
+static void installPassThroughStages(IngestPipeline& pipeline) {
+    for (IngestStage stage : IngestPipeline::stageOrder()) {
+        pipeline.setStageFunction(stage, [](IngestJob&) { return true; });
+    }
+}
+
+static AssetManager::StageMetrics metricsFor(const IngestPipeline& pipeline, const std::string& name) {
+    for (const auto& metrics : pipeline.getStageMetrics()) {
+        if (metrics.name == name) return metrics;
+    }
+    return {};
+}
+
+static std::vector<std::string> makePaths(size_t count) {
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < count; ++i) {
+        paths.push_back("asset_" + std::to_string(i) + ".obj");
+    }
+    return paths;
+}
+
+int main() {
+    TestRunner runner;
+
+    runner.beginSuite("IngestPipeline Tests");
+
+    // Test 1: Results come back in input order even with parallel stages
+    runner.runTest("Results In Input Order", []() -> bool {
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        pipeline.setStageConfig(IngestStage::Import, StageConfig{4, 2});
+        pipeline.setStageFunction(IngestStage::Import, [](IngestJob& job) {
+            std::this_thread::sleep_for(std::chrono::milliseconds((job.sequence * 7) % 5));
+            job.import_result.success = true;
+            return true;
+        });
+
+        auto paths = makePaths(20);
+        auto jobs = pipeline.run(paths);
+
+        if (jobs.size() != paths.size()) return false;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (jobs[i].sequence != i || jobs[i].asset_path != paths[i] || jobs[i].failed) return false;
+        }
+        return true;
+    });
+
+    // Test 2: Validation failure skips every later stage
+    runner.runTest("Validation Failure Skips Later Stages", []() -> bool {
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        std::atomic<int> imports{0};
+        std::atomic<int> history{0};
+        pipeline.setStageFunction(IngestStage::Validate, [](IngestJob& job) {
+            if (job.sequence % 2 == 1) {
+                job.message = "bad asset";
+                return false;
+            }
+            return true;
+        });
+        pipeline.setStageFunction(IngestStage::Import, [&imports](IngestJob&) { ++imports; return true; });
+        pipeline.setStageFunction(IngestStage::History, [&history](IngestJob&) { ++history; return true; });
+
+        auto jobs = pipeline.run(makePaths(10));
+
+        bool valid = imports == 5 && history == 5;
+        valid &= jobs[1].failed && jobs[1].failed_stage == "validate" && jobs[1].message == "bad asset";
+        valid &= !jobs[0].failed;
+        return valid;
+    });
+
+    // Test 3: Failed imports are still recorded by the history stage
+    runner.runTest("Failed Import Reaches History", []() -> bool {
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        std::atomic<int> materials{0};
+        std::atomic<int> history{0};
+        pipeline.setStageFunction(IngestStage::Import, [](IngestJob& job) {
+            job.import_result.success = false;
+            return false;
+        });
+        pipeline.setStageFunction(IngestStage::Materials, [&materials](IngestJob&) { ++materials; return true; });
+        pipeline.setStageFunction(IngestStage::History, [&history](IngestJob&) { ++history; return true; });
+
+        auto jobs = pipeline.run(makePaths(3));
+
+        return materials == 0 && history == 3 && jobs[2].failed_stage == "import";
+    });
+
+    // Test 4: Validation of later items overlaps with imports of earlier ones
+    runner.runTest("Stages Overlap", []() -> bool {
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        std::atomic<bool> import_running{false};
+        std::atomic<int> validated_during_import{0};
+        pipeline.setStageFunction(IngestStage::Validate, [&](IngestJob&) {
+            if (import_running) ++validated_during_import;
+            return true;
+        });
+        pipeline.setStageFunction(IngestStage::Import, [&](IngestJob&) {
+            import_running = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            import_running = false;
+            return true;
+        });
+
+        pipeline.run(makePaths(6));
+
+        return validated_during_import > 0;
+    });
+
+    // Test 5: A slow stage throttles upstream producers through its bounded queue
+    runner.runTest("Bounded Queue Backpressure", []() -> bool {
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        pipeline.setStageConfig(IngestStage::Import, StageConfig{1, 1});
+        pipeline.setStageFunction(IngestStage::Import, [](IngestJob&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            return true;
+        });
+
+        pipeline.run(makePaths(8));
+
+        // convert feeds the import queue, so it is the stage that gets throttled
+        bool valid = pipeline.getStageMetrics().size() == IngestPipeline::stageOrder().size();
+        valid &= metricsFor(pipeline, "import").queue_high_water <= 1;
+        valid &= metricsFor(pipeline, "convert").backpressure_seconds > 0.0;
+        return valid;
+    });
+
+    // Test 6: Per-stage metrics count processed, failed and skipped jobs
+    runner.runTest("Stage Metrics", []() -> bool {
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        pipeline.setStageFunction(IngestStage::Convert, [](IngestJob& job) { return job.sequence != 0; });
+
+        pipeline.run(makePaths(5));
+        auto validate = metricsFor(pipeline, "validate");
+        auto convert = metricsFor(pipeline, "convert");
+        auto import = metricsFor(pipeline, "import");
+
+        bool valid = validate.processed == 5 && validate.failed == 0;
+        valid &= convert.processed == 5 && convert.failed == 1;
+        valid &= import.processed == 4 && import.skipped == 1;
+        valid &= validate.throughput_per_second >= 0.0;
+        return valid;
+    });
+
+    // Test 7: Default validate stage rejects missing files before import
+    runner.runTest("Default Validation Rejects Missing File", []() -> bool {
+        IngestPipeline pipeline;
+        auto jobs = pipeline.run({"definitely_missing_asset.obj"});
+        return jobs.size() == 1 && jobs[0].failed && jobs[0].failed_stage == "validate";
+    });
+
+    // Test 8: Default prefetch stage warms each asset's closure
+    runner.runTest("Prefetch Stage Queues Readahead", []() -> bool {
+        std::filesystem::create_directories("pipeline_prefetch_test");
+        std::ofstream("pipeline_prefetch_test/crate.obj") << "mtllib crate.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+        std::ofstream("pipeline_prefetch_test/crate.mtl") << "newmtl crate\nmap_Kd crate_albedo.png\n";
+        std::ofstream("pipeline_prefetch_test/crate_albedo.png") << "png";
+
+        auto prefetcher = std::make_shared<AssetManager::DependencyPrefetcher>(2);
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        pipeline.setPrefetcher(prefetcher);
+        pipeline.setStageFunction(IngestStage::Prefetch, nullptr);   // back to the default stage
+
+        pipeline.run({"pipeline_prefetch_test/crate.obj"});
+        prefetcher->waitIdle();
+        auto stats = prefetcher->getStats();
+
+        std::filesystem::remove_all("pipeline_prefetch_test");
+        return stats.assets_enqueued == 1 && stats.files_advised == 3 && stats.failures == 0;
+    });
+
+    // Test 9: Empty batch
+    runner.runTest("Empty Batch", []() -> bool {
+        IngestPipeline pipeline;
+        auto jobs = pipeline.run({});
+        return jobs.empty() && pipeline.getStageMetrics().size() == IngestPipeline::stageOrder().size();
+    });
+
+    // Test 10: The default validate stage runs on several workers against one shared validator
+    runner.runTest("Default Validation Runs Concurrently", []() -> bool {
+        std::filesystem::create_directories("pipeline_validate_test");
+        std::vector<std::string> paths;
+        for (int i = 0; i < 16; ++i) {
+            std::string path = "pipeline_validate_test/part_" + std::to_string(i) + ".obj";
+            if (i % 4 != 3) {
+                std::ofstream(path) << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+            }
+            paths.push_back(path);
+        }
+
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        pipeline.setStageFunction(IngestStage::Validate, nullptr);   // back to the default stage
+        pipeline.setStageConfig(IngestStage::Validate, StageConfig{4, 8});
+        auto jobs = pipeline.run(paths);
+
+        bool valid = jobs.size() == paths.size() && metricsFor(pipeline, "validate").concurrency == 4;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            bool missing = i % 4 == 3;
+            valid &= jobs[i].failed == missing && (!missing || jobs[i].failed_stage == "validate");
+        }
+        std::filesystem::remove_all("pipeline_validate_test");
+        return valid;
+    });
+
+    // Test 11: Assets warmed by the prefetch stage are not queued again by the import stage
+    runner.runTest("Import Stage Does Not Re-Queue Prefetch", []() -> bool {
+        std::filesystem::create_directories("pipeline_import_test/stub");
+        std::ofstream("pipeline_import_test/crate.obj") << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+        std::ofstream("pipeline_import_test/stub/blender") << "#!/bin/sh\nexit 0\n";
+        std::filesystem::permissions("pipeline_import_test/stub/blender", std::filesystem::perms::owner_all);
+
+        auto prefetcher = std::make_shared<AssetManager::DependencyPrefetcher>(2);
+        auto import_manager = std::make_shared<AssetManager::ImportManager>();
+        import_manager->setPrefetcher(prefetcher);
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        pipeline.setPrefetcher(prefetcher);
+        pipeline.setImportManager(import_manager);
+        pipeline.setStageFunction(IngestStage::Prefetch, nullptr);
+        pipeline.setStageFunction(IngestStage::Import, nullptr);
+
+        const char* old_path = std::getenv("PATH");
+        std::string saved_path = old_path ? old_path : "";
+        setenv("PATH", (std::filesystem::absolute("pipeline_import_test/stub").string() + ":" + saved_path).c_str(), 1);
+        pipeline.run({"pipeline_import_test/crate.obj"});
+        setenv("PATH", saved_path.c_str(), 1);
+        prefetcher->waitIdle();
+
+        bool valid = prefetcher->getStats().assets_enqueued == 1;
+        std::filesystem::remove_all("pipeline_import_test");
+        return valid;
+    });
+
+    // Test 12: An import recorded by the history stage can be undone against its target scene
+    runner.runTest("Ingested Import Can Be Undone", []() -> bool {
+        std::filesystem::remove_all("pipeline_undo_test");
+        std::filesystem::create_directories("pipeline_undo_test/stub");
+        std::ofstream("pipeline_undo_test/crate.obj") << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+        std::ofstream("pipeline_undo_test/scene.blend") << "BLENDER";
+        std::string scripts = std::filesystem::absolute("pipeline_undo_test").string();
+        // Keeps each script it is given and reports one imported object
+        std::ofstream("pipeline_undo_test/stub/blender")
+            << "#!/bin/sh\nn=$(ls '" << scripts << "' | grep -c '^script_')\n"
+            << "cp \"$4\" '" << scripts << "/script_'$n'.py'\necho \"IMPORTED: ['Crate']\"\necho SUCCESS\n";
+        std::filesystem::permissions("pipeline_undo_test/stub/blender", std::filesystem::perms::owner_all);
+
+        auto history = std::make_shared<AssetManager::ImportHistory>();
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        pipeline.setImportManager(std::make_shared<AssetManager::ImportManager>());
+        pipeline.setImportHistory(history);
+        pipeline.setStageFunction(IngestStage::Import, nullptr);
+        pipeline.setStageFunction(IngestStage::History, nullptr);
+        AssetManager::ImportOptions options;
+        options.scene_file = "pipeline_undo_test/scene.blend";
+
+        const char* old_path = std::getenv("PATH");
+        std::string saved_path = old_path ? old_path : "";
+        setenv("PATH", (std::filesystem::absolute("pipeline_undo_test/stub").string() + ":" + saved_path).c_str(), 1);
+        auto jobs = pipeline.run({"pipeline_undo_test/crate.obj"}, options);
+        AssetManager::UndoResult undo = history->undoLastImport();
+        setenv("PATH", saved_path.c_str(), 1);
+
+        std::ifstream import_in("pipeline_undo_test/script_0.py");
+        std::string import_script((std::istreambuf_iterator<char>(import_in)), std::istreambuf_iterator<char>());
+        std::ifstream undo_in("pipeline_undo_test/script_1.py");
+        std::string undo_script((std::istreambuf_iterator<char>(undo_in)), std::istreambuf_iterator<char>());
+        std::string scene = std::filesystem::absolute("pipeline_undo_test/scene.blend").lexically_normal().string();
+
+        bool valid = jobs.size() == 1 && !jobs[0].failed && jobs[0].import_result.scene_file == scene;
+        valid &= import_script.find("save_as_mainfile") != std::string::npos;
+        valid &= undo.success && undo.removed_objects == std::vector<std::string>{"Crate"} && history->isEmpty();
+        valid &= undo_script.find(scene) != std::string::npos && undo_script.find("\"Crate\"") != std::string::npos;
+        std::filesystem::remove_all("pipeline_undo_test");
+        return valid;
+    });
+
+    // Test 13: Concurrent Import workers targeting one scene keep every object in the saved file
+    runner.runTest("Concurrent Imports Into One Scene Keep Every Object", []() -> bool {
+        std::filesystem::remove_all("pipeline_scene_test");
+        std::filesystem::create_directories("pipeline_scene_test/stub");
+        std::vector<std::string> assets;
+        for (const std::string name : {"crate", "barrel", "lamp", "table"}) {
+            std::ofstream("pipeline_scene_test/" + name + ".obj") << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+            assets.push_back("pipeline_scene_test/" + name + ".obj");
+        }
+        std::ofstream("pipeline_scene_test/scene.blend");
+        std::string scene = std::filesystem::absolute("pipeline_scene_test/scene.blend").string();
+        // Opens the scene, adds its object and saves; overlapping runs would drop each other's object
+        std::ofstream("pipeline_scene_test/stub/blender")
+            << "#!/bin/sh\nname=$(basename \"$6\" .obj)\ncp '" << scene << "' '" << scene << "'.$$\nsleep 0.2\n"
+            << "echo $name >> '" << scene << "'.$$\nmv '" << scene << "'.$$ '" << scene << "'\n"
+            << "echo \"IMPORTED: ['$name']\"\necho SUCCESS\n";
+        std::filesystem::permissions("pipeline_scene_test/stub/blender", std::filesystem::perms::owner_all);
+
+        IngestPipeline pipeline;
+        installPassThroughStages(pipeline);
+        pipeline.setImportManager(std::make_shared<AssetManager::ImportManager>());
+        pipeline.setStageFunction(IngestStage::Import, nullptr);
+        StageConfig config;
+        config.concurrency = 2;
+        pipeline.setStageConfig(IngestStage::Import, config);
+        AssetManager::ImportOptions options;
+        options.scene_file = "pipeline_scene_test/scene.blend";
+
+        const char* old_path = std::getenv("PATH");
+        std::string saved_path = old_path ? old_path : "";
+        setenv("PATH", (std::filesystem::absolute("pipeline_scene_test/stub").string() + ":" + saved_path).c_str(), 1);
+        auto jobs = pipeline.run(assets, options);
+        setenv("PATH", saved_path.c_str(), 1);
+
+        std::set<std::string> saved;
+        std::ifstream scene_in(scene);
+        for (std::string line; std::getline(scene_in, line);) {
+            saved.insert(line);
+        }
+        bool valid = jobs.size() == 4;
+        for (const auto& job : jobs) {
+            valid &= !job.failed && job.import_result.success;
+        }
+        valid &= saved == std::set<std::string>({"barrel", "crate", "lamp", "table"});
+        std::filesystem::remove_all("pipeline_scene_test");
+        return valid;
+    });
+
+    runner.printSummary();
+
+    return runner.getFailedCount() == 0 ? 0 : 1;
+}
@@ -11,8 +11,15 @@
 #include "test_harness.hpp"
 #include "../include/material_manager.hpp"
 #include "../include/asset_manager.hpp"
+#include "../include/texture_processor.hpp"
+#include "../include/file_probe.hpp"
 #include <iostream>
 #include <memory>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <cmath>
+#include <cstdlib>
 
 using namespace TestHarness;
 
@@ -171,6 +178,571 @@ int main() {
         return valid;
     });
     
+    // Test 13: Batch material creation
+    runner.runTest("Create Materials Batch", []() -> bool {
+        AssetManager::MaterialManager manager;
+        
+        AssetManager::MaterialSpec unnamed;
+        AssetManager::MaterialSpec missing_texture;
+        missing_texture.options.name = "BatchMissing";
+        missing_texture.textures.push_back({"does/not/exist_albedo.png", "albedo"});
+        AssetManager::MaterialSpec plain;
+        plain.options.name = "BatchPlain";
+        
+        auto results = manager.createMaterials({unnamed, missing_texture, plain});
+        bool valid = results.size() == 3;
+        valid &= !results[0].success && results[0].message.find("empty") != std::string::npos;
+        valid &= !results[1].success && results[1].message.find("Invalid texture path") != std::string::npos;
+        valid &= results[2].material_name == "BatchPlain";
+        valid &= manager.createMaterials({}).empty();
+        
+        return valid;
+    });
+    
+    // Test 14: Texture sets grouped in one pass
+    runner.runTest("Texture Set Index Grouping", []() -> bool {
+        AssetManager::TextureSetIndex index;
+        index.build({
+            "lib/rock/Rock-Albedo_2K.png", "lib/rock/rock_albedo_4k.png", "lib/rock/ROCK_nrm.png",
+            "lib/rock/rock_Roughness.jpg", "lib/rock/rock_rough_mask.png",
+            "lib/hero/body_basecolor.1001.exr", "lib/hero/body_basecolor.1002.exr", "lib/hero/body_normal_1001.exr",
+            "lib/hero/eyes_diffuse.png", "lib/hero/readme.png"
+        });
+        
+        bool valid = index.size() == 3;
+        const AssetManager::TextureSet* rock = index.findForAsset("lib/rock/Rock.fbx");
+        valid &= rock && rock->channels.size() == 3;
+        valid &= rock && rock->channels.at("base_color").path == "lib/rock/rock_albedo_4k.png";
+        valid &= rock && rock->channels.at("base_color").resolutions.size() == 2;
+        valid &= rock && rock->channels.at("normal").path == "lib/rock/ROCK_nrm.png";
+        valid &= rock && rock->channels.at("roughness").path == "lib/rock/rock_Roughness.jpg";
+        
+        const AssetManager::TextureSet* body = index.find("lib/hero", "Body");
+        valid &= body && body->channels.at("base_color").path == "lib/hero/body_basecolor.1001.exr";
+        valid &= body && body->channels.at("base_color").udim_pattern == "lib/hero/body_basecolor.<UDIM>.exr";
+        valid &= body && body->channels.at("base_color").udim_tiles == std::vector<int>({1001, 1002});
+        valid &= body && body->channels.at("normal").path == "lib/hero/body_normal_1001.exr";
+        valid &= body && body->channels.at("normal").udim_pattern == "lib/hero/body_normal_<UDIM>.exr";
+        
+        // Several sets in one directory: only an exact name match resolves
+        valid &= index.findForAsset("lib/hero/eyes.obj") != nullptr;
+        valid &= index.findForAsset("lib/hero/prop.obj") == nullptr;
+        return valid;
+    });
+    
+    // Test 15: Texture discovery probes headers and caches by directory summary
+    runner.runTest("Texture Discovery Probe And Cache", []() -> bool {
+        std::filesystem::remove_all("texture_discovery_test");
+        std::filesystem::create_directories("texture_discovery_test/sub");
+        auto write = [](const std::string& path, const std::string& bytes) {
+            std::ofstream(path, std::ios::binary) << bytes;
+        };
+        // PNG: signature + IHDR (64x32, 8-bit RGBA)
+        write("texture_discovery_test/wall_albedo.png",
+              std::string("\x89PNG\r\n\x1a\n\0\0\0\x0dIHDR\0\0\0\x40\0\0\0\x20\x08\x06\0\0\0", 29));
+        // JPEG: SOI, APP0 segment, SOF0 (height 16, width 48, 3 components)
+        write("texture_discovery_test/sub/wall_rough.jpg",
+              std::string("\xff\xd8\xff\xe0\0\x04" "ab" "\xff\xc0\0\x11\x08\0\x10\0\x30\x03", 19));
+        write("texture_discovery_test/notes.txt", "not a texture");
+        
+        AssetManager::MaterialManager manager;
+        auto textures = manager.discoverTextures("texture_discovery_test");
+        bool valid = textures.size() == 2;
+        valid &= textures.size() == 2 && textures[0].width == 48 && textures[0].height == 16 && textures[0].channels == 3;
+        valid &= textures.size() == 2 && textures[1].width == 64 && textures[1].height == 32 && textures[1].channels == 4;
+        valid &= manager.getTextureDiscoveryStats().files_probed == 2;
+        
+        // Unchanged: answered from the directory cache
+        valid &= manager.discoverTextures("texture_discovery_test").size() == 2;
+        valid &= manager.getTextureDiscoveryStats().directory_cache_hits == 1;
+        
+        // One new file: only it is probed
+        write("texture_discovery_test/wall_nrm.bmp",
+              std::string("BM") + std::string(16, '\0') + std::string("\x08\0\0\0\x04\0\0\0\0\0\x18\0", 12));
+        valid &= manager.discoverTextures("texture_discovery_test").size() == 3;
+        auto stats = manager.getTextureDiscoveryStats();
+        valid &= stats.files_probed == 3 && stats.files_reused == 2 && stats.decoder_fallbacks == 0;
+        
+        std::filesystem::remove_all("texture_discovery_test");
+        return valid;
+    });
+
+    // Test 16: Texture variants, mip chains, EXR round trip and ORM packing
+    runner.runTest("Texture Processor Variants And ORM", []() -> bool {
+        using AssetManager::TextureProcessor;
+        std::filesystem::remove_all("texture_processor_test");
+        std::filesystem::create_directories("texture_processor_test/lib");
+        // 64x32 RLE TGA, 24-bit: 16 run packets of 128 pixels, B=16 G=32 R=200
+        std::string tga("\0\0\x0a\0\0\0\0\0\0\0\0\0\x40\0\x20\0\x18\0", 18);
+        for (int i = 0; i < 16; ++i) {
+            tga += std::string("\xff\x10\x20\xc8", 4);
+        }
+        std::ofstream("texture_processor_test/lib/rock_ao.tga", std::ios::binary) << tga;
+
+        std::string error;
+        AssetManager::ImageBuffer rough;
+        rough.width = 32;
+        rough.height = 16;
+        rough.channels = 1;
+        rough.bytes.assign(rough.sampleCount(), 50);
+        bool valid = TextureProcessor::encode("texture_processor_test/lib/rock_rough.png", rough, error);
+
+        AssetManager::ImageBuffer hdr, decoded;
+        hdr.width = 5;
+        hdr.height = 19;
+        hdr.channels = 4;
+        hdr.is_float = true;
+        for (size_t i = 0; i < hdr.sampleCount(); ++i) {
+            hdr.floats.push_back(static_cast<float>(i % 7) * 0.25f);
+        }
+        valid &= TextureProcessor::encode("texture_processor_test/sky.exr", hdr, error);
+        valid &= TextureProcessor::decode("texture_processor_test/sky.exr", decoded, error);
+        valid &= decoded.is_float && decoded.channels == 4 && decoded.floats == hdr.floats;
+        valid &= TextureProcessor::decode("texture_processor_test/lib/rock_ao.tga", decoded, error);
+        valid &= decoded.width == 64 && decoded.channels == 3 && decoded.bytes[0] == 200 && decoded.bytes[2] == 16;
+
+        // 64x32 source: 32x16 and 16x8 variants plus mips 32x16 ... 1x1
+        AssetManager::TextureVariantOptions options;
+        options.cache_root = "texture_processor_test/cache";
+        options.max_sizes = {16, 32, 64};
+        options.mip_chain = true;
+        options.threads = 2;
+        std::vector<std::string> sources = {"texture_processor_test/lib/rock_ao.tga", "texture_processor_test/lib/rock_rough.png"};
+        auto results = TextureProcessor(options).generateVariants(sources);
+        valid &= results.size() == 2 && results[0].success && results[0].variants.size() == 8;
+        valid &= results[0].variants.size() == 8 && results[0].variants[1].width == 16 && results[0].variants[1].height == 8;
+        valid &= results[0].variants.size() == 8 && results[0].variants.back().kind == "mip" && results[0].variants.back().width == 1;
+        valid &= results.size() == 2 && results[1].success && results[1].variants.size() == 6;
+        valid &= results[0].variants.size() == 8 && TextureProcessor::decode(results[0].variants[1].path, decoded, error);
+        valid &= decoded.width == 16 && decoded.bytes[0] == 200 && decoded.bytes[1] == 32 && decoded.bytes[47] == 16;
+
+        // Unchanged sources are answered from the manifest
+        auto cached = TextureProcessor(options).generateVariants(sources);
+        valid &= cached.size() == 2 && cached[0].from_cache && cached[1].from_cache && cached[0].variants.size() == 8;
+
+        // ORM packing through the index, linked back to the source channels
+        AssetManager::AssetManager manager;
+        valid &= manager.initialize("texture_processor_test/lib") && manager.scan_assets(true);
+        auto packed = manager.pack_orm_textures(options);
+        valid &= packed.size() == 1 && packed[0].success && packed[0].variants.size() == 1;
+        valid &= !packed.empty() && TextureProcessor::decode(packed[0].variants[0].path, decoded, error);
+        valid &= decoded.width == 64 && decoded.height == 32 && decoded.channels == 3;
+        valid &= decoded.bytes[0] == 200 && decoded.bytes[1] == 50 && decoded.bytes[2] == 0;
+        auto ao = manager.get_asset_by_path("rock_ao.tga");
+        valid &= ao && ao->metadata.count("orm_texture") == 1;
+
+        std::filesystem::remove_all("texture_processor_test");
+        return valid;
+    });
+
+    // Test 17: Texture sets of a scatter group baked into one atlas page with UV remaps
+    runner.runTest("Texture Atlas Bakes Texture Sets", []() -> bool {
+        using AssetManager::TextureProcessor;
+        std::filesystem::remove_all("texture_atlas_test");
+        std::filesystem::create_directories("texture_atlas_test/lib/rock");
+        std::filesystem::create_directories("texture_atlas_test/lib/leaf");
+        std::filesystem::create_directories("texture_atlas_test/lib/stray");
+        auto solid = [](const std::string& path, int width, int height, std::vector<uint8_t> texel) {
+            AssetManager::ImageBuffer image;
+            image.width = width;
+            image.height = height;
+            image.channels = static_cast<int>(texel.size());
+            for (int i = 0; i < width * height; ++i) {
+                image.bytes.insert(image.bytes.end(), texel.begin(), texel.end());
+            }
+            std::string error;
+            return TextureProcessor::encode(path, image, error);
+        };
+        bool valid = solid("texture_atlas_test/lib/rock/rock_albedo.png", 48, 24, {200, 10, 10});
+        valid &= solid("texture_atlas_test/lib/leaf/leaf_albedo.png", 32, 32, {10, 200, 10, 128});
+        valid &= solid("texture_atlas_test/lib/leaf/leaf_rough.png", 32, 32, {40});
+        for (const char* model : {"rock/rock.obj", "rock/rock_small.obj", "leaf/leaf.obj", "stray/stray.obj"}) {
+            std::ofstream(std::string("texture_atlas_test/lib/") + model) << "v 0 0 0\n";
+        }
+
+        AssetManager::AssetManager manager;
+        valid &= manager.initialize("texture_atlas_test/lib") && manager.scan_assets(true);
+        AssetManager::TextureAtlasOptions options;
+        options.cache_root = "texture_atlas_test/cache";
+        options.name = "props";
+        options.page_size = 128;
+        options.padding = 2;
+        options.mip_levels = 2;     // 4-texel blocks: padding rounds up to 4
+        auto result = manager.build_texture_atlas({"texture_atlas_test/lib/rock/rock.obj", "texture_atlas_test/lib/rock/rock_small.obj",
+                                                   "texture_atlas_test/lib/leaf/leaf.obj", "texture_atlas_test/lib/stray/stray.obj"}, options);
+        valid &= result.success && result.pages.size() == 1 && result.placements.size() == 2;
+        valid &= result.source_materials == 2 && result.source_textures == 3;
+        valid &= result.message.find("1 assets without") != std::string::npos;
+        if (!valid) {
+            std::filesystem::remove_all("texture_atlas_test");
+            return false;
+        }
+
+        const auto& page = result.pages[0];
+        const auto& rock = result.placements[0];
+        const auto& leaf = result.placements[1];
+        valid &= rock.width == 48 && rock.height == 24 && rock.x % 4 == 0 && rock.y % 4 == 0;
+        valid &= page.width <= 128 && page.height <= 128 && std::filesystem::exists(result.table_path);
+        AssetManager::ImageBuffer color, normal, orm;
+        std::string error;
+        valid &= TextureProcessor::decode(page.textures.at("base_color"), color, error) && color.channels == 4;
+        valid &= TextureProcessor::decode(page.textures.at("normal"), normal, error);
+        valid &= TextureProcessor::decode(page.textures.at("orm"), orm, error);
+        valid &= color.width == page.width && normal.width == page.width && orm.width == page.width;
+        if (!valid) {
+            std::filesystem::remove_all("texture_atlas_test");
+            return false;
+        }
+        auto texel = [](const AssetManager::ImageBuffer& image, int x, int y) {
+            return &image.bytes[(static_cast<size_t>(y) * image.width + x) * image.channels];
+        };
+        // Item texels, the gutter just outside the rock, neutral normal and packed ORM
+        const uint8_t* rock_color = texel(color, rock.x + 5, rock.y + 5);
+        const uint8_t* rock_gutter = texel(color, rock.x - 3, rock.y + 5);
+        const uint8_t* leaf_color = texel(color, leaf.x + 5, leaf.y + 5);
+        valid &= rock_color[0] == 200 && rock_color[1] == 10 && rock_color[3] == 255;
+        valid &= rock_gutter[0] == 200 && rock_gutter[2] == 10;
+        valid &= leaf_color[1] == 200 && leaf_color[3] == 128;
+        valid &= texel(normal, rock.x + 5, rock.y + 5)[2] == 255;
+        valid &= texel(orm, leaf.x + 5, leaf.y + 5)[0] == 255 && texel(orm, leaf.x + 5, leaf.y + 5)[1] == 40;
+        valid &= texel(orm, rock.x + 5, rock.y + 5)[1] == 128;
+
+        // UV (0.5, 0.5) of the leaf lands on the centre of its rectangle (V runs bottom-up)
+        float u = 0.5f * leaf.u_scale + leaf.u_offset;
+        float v = 0.5f * leaf.v_scale + leaf.v_offset;
+        valid &= std::abs(u * page.width - (leaf.x + leaf.width * 0.5f)) < 0.01f;
+        valid &= std::abs((1.0f - v) * page.height - (leaf.y + leaf.height * 0.5f)) < 0.01f;
+
+        // Imports of atlased assets carry their placement to the import script
+        auto imported = manager.importAsset("texture_atlas_test/lib/rock/rock_small.obj");
+        auto skipped = manager.importAsset("texture_atlas_test/lib/stray/stray.obj");
+        valid &= imported.metadata.count("atlas_remapped_objects") == 1 && skipped.metadata.count("atlas_remapped_objects") == 0;
+
+        std::filesystem::remove_all("texture_atlas_test");
+        return valid;
+    });
+
+    // Test 18: Identical material requests reuse the registered material, identical textures share one path
+    runner.runTest("Material Registry Reuses Identical Materials", []() -> bool {
+        std::filesystem::remove_all("material_registry_test");
+        std::filesystem::create_directories("material_registry_test/copy");
+        std::ofstream("material_registry_test/rock_albedo.png", std::ios::binary) << "\x89PNG same pixels";
+        std::ofstream("material_registry_test/copy/rock_albedo.png", std::ios::binary) << "\x89PNG same pixels";
+        std::ofstream("material_registry_test/moss_albedo.png", std::ios::binary) << "\x89PNG other pixels";
+
+        AssetManager::MaterialManager manager;
+        AssetManager::MaterialSpec rock;
+        rock.options.name = "Rock";
+        rock.options.roughness = 0.42f;
+        rock.options.albedo_texture = "material_registry_test/rock_albedo.png";
+        manager.registerMaterial(rock, "Rock");
+        bool valid = manager.findRegisteredMaterial(rock).empty();   // no scene file, nothing to reuse
+        manager.setScene("material_registry_test/scene.blend");
+        manager.registerMaterial(rock, "Rock");
+
+        // Float noise below the quantum and a byte-identical copy of the texture still match
+        AssetManager::MaterialSpec copy = rock;
+        copy.options.name = "Rock_Copy";
+        copy.options.roughness = 0.420001f;
+        copy.options.albedo_texture = "material_registry_test/copy/rock_albedo.png";
+        valid &= manager.findRegisteredMaterial(copy) == "Rock";
+
+        AssetManager::MaterialSpec rougher = rock;
+        rougher.options.roughness = 0.6f;
+        AssetManager::MaterialSpec moss = rock;
+        moss.options.albedo_texture = "material_registry_test/moss_albedo.png";
+        AssetManager::MaterialSpec opaque = rock;
+        opaque.options.custom_properties["curve"] = std::vector<float>{0.0f, 1.0f};
+        valid &= manager.findRegisteredMaterial(rougher).empty() && manager.findRegisteredMaterial(moss).empty();
+        valid &= manager.findRegisteredMaterial(opaque).empty();
+
+        // Reuse needs no Blender run, single or batched
+        auto reused = manager.createMaterial(copy.options);
+        valid &= reused.success && reused.material_name == "Rock" && reused.metadata.count("reused") == 1;
+        valid &= reused.assigned_textures.size() == 1 &&
+                 reused.assigned_textures[0] == std::filesystem::absolute("material_registry_test/rock_albedo.png").string();
+        auto batch = manager.createMaterials({copy, rock});
+        valid &= batch.size() == 2 && batch[0].success && batch[1].success && batch[1].material_name == "Rock";
+
+        // Registries are per scene
+        manager.setScene("other.blend");
+        valid &= manager.findRegisteredMaterial(rock).empty();
+        manager.setScene("material_registry_test/../material_registry_test/scene.blend");
+        valid &= manager.findRegisteredMaterial(rock) == "Rock";
+
+        auto stats = manager.getMaterialRegistryStats();
+        valid &= stats.materials_registered == 1 && stats.materials_reused == 3 && stats.textures_shared == 2;
+        manager.clearMaterialRegistry();
+        valid &= manager.findRegisteredMaterial(rock).empty();
+
+        // A material Blender failed to create leaves no texture for later requests to share
+        std::filesystem::create_directories("material_registry_test/stub");
+        std::ofstream("material_registry_test/stub/blender") << "#!/bin/sh\necho 'Blender quit unexpectedly'\nexit 1\n";
+        std::filesystem::permissions("material_registry_test/stub/blender", std::filesystem::perms::owner_all);
+        std::ofstream("material_registry_test/copy/moss_albedo.png", std::ios::binary) << "\x89PNG other pixels";
+        const char* old_path = std::getenv("PATH");
+        std::string saved_path = old_path ? old_path : "";
+        setenv("PATH", (std::filesystem::absolute("material_registry_test/stub").string() + ":" + saved_path).c_str(), 1);
+        moss.options.name = "Moss";
+        auto failed = manager.createMaterials({moss});
+        setenv("PATH", saved_path.c_str(), 1);
+        valid &= failed.size() == 1 && !failed[0].success;
+        AssetManager::MaterialSpec moss_copy = moss;
+        moss_copy.options.albedo_texture = "material_registry_test/copy/moss_albedo.png";
+        manager.registerMaterial(moss_copy, "Moss");
+        valid &= manager.getMaterialRegistryStats().textures_shared == 2;
+
+        std::filesystem::remove_all("material_registry_test");
+        return valid;
+    });
+
+    // Test 19: Node-tree templates are keyed by graph shape and tracked per template library
+    runner.runTest("Material Templates Keyed By Node Graph Shape", []() -> bool {
+        using AssetManager::MaterialManager;
+        AssetManager::MaterialSpec rock;
+        rock.options.roughness = 0.8f;
+        rock.options.albedo_texture = "rock_albedo.png";
+        rock.options.normal_texture = "rock_normal.png";
+        AssetManager::MaterialSpec metal;
+        metal.options.metallic = 1.0f;
+        metal.textures = {{"metal_normal.png", "normal"}, {"metal_albedo.png", "albedo"}};
+        AssetManager::MaterialSpec plain;
+        AssetManager::MaterialSpec flat = plain;
+        flat.options.use_nodes = false;
+
+        // Values and files do not change the shape; channels and node use do
+        std::string key = MaterialManager::templateKey(rock);
+        bool valid = key.size() == 16 && key == MaterialManager::templateKey(metal);
+        valid &= MaterialManager::templateKey(plain) != key && !MaterialManager::templateKey(plain).empty();
+        valid &= MaterialManager::templateKey(flat).empty();
+
+        // Resident templates come from the library's manifest, and only while the library exists
+        std::filesystem::remove_all("material_template_test");
+        std::filesystem::create_directories("material_template_test");
+        std::ofstream("material_template_test/templates.blend.json") << "{\"templates\": [\"" << key << "\"]}";
+        MaterialManager missing;
+        missing.setTemplateLibrary("material_template_test/templates.blend");
+        valid &= missing.getResidentTemplates().empty();
+        std::ofstream("material_template_test/templates.blend", std::ios::binary) << "BLENDER";
+        MaterialManager manager;
+        manager.setTemplateLibrary("material_template_test/templates.blend");
+        valid &= manager.getResidentTemplates() == std::set<std::string>{key};
+        valid &= manager.getTemplateLibrary() == std::filesystem::absolute("material_template_test/templates.blend").string();
+        manager.setTemplateLibrary("");
+        valid &= manager.getResidentTemplates().empty() && manager.getTemplateStats().materials_instanced == 0;
+
+        std::filesystem::remove_all("material_template_test");
+        return valid;
+    });
+
+    // Test 20: Preview spheres are rendered on the CPU and cached by parameter hash
+    runner.runTest("Material Preview Spheres Rendered And Cached", []() -> bool {
+        AssetManager::MaterialManager manager;
+        auto metal = manager.renderPresetPreview("metal", 64);
+        if (!metal || metal->size != 64 || metal->rgba.size() != 64u * 64u * 4u) {
+            return false;
+        }
+        auto alphaAt = [](const AssetManager::MaterialPreview& preview, int x, int y) {
+            return preview.rgba[(static_cast<size_t>(y) * preview.size + x) * 4 + 3];
+        };
+        auto brightest = [](const AssetManager::MaterialPreview& preview) {
+            int peak = 0;
+            for (size_t i = 0; i < preview.rgba.size(); i += 4) {
+                peak = std::max(peak, preview.rgba[i] + preview.rgba[i + 1] + preview.rgba[i + 2]);
+            }
+            return peak;
+        };
+        bool valid = alphaAt(*metal, 32, 32) == 255 && alphaAt(*metal, 0, 0) == 0 && alphaAt(*metal, 63, 63) == 0;
+        valid &= manager.renderPresetPreview("metal", 64) == metal && manager.getPreviewStats().cache_hits == 1;
+        valid &= manager.renderPresetPreview("plastic", 64)->rgba != metal->rgba;
+        valid &= manager.renderPresetPreview("missing", 64) == nullptr;
+
+        // A smooth surface concentrates the highlight, a rough one spreads it
+        AssetManager::MaterialSpec smooth;
+        smooth.options.roughness = 0.1f;
+        AssetManager::MaterialSpec rough = smooth;
+        rough.options.roughness = 0.9f;
+        valid &= brightest(*manager.renderPreview(smooth, 64)) > brightest(*manager.renderPreview(rough, 64));
+
+        // Albedo textures are sampled through the sphere UVs
+        std::filesystem::remove_all("material_preview_test");
+        std::filesystem::create_directories("material_preview_test");
+        AssetManager::ImageBuffer red;
+        red.width = red.height = 4;
+        red.channels = 3;
+        for (int i = 0; i < 16; ++i) {
+            red.bytes.insert(red.bytes.end(), {230, 20, 20});
+        }
+        std::string error;
+        valid &= AssetManager::TextureProcessor::encode("material_preview_test/red.png", red, error);
+        AssetManager::MaterialSpec textured;
+        textured.options.name = "Brick";
+        textured.options.albedo_texture = "material_preview_test/red.png";
+        manager.setScene("material_preview_test/scene.blend");
+        manager.registerMaterial(textured, "Brick");
+        auto brick = manager.renderMaterialPreview("Brick", 64);
+        const uint8_t* center = brick ? brick->rgba.data() + (32 * 64 + 32) * 4 : nullptr;
+        valid &= center && center[0] > 2 * center[1] && manager.getPreviewStats().textures_loaded == 1;
+        valid &= manager.renderMaterialPreview("Unknown", 64) == nullptr;
+
+        // Thumbnails take milliseconds, not a Blender launch
+        auto large = manager.renderPresetPreview("fabric", 128);
+        valid &= large && large->render_ms < 100.0;
+
+        std::filesystem::remove_all("material_preview_test");
+        return valid;
+    });
+
+    // Test 21: One header read per file serves the texture parser, format probes and every subsystem
+    runner.runTest("Shared File Probe Reads Each File Once", []() -> bool {
+        std::filesystem::remove_all("file_probe_test");
+        std::filesystem::create_directories("file_probe_test");
+        AssetManager::ImageBuffer image;
+        image.width = 8;
+        image.height = 4;
+        image.channels = 3;
+        image.bytes.assign(8 * 4 * 3, 128);
+        std::string error;
+        bool valid = AssetManager::TextureProcessor::encode("file_probe_test/wall.png", image, error);
+        {
+            std::ofstream fbx("file_probe_test/chair.fbx", std::ios::binary);
+            const unsigned char header[27] = {'K', 'a', 'y', 'd', 'a', 'r', 'a', ' ', 'F', 'B', 'X', ' ', 'B', 'i',
+                                              'n', 'a', 'r', 'y', ' ', ' ', 0, 0x1A, 0, 0xE4, 0x1C, 0, 0};
+            fbx.write(reinterpret_cast<const char*>(header), sizeof(header));
+        }
+
+        AssetManager::FileProbeService service(2);
+        auto wall = service.probe("file_probe_test/wall.png");
+        valid &= wall->has_texture && wall->texture.width == 8 && wall->texture.height == 4;
+        valid &= service.probe("file_probe_test/wall.png") == wall;
+        auto chair = service.probe("file_probe_test/chair.fbx");
+        const auto& fbx = chair->formats.at("fbx");
+        valid &= std::any_cast<bool>(fbx.at("binary")) && std::any_cast<unsigned int>(fbx.at("version")) == 7396;
+        valid &= chair->head.size() == 27 && service.probe("file_probe_test/missing.obj")->exists == false;
+        auto stats = service.getStats();
+        valid &= stats.files_read == 2 && stats.cache_hits == 1;
+
+        // A changed file is read again; the LRU stays within its capacity
+        { std::ofstream("file_probe_test/chair.fbx", std::ios::app) << "more"; }
+        valid &= service.probe("file_probe_test/chair.fbx")->size == 31;
+        { std::ofstream("file_probe_test/notes.txt") << "notes"; }
+        service.probe("file_probe_test/notes.txt");
+        valid &= service.getStats().files_read == 4 && service.getStats().evictions == 1;
+        valid &= service.cached("file_probe_test/wall.png") == nullptr;
+
+        // Material discovery goes through the shared service
+        size_t before = AssetManager::FileProbeService::shared().getStats().probes;
+        AssetManager::MaterialManager manager;
+        auto textures = manager.discoverTextures("file_probe_test");
+        valid &= textures.size() == 1 && textures[0].width == 8;
+        valid &= AssetManager::FileProbeService::shared().getStats().probes > before;
+
+        std::filesystem::remove_all("file_probe_test");
+        return valid;
+    });
+
+    // Test 22: UDIM channels auto-assign through their first tile and are sent to Blender as tiled images
+    runner.runTest("UDIM Texture Sets Auto Assign As Tiled Images", []() -> bool {
+        std::filesystem::remove_all("udim_assign_test");
+        std::filesystem::create_directories("udim_assign_test/hero");
+        std::filesystem::create_directories("udim_assign_test/stub");
+        for (const char* name : {"hero_basecolor.1002.png", "hero_basecolor.1001.png", "hero_normal.png"}) {
+            std::ofstream(std::string("udim_assign_test/hero/") + name, std::ios::binary) << "\x89PNG " << name;
+        }
+        std::ofstream("udim_assign_test/hero/hero.fbx") << "fbx";
+        std::string captured = std::filesystem::absolute("udim_assign_test/batch.json").string();
+        std::ofstream("udim_assign_test/stub/blender")
+            << "#!/bin/sh\ncp \"$7\" '" << captured << "'\n"
+            << "echo 'MATERIAL_RESULT: {\"index\": 0, \"success\": true, \"material_name\": \"hero\"}'\n";
+        std::filesystem::permissions("udim_assign_test/stub/blender", std::filesystem::perms::owner_all);
+
+        auto index = std::make_shared<AssetManager::TextureSetIndex>();
+        std::string hero_dir = std::filesystem::absolute("udim_assign_test/hero").lexically_normal().string();
+        index->build({hero_dir + "/hero_basecolor.1002.png", hero_dir + "/hero_basecolor.1001.png",
+                      hero_dir + "/hero_normal.png"});
+        AssetManager::MaterialManager manager;
+        manager.setTextureSetIndex(index);
+
+        const char* old_path = std::getenv("PATH");
+        std::string saved_path = old_path ? old_path : "";
+        setenv("PATH", (std::filesystem::absolute("udim_assign_test/stub").string() + ":" + saved_path).c_str(), 1);
+        auto result = manager.autoAssignMaterials("udim_assign_test/hero/hero.fbx");
+        setenv("PATH", saved_path.c_str(), 1);
+
+        bool valid = result.success;
+        std::ifstream batch_file(captured);
+        std::string batch((std::istreambuf_iterator<char>(batch_file)), std::istreambuf_iterator<char>());
+        valid &= batch.find("hero_basecolor.1001.png\",\"tiled\":true") != std::string::npos;
+        valid &= batch.find("<UDIM>") == std::string::npos && batch.find("hero_basecolor.1002.png") == std::string::npos;
+        valid &= batch.find("hero_normal.png\",\"type\":\"normal\"}") != std::string::npos;
+
+        std::filesystem::remove_all("udim_assign_test");
+        return valid;
+    });
+
+    // Test 23: Channel names written as several tokens group with single-token channels of the same stem
+    runner.runTest("Texture Set Index Multi-Token Channel Names", []() -> bool {
+        AssetManager::TextureSetIndex index;
+        index.build({
+            "lib/rock/Rock_Base_Color.png", "lib/rock/Rock_Normal.png", "lib/rock/Rock_Ambient_Occlusion_2K.png",
+            "lib/rock/Rock-Roughness.png", "lib/wood/Old_Wood_Base-Color.png", "lib/wood/Old_Wood_Color.png"
+        });
+
+        bool valid = index.size() == 2;
+        const AssetManager::TextureSet* rock = index.find("lib/rock", "Rock");
+        valid &= rock && rock->channels.size() == 4;
+        valid &= rock && rock->channels.at("base_color").path == "lib/rock/Rock_Base_Color.png";
+        valid &= rock && rock->channels.at("ao").resolutions.count("2k") == 1;
+        valid &= rock && rock->channels.count("normal") == 1 && rock->channels.count("roughness") == 1;
+
+        // "Base-Color" is tried before the shorter "Color", both leave the stem "old_wood"
+        const AssetManager::TextureSet* wood = index.find("lib/wood", "Old_Wood");
+        valid &= wood && wood->channels.size() == 1;
+        valid &= wood && wood->channels.at("base_color").resolutions.size() == 1;
+        return valid;
+    });
+
+    // Test 24: Materials are only reused when the batch that created them saved them into the scene file
+    runner.runTest("Material Reuse Needs A Saved Scene", []() -> bool {
+        std::filesystem::remove_all("material_scene_test");
+        std::filesystem::create_directories("material_scene_test/stub");
+        std::string requests = std::filesystem::absolute("material_scene_test").string();
+        // Keeps each batch request and reports every material as created
+        std::ofstream("material_scene_test/stub/blender")
+            << "#!/bin/sh\nn=$(ls '" << requests << "' | grep -c '^request_')\n"
+            << "cp \"$7\" '" << requests << "/request_'$n'.json'\n"
+            << "echo 'MATERIAL_RESULT: {\"index\": 0, \"success\": true, \"material_name\": \"Slate\"}'\n";
+        std::filesystem::permissions("material_scene_test/stub/blender", std::filesystem::perms::owner_all);
+        auto batches = [&requests]() {
+            return std::distance(std::filesystem::directory_iterator(requests), std::filesystem::directory_iterator()) - 1;
+        };
+
+        AssetManager::MaterialManager manager;
+        AssetManager::MaterialSpec slate;
+        slate.options.name = "Slate";
+        slate.options.roughness = 0.7f;
+
+        const char* old_path = std::getenv("PATH");
+        std::string saved_path = old_path ? old_path : "";
+        setenv("PATH", (std::filesystem::absolute("material_scene_test/stub").string() + ":" + saved_path).c_str(), 1);
+        // Without a scene file each session is discarded, so the second request runs Blender again
+        auto first = manager.createMaterial(slate.options);
+        auto second = manager.createMaterial(slate.options);
+        bool valid = first.success && second.success && second.metadata.count("reused") == 0 && batches() == 2;
+
+        manager.setScene("material_scene_test/scene.blend");
+        auto created = manager.createMaterial(slate.options);
+        auto reused = manager.createMaterial(slate.options);
+        setenv("PATH", saved_path.c_str(), 1);
+        valid &= created.success && reused.success && reused.metadata.count("reused") == 1 && batches() == 3;
+
+        std::ifstream request_in("material_scene_test/request_2.json");
+        std::string request((std::istreambuf_iterator<char>(request_in)), std::istreambuf_iterator<char>());
+        valid &= request.find(std::filesystem::absolute("material_scene_test/scene.blend").string()) != std::string::npos;
+        std::filesystem::remove_all("material_scene_test");
+        return valid;
+    });
+
     runner.printSummary();
     
     return runner.getFailedCount() == 0 ? 0 : 1;
@@ -2,7 +2,7 @@ const std = @import("std");
 
 pub fn build(b: *std.Build) void {
     // Create a custom step that runs zig c++ directly
-    const compile_step = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "src/main.cpp", "src/core/audit.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "src/core/asset_validator.cpp", "src/core/import_manager.cpp", "src/core/material_manager.cpp", "-o", "zig-out/bin/blender_asset_manager" });
+    const compile_step = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "src/main.cpp", "src/core/audit.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "src/core/asset_validator.cpp", "src/core/obj_validator.cpp", "src/core/image_integrity.cpp", "src/core/crc32.cpp", "src/core/import_manager.cpp", "src/core/import_telemetry.cpp", "src/core/dependency_prefetcher.cpp", "src/core/hot_asset_cache.cpp", "src/core/material_manager.cpp", "src/core/texture_set_index.cpp", "src/core/texture_probe.cpp", "src/core/file_probe.cpp", "src/core/texture_processor.cpp", "src/core/texture_budget.cpp", "src/core/texture_atlas.cpp", "src/core/material_preview.cpp", "-lpng", "-ljpeg", "-lz", "-o", "zig-out/bin/blender_asset_manager" });
 
     // Make sure the output directory exists
     const mkdir_step = b.addSystemCommand(&.{ "mkdir", "-p", "zig-out/bin" });
@@ -22,10 +22,10 @@ pub fn build(b: *std.Build) void {
     build_step.dependOn(&compile_step.step);
 
     // Add ImportManager test build (using simple test harness)
-    const import_test_compile = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "src/core/import_manager.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "src/core/material_manager.cpp", "Tests/test_import_manager.cpp", "-o", "zig-out/bin/test_import_manager" });
+    const import_test_compile = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "src/core/import_manager.cpp", "src/core/import_telemetry.cpp", "src/core/dependency_prefetcher.cpp", "src/core/obj_validator.cpp", "src/core/hot_asset_cache.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "src/core/material_manager.cpp", "src/core/texture_set_index.cpp", "src/core/texture_probe.cpp", "src/core/file_probe.cpp", "src/core/texture_processor.cpp", "src/core/texture_budget.cpp", "src/core/texture_atlas.cpp", "src/core/material_preview.cpp", "Tests/test_import_manager.cpp", "-lpng", "-ljpeg", "-lz", "-o", "zig-out/bin/test_import_manager" });
 
     // Add ImportHistory test build
-    const history_test_compile = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "src/core/import_history.cpp", "Tests/test_import_history.cpp", "-o", "zig-out/bin/test_import_history" });
+    const history_test_compile = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "src/core/import_history.cpp", "src/core/history_journal.cpp", "src/core/crc32.cpp", "src/core/history_serializer.cpp", "src/core/history_index.cpp", "src/core/history_rollup.cpp", "Tests/test_import_history.cpp", "-o", "zig-out/bin/test_import_history" });
     history_test_compile.step.dependOn(&mkdir_step.step);
 
     const history_test_build_step = b.step("build-test-history", "Build the import history tests");
@@ -39,10 +39,10 @@ pub fn build(b: *std.Build) void {
     run_history_test_step.dependOn(&run_history_test.step);
 
     // Add PythonBridge test build (without Python - universal mode)
-    const python_bridge_test_compile = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "src/core/python_bridge.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "src/core/import_manager.cpp", "src/core/material_manager.cpp", "src/core/import_history.cpp", "Tests/test_python_bridge.cpp", "-o", "zig-out/bin/test_python_bridge" });
+    const python_bridge_test_compile = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "src/core/python_bridge.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "src/core/import_manager.cpp", "src/core/import_telemetry.cpp", "src/core/dependency_prefetcher.cpp", "src/core/obj_validator.cpp", "src/core/hot_asset_cache.cpp", "src/core/material_manager.cpp", "src/core/texture_set_index.cpp", "src/core/texture_probe.cpp", "src/core/file_probe.cpp", "src/core/texture_processor.cpp", "src/core/texture_budget.cpp", "src/core/texture_atlas.cpp", "src/core/material_preview.cpp", "src/core/import_history.cpp", "src/core/history_journal.cpp", "src/core/crc32.cpp", "src/core/history_serializer.cpp", "src/core/history_index.cpp", "src/core/history_rollup.cpp", "Tests/test_python_bridge.cpp", "-lpng", "-ljpeg", "-lz", "-o", "zig-out/bin/test_python_bridge" });
 
     // Add PythonBridge test build (with Python - optional)
-    const python_bridge_test_compile_with_python = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "-I", "/usr/include/python3.13", "-lpython3.13", "-DTAHLIA_ENABLE_PYTHON", "src/core/python_bridge.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "src/core/import_manager.cpp", "src/core/material_manager.cpp", "src/core/import_history.cpp", "Tests/test_python_bridge.cpp", "-o", "zig-out/bin/test_python_bridge_with_python" });
+    const python_bridge_test_compile_with_python = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "-I", "/usr/include/python3.13", "-lpython3.13", "-DTAHLIA_ENABLE_PYTHON", "src/core/python_bridge.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "src/core/import_manager.cpp", "src/core/import_telemetry.cpp", "src/core/dependency_prefetcher.cpp", "src/core/obj_validator.cpp", "src/core/hot_asset_cache.cpp", "src/core/material_manager.cpp", "src/core/texture_set_index.cpp", "src/core/texture_probe.cpp", "src/core/file_probe.cpp", "src/core/texture_processor.cpp", "src/core/texture_budget.cpp", "src/core/texture_atlas.cpp", "src/core/material_preview.cpp", "src/core/import_history.cpp", "src/core/history_journal.cpp", "src/core/crc32.cpp", "src/core/history_serializer.cpp", "src/core/history_index.cpp", "src/core/history_rollup.cpp", "Tests/test_python_bridge.cpp", "-lpng", "-ljpeg", "-lz", "-o", "zig-out/bin/test_python_bridge_with_python" });
     python_bridge_test_compile.step.dependOn(&mkdir_step.step);
     python_bridge_test_compile_with_python.step.dependOn(&mkdir_step.step);
 
@@ -78,7 +78,7 @@ pub fn build(b: *std.Build) void {
     run_import_test_step.dependOn(&run_import_test.step);
 
     // Add MaterialManager test build
-    const material_test_compile = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "src/core/material_manager.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "src/core/import_manager.cpp", "Tests/test_material_manager.cpp", "-o", "zig-out/bin/test_material_manager" });
+    const material_test_compile = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "src/core/material_manager.cpp", "src/core/texture_set_index.cpp", "src/core/texture_probe.cpp", "src/core/file_probe.cpp", "src/core/texture_processor.cpp", "src/core/texture_budget.cpp", "src/core/texture_atlas.cpp", "src/core/material_preview.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "src/core/import_manager.cpp", "src/core/import_telemetry.cpp", "src/core/dependency_prefetcher.cpp", "src/core/obj_validator.cpp", "src/core/hot_asset_cache.cpp", "Tests/test_material_manager.cpp", "-lpng", "-ljpeg", "-lz", "-o", "zig-out/bin/test_material_manager" });
     material_test_compile.step.dependOn(&mkdir_step.step);
 
     const material_test_build_step = b.step("build-test-material", "Build the material manager tests");
@@ -91,8 +91,22 @@ pub fn build(b: *std.Build) void {
     const run_material_test_step = b.step("run-test-material", "Run the material manager tests");
     run_material_test_step.dependOn(&run_material_test.step);
 
+    // Add IngestPipeline test build
+    const pipeline_test_compile = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "Tests", "src/core/ingest_pipeline.cpp", "src/core/asset_validator.cpp", "src/core/obj_validator.cpp", "src/core/image_integrity.cpp", "src/core/crc32.cpp", "src/core/import_manager.cpp", "src/core/import_telemetry.cpp", "src/core/dependency_prefetcher.cpp", "src/core/hot_asset_cache.cpp", "src/core/import_history.cpp", "src/core/history_journal.cpp", "src/core/history_serializer.cpp", "src/core/history_index.cpp", "src/core/history_rollup.cpp", "src/core/material_manager.cpp", "src/core/texture_set_index.cpp", "src/core/texture_probe.cpp", "src/core/file_probe.cpp", "src/core/texture_processor.cpp", "src/core/texture_budget.cpp", "src/core/texture_atlas.cpp", "src/core/material_preview.cpp", "src/core/asset_manager.cpp", "src/core/asset_indexer.cpp", "Tests/test_ingest_pipeline.cpp", "-lpng", "-ljpeg", "-lz", "-o", "zig-out/bin/test_ingest_pipeline" });
+    pipeline_test_compile.step.dependOn(&mkdir_step.step);
+
+    const pipeline_test_build_step = b.step("build-test-pipeline", "Build the ingest pipeline tests");
+    pipeline_test_build_step.dependOn(&pipeline_test_compile.step);
+
+    // Add run test step
+    const run_pipeline_test = b.addSystemCommand(&.{"zig-out/bin/test_ingest_pipeline"});
+    run_pipeline_test.step.dependOn(&pipeline_test_compile.step);
+
+    const run_pipeline_test_step = b.step("run-test-pipeline", "Run the ingest pipeline tests");
+    run_pipeline_test_step.dependOn(&run_pipeline_test.step);
+
     // GUI Application
-    const gui_app = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "src/gui", "-I", "dependencies/imgui", "-lglfw", "-lGL", "-lGLU", "src/gui/main_gui.cpp", "src/gui/asset_library_gui.cpp", "dependencies/imgui/imgui.cpp", "dependencies/imgui/imgui_draw.cpp", "dependencies/imgui/imgui_tables.cpp", "dependencies/imgui/imgui_widgets.cpp", "dependencies/imgui/backends/imgui_impl_glfw.cpp", "dependencies/imgui/backends/imgui_impl_opengl3.cpp", "src/core/asset_manager.cpp", "src/core/import_manager.cpp", "src/core/material_manager.cpp", "src/core/import_history.cpp", "src/core/asset_indexer.cpp", "src/core/asset_validator.cpp", "src/core/audit.cpp", "src/core/python_bridge.cpp", "-o", "zig-out/bin/tahlia_gui" });
+    const gui_app = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "src/gui", "-I", "dependencies/imgui", "-lglfw", "-lGL", "-lGLU", "src/gui/main_gui.cpp", "src/gui/asset_library_gui.cpp", "dependencies/imgui/imgui.cpp", "dependencies/imgui/imgui_draw.cpp", "dependencies/imgui/imgui_tables.cpp", "dependencies/imgui/imgui_widgets.cpp", "dependencies/imgui/backends/imgui_impl_glfw.cpp", "dependencies/imgui/backends/imgui_impl_opengl3.cpp", "src/core/asset_manager.cpp", "src/core/import_manager.cpp", "src/core/import_telemetry.cpp", "src/core/dependency_prefetcher.cpp", "src/core/hot_asset_cache.cpp", "src/core/material_manager.cpp", "src/core/texture_set_index.cpp", "src/core/texture_probe.cpp", "src/core/file_probe.cpp", "src/core/texture_processor.cpp", "src/core/texture_budget.cpp", "src/core/texture_atlas.cpp", "src/core/material_preview.cpp", "src/core/import_history.cpp", "src/core/history_journal.cpp", "src/core/history_serializer.cpp", "src/core/history_index.cpp", "src/core/history_rollup.cpp", "src/core/asset_indexer.cpp", "src/core/asset_validator.cpp", "src/core/obj_validator.cpp", "src/core/image_integrity.cpp", "src/core/crc32.cpp", "src/core/audit.cpp", "src/core/python_bridge.cpp", "src/core/ingest_pipeline.cpp", "-lpng", "-ljpeg", "-lz", "-o", "zig-out/bin/tahlia_gui" });
     gui_app.step.dependOn(&mkdir_step.step);
 
     const gui_build_step = b.step("build-gui", "Build the GUI application");
@@ -105,7 +119,7 @@ pub fn build(b: *std.Build) void {
     gui_run_step.dependOn(&gui_run.step);
 
     // GUI Test
-    const gui_test = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "src/gui", "-I", "dependencies/imgui", "-I", "Tests", "-lglfw", "-lGL", "-lGLU", "Tests/test_gui.cpp", "src/gui/asset_library_gui.cpp", "dependencies/imgui/imgui.cpp", "dependencies/imgui/imgui_draw.cpp", "dependencies/imgui/imgui_tables.cpp", "dependencies/imgui/imgui_widgets.cpp", "dependencies/imgui/backends/imgui_impl_glfw.cpp", "dependencies/imgui/backends/imgui_impl_opengl3.cpp", "src/core/asset_manager.cpp", "src/core/import_manager.cpp", "src/core/material_manager.cpp", "src/core/import_history.cpp", "src/core/asset_indexer.cpp", "src/core/asset_validator.cpp", "src/core/audit.cpp", "src/core/python_bridge.cpp", "-o", "zig-out/bin/test_gui" });
+    const gui_test = b.addSystemCommand(&.{ "zig", "c++", "-std=c++17", "-Wall", "-Wextra", "-I", "include", "-I", "src/gui", "-I", "dependencies/imgui", "-I", "Tests", "-lglfw", "-lGL", "-lGLU", "Tests/test_gui.cpp", "src/gui/asset_library_gui.cpp", "dependencies/imgui/imgui.cpp", "dependencies/imgui/imgui_draw.cpp", "dependencies/imgui/imgui_tables.cpp", "dependencies/imgui/imgui_widgets.cpp", "dependencies/imgui/backends/imgui_impl_glfw.cpp", "dependencies/imgui/backends/imgui_impl_opengl3.cpp", "src/core/asset_manager.cpp", "src/core/import_manager.cpp", "src/core/import_telemetry.cpp", "src/core/dependency_prefetcher.cpp", "src/core/hot_asset_cache.cpp", "src/core/material_manager.cpp", "src/core/texture_set_index.cpp", "src/core/texture_probe.cpp", "src/core/file_probe.cpp", "src/core/texture_processor.cpp", "src/core/texture_budget.cpp", "src/core/texture_atlas.cpp", "src/core/material_preview.cpp", "src/core/import_history.cpp", "src/core/history_journal.cpp", "src/core/history_serializer.cpp", "src/core/history_index.cpp", "src/core/history_rollup.cpp", "src/core/asset_indexer.cpp", "src/core/asset_validator.cpp", "src/core/obj_validator.cpp", "src/core/image_integrity.cpp", "src/core/crc32.cpp", "src/core/audit.cpp", "src/core/python_bridge.cpp", "src/core/ingest_pipeline.cpp", "-lpng", "-ljpeg", "-lz", "-o", "zig-out/bin/test_gui" });
     gui_test.step.dependOn(&mkdir_step.step);
 
     const gui_test_build_step = b.step("build-test-gui", "Build the GUI tests");
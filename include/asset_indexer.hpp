@@ -52,12 +52,14 @@ public:
     std::vector<AssetInfo> get_assets_by_category(const std::string& category) const;
     std::vector<AssetInfo> get_assets_by_type(const std::string& type) const;
     std::optional<AssetInfo> get_asset_by_path(const std::string& path) const;
+    std::vector<std::string> get_dependency_closure(const std::string& path) const;
     
     // Cache management
     bool is_cache_valid() const;
     void clear_cache();
     void update_asset(const std::string& path);
     void remove_asset(const std::string& path);
+    bool set_asset_metadata(const std::string& path, const std::string& key, const std::any& value);
     bool save_cache_to_file(const std::string& cache_file_path) const;
     bool load_cache_from_file(const std::string& cache_file_path);
     
@@ -88,7 +90,8 @@ private:
     std::vector<std::string> ignored_patterns_;
     std::map<std::string, std::string> extension_mappings_;
     
-    // Thread safety
+    // Thread safety: guards assets_by_path_ and root_path_ writes against
+    // get_dependency_closure, which runs on prefetch worker threads
     mutable std::mutex cache_mutex_;
     
     // Private helper methods
@@ -107,8 +110,10 @@ private:
     std::map<std::string, std::any> extract_obj_metadata(const std::filesystem::path& file_path) const;
     std::map<std::string, std::any> extract_fbx_metadata(const std::filesystem::path& file_path) const;
     std::map<std::string, std::any> extract_blend_metadata(const std::filesystem::path& file_path) const;
+    std::map<std::string, std::any> extract_texture_metadata(const std::filesystem::path& file_path) const;
     std::vector<std::string> find_obj_dependencies(const std::filesystem::path& file_path) const;
     std::vector<std::string> find_material_dependencies(const std::filesystem::path& file_path) const;
+    std::vector<std::string> find_blend_dependencies(const std::filesystem::path& file_path) const;
     void add_texture_dependency(const std::string& texture_path, const std::filesystem::path& material_file_path, std::vector<std::string>& dependencies) const;
 };
 
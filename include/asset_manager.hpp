@@ -42,6 +42,9 @@
 #include "import_manager.hpp"
 #include "material_manager.hpp"
 #include "import_history.hpp"
+#include "texture_processor.hpp"
+#include "texture_budget.hpp"
+#include "texture_atlas.hpp"
 
 namespace AssetManager {
 
@@ -97,6 +100,15 @@ public:
     std::vector<AssetInfo> get_assets_by_type(const std::string& type) const;
     std::vector<AssetInfo> get_assets_by_category(const std::string& category) const;
     std::optional<AssetInfo> get_asset_by_path(const std::string& path) const;
+    std::vector<std::string> get_dependency_closure(const std::string& asset_path) const;
+    // PBR texture sets grouped from the indexed textures after each scan
+    std::shared_ptr<const TextureSetIndex> get_texture_sets() const;
+    // Optimized texture variants written to options.cache_root and linked back into the index
+    std::vector<TextureJobResult> generate_texture_variants(const TextureVariantOptions& options);
+    std::vector<TextureJobResult> pack_orm_textures(const TextureVariantOptions& options);
+    // Texture sets of a scatter group baked into shared atlas pages; later imports of those assets use the atlas
+    TextureAtlasResult build_texture_atlas(const std::vector<std::string>& asset_paths, const TextureAtlasOptions& options);
+    void clear_texture_atlases();
     
     // Asset validation
     bool validate_asset(const std::string& asset_path);
@@ -143,10 +155,23 @@ public:
     std::vector<ImportResult> importAssetsLine(const std::vector<std::string>& asset_paths, const ImportOptions& options = {}, float spacing = 5.0f);
     std::vector<ImportResult> importAssetsRandom(const std::vector<std::string>& asset_paths, const ImportOptions& options = {}, int count = 10, float area_size = 20.0f);
     
+    // Local SSD hot-asset cache used transparently by imports
+    bool enable_hot_asset_cache(const std::string& cache_root, uint64_t capacity_bytes,
+                                CacheEvictionPolicy policy = CacheEvictionPolicy::LRU);
+    std::shared_ptr<HotAssetCache> get_hot_asset_cache() const;
+    
+    // Texture-memory budget for imports; over budget, cached variants are substituted at import time (0 = off)
+    void set_texture_memory_budget(uint64_t budget_bytes);
+    uint64_t get_texture_memory_budget() const;
+    TextureBudgetPlan plan_texture_budget(const std::vector<std::string>& asset_paths, uint64_t budget_bytes) const;
+    TextureBudgetPlan get_last_texture_budget_plan() const;
+    
 private:
     std::unique_ptr<AssetIndexer> indexer_;
     std::unique_ptr<ImportManager> import_manager_;
     std::unique_ptr<MaterialManager> material_manager_;
+    std::shared_ptr<DependencyPrefetcher> prefetcher_;
+    std::shared_ptr<HotAssetCache> hot_cache_;
     // TODO: Add other subsystems when implemented (DONE)
     // std::unique_ptr<AssetValidator> validator_;
     // std::unique_ptr<AssetSearcher> searcher_;
@@ -164,6 +189,10 @@ private:
     // Material presets are now handled by MaterialManager
     std::map<std::string, std::string> import_handlers_;
     std::map<std::string, std::vector<std::string>> pbr_texture_mappings_;
+    std::shared_ptr<TextureSetIndex> texture_sets_;
+    uint64_t texture_budget_bytes_;
+    TextureBudgetPlan last_texture_budget_plan_;
+    std::map<std::string, AtlasRemap> atlas_remaps_;   // absolute asset path -> atlas placement
     
     bool initialized_;
     std::chrono::system_clock::time_point last_cache_update_;
@@ -172,6 +201,12 @@ private:
     // Material presets are now handled by MaterialManager
     void initialize_import_handlers();
     void initialize_pbr_mappings();
+    void rebuild_texture_sets();
+    bool describe_texture(const std::string& texture_path, TextureFootprint& texture) const;
+    std::vector<TextureFootprint> cached_texture_variants(const std::string& texture_path) const;
+    ImportOptions apply_texture_budget(const std::vector<std::string>& asset_paths, const ImportOptions& options);
+    void report_texture_budget(std::vector<ImportResult>& results) const;
+    ImportOptions apply_texture_atlases(const std::vector<std::string>& asset_paths, const ImportOptions& options) const;
     std::string serialize_to_json(const std::any& data) const;
     std::any deserialize_from_json(const std::string& json) const;
 };
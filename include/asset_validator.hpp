@@ -11,6 +11,8 @@
  * - Comprehensive error detection and reporting
  * - Integration with existing AssetIndexer and AssetManager
  * - High-performance validation with minimal I/O overhead
+ * - Batches run on a pool of worker threads; each worker keeps its own counters and merges them once
+ * - Optional persistent result cache keyed by file identity, rule version and the files each result depends on
  * - Extensible design for new file format support
  *
  * Key Features:
@@ -18,7 +20,8 @@
  * - Missing texture and dependency detection
  * - Format-specific validation (OBJ, FBX, Blend, MTL files)
  * - Detailed validation reports with actionable recommendations
- * - Batch validation for entire asset libraries
+ * - Batch validation for entire asset libraries, in parallel, with results in input order
+ * - Incremental reruns: only changed files, and files whose references changed, are validated again
  * - Performance-optimized validation algorithms
  */
 
@@ -31,9 +34,15 @@
 #include <filesystem>
 #include <memory>
 #include <any>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
 
 namespace AssetManager {
 
+    struct OBJIssueSample;
+
     /**
      * @brief Validation severity levels for categorizing issues
      * 
@@ -76,6 +85,7 @@ namespace AssetManager {
         size_t warning_count;                       ///< Number of warnings
         size_t info_count;                          ///< Number of info messages
         std::vector<ValidationIssue> issues;        ///< Detailed list of issues
+        std::vector<std::string> dependencies;      ///< Referenced files the checks looked at (MTL, textures)
         std::map<std::string, std::any> metadata;   ///< Additional validation metadata
     };
 
@@ -96,6 +106,14 @@ namespace AssetManager {
          */
         AssetValidator();
 
+        /**
+         * @brief Version of the validation rules
+         * 
+         * Bump whenever a check changes what it reports; cached results produced
+         * under another version are discarded.
+         */
+        static constexpr int kRuleVersion = 4;
+
         /**
          * @brief Destructor for cleanup and resource management
          */
@@ -116,7 +134,9 @@ namespace AssetManager {
          * @brief Validates multiple assets in batch
          * 
          * Efficiently validates multiple assets, providing progress feedback
-         * and comprehensive reporting for the entire batch.
+         * and comprehensive reporting for the entire batch. With more than one
+         * thread configured, files are validated in parallel; results are still
+         * returned in the order of file_paths.
          * 
          * @param file_paths Vector of file paths to validate
          * @return Vector of ValidationResult objects for each asset
@@ -177,6 +197,59 @@ namespace AssetManager {
          */
         std::map<std::string, std::any> getValidationStats() const;
 
+        /**
+         * @brief Sets the number of worker threads used for batch validation
+         * 
+         * 1 validates on the calling thread (the default), 0 uses one worker per
+         * hardware thread. Also settable through the "threads" validation option.
+         * Must not be changed while a batch is running.
+         * 
+         * @param threads Worker thread count
+         */
+        void setThreadCount(size_t threads);
+
+        /**
+         * @brief Gets the configured worker thread count (0 = one per hardware thread)
+         * 
+         * @return Configured thread count
+         */
+        size_t getThreadCount() const;
+
+        /**
+         * @brief Enables the persistent validation cache and loads it
+         * 
+         * Results are keyed by absolute path, size, modification time and (with
+         * content hashing) a content hash, together with the rule version and the
+         * options that influence results. A cached result is reused only while the
+         * file and every file it depends on are unchanged. Also settable through the
+         * "cache_path" validation option; an empty path disables the cache.
+         * 
+         * @param cache_path JSON file holding the cache
+         */
+        void setCachePath(const std::string& cache_path);
+
+        /**
+         * @brief Gets the cache file path ("" when the cache is disabled)
+         * 
+         * @return Cache path
+         */
+        std::string getCachePath() const;
+
+        /**
+         * @brief Writes the cache if it changed since it was loaded or saved
+         * 
+         * Batch validation saves automatically; call this after validateAsset calls.
+         * The file is replaced atomically (temporary file + rename).
+         * 
+         * @return True if the cache is up to date on disk
+         */
+        bool saveCache();
+
+        /**
+         * @brief Drops every cached result (in memory; the file is rewritten on the next save)
+         */
+        void clearCache();
+
         /**
          * @brief Determines file type based on extension and content
          * 
@@ -200,6 +273,108 @@ namespace AssetManager {
         bool isTextureFile(const std::string& file_path);
 
     private:
+        /**
+         * @brief Per-thread validation counters, merged into the shared totals once per batch
+         */
+        struct ValidationCounters {
+            size_t files_validated = 0;
+            size_t issues_found = 0;
+            size_t files_with_errors = 0;
+            size_t files_with_warnings = 0;
+            size_t cache_hits = 0;                  ///< Results reused from the cache
+            size_t dependency_invalidations = 0;    ///< Unchanged files revalidated because a reference changed
+        };
+
+        /**
+         * @brief Identity of a file on disk at validation time
+         */
+        struct FileStamp {
+            std::string path;           ///< Absolute, normalized path
+            bool exists = false;
+            uint64_t size = 0;
+            int64_t modified = 0;       ///< Modification time in file-clock ticks
+        };
+
+        /**
+         * @brief One cached result with the identity of its file and dependencies
+         */
+        struct CacheEntry {
+            FileStamp stamp;
+            uint64_t content_hash = 0;              ///< 0 unless content hashing is enabled
+            ValidationResult result;
+            std::vector<FileStamp> dependencies;
+        };
+
+        /**
+         * @brief Validates one file, reusing its cached result when nothing it depends on changed
+         * 
+         * @param file_path Path to the asset file to validate
+         * @param counters Counters of the current thread (cache hits and invalidations)
+         * @return ValidationResult for the file
+         */
+        ValidationResult validateCached(const std::string& file_path, ValidationCounters& counters);
+
+        /**
+         * @brief Discards the cached results if the rules or result-relevant options changed
+         */
+        void syncCacheSignature();
+
+        /**
+         * @brief Describes the rule version and the options that change results
+         * 
+         * @return Signature string stored with the cache
+         */
+        std::string cacheSignature() const;
+
+        /**
+         * @brief Loads the cache file; a missing or damaged file yields an empty cache
+         */
+        void loadCache();
+
+        /**
+         * @brief Reads the identity of a file
+         * 
+         * @param path Path to the file
+         * @return Stamp with an absolute path; exists is false if the file cannot be stat'ed
+         */
+        static FileStamp stampFile(const std::string& path);
+
+        /**
+         * @brief Hashes file contents (CRC-32 and Adler-32, mixed with the size)
+         * 
+         * @param path Path to the file
+         * @return Content hash, 0 if the file cannot be read
+         */
+        static uint64_t contentHash(const std::string& path);
+
+        /**
+         * @brief Runs every check on one file without touching the statistics
+         * 
+         * Reads configuration only, so batch workers can call it concurrently.
+         * 
+         * @param file_path Path to the asset file to validate
+         * @return ValidationResult for the file
+         */
+        ValidationResult runValidation(const std::string& file_path);
+
+        /**
+         * @brief Adds one result to a set of counters
+         * 
+         * @param result Validation result to count
+         * @param counters Counters of the current thread
+         */
+        static void countResult(const ValidationResult& result, ValidationCounters& counters);
+
+        /**
+         * @brief Adds a thread's counters and elapsed time to the shared totals
+         * 
+         * Lock-free: each total is a relaxed atomic add, done once per thread and batch.
+         * 
+         * @param counters Counters to merge
+         * @param elapsed_us Wall time to add, in microseconds
+         */
+        void mergeCounters(const ValidationCounters& counters, uint64_t elapsed_us);
+
         /**
          * @brief Validates file integrity and basic properties
          * 
@@ -216,12 +391,22 @@ namespace AssetManager {
          * 
          * Performs format-specific validation for OBJ files, including
          * MTL file references, texture dependencies, and geometry validation.
+         * Geometry is checked in one streaming pass (OBJStreamValidator): index
+         * ranges, NaN/Inf coordinates, degenerate faces and unused vertices.
          * 
          * @param file_path Path to the OBJ file to validate
          * @param result Reference to ValidationResult to populate
          */
         void validateOBJFile(const std::string& file_path, ValidationResult& result);
 
+        /**
+         * @brief Formats the line numbers and first description of an OBJ issue kind
+         * 
+         * @param sample Issue sample from the OBJ scan
+         * @return Context string for the issue report
+         */
+        static std::string sampleContext(const OBJIssueSample& sample);
+
         /**
          * @brief Validates FBX file format and structure
          * 
@@ -295,10 +480,23 @@ namespace AssetManager {
 
         // Private member variables for configuration and state management
         std::map<std::string, std::any> validation_options_;  ///< Validation configuration options
-        std::map<std::string, std::any> validation_stats_;    ///< Validation performance statistics
+        std::atomic<size_t> files_validated_{0};              ///< Files validated so far
+        std::atomic<size_t> issues_found_{0};                 ///< Issues found so far
+        std::atomic<size_t> files_with_errors_{0};            ///< Files with at least one error
+        std::atomic<size_t> files_with_warnings_{0};          ///< Files with at least one warning
+        std::atomic<uint64_t> validation_time_us_{0};         ///< Wall time spent validating
         bool enable_detailed_validation_;                     ///< Flag for detailed validation mode
         bool check_texture_dependencies_;                     ///< Flag for texture dependency checking
         size_t max_file_size_mb_;                            ///< Maximum file size for validation
+        size_t thread_count_;                                 ///< Batch worker threads (0 = hardware threads)
+        bool hash_contents_;                                  ///< Hash contents so touched-but-unchanged files hit the cache
+        std::atomic<size_t> cache_hits_{0};                   ///< Results reused from the cache
+        std::atomic<size_t> dependency_invalidations_{0};     ///< Revalidations caused by changed references
+        mutable std::mutex cache_mutex_;                      ///< Guards the cache state below
+        std::string cache_path_;                              ///< Cache file ("" = cache disabled)
+        std::string cache_signature_;                         ///< Signature the cached results were produced under
+        std::unordered_map<std::string, CacheEntry> cache_;   ///< Absolute path -> cached result
+        bool cache_dirty_ = false;                            ///< Cache changed since it was loaded or saved
     };
 
 } // namespace AssetManager
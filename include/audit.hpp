@@ -76,7 +76,7 @@ private:
     void findDuplicates();
     void checkForMissingReferences(const std::filesystem::path& filePath, const std::string& ext);
     void categorizeFileByType(const std::filesystem::path& filePath, const std::string& ext, double sizeMB);
-    double getFileSizeMB(const std::filesystem::path& filePath) const;
+    double getFileSizeMB(const std::filesystem::directory_entry& entry) const;
     std::string formatFileSize(double sizeMB) const;
 
     // Utility: Get current timestamp as string
@@ -0,0 +1,37 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: crc32.hpp
+ * Description: Header file for Crc32, the standard CRC-32 (gzip/PNG, reflected polynomial 0xEDB88320) shared by
+ *              ImageIntegrityChecker (PNG chunk CRCs), AssetValidator (content hashes) and HistoryJournal
+ *              (record framing).
+ *
+ * Architecture:
+ * - Carry-less multiply folding (PCLMULQDQ) when the CPU has it, chosen once at runtime
+ * - Slicing-by-8 tables for tails and older CPUs; no zlib dependency, so the history targets stay lean
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AssetManager {
+
+class Crc32 {
+public:
+    // Continues from crc; update(0, data, size) starts a new one
+    static uint32_t update(uint32_t crc, const unsigned char* data, size_t size);
+    static bool hardwareAccelerated();
+
+private:
+    // Folds 16-byte blocks with carry-less multiplies; size is a multiple of 16 and at least 64
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    __attribute__((target("pclmul,sse4.1")))
+#endif
+    static uint32_t folded(uint32_t crc, const unsigned char* data, size_t size);
+    // Table-driven, on the running (inverted) register
+    static uint32_t sliced(uint32_t crc, const unsigned char* data, size_t size);
+};
+
+} // namespace AssetManager
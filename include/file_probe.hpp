@@ -0,0 +1,109 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: file_probe.hpp
+ * Description: Header file for FileProbeService, which reads a file's header region once and runs every
+ *              registered format probe on it. The indexer, validator, auditor and material manager share one
+ *              instance, so a file they all look at is opened and read once instead of once per subsystem.
+ *
+ * Architecture:
+ * - One read of up to 64 KiB per (path, size, mtime); JPEG extends the same read to 1 MiB when large EXIF
+ *   blocks hide the frame header
+ * - Texture headers are parsed with TextureHeaderProbe::parse; other formats are named probes that fill a
+ *   field map, and new ones can be registered at runtime
+ * - Results keep the first kRetainedBytes of the file for signature checks, then sit in a bounded LRU
+ * - A cache hit costs one stat() to confirm the file has not changed
+ *
+ * Key Features:
+ * - Built-in probes for FBX (binary/ASCII, version) and .blend (version, pointer size, endianness)
+ * - Thread-safe; workers may probe concurrently, the read itself happens outside the lock
+ * - Stats for hits, reads and bytes read so callers can see the I/O saved
+ */
+
+#pragma once
+
+#include "texture_probe.hpp"
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <any>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+namespace AssetManager {
+
+struct FileProbe {
+    std::string path;                   // absolute, normalized
+    std::string extension;              // lower-case, with the dot
+    bool exists = false;
+    bool is_regular = false;
+    bool opened = false;
+    bool read_failed = false;           // opened, but reading the header region failed
+    uint64_t size = 0;
+    int64_t modified = 0;               // file_time_type ticks
+    std::vector<unsigned char> head;    // first kRetainedBytes of the file (fewer if the file is shorter)
+    bool has_texture = false;           // texture holds a parsed image header
+    TextureHeader texture;
+    std::map<std::string, std::map<std::string, std::any>> formats;    // probe name -> fields, probes that matched
+};
+
+struct FileProbeStats {
+    size_t probes = 0;                  // probe() calls
+    size_t cache_hits = 0;
+    size_t files_read = 0;
+    size_t bytes_read = 0;
+    size_t evictions = 0;
+};
+
+class FileProbeService {
+public:
+    // Returns true and fills fields if it recognised the data; data is the file's header region
+    using FormatProbe = std::function<bool(const unsigned char* data, size_t size, const FileProbe& file,
+                                           std::map<std::string, std::any>& fields)>;
+
+    explicit FileProbeService(size_t capacity = 4096);
+
+    // Instance shared by every subsystem in the process
+    static FileProbeService& shared();
+
+    std::shared_ptr<const FileProbe> probe(const std::string& path);
+    // Cached result if the file is unchanged since it was probed; never reads the file
+    std::shared_ptr<const FileProbe> cached(const std::string& path);
+
+    void registerProbe(const std::string& name, FormatProbe probe);
+    FileProbeStats getStats() const;
+    void clearCache();
+
+    static constexpr size_t kReadBytes = 64 * 1024;
+    static constexpr size_t kJpegReadBytes = 1024 * 1024;
+    static constexpr size_t kRetainedBytes = 4096;
+
+private:
+    using CacheList = std::list<std::pair<std::string, std::shared_ptr<const FileProbe>>>;
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    CacheList lru_;                                             // most recently used first
+    std::unordered_map<std::string, CacheList::iterator> cache_;
+    std::vector<std::pair<std::string, FormatProbe>> probes_;
+    FileProbeStats stats_;
+
+    std::shared_ptr<const FileProbe> lookup(const FileProbe& stamp);
+    static std::shared_ptr<FileProbe> read(const FileProbe& stamp,
+                                           const std::vector<std::pair<std::string, FormatProbe>>& probes,
+                                           size_t& bytes_read);
+    void store(const std::shared_ptr<const FileProbe>& probe);
+
+    static FileProbe stampFile(const std::string& path);
+    static bool probeFBX(const unsigned char* data, size_t size, const FileProbe& file,
+                         std::map<std::string, std::any>& fields);
+    static bool probeBlend(const unsigned char* data, size_t size, const FileProbe& file,
+                           std::map<std::string, std::any>& fields);
+};
+
+} // namespace AssetManager
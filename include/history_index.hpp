@@ -0,0 +1,121 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: history_index.hpp
+ * Description: Header file for the HistoryIndex class, the in-memory store behind ImportHistory.
+ *              Entries live in a time-ordered log with hash indices by id, asset path and import type,
+ *              so lookups and filtered queries never scan or sort the whole history.
+ *
+ * Architecture:
+ * - Log is a power-of-two ring ordered by (timestamp, insertion); appends are the common case and stay O(1)
+ * - The oldest slots are popped off the ring head in O(1), so size- and age-based eviction never shift entries
+ * - Removal elsewhere tombstones a slot; the ring is compacted once tombstones outnumber live entries
+ * - Id index maps to a slot sequence number; asset and type indices hold ascending sequence numbers per key
+ * - HistoryRollup is updated on every insert and removal, so analytics never rescan the log
+ * - HistoryIdGenerator produces monotonic ULID-style ids (48-bit milliseconds + 80-bit counter/random)
+ *
+ * Key Features:
+ * - O(1) id lookup, existence checks and removal
+ * - Time-range queries by binary search over the log
+ * - Visitor and page APIs that walk newest-first without copying or sorting the history
+ * - Prefix removal (retention and max size) touches only the evicted slots
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <chrono>
+#include <deque>
+#include <cstdint>
+#include <random>
+#include "history_rollup.hpp"
+
+namespace AssetManager {
+
+struct ImportHistoryEntry;
+
+class HistoryIndex {
+public:
+    // Return false from a visitor to stop the walk
+    using Visitor = std::function<bool(const ImportHistoryEntry&)>;
+    using Predicate = std::function<bool(const ImportHistoryEntry&)>;
+
+    // Mutation; an entry whose id is already present replaces the old one
+    void insert(ImportHistoryEntry entry);
+    void insertBatch(std::vector<ImportHistoryEntry> entries);   // one merge however many are back-dated
+    void assign(std::vector<ImportHistoryEntry> entries);
+    void clear();
+    bool erase(const std::string& entry_id);
+    std::vector<std::string> eraseWhere(const Predicate& predicate);
+    std::vector<std::string> eraseBefore(const std::chrono::system_clock::time_point& cutoff);
+    std::vector<std::string> eraseOldest(size_t count);
+
+    // Lookup
+    const ImportHistoryEntry* find(const std::string& entry_id) const;
+    const ImportHistoryEntry* newest() const;
+    const ImportHistoryEntry* oldest() const;
+    std::pair<const ImportHistoryEntry*, const ImportHistoryEntry*> boundsInRange(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end) const;   // (oldest, newest) or nulls
+    bool containsAsset(const std::string& asset_path) const;     // at least one live entry for the asset
+    size_t size() const { return live_count_; }
+    bool empty() const { return live_count_ == 0; }
+
+    // Newest-first walks
+    void forEach(const Visitor& visitor) const;
+    void forEachByAsset(const std::string& asset_path, const Visitor& visitor) const;
+    void forEachByType(const std::string& import_type, const Visitor& visitor) const;
+    void forEachInRange(const std::chrono::system_clock::time_point& start,
+                        const std::chrono::system_clock::time_point& end,
+                        const Visitor& visitor) const;
+    std::vector<ImportHistoryEntry> page(size_t offset, size_t limit) const;
+
+    // Live entries, oldest first (persistence and export order)
+    std::vector<ImportHistoryEntry> entries() const;
+
+    // Incremental analytics over the live entries
+    const HistoryRollup& rollup() const { return rollup_; }
+
+private:
+    // Ring of slots in (timestamp, insertion) order; sequence number `seq` lives at
+    // logical index seq - base_seq_, i.e. ring_[(head_ + seq - base_seq_) & (ring_.size() - 1)]
+    std::vector<ImportHistoryEntry> ring_;
+    std::vector<bool> live_;
+    size_t head_ = 0;
+    size_t count_ = 0;        // occupied slots, live or tombstoned
+    size_t live_count_ = 0;
+    uint64_t base_seq_ = 0;   // sequence number of the oldest occupied slot
+    std::unordered_map<std::string, uint64_t> by_id_;
+    std::unordered_map<std::string, std::deque<uint64_t>> by_asset_;
+    std::unordered_map<std::string, std::deque<uint64_t>> by_type_;
+    HistoryRollup rollup_;
+
+    size_t physical(size_t logical) const { return (head_ + logical) & (ring_.size() - 1); }
+    size_t lowerBound(const std::chrono::system_clock::time_point& time) const;
+    size_t upperBound(const std::chrono::system_clock::time_point& time) const;
+    void pushBack(ImportHistoryEntry entry);
+    void trimFront();
+    void relayout(std::vector<ImportHistoryEntry> entries);
+    void mergeSorted(std::vector<ImportHistoryEntry> entries);
+    static void keepLastById(std::vector<ImportHistoryEntry>& entries);
+    std::vector<ImportHistoryEntry> takeLive();
+    void indexSlot(size_t logical);
+    void kill(size_t logical);
+    void compactIfSparse();
+    void walkSequences(const std::deque<uint64_t>& sequences, const Visitor& visitor) const;
+};
+
+class HistoryIdGenerator {
+public:
+    // "import_" followed by a 26-character Crockford base32 ULID; strictly increasing per process
+    static std::string next();
+
+private:
+    // Engine seeded from several random_device draws mixed with pid and clock
+    static std::mt19937_64 seededEngine();
+};
+
+} // namespace AssetManager
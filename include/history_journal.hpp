@@ -0,0 +1,148 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: history_journal.hpp
+ * Description: Header file for the HistoryJournal class, the append-only persistence layer behind ImportHistory.
+ *              Every history change becomes one small checksummed record appended to a journal, and the
+ *              journal is periodically compacted into a snapshot on a background thread.
+ *
+ * Architecture:
+ * - Three files per history path: "<path>.snapshot", "<path>.journal.sealed" and "<path>.journal"
+ * - Records are single-line JSON prefixed with a CRC32 (the shared Crc32), written with one
+ *   O_APPEND write each
+ * - Compaction seals the active journal, writes the snapshot to a temp file and renames it into place
+ * - Recovery replays snapshot, sealed journal and active journal in that order; replay is idempotent
+ * - Multi-process safe: every process appends to the same journal under a shared flock on "<path>.lock";
+ *   sealing takes it exclusively, and compaction is serialized by "<path>.compact.lock"
+ * - Snapshots are rebuilt from the files on disk, never from one process's in-memory copy
+ *
+ * Key Features:
+ * - O(1) writes per add, removal or clear instead of a full-history rewrite
+ * - Torn trailing records (crash mid-write) are detected by checksum and truncated away
+ * - Optional fdatasync per record for power-loss durability
+ * - Background compaction never blocks appends
+ * - tail() streams records appended by other processes since the last read, skipping its own
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+
+namespace AssetManager {
+
+struct ImportHistoryEntry;
+
+struct HistoryJournalStats {
+    size_t records_appended = 0;
+    uint64_t bytes_appended = 0;
+    size_t records_since_compaction = 0;
+    size_t compactions = 0;
+    size_t failed_compactions = 0;
+    size_t deferred_compactions = 0;   // another process held the compaction lock
+    size_t records_tailed = 0;
+    size_t records_replayed = 0;
+    size_t torn_records_discarded = 0;   // incomplete final records
+    size_t damaged_records_skipped = 0;  // checksum or framing failures in the middle of a file
+};
+
+class HistoryJournal {
+public:
+    explicit HistoryJournal(const std::string& history_path);
+    ~HistoryJournal();
+
+    HistoryJournal(const HistoryJournal&) = delete;
+    HistoryJournal& operator=(const HistoryJournal&) = delete;
+
+    // Record appends; each is one checksummed line
+    bool appendAdd(const ImportHistoryEntry& entry);
+    bool appendRemove(const std::vector<std::string>& entry_ids);
+    bool appendClear();
+
+    // Rebuilds the live entries (in insertion order) from snapshot and journals
+    bool recover(std::vector<ImportHistoryEntry>& entries);
+
+    // Applies records other processes appended since the last recover()/tail();
+    // false means the journal was sealed meanwhile and a full recover() is needed
+    bool tail(const std::function<void(const ImportHistoryEntry&)>& on_add,
+              const std::function<void(const std::vector<std::string>&)>& on_remove,
+              const std::function<void()>& on_clear);
+
+    // Compaction: seal the journal and fold snapshot + sealed journal into a new snapshot
+    bool shouldCompact(size_t live_entries) const;
+    void compactAsync();
+    bool compact();
+    void waitForCompaction();
+
+    void setDurableWrites(bool enable);
+    void setCompactionThreshold(size_t records);
+
+    HistoryJournalStats getStats() const;
+    std::string getJournalPath() const;
+    std::string getSnapshotPath() const;
+    bool hasStore() const;          // a snapshot or journal exists at the history path
+
+    // Entry <-> compact JSON line (shared with the snapshot format)
+    static std::string encodeEntry(const ImportHistoryEntry& entry);
+    static bool decodeEntry(const std::string& json_text, ImportHistoryEntry& entry);
+
+private:
+    enum class RecordOp { Add, Remove, Clear };
+    using RecordHandler = std::function<void(RecordOp op, uint64_t offset, ImportHistoryEntry& entry,
+                                             const std::vector<std::string>& ids)>;
+
+    struct ReplayState {
+        std::vector<ImportHistoryEntry> entries;
+        std::vector<bool> live;
+        std::unordered_map<std::string, size_t> positions;
+    };
+
+    static constexpr int kWriteAttempts = 3;   // whole-record writes before an append gives up
+
+    std::string journal_path_;
+    std::string sealed_path_;
+    std::string snapshot_path_;
+    std::string lock_path_;
+    std::string compact_lock_path_;
+    int journal_fd_ = -1;
+    int lock_fd_ = -1;
+    int compact_lock_fd_ = -1;
+    bool tail_ready_ = false;     // set by recover(); tail() needs a starting point
+    int tail_fd_ = -1;            // keeps the tailed journal's inode from being reused once it is sealed
+    uint64_t tail_inode_ = 0;     // active journal the tail offset refers to (0: absent)
+    uint64_t tail_offset_ = 0;
+    std::unordered_set<uint64_t> own_records_;   // offsets of this process's appends to the tailed journal
+    bool durable_writes_ = false;
+    size_t compaction_threshold_ = 4096;
+    HistoryJournalStats stats_;
+    std::thread compaction_thread_;
+    mutable std::mutex mutex_;
+
+    bool appendRecordLocked(const std::string& payload);
+    void terminateFragmentLocked();
+    bool openJournalLocked();
+    void closeJournalLocked();
+    bool sealJournalLocked();
+    bool tryBeginCompaction();
+    void endCompaction();
+    bool buildAndWriteSnapshot();
+    bool writeSnapshot(const std::vector<ImportHistoryEntry>& entries);
+    size_t replayFile(const std::string& path, bool truncate_torn_tail, ReplayState& state, bool& torn,
+                      size_t& damaged, uint64_t* end_offset = nullptr);
+    size_t readRecords(const std::string& path, uint64_t start_offset, const RecordHandler& handler,
+                       uint64_t& good_offset, bool& torn, size_t& damaged);
+    static void applyRecord(ReplayState& state, RecordOp op, ImportHistoryEntry& entry,
+                            const std::vector<std::string>& ids);
+    static bool lockFile(int& fd, const std::string& path, int operation);
+    static void unlockFile(int fd);
+    static uint64_t inodeOf(const std::string& path);
+    static std::string frameRecord(const std::string& payload);
+};
+
+} // namespace AssetManager
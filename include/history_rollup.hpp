@@ -0,0 +1,101 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: history_rollup.hpp
+ * Description: Header file for the HistoryRollup class, the incrementally maintained analytics behind
+ *              ImportHistory statistics. Counters are updated on every add and removal, so reports never
+ *              rescan the history.
+ *
+ * Architecture:
+ * - Running totals by outcome, import type and asset extension for the whole history
+ * - Hourly and daily buckets (UTC, keyed by hours/days since epoch) holding the same counters
+ * - AssetHeavyHitters: a Space-Saving sketch with a fixed number of counters for most-imported assets
+ * - Removals decrement the bucket of the removed entry's timestamp; empty buckets are dropped
+ *
+ * Key Features:
+ * - O(1) totals and O(buckets) window queries independent of history size
+ * - Windows are bucket-aligned: full days come from daily buckets, the partial edges from hourly ones
+ * - Top-k assets in O(k log k); exact while the number of distinct assets fits the sketch
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+
+namespace AssetManager {
+
+struct ImportHistoryEntry;
+
+struct HistoryRollupCounters {
+    size_t total = 0;
+    size_t successful = 0;
+    size_t failed = 0;
+    std::map<std::string, size_t> import_types;
+    std::map<std::string, size_t> asset_types;   // by file extension
+};
+
+class AssetHeavyHitters {
+public:
+    explicit AssetHeavyHitters(size_t capacity = 256);
+
+    void add(const std::string& asset_path);
+    void remove(const std::string& asset_path);
+    void clear();
+
+    // Highest estimated counts first; estimates never undercount a tracked asset
+    std::vector<std::pair<std::string, size_t>> top(size_t count) const;
+    size_t capacity() const { return capacity_; }
+    bool isExact() const { return !evicted_; }   // false from the first eviction until clear()
+
+private:
+    struct Counter {
+        std::multimap<size_t, std::string>::iterator position;
+        size_t error;
+    };
+
+    size_t capacity_;
+    bool evicted_ = false;
+    std::multimap<size_t, std::string> by_count_;
+    std::unordered_map<std::string, Counter> counters_;
+
+    void setCount(Counter& counter, const std::string& asset_path, size_t count);
+};
+
+class HistoryRollup {
+public:
+    explicit HistoryRollup(size_t heavy_hitter_capacity = 256);
+
+    void add(const ImportHistoryEntry& entry);
+    void remove(const ImportHistoryEntry& entry);
+    void clear();
+
+    // Queries
+    const HistoryRollupCounters& totals() const { return totals_; }
+    HistoryRollupCounters window(const std::chrono::system_clock::time_point& start,
+                                 const std::chrono::system_clock::time_point& end) const;
+    const AssetHeavyHitters& heavyHitters() const { return heavy_hitters_; }
+    size_t getBucketCount() const { return hourly_.size() + daily_.size(); }
+
+    static std::string assetType(const std::string& asset_path);
+
+private:
+    HistoryRollupCounters totals_;
+    std::map<int64_t, HistoryRollupCounters> hourly_;
+    std::map<int64_t, HistoryRollupCounters> daily_;
+    AssetHeavyHitters heavy_hitters_;
+
+    static void apply(HistoryRollupCounters& counters, const ImportHistoryEntry& entry,
+                      const std::string& asset_type, bool add);
+    static void merge(HistoryRollupCounters& into, const HistoryRollupCounters& from);
+    static void applyBucket(std::map<int64_t, HistoryRollupCounters>& buckets, int64_t key,
+                            const ImportHistoryEntry& entry, const std::string& asset_type, bool add);
+    static int64_t hourOf(const std::chrono::system_clock::time_point& time);
+    static int64_t floorDiv(int64_t value, int64_t divisor);
+};
+
+} // namespace AssetManager
@@ -0,0 +1,54 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: history_serializer.hpp
+ * Description: Header file for the HistorySerializer class, which reads and writes the ImportHistory JSON
+ *              export format. Writing escapes every string; reading is a streaming SAX parse that builds
+ *              entries directly without materializing a JSON document.
+ *
+ * Architecture:
+ * - Writer emits the established {"history": [ {...}, ... ]} layout field by field
+ * - Reader is a single-pass SAX tokenizer; a small depth/field state machine turns events into entries
+ * - Files are memory-mapped for reading and released window by window, so neither heap nor resident
+ *   memory tracks the size of the file text
+ *
+ * Key Features:
+ * - Round-trips every entry field: options, imported_objects and metadata included
+ * - JSON escaping of quotes, backslashes and control characters; invalid UTF-8 replaced with U+FFFD
+ * - Microsecond timestamps ("timestamp_us") alongside the legacy seconds field
+ * - Unknown keys and nested values are skipped, so newer exports still load
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include "import_history.hpp"
+
+namespace AssetManager {
+
+class HistorySerializer {
+public:
+    // Export
+    static void write(std::ostream& out, const std::vector<ImportHistoryEntry>& entries);
+    static std::string toJSON(const std::vector<ImportHistoryEntry>& entries);
+
+    // Import; `entries` is only replaced when the whole document parses
+    static bool parse(const std::string& json_data, std::vector<ImportHistoryEntry>& entries,
+                      std::string* error = nullptr);
+    static bool parseFile(const std::string& file_path, std::vector<ImportHistoryEntry>& entries,
+                          std::string* error = nullptr);
+
+private:
+    class SaxHandler;
+    class Reader;
+    // parseFile() drops mapped pages the Reader has moved past every this many bytes
+    static constexpr size_t kReleaseWindow = 64 * 1024 * 1024;
+    static bool parseRange(const char* begin, const char* end, std::vector<ImportHistoryEntry>& entries,
+                           std::string* error, size_t release_window);
+    static void writeString(std::ostream& out, const std::string& value);
+    static void writeStringMap(std::ostream& out, const std::map<std::string, std::string>& values);
+};
+
+} // namespace AssetManager
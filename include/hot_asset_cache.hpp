@@ -0,0 +1,160 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: hot_asset_cache.hpp
+ * Description: Header file for the HotAssetCache class, a local SSD cache tier for frequently imported assets.
+ *              Hot assets and their dependency closures are copied (or reflinked) from network storage into a
+ *              mirrored tree under a configurable cache root, and imports transparently read the local copy.
+ *
+ * Architecture:
+ * - Mirrored layout (cache_root + absolute source path) keeps relative MTL/texture references valid
+ * - One cache entry per asset; files shared between entries are reference counted
+ * - Admission driven by import frequency and a first-order Markov next-import predictor
+ * - LRU or LFU eviction under a byte capacity; manifest persisted in the cache root
+ * - Admissions copy on a background worker so the import path never waits for a copy
+ *
+ * Key Features:
+ * - resolve() returns the cached path when the asset and every cached dependency are unchanged (size + mtime)
+ * - FICLONE reflink when source and cache share a filesystem, plain copy otherwise
+ * - warmFromHistory() seeds the cache and predictor from ImportHistory
+ * - Hit/miss/stale/eviction counters and hit rate
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <set>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "import_history.hpp"
+
+namespace AssetManager {
+
+enum class CacheEvictionPolicy {
+    LRU,    // Evict the entry resolved longest ago
+    LFU     // Evict the entry with the fewest hits (ties broken by recency)
+};
+
+struct HotCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t stale = 0;               // Cached copies dropped because the source changed
+    size_t admissions = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    uint64_t bytes_cached = 0;
+    uint64_t capacity_bytes = 0;
+    double hit_rate = 0.0;          // hits / (hits + misses)
+};
+
+// First-order Markov model over the sequence of imported asset paths
+class NextImportPredictor {
+public:
+    void observe(const std::string& previous, const std::string& next);
+    void train(const std::vector<ImportHistoryEntry>& history);
+    std::vector<std::string> predict(const std::string& current, size_t count = 3) const;
+    void clear();
+
+private:
+    std::unordered_map<std::string, std::unordered_map<std::string, size_t>> transitions_;
+};
+
+class HotAssetCache {
+public:
+    // Returns the asset itself plus every file it references, as openable paths
+    using ClosureResolver = std::function<std::vector<std::string>(const std::string&)>;
+
+    HotAssetCache(const std::string& cache_root, uint64_t capacity_bytes,
+                  CacheEvictionPolicy policy = CacheEvictionPolicy::LRU);
+    ~HotAssetCache();
+
+    HotAssetCache(const HotAssetCache&) = delete;
+    HotAssetCache& operator=(const HotAssetCache&) = delete;
+
+    void setClosureResolver(ClosureResolver resolver);
+    void setAdmissionThreshold(size_t imports);     // Imports of an asset before it is admitted
+    void setPredictionFanout(size_t count);         // Predicted successors admitted per import
+
+    // Import-time lookup: cached copy if fresh, otherwise the original path
+    std::string resolve(const std::string& asset_path);
+    bool contains(const std::string& asset_path) const;
+
+    // Copy an asset and its closure into the cache now; false if it cannot fit or copy fails
+    bool admit(const std::string& asset_path);
+    // Feed an import into the frequency counters and predictor; may queue admissions
+    void recordImport(const std::string& asset_path);
+    // Train the predictor on past imports and queue the most frequently imported assets
+    void warmFromHistory(const std::vector<ImportHistoryEntry>& history, size_t top_n = 10);
+    std::vector<std::string> predictNext(const std::string& asset_path, size_t count = 3) const;
+
+    void waitIdle();
+    void shutdown();
+    void clear();
+
+    HotCacheStats getStats() const;
+    std::string getCacheRoot() const;
+    // Where a source file is (or would be) copied: cache root + absolute source path
+    std::string mirrorPath(const std::string& source) const;
+
+private:
+    struct CachedFile {
+        std::string source;
+        std::string cached;
+        uint64_t size = 0;          // source size and mtime when it was copied
+        int64_t mtime = 0;
+    };
+
+    struct Entry {
+        std::string source;
+        std::vector<CachedFile> files;      // asset first, then its dependency closure
+        uint64_t last_access = 0;
+        size_t hits = 0;
+    };
+
+    std::string cache_root_;
+    uint64_t capacity_bytes_;
+    CacheEvictionPolicy policy_;
+    ClosureResolver resolver_;
+    size_t admission_threshold_ = 2;
+    size_t prediction_fanout_ = 2;
+
+    std::map<std::string, Entry> entries_;
+    std::unordered_map<std::string, size_t> file_refs_;        // cached path → entries using it
+    std::unordered_map<std::string, uint64_t> file_sizes_;     // cached path → bytes
+    std::unordered_map<std::string, size_t> pinned_;           // cached path → copies in flight; never deleted
+    uint64_t bytes_cached_ = 0;
+    uint64_t access_tick_ = 0;
+    HotCacheStats stats_;
+
+    std::unordered_map<std::string, size_t> import_counts_;
+    std::string last_imported_;
+    NextImportPredictor predictor_;
+
+    std::deque<std::string> pending_;
+    std::set<std::string> queued_;
+    std::thread worker_;
+    bool worker_busy_ = false;
+    bool stopping_ = false;
+    mutable std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable idle_;
+
+    std::string normalize(const std::string& path) const;
+    bool copyFile(const std::string& source, const std::string& destination) const;
+    void releaseEntryLocked(const Entry& entry);
+    void evictLocked(const std::string& keep);
+    void scheduleLocked(const std::string& key);
+    void workerLoop();
+    void loadManifest();
+    void saveManifestLocked() const;
+    static bool statFile(const std::string& path, uint64_t& size, int64_t& mtime);
+};
+
+} // namespace AssetManager
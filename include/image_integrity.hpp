@@ -0,0 +1,61 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: image_integrity.hpp
+ * Description: Header file for ImageIntegrityChecker, which walks the structure of texture files to catch
+ *              truncation and corruption without decoding pixels. A PNG cut short by an interrupted NAS copy has
+ *              a valid signature and header, so magic-number checks pass it; its chunk list does not add up.
+ *
+ * Architecture:
+ * - The file is memory-mapped read-only and walked front to back once (sequential access hint)
+ * - Format is detected from magic bytes; TGA, which has none, from the extension
+ * - PNG chunk CRCs go through the shared Crc32 (PCLMULQDQ folding when the CPU has it)
+ *
+ * Key Features:
+ * - PNG: every chunk's length, type and CRC, IHDR first, IEND present
+ * - JPEG: marker segments through the entropy-coded data up to EOI
+ * - OpenEXR: header attributes and the chunk offset table of single-part images
+ * - TGA and BMP: header fields against the file size; TGA RLE packets are walked to the last pixel
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace AssetManager {
+
+struct ImageIntegrityReport {
+    bool opened = false;
+    std::string format;                 // ".png", ".jpg", ".exr", ".tga", ".bmp"; empty if not recognised
+    bool checked = false;               // structure was walked (false for unsupported formats or variants)
+    bool truncated = false;             // the structure runs past the end of the file
+    std::vector<std::string> problems;  // in file order, at most ImageIntegrityChecker::kMaxProblems
+    uint64_t bytes = 0;
+    uint64_t segments = 0;              // PNG chunks, JPEG segments, EXR chunks or TGA packets walked
+    double scan_ms = 0.0;
+};
+
+class ImageIntegrityChecker {
+public:
+    static ImageIntegrityReport check(const std::string& path);
+    static ImageIntegrityReport checkBuffer(const unsigned char* data, size_t size, const std::string& extension);
+
+    static constexpr size_t kMaxProblems = 8;
+
+private:
+    static void checkPNG(const unsigned char* data, size_t size, ImageIntegrityReport& report);
+    static void checkJPEG(const unsigned char* data, size_t size, ImageIntegrityReport& report);
+    static void checkEXR(const unsigned char* data, size_t size, ImageIntegrityReport& report);
+    static void checkTGA(const unsigned char* data, size_t size, ImageIntegrityReport& report);
+    static void checkBMP(const unsigned char* data, size_t size, ImageIntegrityReport& report);
+
+    static void problem(ImageIntegrityReport& report, const std::string& text);
+    static void truncated(ImageIntegrityReport& report, const std::string& what, uint64_t needed, uint64_t size);
+    static uint32_t readBE(const unsigned char* data, size_t bytes);
+    static uint32_t readLE(const unsigned char* data, size_t bytes);
+};
+
+} // namespace AssetManager
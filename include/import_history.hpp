@@ -11,6 +11,11 @@
  * - Integration with ImportManager for automatic tracking
  * - Configurable history retention and cleanup policies
  * - Thread-safe operations for concurrent import tracking
+ * - Append-only journal persistence (HistoryJournal) with background snapshot compaction
+ * - Multi-process history store: processes append to one flock-guarded journal and tail each other's records
+ * - Time-ordered indexed store (HistoryIndex) for O(1) id lookup and binary-searched time ranges
+ * - Ring-buffer retention: O(1) eviction of the oldest entries, expiry by whole hour segments
+ * - Incremental analytics (HistoryRollup): hourly/daily buckets and a top-k sketch of imported assets
  * - Extensible design for custom history operations
  *
  * Key Features:
@@ -33,6 +38,10 @@
 #include <filesystem>
 #include <optional>
 #include <set>
+#include <unordered_set>
+#include <functional>
+#include "history_journal.hpp"
+#include "history_index.hpp"
 
 namespace AssetManager {
 
@@ -83,10 +92,20 @@ public:
         const std::chrono::system_clock::time_point& start,
         const std::chrono::system_clock::time_point& end) const;
 
-    // Undo operations
+    // Paged and visitor access (newest first, no full copy or sort); return false to stop a walk
+    std::vector<ImportHistoryEntry> getHistoryPage(size_t offset, size_t limit) const;
+    void forEachEntry(const std::function<bool(const ImportHistoryEntry&)>& visitor) const;
+    void forEachEntryInRange(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end,
+        const std::function<bool(const ImportHistoryEntry&)>& visitor) const;
+
+    // Undo operations; objects are removed from the .blend named by the entry's "scene_file" metadata
+    // (recorded from ImportResult::scene_file when ImportOptions::scene_file was set), and entries with
+    // objects but no scene file are reported as unsupported
     UndoResult undoLastImport();
     UndoResult undoImport(const std::string& entry_id);
-    UndoResult undoImports(const std::vector<std::string>& entry_ids);
+    UndoResult undoImports(const std::vector<std::string>& entry_ids);   // one Blender run per scene file, one history update
     bool canUndo() const;
     std::vector<std::string> getUndoableEntries() const;
 
@@ -102,6 +121,9 @@ public:
 
     // History analysis and reporting
     HistoryStats getStats() const;
+    HistoryStats getStatsInRange(
+        const std::chrono::system_clock::time_point& start,
+        const std::chrono::system_clock::time_point& end) const;
     std::vector<std::string> getMostImportedAssets(size_t count = 10) const;
     std::vector<std::string> getRecentlyImportedAssets(size_t count = 10) const;
     std::map<std::string, size_t> getImportTypeDistribution() const;
@@ -113,6 +135,17 @@ public:
     std::string exportHistoryAsJSON() const;
     bool importHistoryFromJSON(const std::string& json_data);
 
+    // Journal-backed store at the history file path (appends per change, compacts in background)
+    // No store is open until setHistoryFilePath() names one; opening recovers it (adopting a legacy JSON
+    // history file at that path once) and recoverHistory() re-reads it from scratch
+    // Several processes may share one store; refreshHistory() applies what the others appended
+    bool recoverHistory();
+    bool refreshHistory();
+    bool compactHistory();
+    void setCompactionThreshold(size_t records);
+    void setDurableWrites(bool enable);
+    HistoryJournalStats getJournalStats() const;
+
     // Configuration
     void setMaxHistorySize(size_t max_size);
     void setRetentionPeriod(std::chrono::hours retention_hours);
@@ -127,17 +160,41 @@ public:
     bool isEmpty() const;
 
 private:
-    std::vector<ImportHistoryEntry> history_;
+    HistoryIndex history_;
     size_t max_history_size_;
     std::chrono::hours retention_period_;
     bool auto_cleanup_enabled_;
     std::string history_file_path_;
+    std::unique_ptr<HistoryJournal> journal_;
+    size_t compaction_threshold_;
+    bool durable_writes_;
+    
+    // Retention: expiry runs when the oldest hour segment ages out; size evictions are journaled in batches
+    static constexpr size_t kEvictionBatch = 64;
+    std::chrono::system_clock::time_point next_expiry_;
+    std::vector<std::string> pending_evictions_;
+    std::unordered_set<std::string> pending_eviction_ids_;
     
     // Internal helpers
+    HistoryJournal* journal();
+    void maybeCompact();
+    bool migrateLegacyHistory(HistoryJournal& store, std::vector<ImportHistoryEntry>& entries);
+    void replaceHistory(std::vector<ImportHistoryEntry> entries);
+    static void fillStats(HistoryStats& stats, const HistoryRollupCounters& counters);
+    void journalRemovals(const std::vector<std::string>& removed_ids);
+    std::vector<std::string> removeEntriesWhere(const std::function<bool(const ImportHistoryEntry&)>& predicate);
     void cleanupOldEntries();
     void enforceMaxSize();
+    void flushEvictions();
+    void rescheduleExpiry();
+    static std::chrono::system_clock::time_point segmentStart(const std::chrono::system_clock::time_point& time);
+    std::chrono::system_clock::time_point segmentExpiry(const std::chrono::system_clock::time_point& time) const;
     std::string generateUniqueId() const;
     bool removeEntryFromBlender(const ImportHistoryEntry& entry);
+    static std::string entrySceneFile(const ImportHistoryEntry& entry);
+    static bool isUndoable(const ImportHistoryEntry& entry);
+    bool removeObjectsFromBlender(const std::string& scene_file, const std::vector<std::string>& object_names,
+                                  bool purge_orphans);
     std::vector<std::string> getImportedObjectNames(const ImportHistoryEntry& entry) const;
 };
 
@@ -20,6 +20,10 @@
  * - Support for linking assets instead of importing
  * - Integration with material and collection management
  * - Detailed import result reporting and error handling
+ * - Per-stage import telemetry with rolling per-asset-type histograms
+ * - Dependency readahead as soon as imports are queued
+ * - Transparent local SSD hot-asset cache lookups
+ * - Texture atlas remapping: UV rewrite and one shared material per atlas page
  * - Extensible design for new import patterns and asset types
  */
 
@@ -32,9 +36,23 @@
 #include <any>
 #include <memory>
 #include <filesystem>
+#include <mutex>
+#include "import_telemetry.hpp"
+#include "dependency_prefetcher.hpp"
+#include "hot_asset_cache.hpp"
 
 namespace AssetManager {
 
+// Where an asset's textures ended up in a baked atlas (see TextureAtlasBuilder)
+struct AtlasRemap {
+    std::string material_name;                      // shared atlas material, created on first use
+    std::map<std::string, std::string> textures;    // "base_color", "normal", "orm" -> atlas page
+    float u_scale = 1.0f;                           // atlas_uv = uv * scale + offset
+    float v_scale = 1.0f;
+    float u_offset = 0.0f;
+    float v_offset = 0.0f;
+};
+
 struct ImportOptions {
     std::tuple<float, float, float> location = {0.0f, 0.0f, 0.0f};
     std::tuple<float, float, float> rotation = {0.0f, 0.0f, 0.0f};
@@ -44,6 +62,16 @@ struct ImportOptions {
     bool auto_smooth = true;
     std::string collection_name;
     bool link_instead_of_import = false;
+    // Absolute asset path -> (absolute image path -> replacement file, e.g. a lower-resolution variant);
+    // images are matched by full path and remapped before pixels are loaded
+    std::map<std::string, std::map<std::string, std::string>> texture_substitutions;
+    // Absolute asset path -> atlas placement; the render UV layer is remapped and the material replaced by the
+    // atlas material. Meshes with UVs outside [0,1] or more than one material slot are skipped
+    std::map<std::string, AtlasRemap> atlas_remaps;
+    // Target scene: the .blend is opened before the import (created if missing) and saved after it, so the
+    // objects persist and the import can be undone. The hot cache is bypassed so links point at the source.
+    // Empty: a blank scene that is discarded afterwards
+    std::string scene_file;
     // Extend with more options as needed
 };
 
@@ -52,6 +80,7 @@ struct ImportResult {
     bool success;
     std::string message;
     std::vector<std::string> imported_objects;
+    std::string scene_file;     // absolute path of the scene the objects were saved into; empty if none
     std::map<std::string, std::any> metadata;
 };
 
@@ -60,8 +89,8 @@ public:
     ImportManager();
     ~ImportManager();
 
-    // Import a single asset with options
-    ImportResult importAsset(const std::string& asset_path, const ImportOptions& options = {});
+    // Import a single asset with options; queue_prefetch=false when the caller already queued readahead for it
+    ImportResult importAsset(const std::string& asset_path, const ImportOptions& options = {}, bool queue_prefetch = true);
 
     // Bulk import assets in a grid pattern
     std::vector<ImportResult> importAssetsGrid(const std::vector<std::string>& asset_paths, const ImportOptions& options = {}, int rows = 1, int cols = 1, float spacing = 5.0f);
@@ -81,9 +110,32 @@ public:
     // Utility: Check if asset can be linked instead of imported
     bool canLinkAsset(const std::string& asset_path) const;
 
+    // Dependency readahead issued when imports are queued (optional)
+    void setPrefetcher(std::shared_ptr<DependencyPrefetcher> prefetcher);
+    std::shared_ptr<DependencyPrefetcher> getPrefetcher() const;
+
+    // Local hot-asset cache consulted before every import without a scene_file (optional)
+    void setHotAssetCache(std::shared_ptr<HotAssetCache> cache);
+    std::shared_ptr<HotAssetCache> getHotAssetCache() const;
+
+    // Telemetry: rolling histograms of stage timings per asset type
+    std::shared_ptr<ImportTelemetryRegistry> getTelemetryRegistry() const;
+    TelemetrySummary getTelemetrySummary(const std::string& asset_type, const std::string& metric) const;
+
 private:
     std::shared_ptr<class AssetManager> asset_manager_;
+    std::shared_ptr<ImportTelemetryRegistry> telemetry_;
+    std::shared_ptr<DependencyPrefetcher> prefetcher_;
+    std::shared_ptr<HotAssetCache> hot_cache_;
+    // One lock per scene_file: each import opens and saves the whole scene, so two at once would lose objects
+    std::mutex scene_locks_mutex_;
+    std::map<std::string, std::shared_ptr<std::mutex>> scene_locks_;
     // Internal helpers and state
+    ImportResult importSingle(const std::string& asset_path, const ImportOptions& options, bool queue_prefetch);
+    std::shared_ptr<std::mutex> sceneLock(const std::string& scene_path);
+    static double monotonicSeconds();
+    std::string assetTypeFor(const std::string& asset_path) const;
+    bool parseTelemetry(const std::string& output, double spawn_start, ImportTelemetry& telemetry) const;
 };
 
 } // namespace AssetManager 
\ No newline at end of file
@@ -0,0 +1,103 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: import_telemetry.hpp
+ * Description: Header file for structured import telemetry collected from every Blender import run.
+ *              Captures monotonic per-stage timings, I/O volume, datablock counts and worker memory,
+ *              and aggregates them into rolling per-asset-type histograms for regression tracking.
+ *
+ * Architecture:
+ * - ImportTelemetry value type attached to every ImportResult (also flattened into metadata)
+ * - Stage markers emitted by the Blender-side script and timestamped with time.monotonic()
+ * - Fixed log2 bucket histograms over a bounded rolling window of recent samples
+ * - Registry keyed by (asset type, metric) guarded by a single mutex
+ *
+ * Key Features:
+ * - Spawn, library load, link, transform, join and stdout-parse timings in milliseconds
+ * - Bytes read, objects and datablocks created, peak worker RSS
+ * - Rolling p50/p90/p99, mean, min/max and bucket counts per asset type
+ * - Cheap enough to record on every import (O(1) insert, O(window) summary)
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <any>
+#include <deque>
+#include <mutex>
+#include <cstdint>
+
+namespace AssetManager {
+
+struct ImportTelemetry {
+    std::string asset_type;            // Lower-case extension without the dot ("blend", "fbx", ...)
+    double spawn_ms = 0.0;             // popen() until the worker script starts executing
+    double library_load_ms = 0.0;      // bpy.data.libraries.load() / format importer
+    double link_ms = 0.0;              // Linking loaded datablocks into the scene
+    double transform_ms = 0.0;         // Applying location/rotation/scale/auto-smooth
+    double join_ms = 0.0;              // Object join + collection placement
+    double parse_ms = 0.0;             // Parsing worker stdout on the C++ side
+    double total_ms = 0.0;             // Wall time of the whole importAsset() call
+    uint64_t bytes_read = 0;           // Bytes read by the worker while loading the library
+    bool bytes_read_measured = false;  // False when the worker could not read /proc/self/io
+    size_t objects_created = 0;        // Objects linked into the scene
+    size_t datablocks_created = 0;     // Net new datablocks across bpy.data collections
+    long peak_worker_rss_kb = 0;       // Peak resident set size of the worker process
+
+    // Flatten into "telemetry.*" keys so generic metadata consumers can read it
+    void writeTo(std::map<std::string, std::any>& metadata) const;
+    // Named numeric view used by the histogram registry
+    std::map<std::string, double> metrics() const;
+};
+
+struct TelemetrySummary {
+    std::string asset_type;
+    std::string metric;
+    size_t count = 0;
+    double mean = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    std::vector<double> bucket_upper_bounds;   // Exclusive upper bound of each bucket (last is +inf)
+    std::vector<size_t> bucket_counts;
+};
+
+class RollingHistogram {
+public:
+    explicit RollingHistogram(size_t window_size = 256);
+
+    void add(double value);
+    TelemetrySummary summarize() const;
+    size_t size() const;
+
+    static const std::vector<double>& bucketBounds();
+
+private:
+    size_t window_size_;
+    std::deque<double> window_;
+    std::vector<size_t> bucket_counts_;
+
+    static size_t bucketFor(double value);
+};
+
+class ImportTelemetryRegistry {
+public:
+    explicit ImportTelemetryRegistry(size_t window_size = 256);
+
+    void record(const ImportTelemetry& telemetry);
+    TelemetrySummary getSummary(const std::string& asset_type, const std::string& metric) const;
+    std::vector<TelemetrySummary> getSummaries(const std::string& asset_type) const;
+    std::vector<std::string> getAssetTypes() const;
+    void clear();
+
+private:
+    size_t window_size_;
+    std::map<std::string, std::map<std::string, RollingHistogram>> histograms_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace AssetManager
@@ -0,0 +1,188 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: ingest_pipeline.hpp
+ * Description: Header file for the IngestPipeline class, a pipelined job-graph executor that carries assets
+ *              from disk into the scene: validate → prefetch → convert → import → materials → history.
+ *              Stages run concurrently on their own worker threads, connected by bounded queues, so that
+ *              CPU-bound validation and dependency readahead of item N+1 overlap with the
+ *              Blender-bound import of item N.
+ *
+ * Architecture:
+ * - One BoundedQueue between each pair of adjacent stages (blocking push = backpressure)
+ * - Per-stage worker count and queue capacity (StageConfig)
+ * - Default stage functions bound to AssetValidator, ImportManager, MaterialManager and ImportHistory
+ * - Any stage can be replaced with a custom StageFunction (e.g. a real converter)
+ * - Jobs that fail a stage skip the remaining work stages but still drain through the graph
+ *
+ * Key Features:
+ * - Overlapping validation, readahead, conversion, import, material assignment and history recording
+ * - Bounded memory regardless of batch size
+ * - Per-stage throughput, busy time, backpressure wait and queue high-water metrics
+ * - Results returned in input order
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include "import_manager.hpp"
+#include "material_manager.hpp"
+#include "asset_validator.hpp"
+#include "import_history.hpp"
+#include "dependency_prefetcher.hpp"
+
+namespace AssetManager {
+
+enum class IngestStage {
+    Validate,
+    Prefetch,
+    Convert,
+    Import,
+    Materials,
+    History
+};
+
+struct IngestJob {
+    size_t sequence = 0;                  // Position in the input batch
+    std::string asset_path;               // Source asset
+    std::string converted_path;           // Path handed to the importer (== asset_path unless converted)
+    ImportOptions options;
+    ValidationResult validation{};
+    ImportResult import_result{};
+    MaterialResult material_result{};
+    bool failed = false;
+    std::string failed_stage;             // Name of the stage that rejected the job
+    std::string message;
+};
+
+struct StageConfig {
+    size_t concurrency = 1;               // Worker threads for this stage
+    size_t queue_capacity = 4;            // Capacity of the queue feeding this stage
+};
+
+struct StageMetrics {
+    std::string name;
+    size_t concurrency = 0;
+    size_t processed = 0;                 // Jobs the stage function ran on
+    size_t failed = 0;                    // Jobs the stage function rejected
+    size_t skipped = 0;                   // Jobs passed through because an earlier stage failed
+    double busy_seconds = 0.0;            // Summed time inside the stage function
+    double backpressure_seconds = 0.0;    // Summed time blocked pushing into the next queue
+    double elapsed_seconds = 0.0;         // First job started → last job finished
+    double throughput_per_second = 0.0;   // processed / elapsed_seconds
+    size_t queue_high_water = 0;          // Deepest the input queue got
+};
+
+// Fixed-capacity MPMC queue; push blocks while full, pop blocks while empty and open
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity == 0 ? 1 : capacity) {}
+
+    // Returns seconds spent waiting for space
+    double push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto wait_start = std::chrono::steady_clock::now();
+        not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+        double waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - wait_start).count();
+        items_.push_back(std::move(item));
+        high_water_ = std::max(high_water_, items_.size());
+        not_empty_.notify_one();
+        return waited;
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+    size_t highWater() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return high_water_;
+    }
+
+private:
+    size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    size_t high_water_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+class IngestPipeline {
+public:
+    // Returns false to reject the job; set job.message to explain why
+    using StageFunction = std::function<bool(IngestJob&)>;
+
+    IngestPipeline();
+    ~IngestPipeline();
+
+    // Integration points used by the default stage functions
+    void setValidator(std::shared_ptr<AssetValidator> validator);
+    void setImportManager(std::shared_ptr<ImportManager> import_manager);
+    void setMaterialManager(std::shared_ptr<MaterialManager> material_manager);
+    void setImportHistory(std::shared_ptr<ImportHistory> import_history);
+    void setPrefetcher(std::shared_ptr<DependencyPrefetcher> prefetcher);
+
+    // Stage configuration
+    void setStageFunction(IngestStage stage, StageFunction function);
+    void setStageConfig(IngestStage stage, const StageConfig& config);
+    StageConfig getStageConfig(IngestStage stage) const;
+
+    // Run a batch through the graph; blocks until every job has left the last stage
+    std::vector<IngestJob> run(const std::vector<std::string>& asset_paths, const ImportOptions& options = {});
+
+    // Metrics of the most recent run, in stage order
+    std::vector<StageMetrics> getStageMetrics() const;
+
+    static std::string stageName(IngestStage stage);
+    static std::vector<IngestStage> stageOrder();
+
+private:
+    std::shared_ptr<AssetValidator> validator_;
+    std::shared_ptr<ImportManager> import_manager_;
+    std::shared_ptr<MaterialManager> material_manager_;
+    std::shared_ptr<ImportHistory> import_history_;
+    std::shared_ptr<DependencyPrefetcher> prefetcher_;
+
+    std::map<IngestStage, StageFunction> stage_functions_;
+    std::map<IngestStage, StageConfig> stage_configs_;
+    std::vector<StageMetrics> last_metrics_;
+    mutable std::mutex metrics_mutex_;
+    std::mutex history_mutex_;            // ImportHistory is mutated from the history stage only
+
+    // Default stage implementations
+    bool validateStage(IngestJob& job);
+    bool prefetchStage(IngestJob& job);
+    bool convertStage(IngestJob& job);
+    bool importStage(IngestJob& job);
+    bool materialsStage(IngestJob& job);
+    bool historyStage(IngestJob& job);
+    StageFunction resolveStageFunction(IngestStage stage);
+};
+
+} // namespace AssetManager
@@ -14,17 +14,23 @@
  * - Texture loading and assignment with automatic format detection
  * - PBR material creation with multiple map support (albedo, normal, roughness, etc.)
  * - Material validation and optimization
+ * - Batch creation: many materials in one Blender session, sharing image datablocks and texture nodes
+ * - Node-tree templates per node-graph shape, copied per material and kept in an optional .blend library
+ * - Texture discovery lists from the asset index when it covers a folder, probes headers on worker
+ *   threads and caches results per directory summary
  * - Thread-safe operations for concurrent material processing
  * 
  * Key Features:
  * - Create PBR materials with full parameter control
  * - Load and assign textures with automatic format detection
  * - Quick material setup with presets (metal, plastic, fabric, etc.)
- * - Auto-assign materials based on asset type and naming conventions
+ * - Auto-assign materials based on asset type and naming conventions (O(1) texture-set lookup)
  * - Material validation and optimization
  * - Integration with Blender material system
  * - Support for multiple texture formats (PNG, JPG, TGA, EXR, etc.)
  * - Material library management and reuse
+ * - Per-scene material registry: identical requests reuse one material, identical textures one image
+ * - CPU-rendered PBR preview spheres for presets and created materials, cached by parameter hash
  */
 
 #pragma once
@@ -36,6 +42,12 @@
 #include <tuple>
 #include <any>
 #include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <set>
+#include <cstdint>
+#include "texture_set_index.hpp"
+#include "material_preview.hpp"
 
 namespace AssetManager {
 
@@ -93,6 +105,23 @@ struct MaterialResult {
     std::map<std::string, std::any> metadata;
 };
 
+/**
+ * @brief A texture bound to a material slot
+ */
+struct TextureAssignment {
+    std::string texture_path;
+    std::string texture_type;  // "albedo", "normal", "roughness", "metallic", "ao", "emission", "displacement"
+    bool tiled = false;        // texture_path is the first tile of a UDIM set; loaded as a tiled image
+};
+
+/**
+ * @brief One material of a batch: its options plus texture assignments beyond the option slots
+ */
+struct MaterialSpec {
+    MaterialOptions options;
+    std::vector<TextureAssignment> textures;
+};
+
 /**
  * @brief Texture information and metadata
  */
@@ -106,6 +135,36 @@ struct TextureInfo {
     std::map<std::string, std::any> metadata;
 };
 
+/**
+ * @brief Counters for texture discovery and its caches
+ */
+struct TextureDiscoveryStats {
+    size_t directory_cache_hits = 0;  // Whole discoveries answered from the directory cache
+    size_t index_listings = 0;        // Discoveries listed from the asset index instead of the file system
+    size_t files_probed = 0;          // Headers read
+    size_t files_reused = 0;          // Unchanged files answered from the per-file cache
+    size_t decoder_fallbacks = 0;     // Files whose header was not understood (loaded through Blender)
+};
+
+/**
+ * @brief Counters for the per-scene material registry
+ */
+struct MaterialRegistryStats {
+    size_t materials_registered = 0;  // Materials created (or registered) under a parameter hash
+    size_t materials_reused = 0;      // Requests answered with an existing identical material
+    size_t textures_shared = 0;       // Texture paths redirected to a file with identical content
+    size_t unhashable_requests = 0;   // Requests with custom properties that cannot be hashed (never reused)
+};
+
+/**
+ * @brief Counters for node-tree template instancing
+ */
+struct MaterialTemplateStats {
+    size_t templates_compiled = 0;    // Templates built node by node in a Blender session
+    size_t templates_appended = 0;    // Templates appended ready-made from the template library
+    size_t materials_instanced = 0;   // Materials created by copying a template
+};
+
 /**
  * @brief Material preset definition
  */
@@ -128,11 +187,40 @@ public:
     MaterialResult createMaterial(const MaterialOptions& options);
     MaterialResult createPBRMaterial(const std::string& name, const MaterialOptions& options = {});
     MaterialResult createQuickMaterial(const std::string& name, const std::string& preset_type);
+    // One Blender session for the whole batch; results are in spec order
+    std::vector<MaterialResult> createMaterials(const std::vector<MaterialSpec>& specs);
+
+    // Per-scene registry: identical requests (quantized parameters, texture content) reuse the first material,
+    // and textures with identical content are always referenced through one path (one image datablock).
+    // The scene is a .blend that batches open and save into; without one nothing is registered or reused
+    void setScene(const std::string& scene_key);
+    std::string getScene() const;
+    void registerMaterial(const MaterialSpec& spec, const std::string& material_name);
+    std::string findRegisteredMaterial(const MaterialSpec& spec);
+    void clearMaterialRegistry();
+    MaterialRegistryStats getMaterialRegistryStats() const;
+
+    // Node-tree templates: each node-graph shape is compiled once per Blender session and copied per material;
+    // with a template library (.blend), sessions append the templates it holds instead of compiling them
+    void setTemplateLibrary(const std::string& library_path);
+    std::string getTemplateLibrary() const;
+    std::set<std::string> getResidentTemplates() const;
+    MaterialTemplateStats getTemplateStats() const;
+    static std::string templateKey(const MaterialSpec& spec);
+
+    // Preview spheres rendered on the CPU (no Blender), cached by parameter hash; cheap enough to call every frame.
+    // Presets by name, created or registered materials of the current scene by material name; nullptr if unknown
+    std::shared_ptr<const MaterialPreview> renderPreview(const MaterialSpec& spec, int size = 128);
+    std::shared_ptr<const MaterialPreview> renderPresetPreview(const std::string& preset_name, int size = 128);
+    std::shared_ptr<const MaterialPreview> renderMaterialPreview(const std::string& material_name, int size = 128);
+    MaterialPreviewStats getPreviewStats() const;
 
     // Texture handling
     TextureInfo loadTexture(const std::string& texture_path);
     MaterialResult assignTexture(const std::string& material_name, const std::string& texture_path, const std::string& texture_type);
     std::vector<TextureInfo> discoverTextures(const std::string& directory_path);
+    TextureDiscoveryStats getTextureDiscoveryStats() const;
+    void clearTextureCache();
 
     // Material presets
     std::vector<MaterialPreset> getAvailablePresets() const;
@@ -151,10 +239,61 @@ public:
 
     // Integration points
     void setAssetManager(std::shared_ptr<class AssetManager> manager);
+    // Library texture sets; when set, autoAssignMaterials looks textures up instead of scanning
+    void setTextureSetIndex(std::shared_ptr<const TextureSetIndex> texture_sets);
 
 private:
     std::shared_ptr<class AssetManager> asset_manager_;
+    std::shared_ptr<const TextureSetIndex> texture_sets_;
+    
+    // Texture discovery caches (directory summary -> results, path -> probed header)
+    struct TextureFileRecord {
+        std::string path;
+        uint64_t size;
+        int64_t modified;
+    };
+    struct CachedProbe {
+        uint64_t size;
+        int64_t modified;
+        TextureInfo info;
+    };
+    struct CachedDirectory {
+        uint64_t summary;
+        std::vector<TextureInfo> textures;
+    };
+    mutable std::mutex texture_cache_mutex_;
+    std::mutex blender_fallback_mutex_;   // one loadTexture() Blender run at a time
+    std::unordered_map<std::string, CachedDirectory> directory_cache_;
+    std::unordered_map<std::string, CachedProbe> probe_cache_;
+    TextureDiscoveryStats discovery_stats_;
     std::map<std::string, MaterialPreset> material_presets_;
+
+    // Material registry (scene -> parameter hash -> material) and file content hashes
+    struct SceneMaterials {
+        std::unordered_map<uint64_t, std::string> by_hash;
+        std::unordered_map<std::string, uint64_t> by_name;
+        std::unordered_map<uint64_t, std::string> textures;  // content hash -> first path used in the scene
+        std::unordered_map<std::string, MaterialSpec> specs; // material name -> spec it was created from
+    };
+    struct ContentHash {
+        uint64_t size;
+        int64_t modified;
+        uint64_t hash;
+    };
+    mutable std::mutex registry_mutex_;
+    std::mutex scene_file_mutex_;         // one batch at a time saves into a scene file
+    std::string scene_key_;               // absolute .blend path, or "" for a discarded session
+    std::unordered_map<std::string, SceneMaterials> scene_materials_;
+    std::unordered_map<std::string, ContentHash> content_hashes_;
+    MaterialRegistryStats registry_stats_;
+
+    // Template library and the templates it holds (library path -> template keys)
+    mutable std::mutex template_mutex_;
+    std::string template_library_;
+    std::map<std::string, std::set<std::string>> resident_templates_;
+    MaterialTemplateStats template_stats_;
+
+    std::unique_ptr<MaterialPreviewRenderer> preview_renderer_;
     
     // Internal helpers
     void initializeDefaultPresets();
@@ -162,6 +301,18 @@ private:
     std::string generateMaterialName(const std::string& base_name) const;
     bool validateTexturePath(const std::string& texture_path) const;
     std::string getTextureFormat(const std::string& texture_path) const;
+    static std::vector<TextureAssignment> collectTextureAssignments(const MaterialSpec& spec);
+    void loadTemplateManifest(const std::string& library_path);
+    void saveTemplateManifest(const std::string& library_path) const;
+    // Registry helpers; the caller holds registry_mutex_
+    MaterialSpec shareTextures(const MaterialSpec& spec, SceneMaterials& scene, bool record, std::vector<std::string>& shared);
+    bool hashMaterial(const MaterialSpec& spec, uint64_t& hash);
+    bool textureContentHash(const std::string& texture_path, uint64_t& hash);
+    static std::string uniqueMaterialName(const std::string& name, const SceneMaterials& scene,
+                                          const std::set<std::string>& reserved);
+    std::vector<TextureFileRecord> listTextureFiles(const std::filesystem::path& directory, bool& from_index) const;
+    static uint64_t summarizeTextureFiles(const std::vector<TextureFileRecord>& files);
+    TextureInfo probeTexture(const std::string& texture_path);
 };
 
 } // namespace AssetManager 
\ No newline at end of file
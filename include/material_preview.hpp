@@ -0,0 +1,147 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: material_preview.hpp
+ * Description: Header file for the MaterialPreviewRenderer class, a small native software shader that renders
+ *              PBR preview spheres for material presets and created materials without starting Blender.
+ *              Thumbnail-sized previews take a few milliseconds each, so a library of presets can be shown at once.
+ *
+ * Architecture:
+ * - Sphere geometry per size (normals, light/view dot products, UVs, edge coverage) is computed once and shared
+ * - Per material, the shading inputs are laid out as arrays (structure of arrays) and shaded 4 pixels per SSE2 op,
+ *   with a scalar loop for the tail and for hosts without SSE2
+ * - Previews are cached by the material's parameter hash and size, least recently used first out
+ *
+ * Key Features:
+ * - Lambert diffuse plus GGX specular (Smith-Schlick visibility, Schlick Fresnel), with a clearcoat lobe
+ * - One key light and a sky/ground hemisphere for ambient light and reflections, blurred by roughness
+ * - Optional albedo, roughness, metallic, AO and normal textures, sampled through the sphere's equirect UVs
+ * - Output is straight-alpha sRGB RGBA8 with an anti-aliased silhouette, ready for a GPU texture upload
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+namespace AssetManager {
+
+struct MaterialSpec;
+
+struct MaterialPreview {
+    int size = 0;                   // width and height in pixels
+    std::vector<uint8_t> rgba;      // size * size * 4, sRGB, straight alpha, top row first
+    uint64_t key = 0;               // material parameter hash the preview was cached under
+    double render_ms = 0.0;
+};
+
+struct MaterialPreviewStats {
+    size_t previews_rendered = 0;
+    size_t cache_hits = 0;
+    size_t textures_loaded = 0;     // texture files decoded for previews
+    size_t texture_failures = 0;    // texture files that could not be decoded (shaded as untextured)
+    double render_ms = 0.0;         // total time spent rendering
+};
+
+class MaterialPreviewRenderer {
+public:
+    explicit MaterialPreviewRenderer(size_t cache_capacity = 512);
+
+    // Cached under (key, size); key is the material's parameter hash
+    std::shared_ptr<const MaterialPreview> render(const MaterialSpec& spec, int size, uint64_t key);
+    // For materials without a parameter hash; never cached
+    std::shared_ptr<const MaterialPreview> renderUncached(const MaterialSpec& spec, int size);
+
+    MaterialPreviewStats getStats() const;
+    void clearCache();
+
+    static constexpr int kMinSize = 8;
+    static constexpr int kMaxSize = 1024;
+    static constexpr int kTextureSize = 256;    // textures are reduced to this longest edge before sampling
+
+private:
+    // Per-pixel terms of the unit sphere at one size; pixels outside the silhouette are left out
+    struct SphereGeometry {
+        int size = 0;
+        std::vector<uint32_t> pixels;   // index into the size x size image
+        std::vector<float> coverage;
+        std::vector<float> nx, ny, nz;
+        std::vector<float> ndotl, ndotv, ndoth;
+        std::vector<float> hemi_n;      // sky weight of the normal
+        std::vector<float> hemi_r;      // sky weight of the reflection vector
+        std::vector<float> fresnel_v;   // (1 - N.V)^5
+        std::vector<float> u, v;        // equirect UVs, v = 0 at the top
+    };
+
+    // Decoded texture reduced to kTextureSize, as linear floats
+    struct PreviewTexture {
+        uint64_t file_size = 0;
+        int64_t modified = 0;
+        int width = 0;
+        int height = 0;
+        int channels = 0;               // 1 (data) or 3 (color, normal)
+        std::vector<float> texels;
+    };
+
+    // Arrays the shading kernel reads and writes, one entry per silhouette pixel
+    struct ShadingLanes {
+        const float* ndotl;
+        const float* ndotv;
+        const float* ndoth;
+        const float* hemi_n;
+        const float* hemi_r;
+        const float* fresnel_v;
+        const float* albedo[3];
+        const float* roughness;
+        const float* metallic;
+        const float* ao;
+        float* out[3];
+    };
+
+    struct ShadingConstants {
+        float fresnel_h;                // (1 - V.H)^5; V and H are the same for every pixel
+        float dielectric_f0;
+        float diffuse_weight;           // 1 - transmission
+        float clearcoat;
+        float clearcoat_a2;
+        float clearcoat_k;
+        float light[3];
+        float sky[3];
+        float ground[3];
+        float emission[3];
+    };
+
+    using CacheList = std::list<std::pair<uint64_t, std::shared_ptr<const MaterialPreview>>>;
+
+    size_t cache_capacity_;
+    mutable std::mutex mutex_;
+    CacheList lru_;                                              // most recently used first
+    std::unordered_map<uint64_t, CacheList::iterator> cache_;
+    std::map<int, std::shared_ptr<const SphereGeometry>> geometry_;
+    std::unordered_map<std::string, std::shared_ptr<const PreviewTexture>> textures_;
+    MaterialPreviewStats stats_;
+
+    std::shared_ptr<MaterialPreview> shade(const MaterialSpec& spec, int size);
+    std::shared_ptr<const SphereGeometry> sphereGeometry(int size);
+    std::shared_ptr<const PreviewTexture> loadTexture(const std::string& path, int channels, bool srgb);
+
+    static std::shared_ptr<const SphereGeometry> buildGeometry(int size);
+    static void lightVectors(float light[3], float half[3]);
+    static void surfaceTerms(float nx, float ny, float nz, float terms[6]);
+    static std::string textureFor(const MaterialSpec& spec, const std::string& type);
+    static void sampleTexture(const PreviewTexture& texture, const SphereGeometry& geometry, int channel,
+                              float* out);
+    static void shadeLanes(const ShadingLanes& lanes, const ShadingConstants& constants, size_t count);
+    static void shadePixel(const ShadingLanes& lanes, const ShadingConstants& constants, size_t i);
+    static uint64_t cacheKey(uint64_t key, int size);
+    static int clampSize(int size);
+};
+
+} // namespace AssetManager
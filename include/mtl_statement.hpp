@@ -0,0 +1,75 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: mtl_statement.hpp
+ * Description: MTL texture-statement parser shared by the classes that follow .mtl texture references
+ *              (AssetValidator, AssetIndexer, DependencyPrefetcher).
+ *
+ * Key Features:
+ * - Recognizes every texture statement (map_Kd, map_d, map_Pr, bump, disp, norm, ...)
+ * - Skips the options in front of the file name, such as -bm 1.0 or -s 1 1 1
+ * - The file name is the rest of the statement, so names containing spaces survive
+ */
+
+#pragma once
+
+#include <string>
+#include <sstream>
+#include <unordered_set>
+#include <cctype>
+#include <cstdlib>
+
+namespace AssetManager {
+
+/**
+ * @brief Extracts the texture file named by an MTL statement.
+ *
+ * @param statement One MTL line; a trailing # comment and surrounding whitespace are ignored.
+ * @return Texture file name, or an empty string if the line is not a texture statement.
+ */
+inline std::string mtlTextureFile(const std::string& statement) {
+    std::istringstream iss(statement.substr(0, statement.find('#')));
+    std::string keyword;
+    iss >> keyword;
+    static const std::unordered_set<std::string> kTextureStatements = {
+        "map_Ka", "map_Kd", "map_Ks", "map_Ke", "map_Ns", "map_d", "map_bump", "map_Bump", "map_Pr", "map_Pm",
+        "map_Ps", "map_Pc", "map_Pcr", "map_aat", "bump", "disp", "decal", "norm", "refl"
+    };
+    if (kTextureStatements.count(keyword) == 0) {
+        return "";
+    }
+
+    // Options come first: -o/-s/-t take up to three numbers, -mm two, the rest one value
+    std::string token;
+    while (iss >> token) {
+        if (token.size() < 2 || token[0] != '-' || std::isdigit(static_cast<unsigned char>(token[1]))) {
+            break;
+        }
+        int max_values = (token == "-o" || token == "-s" || token == "-t") ? 3 : token == "-mm" ? 2 : 1;
+        for (int i = 0; i < max_values; ++i) {
+            std::streampos before = iss.tellg();
+            std::string value;
+            if (!(iss >> value)) break;
+            char* end = nullptr;
+            std::strtod(value.c_str(), &end);
+            bool numeric = end && *end == '\0';
+            if (i > 0 && !numeric) {
+                iss.clear();
+                iss.seekg(before);   // optional trailing value absent; this token is the next option or the file
+                break;
+            }
+        }
+        token.clear();
+    }
+    if (token.empty()) {
+        return "";
+    }
+
+    std::string rest;
+    std::getline(iss, rest);
+    std::string file = token + rest;
+    file.erase(file.find_last_not_of(" \t\r\n") + 1);
+    return file;
+}
+
+} // namespace AssetManager
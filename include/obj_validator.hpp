@@ -0,0 +1,77 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: obj_validator.hpp
+ * Description: Header file for OBJStreamValidator, a single-pass checker for Wavefront OBJ geometry. It catches
+ *              the exports that load "fine" in the validator and then crash a render node: face indices past the
+ *              end of the vertex list, index 0, NaN/Inf coordinates and collapsed faces.
+ *
+ * Architecture:
+ * - The file is memory-mapped and scanned once; pages behind the scan position are released every
+ *   kReleaseWindow bytes, so resident memory stays bounded on multi-GB files
+ * - Lines are split with memchr (vectorized in libc); numbers are checked for syntax and range without
+ *   converting them, which is all a validity check needs
+ * - Face, line and point indices, including negative (relative) ones, are resolved against the running
+ *   vertex, texture coordinate and normal counts
+ * - Memory is one bit per vertex (for the unused-vertex check) plus a few line numbers per issue kind
+ *
+ * Key Features:
+ * - Per-kind issue counts with the first kSampleLines line numbers and a description of the first case
+ * - Falls back to chunked buffered reads where the file cannot be mapped
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace AssetManager {
+
+struct OBJIssueSample {
+    uint64_t count = 0;
+    std::vector<uint64_t> lines;        // first OBJStreamValidator::kSampleLines line numbers, 1-based
+    std::string first;                  // what went wrong on the first line
+};
+
+struct OBJScanReport {
+    bool opened = false;
+    uint64_t bytes = 0;
+    uint64_t lines = 0;
+    uint64_t vertices = 0;
+    uint64_t texcoords = 0;
+    uint64_t normals = 0;
+    uint64_t faces = 0;
+    uint64_t unused_vertices = 0;
+    uint64_t first_unused_vertex = 0;   // 1-based vertex number, 0 if every vertex is referenced
+    std::vector<std::string> material_libraries;
+
+    OBJIssueSample index_out_of_range;  // refers past the elements defined so far
+    OBJIssueSample zero_index;          // OBJ indices start at 1
+    OBJIssueSample non_finite;          // nan, inf or out-of-range exponents in v/vt/vn
+    OBJIssueSample malformed;           // unparseable numbers, too few components
+    OBJIssueSample short_faces;         // faces with fewer than 3 corners
+    OBJIssueSample degenerate_faces;    // faces that use the same vertex twice
+    double scan_ms = 0.0;
+};
+
+class OBJStreamValidator {
+public:
+    static OBJScanReport scan(const std::string& path);
+    static OBJScanReport scanBuffer(const char* begin, const char* end);
+    // mtllib names from the header only: reading stops at the first geometry statement
+    static std::vector<std::string> materialLibraries(const std::string& path);
+
+    static constexpr size_t kSampleLines = 5;
+    static constexpr size_t kReleaseWindow = 64 * 1024 * 1024;
+    static constexpr size_t kReadChunk = 4 * 1024 * 1024;
+
+private:
+    class Scanner;
+
+    static bool scanMapped(const std::string& path, Scanner& scanner);
+    static bool scanBuffered(const std::string& path, Scanner& scanner);
+};
+
+} // namespace AssetManager
@@ -0,0 +1,40 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: python_literal.hpp
+ * Description: Quoting helper shared by the classes that generate Python scripts for Blender
+ *              (ImportManager import scripts, ImportHistory undo scripts).
+ *
+ * Key Features:
+ * - Paths and object names become double-quoted Python literals, so quotes, backslashes and
+ *   line breaks in them cannot end the string or inject code into the script
+ */
+
+#pragma once
+
+#include <string>
+
+namespace AssetManager {
+
+/**
+ * @brief Quotes a string for embedding in a generated Python script.
+ *
+ * @param value Raw string (e.g. a texture path or object name containing quotes or backslashes).
+ * @return Double-quoted Python literal.
+ */
+inline std::string pythonStringLiteral(const std::string& value) {
+    std::string literal = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"':  literal += "\\\""; break;
+            case '\\': literal += "\\\\"; break;
+            case '\n': literal += "\\n"; break;
+            case '\r': literal += "\\r"; break;
+            default:   literal += c; break;
+        }
+    }
+    literal += "\"";
+    return literal;
+}
+
+} // namespace AssetManager
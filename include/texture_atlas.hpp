@@ -0,0 +1,106 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: texture_atlas.hpp
+ * Description: Header file for the TextureAtlasBuilder class, which bakes the base-color, normal and ORM textures
+ *              of a group of small assets (scatter props) into shared atlas pages. Each page then needs one
+ *              material instead of one per asset, and the emitted UV remap table tells the import path where
+ *              each asset's textures ended up.
+ *
+ * Architecture:
+ * - One atlas item per texture set; assets sharing a set share its rectangle
+ * - Rectangles are packed with the skyline packer bundled with ImGui (imstb_rectpack.h), page after page
+ * - Padded rectangles are aligned to the mip block size and gutters repeat the item's edge texels
+ * - Pages are cropped to the power-of-two extent they use and written as PNG through TextureProcessor
+ *
+ * Key Features:
+ * - All channels of an item share one rectangle, so one UV transform serves base color, normal and ORM
+ * - Missing channels are filled with neutral values (white, flat normal, AO 1 / roughness 0.5 / metallic 0)
+ * - ORM is taken from a packed texture when available, otherwise packed from the AO/roughness/metallic maps
+ * - UV remap: atlas_uv = uv * scale + offset, in Blender's bottom-left UV convention
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include "texture_processor.hpp"
+
+namespace AssetManager {
+
+struct TextureAtlasOptions {
+    std::string cache_root;         // pages and the remap table are written below this directory
+    std::string name = "atlas";     // group name; prefixes page files and materials
+    int page_size = 4096;           // maximum page edge; pages are cropped to the extent they use
+    int max_item_size = 1024;       // items are downscaled so their longest edge fits this
+    int padding = 4;                // minimum gutter around each item, in texels
+    int mip_levels = 4;             // gutters and alignment keep this many mip levels free of bleeding
+};
+
+struct TextureAtlasItem {
+    std::string name;               // texture set stem or asset name
+    std::map<std::string, std::string> channels;   // "base_color", "normal", "orm", "ao", "roughness", "metallic"
+};
+
+struct TextureAtlasPage {
+    int index = 0;
+    int width = 0;
+    int height = 0;
+    std::string material_name;
+    std::map<std::string, std::string> textures;   // "base_color", "normal", "orm" -> page file
+};
+
+struct TextureAtlasPlacement {
+    std::string name;
+    int page = -1;                  // -1 if the item could not be baked
+    int x = 0;                      // content rectangle in page texels, top-left origin
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    float u_scale = 1.0f;
+    float v_scale = 1.0f;
+    float u_offset = 0.0f;
+    float v_offset = 0.0f;
+    std::string message;            // why the item was skipped
+};
+
+struct TextureAtlasResult {
+    bool success = false;
+    std::string message;
+    std::string table_path;         // JSON remap table
+    std::vector<TextureAtlasPage> pages;
+    std::vector<TextureAtlasPlacement> placements;   // one per input item, in input order
+    size_t source_textures = 0;     // distinct source files read
+    size_t source_materials = 0;    // items baked (one material each before atlasing)
+};
+
+class TextureAtlasBuilder {
+public:
+    explicit TextureAtlasBuilder(TextureAtlasOptions options);
+
+    TextureAtlasResult build(const std::vector<TextureAtlasItem>& items) const;
+
+    const TextureAtlasOptions& getOptions() const { return options_; }
+
+    // Channels written to every page
+    static const std::vector<std::string>& pageChannels();
+
+private:
+    TextureAtlasOptions options_;
+
+    // Item size from the source headers; the sources are decoded only when their page is baked
+    bool measureItem(const TextureAtlasItem& item, int& width, int& height, std::string& error) const;
+    bool loadItem(const TextureAtlasItem& item, int width, int height, std::map<std::string, ImageBuffer>& images,
+                  std::string& error) const;
+    static ImageBuffer toBytes(const ImageBuffer& image, int channels);
+    static void blitWithGutter(const ImageBuffer& image, ImageBuffer& page, int x, int y,
+                               int rect_x, int rect_y, int rect_width, int rect_height);
+    static int channelCount(const std::string& channel);
+    static const uint8_t* neutralTexel(const std::string& channel);
+    static int alignUp(int value, int alignment);
+    static int cropExtent(int used, int alignment, int limit);
+    bool writeTable(const TextureAtlasResult& result, const std::string& path, std::string& error) const;
+};
+
+} // namespace AssetManager
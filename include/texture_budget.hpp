@@ -0,0 +1,90 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: texture_budget.hpp
+ * Description: Header file for the TextureBudgetPlanner class, which estimates the texture memory an import batch
+ *              will need and picks lower-resolution cached variants until the batch fits a configured budget.
+ *
+ * Architecture:
+ * - Dependency closures, texture dimensions and available variants come from resolvers (the index in practice)
+ * - Textures shared by several assets of the batch are counted once
+ * - Over budget, the texture with the largest current footprint steps down to its next smaller variant, repeatedly
+ *
+ * Key Features:
+ * - Memory model follows Blender's image buffers: 4 channels per texel, float for HDR, plus a third for mipmaps
+ * - Reports estimated and planned bytes, substitutions (source -> variant) and the assets that were downgraded
+ * - Textures whose dimensions are unknown are reported rather than guessed
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <cstdint>
+
+namespace AssetManager {
+
+struct TextureFootprint {
+    std::string path;
+    int width = 0;                  // 0 when the dimensions are unknown
+    int height = 0;
+    int channels = 0;
+    int bit_depth = 8;
+    bool is_hdr = false;
+};
+
+struct TextureMemoryModel {
+    bool pad_to_rgba = true;        // Blender keeps 4 channels per texel whatever the file stores
+    bool include_mipmaps = true;    // GPU mip chains add a third on top of the base level
+};
+
+struct TextureBudgetEntry {
+    std::string texture_path;
+    std::string planned_path;       // texture_path, or the variant substituted for it
+    int width = 0;                  // source dimensions
+    int height = 0;
+    int planned_width = 0;
+    int planned_height = 0;
+    uint64_t estimated_bytes = 0;   // at source resolution
+    uint64_t planned_bytes = 0;     // at planned resolution
+    std::vector<std::string> used_by;
+};
+
+struct TextureBudgetPlan {
+    uint64_t budget_bytes = 0;                          // 0 = no budget, estimate only
+    uint64_t estimated_bytes = 0;                       // unique textures at source resolution
+    uint64_t planned_bytes = 0;                         // after substitutions
+    bool within_budget = true;
+    std::vector<TextureBudgetEntry> textures;           // largest estimate first
+    std::map<std::string, std::string> substitutions;   // source texture -> variant path
+    std::map<std::string, std::vector<std::string>> downgraded_assets;   // asset -> substituted textures
+    std::vector<std::string> unknown_textures;          // textures without dimensions; not counted
+};
+
+class TextureBudgetPlanner {
+public:
+    // Asset plus every file it references
+    using ClosureResolver = std::function<std::vector<std::string>(const std::string&)>;
+    // False for files that are not textures; true with width 0 for textures of unknown size
+    using TextureDescriber = std::function<bool(const std::string&, TextureFootprint&)>;
+    // Lower-resolution variants of a texture, in any order
+    using VariantResolver = std::function<std::vector<TextureFootprint>(const std::string&)>;
+
+    TextureBudgetPlanner(ClosureResolver closure, TextureDescriber describe, VariantResolver variants);
+
+    void setMemoryModel(const TextureMemoryModel& model);
+    const TextureMemoryModel& getMemoryModel() const;
+
+    TextureBudgetPlan plan(const std::vector<std::string>& asset_paths, uint64_t budget_bytes) const;
+    uint64_t estimateBytes(const TextureFootprint& texture) const;
+
+private:
+    ClosureResolver closure_;
+    TextureDescriber describe_;
+    VariantResolver variants_;
+    TextureMemoryModel model_;
+};
+
+} // namespace AssetManager
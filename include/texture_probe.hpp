@@ -0,0 +1,54 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: texture_probe.hpp
+ * Description: Header file for TextureHeaderProbe, which reads image dimensions and channel counts straight
+ *              from file headers. Texture discovery uses it instead of starting Blender for every file.
+ *
+ * Architecture:
+ * - Reads the first 64 KiB of a file (JPEG retries with up to 1 MiB when large EXIF blocks come first)
+ * - Format is detected from magic bytes; TGA, which has none, from the extension
+ * - Stateless and thread-safe; callers run probes on their own worker threads
+ *
+ * Key Features:
+ * - PNG, JPEG, TGA, BMP, DDS, Radiance HDR, OpenEXR and TIFF (first IFD within the read window)
+ * - Unsupported or damaged headers return false so callers can fall back to a full decoder
+ */
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace AssetManager {
+
+struct TextureHeader {
+    std::string format;     // lower-case extension style: ".png", ".jpg", ".exr"...
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    int bit_depth = 8;      // bits per channel sample (16 for half-float EXR, 32 for float)
+    bool is_hdr = false;
+};
+
+class TextureHeaderProbe {
+public:
+    static bool probe(const std::string& path, TextureHeader& header);
+    static bool parse(const unsigned char* data, size_t size, const std::string& extension, TextureHeader& header);
+
+private:
+    static bool parsePNG(const unsigned char* data, size_t size, TextureHeader& header);
+    static bool parseJPEG(const unsigned char* data, size_t size, TextureHeader& header);
+    static bool parseTGA(const unsigned char* data, size_t size, TextureHeader& header);
+    static bool parseBMP(const unsigned char* data, size_t size, TextureHeader& header);
+    static bool parseDDS(const unsigned char* data, size_t size, TextureHeader& header);
+    static bool parseHDR(const unsigned char* data, size_t size, TextureHeader& header);
+    static bool parseEXR(const unsigned char* data, size_t size, TextureHeader& header);
+    static bool parseTIFF(const unsigned char* data, size_t size, TextureHeader& header);
+
+    static uint32_t readBE(const unsigned char* data, size_t bytes);
+    static uint32_t readLE(const unsigned char* data, size_t bytes);
+};
+
+} // namespace AssetManager
@@ -0,0 +1,152 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: texture_processor.hpp
+ * Description: Header file for the TextureProcessor class, a native batch texture pipeline that writes
+ *              downscaled variants, mip chains and packed ORM (AO/roughness/metallic) textures to a variant cache.
+ *              Farm scenes can then reference 2K/1K variants instead of loading every 8K source.
+ *
+ * Architecture:
+ * - Decoders: PNG (libpng), JPEG (libjpeg), TGA and scanline OpenEXR (NONE/RLE/ZIPS/ZIP, zlib) natively
+ * - Separable resampler (Lanczos-3 or box) with a rolling window of filtered rows instead of a full intermediate
+ * - Vertical filter taps and 2x2 mip reduction use SSE2 when available, scalar loops otherwise
+ * - One worker per core pulls whole textures from a shared counter; a manifest in the cache root records outputs
+ *
+ * Key Features:
+ * - 8-bit sources stay 8-bit in memory; HDR (EXR) sources are filtered as float and written back as EXR
+ * - Variants are skipped when the source (size, mtime) and the options are unchanged since the last run
+ * - ORM packing resamples mismatched inputs to the largest one and fills missing channels with neutral defaults
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+namespace AssetManager {
+
+enum class ResampleFilter {
+    Box,
+    Lanczos3
+};
+
+struct ImageBuffer {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    bool is_float = false;          // HDR samples live in floats, everything else in bytes
+    std::vector<uint8_t> bytes;
+    std::vector<float> floats;
+
+    size_t sampleCount() const { return static_cast<size_t>(width) * height * channels; }
+    bool empty() const { return width <= 0 || height <= 0 || channels <= 0; }
+};
+
+struct TextureVariantOptions {
+    std::string cache_root;                             // variants are written below this directory
+    std::vector<int> max_sizes = {4096, 2048, 1024};    // longest edge of each variant; sizes >= the source are skipped
+    ResampleFilter filter = ResampleFilter::Lanczos3;
+    bool mip_chain = false;                             // also write every 2x2 box level down to 1x1
+    size_t threads = 0;                                 // 0 = one worker per hardware thread
+};
+
+struct TextureVariant {
+    std::string path;
+    std::string kind;               // "variant", "mip" or "orm"
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+};
+
+struct TextureJobResult {
+    std::string source_path;        // texture path, or the ORM output name for packing jobs
+    bool success = false;
+    bool from_cache = false;
+    std::string message;
+    std::vector<TextureVariant> variants;
+};
+
+struct OrmSources {
+    std::string name;               // output base name, e.g. the texture set stem
+    std::string ao;                 // any of the three may be empty
+    std::string roughness;
+    std::string metallic;
+};
+
+class TextureProcessor {
+public:
+    explicit TextureProcessor(TextureVariantOptions options);
+
+    // Batch jobs, run in parallel; results come back in input order
+    std::vector<TextureJobResult> generateVariants(const std::vector<std::string>& texture_paths);
+    std::vector<TextureJobResult> packORM(const std::vector<OrmSources>& sets);
+
+    const TextureVariantOptions& getOptions() const { return options_; }
+
+    // Codecs: decode picks by extension, encode writes PNG for 8-bit and EXR for float images
+    static bool decode(const std::string& path, ImageBuffer& image, std::string& error);
+    static bool encode(const std::string& path, const ImageBuffer& image, std::string& error);
+
+    // Filters
+    static ImageBuffer downsample2x(const ImageBuffer& image);
+    static ImageBuffer resize(const ImageBuffer& image, int width, int height, ResampleFilter filter);
+
+private:
+    // Separable filter taps: output coordinate i reads indices/weights [offsets[i], offsets[i + 1])
+    struct FilterTaps {
+        std::vector<size_t> offsets;
+        std::vector<int> indices;
+        std::vector<float> weights;
+    };
+
+    struct ManifestEntry {
+        std::string stamp;          // size and mtime of every source
+        std::string signature;      // options the outputs were produced with
+        std::vector<TextureVariant> variants;
+    };
+
+    TextureVariantOptions options_;
+    std::string signature_;
+    std::mutex manifest_mutex_;
+    std::map<std::string, ManifestEntry> manifest_;   // source path or "orm:" key -> outputs
+    bool manifest_loaded_ = false;
+
+    TextureJobResult processTexture(const std::string& source_path);
+    TextureJobResult processORM(const OrmSources& sources);
+    void runParallel(size_t count, const std::function<void(size_t)>& job) const;
+
+    // Variant cache manifest
+    void loadManifest();
+    void saveManifest();
+    std::string manifestPath() const;
+    bool lookupManifest(const std::string& key, const std::string& stamp, TextureJobResult& result);
+    void storeManifest(const std::string& key, const std::string& stamp, const TextureJobResult& result);
+    static std::string sourceStamp(const std::vector<std::string>& paths);
+    std::string outputDirectory(const std::string& key, const std::string& stem) const;
+    static std::string hashKey(const std::string& key);
+
+    // Resampling kernels
+    static FilterTaps computeTaps(int source_size, int target_size, ResampleFilter filter);
+    static void filterRow(const ImageBuffer& image, int row, const FilterTaps& taps, int target_width,
+                          std::vector<float>& scratch, float* out);
+    static void accumulateRow(float* accumulator, const float* row, float weight, size_t count);
+
+    static bool decodePNG(const std::string& path, ImageBuffer& image, std::string& error);
+    static bool decodeJPEG(const std::string& path, ImageBuffer& image, std::string& error);
+    static bool decodeTGA(const std::string& path, ImageBuffer& image, std::string& error);
+    static bool decodeEXR(const std::string& path, ImageBuffer& image, std::string& error);
+    static bool encodePNG(const std::string& path, const ImageBuffer& image, std::string& error);
+    static bool encodeEXR(const std::string& path, const ImageBuffer& image, std::string& error);
+    static bool readFile(const std::string& path, std::vector<uint8_t>& data);
+    static bool unpackEXRBlock(int compression, const uint8_t* data, size_t size, size_t expected,
+                               std::vector<uint8_t>& out);
+    static void packEXRBlock(const std::vector<uint8_t>& raw, std::vector<uint8_t>& out);
+    static float halfToFloat(uint16_t half);
+};
+
+} // namespace AssetManager
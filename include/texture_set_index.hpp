@@ -0,0 +1,78 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: texture_set_index.hpp
+ * Description: Header file for the TextureSetIndex class, which groups a library's textures into PBR texture sets
+ *              in one pass over the indexed paths. Material auto-assignment then looks an asset's set up in O(1)
+ *              instead of scanning its directory.
+ *
+ * Architecture:
+ * - Each texture name is split into stem, channel suffix, resolution token and UDIM tile
+ * - Channel suffixes come from the PBR mappings (channel -> suffix list, e.g. "normal" -> "_nrm")
+ * - Sets are keyed by directory + normalized stem; a per-directory map resolves assets with unmatched names
+ *
+ * Key Features:
+ * - Case and separator insensitive grouping ("Rock-Albedo", "rock_albedo" and "ROCK.albedo" share a set)
+ * - Channel names may span tokens: "Rock_Base_Color" and "Rock_Ambient_Occlusion" join "Rock_Normal"
+ * - UDIM tiles (name.1001.png, name_1001.png) collapse into one channel that points at its lowest tile
+ * - Resolution variants (_2k, _4k, _2048...) are kept per channel; the highest one is preferred
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+namespace AssetManager {
+
+struct TextureChannel {
+    std::string path;                                   // preferred file (highest resolution); UDIM: its lowest tile
+    std::map<std::string, std::string> resolutions;     // resolution token ("2k", "4096") -> path of that variant
+    std::vector<int> udim_tiles;                        // sorted tile numbers, empty if not a UDIM texture
+    std::string udim_pattern;                           // UDIM: `path` with the tile number replaced by "<UDIM>"
+};
+
+struct TextureSet {
+    std::string directory;
+    std::string stem;                                   // normalized: lower case, '_' separators
+    std::map<std::string, TextureChannel> channels;     // "base_color", "normal", "roughness"...
+};
+
+class TextureSetIndex {
+public:
+    TextureSetIndex();
+    explicit TextureSetIndex(std::map<std::string, std::vector<std::string>> suffix_mappings);
+
+    // One pass over the library's texture paths; replaces any previous sets
+    void build(const std::vector<std::string>& texture_paths);
+    void clear();
+
+    // Queries
+    const TextureSet* find(const std::string& directory, const std::string& stem) const;
+    const TextureSet* findForAsset(const std::string& asset_path) const;
+    std::vector<const TextureSet*> getSets() const;
+    size_t size() const { return sets_.size(); }
+
+    static std::map<std::string, std::vector<std::string>> defaultSuffixMappings();
+    static std::string normalizeStem(const std::string& stem);
+
+private:
+    struct ParsedName {
+        std::string stem;
+        std::string channel;
+        std::string resolution;
+        int udim_tile = 0;
+    };
+
+    std::vector<std::pair<std::string, std::string>> suffixes_;   // (suffix without separators, channel), longest first
+    std::unordered_map<std::string, TextureSet> sets_;            // directory + '\n' + stem
+    std::unordered_map<std::string, std::string> by_directory_;   // directory -> set key, "" if several sets
+
+    bool parseName(const std::string& filename, ParsedName& parsed) const;
+    static std::string setKey(const std::string& directory, const std::string& stem);
+    static size_t resolutionRank(const std::string& resolution);
+};
+
+} // namespace AssetManager
@@ -24,11 +24,16 @@
 
 #include "../../include/asset_indexer.hpp"
 #include "../../include/asset_manager.hpp"
+#include "../../include/file_probe.hpp"
+#include "../../include/mtl_statement.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <regex>
+#include <set>
+#include <cstring>
+#include <zlib.h>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
@@ -71,7 +76,10 @@ AssetIndexer::~AssetIndexer() = default;
  */
 bool AssetIndexer::scan_assets(const std::string& root_path, bool force_refresh) {
     try {
-        root_path_ = root_path;
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex_);
+            root_path_ = root_path;
+        }
         
         // Check if cache is still valid to avoid redundant scanning
         if (!force_refresh && is_cache_valid()) {
@@ -143,7 +151,10 @@ bool AssetIndexer::scan_assets(const std::string& root_path, bool force_refresh)
             asset_info.is_valid = true;
             
             // Store asset in optimized lookup maps
-            assets_by_path_[asset_info.path] = asset_info;
+            {
+                std::lock_guard<std::mutex> lock(cache_mutex_);
+                assets_by_path_[asset_info.path] = asset_info;
+            }
             update_categorization_maps(asset_info);
             assets_found++;
         }
@@ -162,7 +173,7 @@ bool AssetIndexer::scan_assets(const std::string& root_path, bool force_refresh)
         std::cout << "  - Total files scanned: " << files_scanned << std::endl;
         std::cout << "  - Total assets found: " << assets_found << std::endl;
         std::cout << "  - Scan duration: " << scan_duration.count() << " ms" << std::endl;
-        std::cout << "  - Scan rate: " << (files_scanned * 1000 / scan_duration.count()) << " files/sec" << std::endl;
+        std::cout << "  - Scan rate: " << (files_scanned * 1000 / std::max<long long>(1, scan_duration.count())) << " files/sec" << std::endl;
         
         return true;
         
@@ -238,6 +249,85 @@ std::optional<AssetInfo> AssetIndexer::get_asset_by_path(const std::string& path
     return std::nullopt;
 }
 
+/**
+ * @brief Resolves the full set of files an import of this asset will read
+ * 
+ * Starts from the asset itself, then follows dependencies transitively: the
+ * indexed dependency list when the scan recorded one, otherwise the format
+ * specific finders, and material files (.mtl/.mat/.material) are expanded into
+ * the textures they reference. Used to warm the page cache before an import.
+ * 
+ * @param path Asset path, either relative to the library root or absolute
+ * @return Openable paths (root-joined), asset first, without duplicates
+ * @note Missing files are omitted; the result is never empty for an existing asset
+ * @note Called from prefetch worker threads, so index reads hold cache_mutex_ and
+ *       never overlap a rescan or update on the owning thread
+ */
+std::vector<std::string> AssetIndexer::get_dependency_closure(const std::string& path) const {
+    std::vector<std::string> closure;
+    std::set<std::string> visited;
+    std::vector<std::filesystem::path> pending;
+    
+    std::string root_path;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        root_path = root_path_;
+    }
+    std::filesystem::path root(root_path);
+    std::filesystem::path start(path);
+    if (start.is_relative() && !root_path.empty() && !std::filesystem::exists(start)) {
+        start = root / start;
+    }
+    pending.push_back(start);
+    
+    auto to_full_path = [&root, &root_path](const std::string& dependency) {
+        std::filesystem::path dep(dependency);
+        return (dep.is_absolute() || root_path.empty()) ? dep : root / dep;
+    };
+    
+    try {
+        while (!pending.empty()) {
+            std::filesystem::path current = pending.back();
+            pending.pop_back();
+            std::string key = current.lexically_normal().string();
+            if (!visited.insert(key).second || !std::filesystem::exists(current)) {
+                continue;
+            }
+            closure.push_back(key);
+            
+            std::string extension = current.extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+            
+            std::vector<std::string> dependencies;
+            if (extension == ".mtl" || extension == ".mat" || extension == ".material") {
+                dependencies = find_material_dependencies(current);
+            } else {
+                // Prefer the indexed dependency list when the scan captured one
+                std::string relative = root_path.empty() ? current.string()
+                    : std::filesystem::relative(current, root).string();
+                {
+                    std::lock_guard<std::mutex> lock(cache_mutex_);
+                    auto it = assets_by_path_.find(relative);
+                    if (it != assets_by_path_.end()) {
+                        dependencies = it->second.dependencies;
+                    }
+                }
+                if (dependencies.empty()) {
+                    dependencies = find_dependencies(current);
+                }
+            }
+            // Reverse push keeps the closure in discovery order
+            for (auto dep = dependencies.rbegin(); dep != dependencies.rend(); ++dep) {
+                pending.push_back(to_full_path(*dep));
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to resolve dependency closure for " << path << ": " << e.what() << std::endl;
+    }
+    
+    return closure;
+}
+
 /**
  * @brief Checks if the current cache is still valid
  * 
@@ -265,7 +355,10 @@ bool AssetIndexer::is_cache_valid() const {
  * freeing memory in long-running applications.
  */
 void AssetIndexer::clear_cache() {
-    assets_by_path_.clear();
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        assets_by_path_.clear();
+    }
     assets_by_category_.clear();
     assets_by_type_.clear();
     cache_valid_ = false;
@@ -284,7 +377,10 @@ void AssetIndexer::update_asset(const std::string& path) {
     std::filesystem::path file_path(path);
     if (std::filesystem::exists(file_path) && is_supported_format(file_path)) {
         AssetInfo asset_info = create_asset_info(file_path);
-        assets_by_path_[asset_info.path] = asset_info;
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex_);
+            assets_by_path_[asset_info.path] = asset_info;
+        }
         update_categorization_maps(asset_info);
     }
 }
@@ -299,9 +395,34 @@ void AssetIndexer::update_asset(const std::string& path) {
  */
 void AssetIndexer::remove_asset(const std::string& path) {
     remove_from_categorization_maps(path);
+    std::lock_guard<std::mutex> lock(cache_mutex_);
     assets_by_path_.erase(path);
 }
 
+/**
+ * @brief Attaches a metadata value to an indexed asset
+ * 
+ * Used by subsystems that derive data from an asset after the scan (texture
+ * variants, packed ORM maps) so the link is visible through every lookup map.
+ * 
+ * @param path Relative path of the asset in the index
+ * @param key Metadata key
+ * @param value Metadata value
+ * @return False if the asset is not in the index
+ */
+bool AssetIndexer::set_asset_metadata(const std::string& path, const std::string& key, const std::any& value) {
+    std::unique_lock<std::mutex> lock(cache_mutex_);
+    auto it = assets_by_path_.find(path);
+    if (it == assets_by_path_.end()) {
+        return false;
+    }
+    it->second.metadata[key] = value;
+    lock.unlock();
+    remove_from_categorization_maps(path);
+    update_categorization_maps(it->second);
+    return true;
+}
+
 /**
  * @brief Saves the current asset index to a JSON file
  * 
@@ -396,7 +517,10 @@ bool AssetIndexer::load_cache_from_file(const std::string& cache_file_path) {
             asset.last_modified = std::chrono::system_clock::from_time_t(timestamp_seconds);
             
             // Rebuild index maps
-            assets_by_path_[asset.path] = asset;
+            {
+                std::lock_guard<std::mutex> lock(cache_mutex_);
+                assets_by_path_[asset.path] = asset;
+            }
             update_categorization_maps(asset);
         }
         
@@ -720,6 +844,8 @@ std::map<std::string, std::any> AssetIndexer::extract_metadata(const std::filesy
         metadata = extract_fbx_metadata(file_path);
     } else if (extension == ".blend") {
         metadata = extract_blend_metadata(file_path);
+    } else if (determine_asset_type(file_path) == "Texture") {
+        metadata = extract_texture_metadata(file_path);
     }
     
     return metadata;
@@ -745,6 +871,8 @@ std::vector<std::string> AssetIndexer::find_dependencies(const std::filesystem::
     // Route to format-specific dependency finders
     if (extension == ".obj") {
         dependencies = find_obj_dependencies(file_path);
+    } else if (extension == ".blend") {
+        dependencies = find_blend_dependencies(file_path);
     }
     
     return dependencies;
@@ -821,6 +949,31 @@ void AssetIndexer::remove_from_categorization_maps(const std::string& path) {
     }
 }
 
+/**
+ * @brief Extracts image dimensions from texture file headers
+ * 
+ * Reads only the header (no pixel decode), so indexing stays I/O bound.
+ * Texture-memory planning relies on these values to estimate imports
+ * without opening every image again.
+ * 
+ * @param file_path Path to the texture file
+ * @return Map with width, height, channels, bit_depth (int) and is_hdr (bool),
+ *         empty if the header is not understood
+ */
+std::map<std::string, std::any> AssetIndexer::extract_texture_metadata(const std::filesystem::path& file_path) const {
+    std::map<std::string, std::any> metadata;
+    auto probe = FileProbeService::shared().probe(file_path.string());
+    if (probe->has_texture) {
+        const TextureHeader& header = probe->texture;
+        metadata["width"] = header.width;
+        metadata["height"] = header.height;
+        metadata["channels"] = header.channels;
+        metadata["bit_depth"] = header.bit_depth;
+        metadata["is_hdr"] = header.is_hdr;
+    }
+    return metadata;
+}
+
 /**
  * @brief Extracts metadata from OBJ files
  * 
@@ -891,31 +1044,20 @@ std::map<std::string, std::any> AssetIndexer::extract_fbx_metadata(const std::fi
         metadata["format"] = "FBX";
         metadata["file_size"] = get_file_size(file_path);
         metadata["last_modified"] = get_file_modification_time(file_path);
-        // File header analysis for basic format validation
-        std::ifstream file(file_path, std::ios::binary);
-        if (file.is_open()) {
-            char header[23];
-            file.read(header, 22);
-            header[22] = '\0';
-            // Check for FBX signature
-            if (std::string(header) == "Kaydara FBX Binary") {
-                metadata["fbx_type"] = "Binary";
-                metadata["is_valid_fbx"] = true;
-            } else if (std::string(header).find("FBX") != std::string::npos) {
-                metadata["fbx_type"] = "ASCII";
-                metadata["is_valid_fbx"] = true;
-            } else {
-                metadata["fbx_type"] = "Unknown";
-                metadata["is_valid_fbx"] = false;
+        // Header analysis from the shared probe (one read per file across subsystems)
+        auto probe = FileProbeService::shared().probe(file_path.string());
+        auto fbx = probe->formats.find("fbx");
+        if (fbx != probe->formats.end()) {
+            bool binary = std::any_cast<bool>(fbx->second.at("binary"));
+            metadata["fbx_type"] = std::string(binary ? "Binary" : "ASCII");
+            metadata["is_valid_fbx"] = true;
+            auto version = fbx->second.find("version");
+            if (version != fbx->second.end() && std::any_cast<unsigned int>(version->second) > 0) {
+                metadata["fbx_version"] = std::any_cast<unsigned int>(version->second);
             }
-            // Read version information if available
-            file.seekg(23);
-            unsigned int version = 0;
-            file.read(reinterpret_cast<char*>(&version), sizeof(version));
-            if (version > 0) {
-                metadata["fbx_version"] = version;
-            }
-            file.close();
+        } else {
+            metadata["fbx_type"] = std::string("Unknown");
+            metadata["is_valid_fbx"] = false;
         }
         // Note: For detailed scene, object, and animation metadata, integration with the Autodesk FBX SDK is required. This implementation extracts all possible metadata using standard C++ file I/O.
     } catch (const std::exception& e) {
@@ -946,34 +1088,18 @@ std::map<std::string, std::any> AssetIndexer::extract_blend_metadata(const std::
         metadata["format"] = "Blend";
         metadata["file_size"] = get_file_size(file_path);
         metadata["last_modified"] = get_file_modification_time(file_path);
-        // File header analysis for basic format validation
-        std::ifstream file(file_path, std::ios::binary);
-        if (file.is_open()) {
-            char header[12];
-            file.read(header, 12);
-            // Check for Blender file signature
-            if (std::string(header, 7) == "BLENDER") {
-                metadata["blend_type"] = "Valid Blender File";
-                metadata["is_valid_blend"] = true;
-                // Extract version information
-                char version[3];
-                file.seekg(9);
-                file.read(version, 2);
-                version[2] = '\0';
-                metadata["blend_version"] = std::string(version);
-                // Extract pointer size and endianness
-                file.seekg(7);
-                char pointer_size = 0;
-                file.read(&pointer_size, 1);
-                metadata["pointer_size"] = (pointer_size == '_') ? 32 : 64;
-                char endianness = 0;
-                file.read(&endianness, 1);
-                metadata["endianness"] = (endianness == 'v') ? "Little" : "Big";
-            } else {
-                metadata["blend_type"] = "Invalid or Corrupted";
-                metadata["is_valid_blend"] = false;
-            }
-            file.close();
+        // Header analysis from the shared probe (one read per file across subsystems)
+        auto probe = FileProbeService::shared().probe(file_path.string());
+        auto blend = probe->formats.find("blend");
+        if (blend != probe->formats.end()) {
+            metadata["blend_type"] = std::string("Valid Blender File");
+            metadata["is_valid_blend"] = true;
+            metadata["blend_version"] = blend->second.at("version");
+            metadata["pointer_size"] = blend->second.at("pointer_size");
+            metadata["endianness"] = blend->second.at("endianness");
+        } else {
+            metadata["blend_type"] = std::string("Invalid or Corrupted");
+            metadata["is_valid_blend"] = false;
         }
         // Note: For detailed scene, object, and animation metadata, integration with the Blender Python API is required. This implementation extracts all possible metadata using standard C++ file I/O.
     } catch (const std::exception& e) {
@@ -1012,8 +1138,8 @@ std::vector<std::string> AssetIndexer::find_obj_dependencies(const std::filesyst
             
             while (std::getline(mtl_file, line)) {
                 // Look for texture map references in MTL file
-                if (line.substr(0, 7) == "map_Kd " || line.substr(0, 8) == "map_Bump ") {
-                    std::string texture_path = line.substr(line.find_last_of(' ') + 1);
+                std::string texture_path = mtlTextureFile(line);
+                if (!texture_path.empty()) {
                     auto full_texture_path = file_path.parent_path() / texture_path;
                     
                     if (std::filesystem::exists(full_texture_path)) {
@@ -1030,6 +1156,113 @@ std::vector<std::string> AssetIndexer::find_obj_dependencies(const std::filesyst
     return dependencies;
 }
 
+/**
+ * @brief Finds dependencies for Blender files
+ * 
+ * Walks the file's block headers and reads only the Image (IM) and Library (LI)
+ * blocks, taking the file paths stored in them: external textures and linked
+ * .blend libraries. Paths starting with "//" are relative to the .blend file.
+ * Reads legacy and Blender 5 (large block header) files, plain or gzip
+ * compressed; zstd-compressed files report no dependencies.
+ * 
+ * @param file_path Path to the .blend file
+ * @return Vector of dependency paths relative to the library root
+ */
+std::vector<std::string> AssetIndexer::find_blend_dependencies(const std::filesystem::path& file_path) const {
+    std::vector<std::string> dependencies;
+    
+    // gzread passes uncompressed files through unchanged
+    gzFile file = gzopen(file_path.string().c_str(), "rb");
+    if (!file) {
+        return dependencies;
+    }
+    gzbuffer(file, 1 << 16);
+    
+    /*
+     * Header: "BLENDER", then either pointer size ('_' 4, '-' 8), endianness ('v'/'V') and version
+     * (12 bytes), or "17-01v0500" for the Blender 5 layout (17 bytes, 64-bit block lengths).
+     * Block header: code, length, old pointer, SDNA index, count (legacy order);
+     * code, SDNA index, old pointer, length, count (large, all 64-bit after the first two).
+     */
+    unsigned char header[17] = {};
+    bool large = false;
+    size_t pointer_size = 8;
+    bool little_endian = true;
+    if (gzread(file, header, 12) == 12 && std::memcmp(header, "BLENDER", 7) == 0) {
+        large = header[7] >= '0' && header[7] <= '9';
+        if (large && gzread(file, header + 12, 5) != 5) {
+            header[0] = 0;
+        }
+        pointer_size = large || header[7] == '-' ? 8 : 4;
+        little_endian = (large ? header[12] : header[8]) == 'v';
+    } else {
+        header[0] = 0;
+    }
+    auto read_int = [little_endian](const unsigned char* data, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(data[little_endian ? i : bytes - 1 - i]) << (8 * i);
+        }
+        return value;
+    };
+    
+    const size_t block_header_size = large ? 32 : 16 + pointer_size;
+    std::set<std::string> seen;
+    std::vector<unsigned char> block;
+    unsigned char block_header[32];
+    while (header[0] != 0 && gzread(file, block_header, static_cast<unsigned>(block_header_size)) ==
+                                 static_cast<int>(block_header_size)) {
+        uint64_t length = large ? read_int(block_header + 16, 8) : read_int(block_header + 4, 4);
+        bool image = std::memcmp(block_header, "IM\0\0", 4) == 0;
+        bool library = std::memcmp(block_header, "LI\0\0", 4) == 0;
+        if (std::memcmp(block_header, "ENDB", 4) == 0) {
+            break;
+        }
+        // Small blocks are read through the buffer; seeking would discard it
+        if (!image && !library && length > (1u << 16)) {
+            if (gzseek(file, static_cast<z_off_t>(length), SEEK_CUR) < 0) {
+                break;
+            }
+            continue;
+        }
+        if (length > (1u << 24)) {
+            break;
+        }
+        block.resize(static_cast<size_t>(length));
+        if (gzread(file, block.data(), static_cast<unsigned>(length)) != static_cast<int>(length)) {
+            break;
+        }
+        if (!image && !library) {
+            continue;
+        }
+        
+        // The filepath field is a NUL-terminated "//relative" or absolute path; ID names start with the block code
+        for (size_t start = 0; start < block.size();) {
+            size_t end = start;
+            while (end < block.size() && block[end] >= 0x20) {
+                ++end;
+            }
+            std::string text(block.begin() + start, block.begin() + end);
+            start = end + 1;
+            if (end >= block.size() || text.size() < 3 || text.find('<') != std::string::npos) {
+                continue;
+            }
+            std::replace(text.begin(), text.end(), '\\', '/');
+            if (text.compare(0, 2, "//") == 0) {
+                text = text.substr(2);
+            } else if (!std::filesystem::path(text).is_absolute()) {
+                continue;
+            }
+            if (seen.insert(text).second) {
+                add_texture_dependency(text, file_path, dependencies);
+            }
+        }
+    }
+    gzclose(file);
+    
+    return dependencies;
+}
+
 /**
  * @brief Finds dependencies for material files
  * 
@@ -1055,27 +1288,9 @@ std::vector<std::string> AssetIndexer::find_material_dependencies(const std::fil
             std::string line;
             
             while (std::getline(mtl_file, line)) {
-                // Remove comments and trim whitespace
-                size_t comment_pos = line.find('#');
-                if (comment_pos != std::string::npos) {
-                    line = line.substr(0, comment_pos);
-                }
-                
-                // Look for texture map references
-                if (line.substr(0, 7) == "map_Kd ") {      // Diffuse texture
-                    std::string texture_path = line.substr(7);
-                    add_texture_dependency(texture_path, file_path, dependencies);
-                } else if (line.substr(0, 8) == "map_Bump ") { // Bump map
-                    std::string texture_path = line.substr(8);
-                    add_texture_dependency(texture_path, file_path, dependencies);
-                } else if (line.substr(0, 8) == "map_Ns ") {   // Specular map
-                    std::string texture_path = line.substr(8);
-                    add_texture_dependency(texture_path, file_path, dependencies);
-                } else if (line.substr(0, 9) == "map_d ") {    // Alpha map
-                    std::string texture_path = line.substr(9);
-                    add_texture_dependency(texture_path, file_path, dependencies);
-                } else if (line.substr(0, 10) == "map_Ka ") {  // Ambient map
-                    std::string texture_path = line.substr(10);
+                // Look for texture map references (every map_* statement, options skipped)
+                std::string texture_path = mtlTextureFile(line);
+                if (!texture_path.empty()) {
                     add_texture_dependency(texture_path, file_path, dependencies);
                 }
             }
@@ -28,6 +28,7 @@
 #include "../../include/asset_indexer.hpp"
 #include "../../include/import_manager.hpp"
 #include "../../include/material_manager.hpp"
+#include "../../include/texture_probe.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -49,12 +50,20 @@ namespace AssetManager {
 AssetManager::AssetManager() 
     : indexer_(std::make_unique<AssetIndexer>())
     , import_manager_(std::make_unique<ImportManager>())
+    , texture_budget_bytes_(0)
     , initialized_(false)
     , last_cache_update_(std::chrono::system_clock::now()) {
     
     // Initialize ImportManager with reference to this AssetManager
     import_manager_->setAssetManager(std::shared_ptr<AssetManager>(this, [](AssetManager*){}));
     
+    // Readahead for queued imports resolves dependency closures through the index
+    prefetcher_ = std::make_shared<DependencyPrefetcher>();
+    prefetcher_->setClosureResolver([this](const std::string& asset_path) {
+        return get_dependency_closure(asset_path);
+    });
+    import_manager_->setPrefetcher(prefetcher_);
+    
     // Initialize core subsystems
     // TODO: Initialize other subsystems when headers are created (DONE)
     // Initialize ImportManager (already done above)
@@ -80,7 +89,15 @@ AssetManager::AssetManager()
 /**
  * @brief Destructor - ensures proper cleanup of all subsystems
  */
-AssetManager::~AssetManager() = default;
+AssetManager::~AssetManager() {
+    // Prefetch and cache workers call back into the indexer; stop them before members go away
+    if (hot_cache_) {
+        hot_cache_->shutdown();
+    }
+    if (prefetcher_) {
+        prefetcher_->shutdown();
+    }
+}
 
 /**
  * @brief Initializes the asset manager with a specific assets root path
@@ -163,6 +180,7 @@ bool AssetManager::scan_assets(bool force_refresh) {
         bool success = indexer_->scan_assets(assets_root_path_, force_refresh);
         if (success) {
             last_cache_update_ = std::chrono::system_clock::now();
+            rebuild_texture_sets();
         }
         return success;
     } catch (const std::exception& e) {
@@ -226,6 +244,24 @@ std::optional<AssetInfo> AssetManager::get_asset_by_path(const std::string& path
     return indexer_->get_asset_by_path(path);
 }
 
+/**
+ * @brief Resolves every file an import of the asset will read
+ * 
+ * @param asset_path Asset path, relative to the library root or absolute
+ * @return The asset followed by its transitive dependencies (MTL files, textures)
+ * @note Falls back to the index-free closure before initialization or for
+ *       files outside the indexed library
+ */
+std::vector<std::string> AssetManager::get_dependency_closure(const std::string& asset_path) const {
+    if (initialized_) {
+        std::vector<std::string> closure = indexer_->get_dependency_closure(asset_path);
+        if (!closure.empty()) {
+            return closure;
+        }
+    }
+    return DependencyPrefetcher::defaultClosure(asset_path);
+}
+
 /**
  * @brief Validates an asset for integrity and completeness
  * 
@@ -703,6 +739,220 @@ void AssetManager::initialize_pbr_mappings() {
     pbr_texture_mappings_["specular"] = {"_specular", "_spec"};
 }
 
+/**
+ * @brief Regroups the indexed textures into PBR texture sets
+ * 
+ * Runs once per scan over the index's texture entries using the PBR suffix
+ * mappings, and hands the result to MaterialManager so material auto-assignment
+ * is a lookup rather than a directory scan.
+ */
+void AssetManager::rebuild_texture_sets() {
+    // Index paths are relative to the root; sets are keyed by absolute paths like the assets looked up
+    std::filesystem::path root = std::filesystem::absolute(assets_root_path_).lexically_normal();
+    std::vector<std::string> texture_paths;
+    for (const auto& asset : indexer_->get_assets_by_type("Texture")) {
+        texture_paths.push_back((root / asset.path).lexically_normal().string());
+    }
+    auto texture_sets = std::make_shared<TextureSetIndex>(pbr_texture_mappings_);
+    texture_sets->build(texture_paths);
+    texture_sets_ = texture_sets;
+    material_manager_->setTextureSetIndex(texture_sets_);
+}
+
+/**
+ * @brief Returns the texture sets built by the last successful scan
+ * 
+ * @return Shared texture set index, or nullptr before the first scan
+ */
+std::shared_ptr<const TextureSetIndex> AssetManager::get_texture_sets() const {
+    return texture_sets_;
+}
+
+/**
+ * @brief Writes downscaled variants of every indexed texture
+ * 
+ * Runs the batch TextureProcessor over the index's textures and records the
+ * written files on each source asset as metadata "texture_variants"
+ * (std::vector<std::string>). Keep options.cache_root outside the assets root,
+ * or the next scan indexes the variants as textures of their own.
+ * 
+ * @param options Variant sizes, filter, mip chain flag and cache root
+ * @return One result per indexed texture
+ */
+std::vector<TextureJobResult> AssetManager::generate_texture_variants(const TextureVariantOptions& options) {
+    std::filesystem::path root = std::filesystem::absolute(assets_root_path_).lexically_normal();
+    std::vector<std::string> relative_paths;
+    std::vector<std::string> texture_paths;
+    for (const auto& asset : indexer_->get_assets_by_type("Texture")) {
+        relative_paths.push_back(asset.path);
+        texture_paths.push_back((root / asset.path).lexically_normal().string());
+    }
+
+    TextureProcessor processor(options);
+    std::vector<TextureJobResult> results = processor.generateVariants(texture_paths);
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].success) {
+            continue;
+        }
+        std::vector<std::string> variant_paths;
+        for (const auto& variant : results[i].variants) {
+            variant_paths.push_back(variant.path);
+        }
+        indexer_->set_asset_metadata(relative_paths[i], "texture_variants", variant_paths);
+    }
+    return results;
+}
+
+/**
+ * @brief Packs AO, roughness and metallic of each texture set into an ORM texture
+ * 
+ * Uses the texture sets from the last scan. Sets with fewer than two of the
+ * three channels gain nothing from packing and are skipped, as are UDIM
+ * channels. Each source channel is linked to the packed file through metadata
+ * "orm_texture" (std::string).
+ * 
+ * @param options Cache root and worker count (sizes and filter are not used)
+ * @return One result per packed set
+ */
+std::vector<TextureJobResult> AssetManager::pack_orm_textures(const TextureVariantOptions& options) {
+    if (!texture_sets_) {
+        return {};
+    }
+    auto channelPath = [](const TextureSet& set, const std::string& channel) {
+        auto it = set.channels.find(channel);
+        return it == set.channels.end() || !it->second.udim_tiles.empty() ? std::string() : it->second.path;
+    };
+    std::vector<OrmSources> sources;
+    for (const TextureSet* set : texture_sets_->getSets()) {
+        OrmSources orm;
+        orm.name = set->stem.empty() ? std::filesystem::path(set->directory).filename().string() : set->stem;
+        orm.ao = channelPath(*set, "ao");
+        orm.roughness = channelPath(*set, "roughness");
+        orm.metallic = channelPath(*set, "metallic");
+        int present = !orm.ao.empty() + !orm.roughness.empty() + !orm.metallic.empty();
+        if (present >= 2) {
+            sources.push_back(orm);
+        }
+    }
+
+    TextureProcessor processor(options);
+    std::vector<TextureJobResult> results = processor.packORM(sources);
+    std::filesystem::path root = std::filesystem::absolute(assets_root_path_).lexically_normal();
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].success || results[i].variants.empty()) {
+            continue;
+        }
+        for (const std::string* path : {&sources[i].ao, &sources[i].roughness, &sources[i].metallic}) {
+            if (!path->empty()) {
+                indexer_->set_asset_metadata(std::filesystem::path(*path).lexically_relative(root).string(),
+                                             "orm_texture", results[i].variants.front().path);
+            }
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief Bakes the texture sets of a group of assets into shared atlas pages
+ * 
+ * Each asset contributes its texture set (assets sharing a set share one atlas
+ * rectangle). ORM comes from the "orm_texture" link written by pack_orm_textures
+ * when present, otherwise it is packed from the AO/roughness/metallic maps.
+ * Successfully baked assets are remembered: later imports of them rewrite their
+ * UVs into the atlas rectangle and use the page's shared material. UVs that tile
+ * outside [0, 1] cannot be atlased and will sample neighbouring items.
+ * 
+ * @param asset_paths Assets of the scatter group
+ * @param options Cache root, group name, page size and padding
+ * @return Pages, placements and the path of the JSON remap table
+ */
+TextureAtlasResult AssetManager::build_texture_atlas(const std::vector<std::string>& asset_paths, const TextureAtlasOptions& options) {
+    TextureAtlasResult result;
+    if (!texture_sets_) {
+        result.message = "No texture sets; scan the library first";
+        return result;
+    }
+    std::filesystem::path root = std::filesystem::absolute(assets_root_path_).lexically_normal();
+    auto channelPath = [](const TextureSet& set, const std::string& channel) {
+        auto it = set.channels.find(channel);
+        return it == set.channels.end() || !it->second.udim_tiles.empty() ? std::string() : it->second.path;
+    };
+
+    std::vector<TextureAtlasItem> items;
+    std::map<const TextureSet*, size_t> item_of_set;
+    std::vector<std::pair<std::string, size_t>> asset_items;
+    size_t unmatched = 0;
+    for (const auto& asset_path : asset_paths) {
+        std::string key = std::filesystem::absolute(asset_path).lexically_normal().string();
+        const TextureSet* set = texture_sets_->findForAsset(key);
+        if (!set) {
+            ++unmatched;
+            continue;
+        }
+        auto inserted = item_of_set.emplace(set, items.size());
+        if (inserted.second) {
+            TextureAtlasItem item;
+            item.name = set->stem.empty() ? std::filesystem::path(set->directory).filename().string() : set->stem;
+            for (const char* channel : {"base_color", "normal", "ao", "roughness", "metallic"}) {
+                std::string path = channelPath(*set, channel);
+                if (!path.empty()) {
+                    item.channels[channel] = path;
+                }
+            }
+            // A packed ORM from pack_orm_textures replaces the separate grey maps
+            for (const char* channel : {"roughness", "ao", "metallic"}) {
+                auto it = item.channels.find(channel);
+                if (it == item.channels.end()) {
+                    continue;
+                }
+                auto asset = indexer_->get_asset_by_path(std::filesystem::path(it->second).lexically_relative(root).string());
+                if (!asset) {
+                    continue;
+                }
+                auto orm = asset->metadata.find("orm_texture");
+                if (orm != asset->metadata.end() && orm->second.type() == typeid(std::string)) {
+                    item.channels["orm"] = std::any_cast<std::string>(orm->second);
+                    item.channels.erase("ao");
+                    item.channels.erase("roughness");
+                    item.channels.erase("metallic");
+                    break;
+                }
+            }
+            items.push_back(std::move(item));
+        }
+        asset_items.emplace_back(key, inserted.first->second);
+    }
+
+    result = TextureAtlasBuilder(options).build(items);
+    for (const auto& [asset_key, index] : asset_items) {
+        const TextureAtlasPlacement& placement = result.placements[index];
+        if (placement.page < 0) {
+            continue;
+        }
+        const TextureAtlasPage& page = *std::find_if(result.pages.begin(), result.pages.end(),
+            [&placement](const TextureAtlasPage& candidate) { return candidate.index == placement.page; });
+        AtlasRemap remap;
+        remap.material_name = page.material_name;
+        remap.textures = page.textures;
+        remap.u_scale = placement.u_scale;
+        remap.v_scale = placement.v_scale;
+        remap.u_offset = placement.u_offset;
+        remap.v_offset = placement.v_offset;
+        atlas_remaps_[asset_key] = remap;
+    }
+    if (unmatched > 0) {
+        result.message += " (" + std::to_string(unmatched) + " assets without a texture set were left out)";
+    }
+    return result;
+}
+
+/**
+ * @brief Forgets every atlas placement, so imports use the assets' own materials again
+ */
+void AssetManager::clear_texture_atlases() {
+    atlas_remaps_.clear();
+}
+
 /**
  * @brief Serializes any data type to JSON string
  * 
@@ -773,23 +1023,234 @@ std::shared_ptr<ImportManager> AssetManager::getImportManager() const {
 }
 
 ImportResult AssetManager::importAsset(const std::string& asset_path, const ImportOptions& options) {
-    return import_manager_->importAsset(asset_path, options);
+    std::vector<ImportResult> results = {import_manager_->importAsset(asset_path, apply_texture_atlases({asset_path}, apply_texture_budget({asset_path}, options)))};
+    report_texture_budget(results);
+    return results.front();
 }
 
 std::vector<ImportResult> AssetManager::importAssetsGrid(const std::vector<std::string>& asset_paths, const ImportOptions& options, int rows, int cols, float spacing) {
-    return import_manager_->importAssetsGrid(asset_paths, options, rows, cols, spacing);
+    auto results = import_manager_->importAssetsGrid(asset_paths, apply_texture_atlases(asset_paths, apply_texture_budget(asset_paths, options)), rows, cols, spacing);
+    report_texture_budget(results);
+    return results;
 }
 
 std::vector<ImportResult> AssetManager::importAssetsCircle(const std::vector<std::string>& asset_paths, const ImportOptions& options, float radius) {
-    return import_manager_->importAssetsCircle(asset_paths, options, radius);
+    auto results = import_manager_->importAssetsCircle(asset_paths, apply_texture_atlases(asset_paths, apply_texture_budget(asset_paths, options)), radius);
+    report_texture_budget(results);
+    return results;
 }
 
 std::vector<ImportResult> AssetManager::importAssetsLine(const std::vector<std::string>& asset_paths, const ImportOptions& options, float spacing) {
-    return import_manager_->importAssetsLine(asset_paths, options, spacing);
+    auto results = import_manager_->importAssetsLine(asset_paths, apply_texture_atlases(asset_paths, apply_texture_budget(asset_paths, options)), spacing);
+    report_texture_budget(results);
+    return results;
 }
 
 std::vector<ImportResult> AssetManager::importAssetsRandom(const std::vector<std::string>& asset_paths, const ImportOptions& options, int count, float area_size) {
-    return import_manager_->importAssetsRandom(asset_paths, options, count, area_size);
+    // Random picks are a subset of asset_paths, so planning for all of them is an upper bound
+    auto results = import_manager_->importAssetsRandom(asset_paths, apply_texture_atlases(asset_paths, apply_texture_budget(asset_paths, options)), count, area_size);
+    report_texture_budget(results);
+    return results;
+}
+
+/**
+ * @brief Sets the texture-memory budget applied to every import
+ * 
+ * @param budget_bytes Budget in bytes; 0 turns planning and substitution off
+ */
+void AssetManager::set_texture_memory_budget(uint64_t budget_bytes) {
+    texture_budget_bytes_ = budget_bytes;
+}
+
+uint64_t AssetManager::get_texture_memory_budget() const {
+    return texture_budget_bytes_;
+}
+
+/**
+ * @brief Estimates an import batch's texture memory and plans variant substitutions
+ * 
+ * Dependency closures and texture dimensions come from the index (headers are
+ * probed for textures it does not know); variants are those linked by
+ * generate_texture_variants, so run that after each scan to make them available.
+ * 
+ * @param asset_paths Assets of the batch
+ * @param budget_bytes Budget in bytes; 0 only estimates
+ * @return Plan with estimated and planned bytes, substitutions and downgraded assets
+ */
+TextureBudgetPlan AssetManager::plan_texture_budget(const std::vector<std::string>& asset_paths, uint64_t budget_bytes) const {
+    TextureBudgetPlanner planner(
+        [this](const std::string& asset_path) { return get_dependency_closure(asset_path); },
+        [this](const std::string& texture_path, TextureFootprint& texture) { return describe_texture(texture_path, texture); },
+        [this](const std::string& texture_path) { return cached_texture_variants(texture_path); });
+    return planner.plan(asset_paths, budget_bytes);
+}
+
+/**
+ * @brief Returns the plan made for the most recent import under a budget
+ * 
+ * @return Last plan; empty if no budgeted import has run
+ */
+TextureBudgetPlan AssetManager::get_last_texture_budget_plan() const {
+    return last_texture_budget_plan_;
+}
+
+bool AssetManager::describe_texture(const std::string& texture_path, TextureFootprint& texture) const {
+    if (indexer_->determine_asset_type(texture_path) != "Texture") {
+        return false;
+    }
+    texture.path = texture_path;
+    std::filesystem::path root = std::filesystem::absolute(assets_root_path_).lexically_normal();
+    auto asset = indexer_->get_asset_by_path(std::filesystem::path(texture_path).lexically_relative(root).string());
+    if (asset && asset->metadata.count("width")) {
+        auto read = [&asset](const char* key, auto& value) {
+            auto it = asset->metadata.find(key);
+            if (it != asset->metadata.end() && it->second.type() == typeid(value)) {
+                value = std::any_cast<std::decay_t<decltype(value)>>(it->second);
+            }
+        };
+        read("width", texture.width);
+        read("height", texture.height);
+        read("channels", texture.channels);
+        read("bit_depth", texture.bit_depth);
+        read("is_hdr", texture.is_hdr);
+        return true;
+    }
+    // Outside the index (or indexed before dimensions were recorded): read the header
+    TextureHeader header;
+    if (TextureHeaderProbe::probe(texture_path, header)) {
+        texture.width = header.width;
+        texture.height = header.height;
+        texture.channels = header.channels;
+        texture.bit_depth = header.bit_depth;
+        texture.is_hdr = header.is_hdr;
+    }
+    return true;
+}
+
+std::vector<TextureFootprint> AssetManager::cached_texture_variants(const std::string& texture_path) const {
+    std::vector<TextureFootprint> variants;
+    std::filesystem::path root = std::filesystem::absolute(assets_root_path_).lexically_normal();
+    auto asset = indexer_->get_asset_by_path(std::filesystem::path(texture_path).lexically_relative(root).string());
+    if (!asset) {
+        return variants;
+    }
+    auto it = asset->metadata.find("texture_variants");
+    if (it == asset->metadata.end() || it->second.type() != typeid(std::vector<std::string>)) {
+        return variants;
+    }
+    for (const auto& variant_path : std::any_cast<const std::vector<std::string>&>(it->second)) {
+        TextureHeader header;
+        if (TextureHeaderProbe::probe(variant_path, header)) {
+            variants.push_back({variant_path, header.width, header.height, header.channels, header.bit_depth, header.is_hdr});
+        }
+    }
+    return variants;
+}
+
+/**
+ * @brief Adds the budget's texture substitutions to an import's options
+ * 
+ * Each downgraded asset gets only the substitutions of its own textures, so an
+ * image shared by name with another asset is left alone. Substitutions the
+ * caller already set take precedence.
+ * 
+ * @param asset_paths Assets about to be imported
+ * @param options Caller's import options
+ * @return Options to import with
+ */
+ImportOptions AssetManager::apply_texture_budget(const std::vector<std::string>& asset_paths, const ImportOptions& options) {
+    if (texture_budget_bytes_ == 0) {
+        return options;
+    }
+    last_texture_budget_plan_ = plan_texture_budget(asset_paths, texture_budget_bytes_);
+    ImportOptions planned = options;
+    for (const auto& [asset, textures] : last_texture_budget_plan_.downgraded_assets) {
+        auto& substitutions = planned.texture_substitutions[std::filesystem::absolute(asset).lexically_normal().string()];
+        for (const auto& texture : textures) {
+            substitutions.emplace(texture, last_texture_budget_plan_.substitutions.at(texture));
+        }
+    }
+    return planned;
+}
+
+/**
+ * @brief Records the budget outcome on each import result
+ * 
+ * Adds "downgraded_textures" (std::vector<std::string>, empty unless the import
+ * succeeded), "texture_memory_planned_bytes" and "texture_memory_within_budget"
+ * to the result metadata.
+ * 
+ * @param results Results of the import that apply_texture_budget planned
+ */
+void AssetManager::report_texture_budget(std::vector<ImportResult>& results) const {
+    if (texture_budget_bytes_ == 0) {
+        return;
+    }
+    for (auto& result : results) {
+        auto it = last_texture_budget_plan_.downgraded_assets.find(result.asset_path);
+        result.metadata["downgraded_textures"] = result.success && it != last_texture_budget_plan_.downgraded_assets.end()
+            ? it->second : std::vector<std::string>();
+        result.metadata["texture_memory_planned_bytes"] = last_texture_budget_plan_.planned_bytes;
+        result.metadata["texture_memory_within_budget"] = last_texture_budget_plan_.within_budget;
+    }
+}
+
+/**
+ * @brief Adds the atlas placements of the batch's assets to the import options
+ * 
+ * Placements the caller already set are kept.
+ * 
+ * @param asset_paths Assets of the batch
+ * @param options Caller's options
+ * @return Options with atlas remaps for every atlased asset of the batch
+ */
+ImportOptions AssetManager::apply_texture_atlases(const std::vector<std::string>& asset_paths, const ImportOptions& options) const {
+    if (atlas_remaps_.empty()) {
+        return options;
+    }
+    ImportOptions remapped = options;
+    for (const auto& asset_path : asset_paths) {
+        auto it = atlas_remaps_.find(std::filesystem::absolute(asset_path).lexically_normal().string());
+        if (it != atlas_remaps_.end()) {
+            remapped.atlas_remaps.insert(*it);
+        }
+    }
+    return remapped;
+}
+
+/**
+ * @brief Enables the local SSD cache tier for imports
+ * 
+ * Hot assets (by import frequency and predicted next import) are copied with
+ * their dependency closures under cache_root; ImportManager then reads the
+ * local copy whenever the source is unchanged.
+ * 
+ * @param cache_root Directory on fast local storage
+ * @param capacity_bytes Maximum bytes kept in the cache
+ * @param policy LRU or LFU eviction
+ * @return true if the cache root is usable
+ * @note Opt-in: the embedding application enables the cache and, since AssetManager
+ *       does not own an ImportHistory, seeds it with HotAssetCache::warmFromHistory.
+ */
+bool AssetManager::enable_hot_asset_cache(const std::string& cache_root, uint64_t capacity_bytes, CacheEvictionPolicy policy) {
+    try {
+        if (hot_cache_) {
+            hot_cache_->shutdown();
+        }
+        hot_cache_ = std::make_shared<HotAssetCache>(cache_root, capacity_bytes, policy);
+        hot_cache_->setClosureResolver([this](const std::string& asset_path) {
+            return get_dependency_closure(asset_path);
+        });
+        import_manager_->setHotAssetCache(hot_cache_);
+        return std::filesystem::is_directory(cache_root);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to enable hot asset cache: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+std::shared_ptr<HotAssetCache> AssetManager::get_hot_asset_cache() const {
+    return hot_cache_;
 }
 
-} // namespace AssetManager 
\ No newline at end of file
+} // namespace AssetManager
@@ -11,25 +11,42 @@
  * - Comprehensive error detection and reporting mechanisms
  * - Integration with existing AssetIndexer and AssetManager components
  * - High-performance validation with minimal I/O overhead
+ * - Batch workers claim files from a shared counter and count into thread-local counters
+ * - The result cache is a JSON file of compact entries: severities as codes, counts rebuilt on load
  * - Extensible design for new file format support
  *
  * Key Features:
  * - File integrity validation (corrupted, empty, inaccessible files)
  * - Missing texture and dependency detection for 3D models
  * - Format-specific validation (OBJ, FBX, Blend, MTL files)
+ * - Structural texture checks (PNG chunks and CRCs, JPEG segments, EXR offset tables) that catch truncated copies
  * - Detailed validation reports with actionable recommendations
  * - Batch validation for entire asset libraries
  * - Performance-optimized validation algorithms
  */
 
 #include "asset_validator.hpp"
+#include "file_probe.hpp"
+#include "obj_validator.hpp"
+#include "image_integrity.hpp"
+#include "crc32.hpp"
+#include "mtl_statement.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <regex>
 #include <cstring>
+#include <cstdlib>
+#include <cctype>
 #include <chrono>
+#include <thread>
+#include <unordered_set>
+#include <stdexcept>
+#include <zlib.h>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
 
 namespace AssetManager {
 
@@ -37,7 +54,9 @@ namespace AssetManager {
     AssetValidator::AssetValidator() 
         : enable_detailed_validation_(true)
         , check_texture_dependencies_(true)
-        , max_file_size_mb_(1000) { // 1GB default limit
+        , max_file_size_mb_(1000) // 1GB default limit
+        , thread_count_(1)
+        , hash_contents_(false) {
         
         // Initialize default validation options
         validation_options_["check_file_integrity"] = true;
@@ -45,13 +64,9 @@ namespace AssetManager {
         validation_options_["check_format_specific"] = true;
         validation_options_["max_file_size_mb"] = max_file_size_mb_;
         validation_options_["enable_detailed_validation"] = enable_detailed_validation_;
-        
-        // Initialize validation statistics
-        validation_stats_["total_files_validated"] = 0;
-        validation_stats_["total_issues_found"] = 0;
-        validation_stats_["validation_time_ms"] = 0;
-        validation_stats_["files_with_errors"] = 0;
-        validation_stats_["files_with_warnings"] = 0;
+        validation_options_["threads"] = thread_count_;
+        validation_options_["cache_path"] = std::string();
+        validation_options_["hash_contents"] = hash_contents_;
     }
 
     // Destructor implementation
@@ -61,6 +76,21 @@ namespace AssetManager {
 
     // Main validation method for single asset
     ValidationResult AssetValidator::validateAsset(const std::string& file_path) {
+        auto start = std::chrono::steady_clock::now();
+        syncCacheSignature();
+        ValidationCounters counters;
+        ValidationResult result = validateCached(file_path, counters);
+        
+        // Update statistics
+        countResult(result, counters);
+        mergeCounters(counters, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+        
+        return result;
+    }
+
+    // Validation of one file, shared by single and batch validation
+    ValidationResult AssetValidator::runValidation(const std::string& file_path) {
         ValidationResult result;
         result.asset_path = file_path;
         result.is_valid = true;
@@ -105,44 +135,166 @@ namespace AssetManager {
                     "Check file accessibility and try again");
         }
         
-        // Update statistics
-        try {
-            validation_stats_["total_files_validated"] = 
-                std::any_cast<size_t>(validation_stats_["total_files_validated"]) + 1;
-            validation_stats_["total_issues_found"] = 
-                std::any_cast<size_t>(validation_stats_["total_issues_found"]) + result.total_issues;
-            
-            if (result.error_count > 0) {
-                validation_stats_["files_with_errors"] = 
-                    std::any_cast<size_t>(validation_stats_["files_with_errors"]) + 1;
-            }
-            if (result.warning_count > 0) {
-                validation_stats_["files_with_warnings"] = 
-                    std::any_cast<size_t>(validation_stats_["files_with_warnings"]) + 1;
-            }
-        } catch (const std::bad_any_cast&) {
-            // Reset statistics if casting fails
-            validation_stats_["total_files_validated"] = size_t(1);
-            validation_stats_["total_issues_found"] = size_t(result.total_issues);
-            validation_stats_["files_with_errors"] = size_t(result.error_count > 0 ? 1 : 0);
-            validation_stats_["files_with_warnings"] = size_t(result.warning_count > 0 ? 1 : 0);
-        }
-        
         return result;
     }
 
     // Batch validation for multiple assets
     std::vector<ValidationResult> AssetValidator::validateAssets(const std::vector<std::string>& file_paths) {
-        std::vector<ValidationResult> results;
-        results.reserve(file_paths.size());
+        /*
+         * Validates the batch on up to thread_count_ workers.
+         * - Workers claim the next file from a shared counter, so one slow file does not hold up the rest
+         * - Each result lands in its input slot; counters stay thread-local until the worker finishes
+         * - A single worker (or a single file) runs on the calling thread
+         * - With the cache enabled, unchanged files reuse their results and the cache is saved afterwards
+         */
+        auto start = std::chrono::steady_clock::now();
+        syncCacheSignature();
+        std::vector<ValidationResult> results(file_paths.size());
+        
+        size_t workers = thread_count_ == 0 ? std::max(1u, std::thread::hardware_concurrency()) : thread_count_;
+        workers = std::min(workers, file_paths.size());
+        
+        std::vector<ValidationCounters> counters(std::max<size_t>(1, workers));
+        if (workers <= 1) {
+            for (size_t i = 0; i < file_paths.size(); ++i) {
+                results[i] = validateCached(file_paths[i], counters[0]);
+                countResult(results[i], counters[0]);
+            }
+        } else {
+            std::atomic<size_t> next{0};
+            std::vector<std::thread> threads;
+            threads.reserve(workers);
+            for (size_t w = 0; w < workers; ++w) {
+                threads.emplace_back([&, w]() {
+                    for (size_t i = next++; i < file_paths.size(); i = next++) {
+                        results[i] = validateCached(file_paths[i], counters[w]);
+                        countResult(results[i], counters[w]);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
         
-        for (const auto& file_path : file_paths) {
-            results.push_back(validateAsset(file_path));
+        // Merge the per-thread counters; the batch's wall time is counted once
+        uint64_t elapsed_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        for (size_t w = 0; w < counters.size(); ++w) {
+            mergeCounters(counters[w], w == 0 ? elapsed_us : 0);
         }
+        saveCache();
         
         return results;
     }
 
+    // Counting of one result into thread-local counters
+    void AssetValidator::countResult(const ValidationResult& result, ValidationCounters& counters) {
+        counters.files_validated++;
+        counters.issues_found += result.total_issues;
+        if (result.error_count > 0) {
+            counters.files_with_errors++;
+        }
+        if (result.warning_count > 0) {
+            counters.files_with_warnings++;
+        }
+    }
+
+    // Lock-free merge of thread-local counters into the shared totals
+    void AssetValidator::mergeCounters(const ValidationCounters& counters, uint64_t elapsed_us) {
+        files_validated_.fetch_add(counters.files_validated, std::memory_order_relaxed);
+        issues_found_.fetch_add(counters.issues_found, std::memory_order_relaxed);
+        files_with_errors_.fetch_add(counters.files_with_errors, std::memory_order_relaxed);
+        files_with_warnings_.fetch_add(counters.files_with_warnings, std::memory_order_relaxed);
+        validation_time_us_.fetch_add(elapsed_us, std::memory_order_relaxed);
+        cache_hits_.fetch_add(counters.cache_hits, std::memory_order_relaxed);
+        dependency_invalidations_.fetch_add(counters.dependency_invalidations, std::memory_order_relaxed);
+    }
+
+    // Cached validation of one file
+    ValidationResult AssetValidator::validateCached(const std::string& file_path, ValidationCounters& counters) {
+        /*
+         * Reuses the cached result of a file when
+         * - its size and mtime match (or, with content hashing, its size and content hash match), and
+         * - every file the result depends on is in the state it was in when the result was produced.
+         * Otherwise the file is validated and its entry replaced. Hashing happens outside the lock.
+         */
+        bool enabled = false;
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex_);
+            enabled = !cache_path_.empty();
+        }
+        if (!enabled) {
+            return runValidation(file_path);
+        }
+        
+        FileStamp stamp = stampFile(file_path);
+        CacheEntry cached;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex_);
+            auto it = cache_.find(stamp.path);
+            if (it != cache_.end()) {
+                cached = it->second;
+                found = true;
+            }
+        }
+        
+        uint64_t content_hash = 0;
+        if (found && stamp.exists && cached.stamp.exists && cached.stamp.size == stamp.size) {
+            bool unchanged = cached.stamp.modified == stamp.modified;
+            if (!unchanged && hash_contents_ && cached.content_hash != 0) {
+                // Touched or copied over, but possibly the same bytes
+                content_hash = contentHash(stamp.path);
+                unchanged = content_hash == cached.content_hash;
+            }
+            if (unchanged) {
+                bool references_unchanged = std::all_of(cached.dependencies.begin(), cached.dependencies.end(),
+                    [](const FileStamp& dependency) {
+                        FileStamp current = stampFile(dependency.path);
+                        return current.exists == dependency.exists && current.size == dependency.size &&
+                               current.modified == dependency.modified;
+                    });
+                if (references_unchanged) {
+                    counters.cache_hits++;
+                    ValidationResult result = std::move(cached.result);
+                    result.asset_path = file_path;
+                    for (auto& issue : result.issues) {
+                        issue.file_path = file_path;
+                    }
+                    if (cached.stamp.modified != stamp.modified) {
+                        std::lock_guard<std::mutex> lock(cache_mutex_);
+                        auto it = cache_.find(stamp.path);
+                        if (it != cache_.end()) {
+                            it->second.stamp = stamp;
+                            cache_dirty_ = true;
+                        }
+                    }
+                    return result;
+                }
+                counters.dependency_invalidations++;
+            }
+        }
+        
+        ValidationResult result = runValidation(file_path);
+        if (!stamp.exists) {
+            return result;
+        }
+        CacheEntry entry;
+        entry.stamp = stamp;
+        if (hash_contents_) {
+            entry.content_hash = content_hash != 0 ? content_hash : contentHash(stamp.path);
+        }
+        entry.result = result;
+        for (const auto& dependency : result.dependencies) {
+            entry.dependencies.push_back(stampFile(dependency));
+        }
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        cache_[stamp.path] = std::move(entry);
+        cache_dirty_ = true;
+        return result;
+    }
+
     // Directory validation with recursive scanning
     std::vector<ValidationResult> AssetValidator::validateDirectory(const std::string& directory_path) {
         std::vector<ValidationResult> results;
@@ -162,6 +314,29 @@ namespace AssetManager {
                 }
             }
             
+            // Forget cached results of files that are no longer in the directory
+            {
+                std::lock_guard<std::mutex> lock(cache_mutex_);
+                if (!cache_path_.empty() && !cache_.empty()) {
+                    std::string prefix = std::filesystem::absolute(directory_path).lexically_normal().string();
+                    if (prefix.empty() || prefix.back() != std::filesystem::path::preferred_separator) {
+                        prefix += std::filesystem::path::preferred_separator;
+                    }
+                    std::unordered_set<std::string> present;
+                    for (const auto& file_path : asset_files) {
+                        present.insert(std::filesystem::absolute(file_path).lexically_normal().string());
+                    }
+                    for (auto it = cache_.begin(); it != cache_.end();) {
+                        if (it->first.compare(0, prefix.size(), prefix) == 0 && !present.count(it->first)) {
+                            it = cache_.erase(it);
+                            cache_dirty_ = true;
+                        } else {
+                            ++it;
+                        }
+                    }
+                }
+            }
+            
             // Validate all found assets
             results = validateAssets(asset_files);
             
@@ -181,10 +356,11 @@ namespace AssetManager {
 
     // File integrity validation
     void AssetValidator::validateFileIntegrity(const std::string& file_path, ValidationResult& result) {
-        std::filesystem::path path(file_path);
+        // Existence, size and the header read come from the shared probe; the format checks that follow reuse it
+        auto probe = FileProbeService::shared().probe(file_path);
         
         // Check if file exists
-        if (!std::filesystem::exists(path)) {
+        if (!probe->exists) {
             addIssue(result, ValidationSeverity::CRITICAL,
                     "File does not exist",
                     "File path: " + file_path,
@@ -194,7 +370,7 @@ namespace AssetManager {
         }
         
         // Check if it's a regular file
-        if (!std::filesystem::is_regular_file(path)) {
+        if (!probe->is_regular) {
             addIssue(result, ValidationSeverity::ERROR,
                     "Path is not a regular file",
                     "Path: " + file_path,
@@ -203,20 +379,8 @@ namespace AssetManager {
             return;
         }
         
-        // Check file size
-        std::error_code ec;
-        auto file_size = std::filesystem::file_size(path, ec);
-        if (ec) {
-            addIssue(result, ValidationSeverity::ERROR,
-                    "Cannot determine file size",
-                    "Error: " + ec.message(),
-                    "Check file permissions and accessibility");
-            result.is_valid = false;
-            return;
-        }
-        
         // Check for empty files
-        if (file_size == 0) {
+        if (probe->size == 0) {
             addIssue(result, ValidationSeverity::WARNING,
                     "File is empty (0 bytes)",
                     "File size: 0 bytes",
@@ -224,7 +388,7 @@ namespace AssetManager {
         }
         
         // Check file size limit
-        size_t file_size_mb = file_size / (1024 * 1024);
+        size_t file_size_mb = static_cast<size_t>(probe->size / (1024 * 1024));
         if (file_size_mb > max_file_size_mb_) {
             addIssue(result, ValidationSeverity::WARNING,
                     "File size exceeds recommended limit",
@@ -233,8 +397,7 @@ namespace AssetManager {
         }
         
         // Test file readability
-        std::ifstream file(file_path, std::ios::binary);
-        if (!file.is_open()) {
+        if (!probe->opened) {
             addIssue(result, ValidationSeverity::CRITICAL,
                     "Cannot open file for reading",
                     "File path: " + file_path,
@@ -243,24 +406,21 @@ namespace AssetManager {
             return;
         }
         
-        // Basic corruption check (read first few bytes)
-        char buffer[1024];
-        file.read(buffer, sizeof(buffer));
-        if (file.fail() && !file.eof()) {
+        // Basic corruption check (the header region must read cleanly)
+        if (probe->read_failed) {
             addIssue(result, ValidationSeverity::ERROR,
                     "File appears to be corrupted or unreadable",
                     "Failed to read file contents",
                     "Check if the file is corrupted or try re-downloading it");
             result.is_valid = false;
         }
-        
-        file.close();
     }
 
     // OBJ file validation
     void AssetValidator::validateOBJFile(const std::string& file_path, ValidationResult& result) {
-        std::ifstream file(file_path);
-        if (!file.is_open()) {
+        // One streaming pass checks structure, index ranges, coordinate values and face topology
+        OBJScanReport report = OBJStreamValidator::scan(file_path);
+        if (!report.opened) {
             addIssue(result, ValidationSeverity::CRITICAL,
                     "Cannot open OBJ file for validation",
                     "File path: " + file_path,
@@ -268,60 +428,72 @@ namespace AssetManager {
             return;
         }
         
-        std::string line;
-        bool has_vertices = false;
-        bool has_faces = false;
-        bool has_mtl_reference = false;
-        std::string mtl_file;
-        
-        while (std::getline(file, line)) {
-            // Remove comments
-            size_t comment_pos = line.find('#');
-            if (comment_pos != std::string::npos) {
-                line = line.substr(0, comment_pos);
-            }
-            
-            // Trim whitespace
-            line.erase(0, line.find_first_not_of(" \t\r\n"));
-            line.erase(line.find_last_not_of(" \t\r\n") + 1);
-            
-            if (line.empty()) continue;
-            
-            // Check for key OBJ elements
-            if (line.substr(0, 2) == "v ") {
-                has_vertices = true;
-            } else if (line.substr(0, 2) == "f ") {
-                has_faces = true;
-            } else if (line.substr(0, 7) == "mtllib ") {
-                has_mtl_reference = true;
-                mtl_file = line.substr(7);
-                // Trim whitespace from MTL filename
-                mtl_file.erase(0, mtl_file.find_first_not_of(" \t"));
-                mtl_file.erase(mtl_file.find_last_not_of(" \t") + 1);
-            }
-        }
-        
-        file.close();
-        
         // Validate OBJ structure
-        if (!has_vertices) {
+        if (report.vertices == 0) {
             addIssue(result, ValidationSeverity::ERROR,
                     "OBJ file contains no vertices",
                     "File: " + file_path,
                     "Add vertex data to make this a valid 3D model");
         }
         
-        if (!has_faces) {
+        if (report.faces == 0) {
             addIssue(result, ValidationSeverity::WARNING,
                     "OBJ file contains no faces",
                     "File: " + file_path,
                     "Add face data to create a complete 3D model");
         }
         
+        // Geometry checks, one issue per kind with the first offending lines
+        if (report.index_out_of_range.count > 0) {
+            addIssue(result, ValidationSeverity::ERROR,
+                    "Element index out of range",
+                    sampleContext(report.index_out_of_range),
+                    "Indices must refer to elements defined earlier in the file; re-export the model");
+        }
+        if (report.zero_index.count > 0) {
+            addIssue(result, ValidationSeverity::ERROR,
+                    "Element uses index 0",
+                    sampleContext(report.zero_index),
+                    "OBJ indices start at 1; the exporter wrote 0-based indices");
+        }
+        if (report.non_finite.count > 0) {
+            addIssue(result, ValidationSeverity::ERROR,
+                    "Vertex data contains NaN or infinite values",
+                    sampleContext(report.non_finite),
+                    "Fix the geometry in the source scene; non-finite coordinates break shading and BVH builds");
+        }
+        if (report.malformed.count > 0) {
+            addIssue(result, ValidationSeverity::ERROR,
+                    "Malformed OBJ element",
+                    sampleContext(report.malformed),
+                    "Check that the file is complete and was written as plain OBJ text");
+        }
+        if (report.short_faces.count > 0) {
+            addIssue(result, ValidationSeverity::ERROR,
+                    "Face has fewer than 3 vertices",
+                    sampleContext(report.short_faces),
+                    "Remove the broken faces or re-export the model");
+        }
+        if (report.degenerate_faces.count > 0) {
+            addIssue(result, ValidationSeverity::WARNING,
+                    "Degenerate face (repeated vertex)",
+                    sampleContext(report.degenerate_faces),
+                    "Merge by distance or clean up degenerate geometry before export");
+        }
+        if (report.unused_vertices > 0) {
+            addIssue(result, ValidationSeverity::WARNING,
+                    "OBJ file contains unused vertices",
+                    std::to_string(report.unused_vertices) + " of " + std::to_string(report.vertices) +
+                        " vertices are not referenced by any element (first: vertex " +
+                        std::to_string(report.first_unused_vertex) + ")",
+                    "Delete loose vertices before export to reduce file size");
+        }
+        
         // Check MTL file if referenced
-        if (has_mtl_reference && !mtl_file.empty()) {
+        for (const auto& mtl_file : report.material_libraries) {
             std::filesystem::path obj_path(file_path);
             std::filesystem::path mtl_path = obj_path.parent_path() / mtl_file;
+            result.dependencies.push_back(mtl_path.string());
             
             if (!std::filesystem::exists(mtl_path)) {
                 addIssue(result, ValidationSeverity::ERROR,
@@ -332,10 +504,22 @@ namespace AssetManager {
         }
     }
 
+    std::string AssetValidator::sampleContext(const OBJIssueSample& sample) {
+        std::string context = "Line " + std::to_string(sample.lines.front()) + ": " + sample.first;
+        if (sample.count > 1) {
+            context += " (" + std::to_string(sample.count) + " occurrences; lines";
+            for (size_t i = 0; i < sample.lines.size(); ++i) {
+                context += (i == 0 ? " " : ", ") + std::to_string(sample.lines[i]);
+            }
+            context += sample.count > sample.lines.size() ? ", ...)" : ")";
+        }
+        return context;
+    }
+
     // FBX file validation
     void AssetValidator::validateFBXFile(const std::string& file_path, ValidationResult& result) {
-        std::ifstream file(file_path, std::ios::binary);
-        if (!file.is_open()) {
+        auto probe = FileProbeService::shared().probe(file_path);
+        if (!probe->opened) {
             addIssue(result, ValidationSeverity::CRITICAL,
                     "Cannot open FBX file for validation",
                     "File path: " + file_path,
@@ -343,21 +527,18 @@ namespace AssetManager {
             return;
         }
         
-        // Read FBX header (first 23 bytes)
-        char header[23];
-        file.read(header, 23);
-        
-        if (file.gcount() < 23) {
+        // FBX header (first 23 bytes)
+        const std::vector<unsigned char>& header = probe->head;
+        if (header.size() < 23) {
             addIssue(result, ValidationSeverity::ERROR,
                     "FBX file is too small to be valid",
                     "File size appears to be corrupted",
                     "Check if the file is complete and not truncated");
-            file.close();
             return;
         }
         
         // Check FBX signature
-        std::string signature(header, 23);
+        std::string signature(reinterpret_cast<const char*>(header.data()), 23);
         if (signature != "Kaydara FBX Binary  ") {
             addIssue(result, ValidationSeverity::WARNING,
                     "FBX file may not be in standard binary format",
@@ -367,9 +548,10 @@ namespace AssetManager {
         
         // Additional FBX-specific validations
         // Check for FBX version (bytes 23-26)
-        file.seekg(23);
         unsigned int version = 0;
-        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        if (header.size() >= 27) {
+            std::memcpy(&version, header.data() + 23, sizeof(version));
+        }
         if (version < 6000 || version > 8000) {
             addIssue(result, ValidationSeverity::WARNING,
                     "FBX version is outside common range (6000-8000)",
@@ -382,36 +564,31 @@ namespace AssetManager {
                     "Version appears to be within a common range");
         }
         // Check for possible file corruption (file size)
-        file.seekg(0, std::ios::end);
-        std::streampos file_size = file.tellg();
-        if (file_size < 1024) {
+        if (probe->size < 1024) {
             addIssue(result, ValidationSeverity::ERROR,
                     "FBX file is suspiciously small",
-                    "File size: " + std::to_string(file_size) + " bytes",
+                    "File size: " + std::to_string(probe->size) + " bytes",
                     "File may be incomplete or corrupted");
         }
-        file.close();
     }
 
     // Blend file validation
     void AssetValidator::validateBlendFile(const std::string& file_path, ValidationResult& result) {
-        std::ifstream file(file_path, std::ios::binary);
-        if (!file.is_open()) {
+        auto probe = FileProbeService::shared().probe(file_path);
+        if (!probe->opened) {
             addIssue(result, ValidationSeverity::CRITICAL,
                     "Cannot open Blend file for validation",
                     "File path: " + file_path,
                     "Check file permissions and accessibility");
             return;
         }
-        // Read Blend file header (first 12 bytes)
-        char header[12];
-        file.read(header, 12);
-        if (file.gcount() < 12) {
+        // Blend file header (first 12 bytes)
+        const char* header = reinterpret_cast<const char*>(probe->head.data());
+        if (probe->head.size() < 12) {
             addIssue(result, ValidationSeverity::ERROR,
                     "Blend file is too small to be valid",
                     "File size appears to be corrupted",
                     "Check if the file is complete and not truncated");
-            file.close();
             return;
         }
         // Check Blend file signature
@@ -425,23 +602,19 @@ namespace AssetManager {
             // Extract pointer size and endianness
             char pointer_size = header[7];
             char endianness = header[8];
-            char version[3] = {header[9], header[10], header[11]};
-            std::string version_str(version, 3);
+            std::string version_str(header + 9, 3);
             addIssue(result, ValidationSeverity::INFO,
                     "Blend file version detected",
                     "Version: " + version_str,
                     "Pointer size: " + std::string((pointer_size == '_') ? "32-bit" : "64-bit") + ", Endianness: " + ((endianness == 'v') ? "Little" : "Big"));
         }
         // Check for possible file corruption (file size)
-        file.seekg(0, std::ios::end);
-        std::streampos file_size = file.tellg();
-        if (file_size < 1024) {
+        if (probe->size < 1024) {
             addIssue(result, ValidationSeverity::ERROR,
                     "Blend file is suspiciously small",
-                    "File size: " + std::to_string(file_size) + " bytes",
+                    "File size: " + std::to_string(probe->size) + " bytes",
                     "File may be incomplete or corrupted");
         }
-        file.close();
     }
 
     // MTL file validation
@@ -478,14 +651,8 @@ namespace AssetManager {
             }
             
             // Check for texture references
-            if (line.substr(0, 7) == "map_Kd " || 
-                line.substr(0, 7) == "map_Ks " ||
-                line.substr(0, 7) == "map_Bump" ||
-                line.substr(0, 7) == "map_Ns ") {
-                std::string texture_file = line.substr(7);
-                // Trim whitespace
-                texture_file.erase(0, texture_file.find_first_not_of(" \t"));
-                texture_file.erase(texture_file.find_last_not_of(" \t") + 1);
+            std::string texture_file = mtlTextureFile(line);
+            if (!texture_file.empty()) {
                 texture_files.push_back(texture_file);
             }
         }
@@ -504,6 +671,7 @@ namespace AssetManager {
         std::filesystem::path mtl_path(file_path);
         for (const auto& texture_file : texture_files) {
             std::filesystem::path texture_path = mtl_path.parent_path() / texture_file;
+            result.dependencies.push_back(texture_path.string());
             
             if (!std::filesystem::exists(texture_path)) {
                 addIssue(result, ValidationSeverity::ERROR,
@@ -516,8 +684,8 @@ namespace AssetManager {
 
     // Texture file validation
     void AssetValidator::validateTextureFile(const std::string& file_path, ValidationResult& result) {
-        std::ifstream file(file_path, std::ios::binary);
-        if (!file.is_open()) {
+        auto probe = FileProbeService::shared().probe(file_path);
+        if (!probe->opened) {
             addIssue(result, ValidationSeverity::CRITICAL,
                     "Cannot open texture file for validation",
                     "File path: " + file_path,
@@ -525,13 +693,11 @@ namespace AssetManager {
             return;
         }
         
-        // Read file header for format detection
-        char header[16];
-        file.read(header, 16);
-        file.close();
+        // File header for format detection, zero-padded for files shorter than 16 bytes
+        char header[16] = {};
+        std::memcpy(header, probe->head.data(), std::min<size_t>(probe->head.size(), sizeof(header)));
         
-        std::string extension = std::filesystem::path(file_path).extension().string();
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        const std::string& extension = probe->extension;
         
         // Basic format validation based on file extension and header
         bool valid_format = false;
@@ -546,9 +712,14 @@ namespace AssetManager {
             if (header[0] == (char)0x89 && header[1] == 'P' && header[2] == 'N' && header[3] == 'G') {
                 valid_format = true;
             }
+        } else if (extension == ".exr") {
+            // Check OpenEXR magic number
+            if (header[0] == (char)0x76 && header[1] == (char)0x2F && header[2] == (char)0x31 && header[3] == (char)0x01) {
+                valid_format = true;
+            }
         } else if (extension == ".tga") {
-            // TGA files are harder to validate without full parsing
-            valid_format = true; // Assume valid for now
+            // TGA has no signature; its header is checked by the structure walk below
+            valid_format = true;
         } else if (extension == ".bmp") {
             // Check BMP signature
             if (header[0] == 'B' && header[1] == 'M') {
@@ -560,7 +731,27 @@ namespace AssetManager {
             addIssue(result, ValidationSeverity::WARNING,
                     "Texture file format may not be supported",
                     "Extension: " + extension + ", File: " + file_path,
-                    "Ensure the texture is in a supported format (JPG, PNG, TGA, BMP)");
+                    "Ensure the texture is in a supported format (JPG, PNG, EXR, TGA, BMP)");
+            return;
+        }
+        
+        /**
+         * @brief Structure walk
+         * 
+         * A file cut short by an interrupted copy keeps its signature and header, so it passes the
+         * check above; its chunk list, segment lengths or offset table run past the end of the file.
+         */
+        ImageIntegrityReport integrity = ImageIntegrityChecker::check(file_path);
+        if (integrity.checked && !integrity.problems.empty()) {
+            std::string context;
+            for (const auto& problem : integrity.problems) {
+                context += (context.empty() ? "" : "; ") + problem;
+            }
+            addIssue(result, ValidationSeverity::ERROR,
+                    integrity.truncated ? "Texture file is truncated" : "Texture file structure is corrupted",
+                    context,
+                    integrity.truncated ? "Copy the texture again from its source; the transfer did not complete"
+                                        : "Re-export the texture from its source application");
         }
     }
 
@@ -593,7 +784,7 @@ namespace AssetManager {
         if (extension == "blend") return "blend";
         if (extension == "mtl") return "mtl";
         if (extension == "jpg" || extension == "jpeg" || extension == "png" || 
-            extension == "tga" || extension == "bmp" || extension == "tiff") return "texture";
+            extension == "tga" || extension == "bmp" || extension == "tiff" || extension == "exr") return "texture";
         
         return "unknown";
     }
@@ -729,11 +920,238 @@ namespace AssetManager {
         if (options.find("max_file_size_mb") != options.end()) {
             max_file_size_mb_ = std::any_cast<size_t>(options.at("max_file_size_mb"));
         }
+        
+        if (options.find("threads") != options.end()) {
+            thread_count_ = std::any_cast<size_t>(options.at("threads"));
+        }
+        
+        if (options.find("hash_contents") != options.end()) {
+            hash_contents_ = std::any_cast<bool>(options.at("hash_contents"));
+        }
+        
+        if (options.find("cache_path") != options.end()) {
+            setCachePath(std::any_cast<std::string>(options.at("cache_path")));
+        }
+    }
+
+    // Worker thread configuration
+    void AssetValidator::setThreadCount(size_t threads) {
+        thread_count_ = threads;
+        validation_options_["threads"] = threads;
+    }
+
+    size_t AssetValidator::getThreadCount() const {
+        return thread_count_;
+    }
+
+    // Persistent cache configuration
+    void AssetValidator::setCachePath(const std::string& cache_path) {
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex_);
+            cache_path_ = cache_path;
+            cache_.clear();
+            cache_signature_.clear();
+            cache_dirty_ = false;
+        }
+        validation_options_["cache_path"] = cache_path;
+        loadCache();
+    }
+
+    std::string AssetValidator::getCachePath() const {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        return cache_path_;
+    }
+
+    void AssetValidator::clearCache() {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        cache_dirty_ = cache_dirty_ || !cache_.empty();
+        cache_.clear();
+    }
+
+    // Cache loading
+    void AssetValidator::loadCache() {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (cache_path_.empty()) {
+            return;
+        }
+        std::ifstream file(cache_path_);
+        if (!file.is_open()) {
+            return;
+        }
+        try {
+            json document = json::parse(file);
+            if (document.value("version", 0) != 1) {
+                return;
+            }
+            cache_signature_ = document.value("signature", "");
+            for (const auto& [path, value] : document.at("files").items()) {
+                CacheEntry entry;
+                entry.stamp.path = path;
+                entry.stamp.exists = true;
+                entry.stamp.size = value.at("s").get<uint64_t>();
+                entry.stamp.modified = value.at("m").get<int64_t>();
+                entry.content_hash = value.value("h", uint64_t(0));
+                entry.result.asset_path = path;
+                entry.result.total_issues = 0;
+                entry.result.error_count = 0;
+                entry.result.warning_count = 0;
+                entry.result.info_count = 0;
+                // Issues are [severity code, description, context, recommendation]; counts follow from them
+                for (const auto& issue : value.at("i")) {
+                    int code = issue.at(0).get<int>();
+                    if (code < static_cast<int>(ValidationSeverity::INFO) || code > static_cast<int>(ValidationSeverity::CRITICAL)) {
+                        throw std::runtime_error("invalid severity code");
+                    }
+                    addIssue(entry.result, static_cast<ValidationSeverity>(code), issue.at(1).get<std::string>(),
+                             issue.at(2).get<std::string>(), issue.at(3).get<std::string>());
+                }
+                entry.result.is_valid = value.at("v").get<int>() != 0;
+                // Dependencies are [path, size, mtime], size -1 for a file that did not exist
+                for (const auto& dependency : value.value("d", json::array())) {
+                    FileStamp stamp;
+                    stamp.path = dependency.at(0).get<std::string>();
+                    int64_t size = dependency.at(1).get<int64_t>();
+                    stamp.exists = size >= 0;
+                    stamp.size = stamp.exists ? static_cast<uint64_t>(size) : 0;
+                    stamp.modified = dependency.at(2).get<int64_t>();
+                    entry.result.dependencies.push_back(stamp.path);
+                    entry.dependencies.push_back(std::move(stamp));
+                }
+                cache_[path] = std::move(entry);
+            }
+        } catch (const std::exception&) {
+            // A damaged cache only costs a full validation
+            cache_.clear();
+            cache_signature_.clear();
+        }
+    }
+
+    // Cache saving
+    bool AssetValidator::saveCache() {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (cache_path_.empty() || !cache_dirty_) {
+            return true;
+        }
+        json files = json::object();
+        for (const auto& [path, entry] : cache_) {
+            json issues = json::array();
+            for (const auto& issue : entry.result.issues) {
+                issues.push_back({static_cast<int>(issue.severity), issue.description, issue.context, issue.recommendation});
+            }
+            json dependencies = json::array();
+            for (const auto& dependency : entry.dependencies) {
+                dependencies.push_back({dependency.path,
+                                        dependency.exists ? static_cast<int64_t>(dependency.size) : int64_t(-1),
+                                        dependency.modified});
+            }
+            json value = {{"s", entry.stamp.size}, {"m", entry.stamp.modified}, {"v", entry.result.is_valid ? 1 : 0},
+                          {"i", issues}};
+            if (entry.content_hash != 0) {
+                value["h"] = entry.content_hash;
+            }
+            if (!dependencies.empty()) {
+                value["d"] = dependencies;
+            }
+            files[path] = std::move(value);
+        }
+        json document = {{"version", 1}, {"signature", cache_signature_}, {"files", files}};
+        
+        std::error_code error;
+        std::filesystem::path parent = std::filesystem::path(cache_path_).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent, error);
+        }
+        std::string temporary = cache_path_ + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            file << document.dump();
+        }
+        std::filesystem::rename(temporary, cache_path_, error);
+        if (error) {
+            return false;
+        }
+        cache_dirty_ = false;
+        return true;
+    }
+
+    // Cache invalidation on rule or option changes
+    void AssetValidator::syncCacheSignature() {
+        std::string signature = cacheSignature();
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (cache_path_.empty() || cache_signature_ == signature) {
+            return;
+        }
+        cache_dirty_ = cache_dirty_ || !cache_.empty() || !cache_signature_.empty();
+        cache_.clear();
+        cache_signature_ = signature;
+    }
+
+    std::string AssetValidator::cacheSignature() const {
+        return "rules=" + std::to_string(kRuleVersion) +
+               ";textures=" + std::to_string(check_texture_dependencies_ ? 1 : 0) +
+               ";max_mb=" + std::to_string(max_file_size_mb_);
+    }
+
+    // File identity
+    AssetValidator::FileStamp AssetValidator::stampFile(const std::string& path) {
+        FileStamp stamp;
+        std::error_code error;
+        std::filesystem::path absolute = std::filesystem::absolute(path, error);
+        stamp.path = (error ? std::filesystem::path(path) : absolute).lexically_normal().string();
+        if (!std::filesystem::is_regular_file(stamp.path, error)) {
+            return stamp;
+        }
+        stamp.size = std::filesystem::file_size(stamp.path, error);
+        if (error) {
+            return stamp;
+        }
+        auto modified = std::filesystem::last_write_time(stamp.path, error);
+        if (error) {
+            return stamp;
+        }
+        stamp.modified = static_cast<int64_t>(modified.time_since_epoch().count());
+        stamp.exists = true;
+        return stamp;
+    }
+
+    uint64_t AssetValidator::contentHash(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return 0;
+        }
+        uint32_t crc = 0;
+        uLong adler = adler32(0L, Z_NULL, 0);
+        uint64_t size = 0;
+        std::vector<char> chunk(1 << 16);
+        while (file) {
+            file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            std::streamsize count = file.gcount();
+            if (count <= 0) {
+                break;
+            }
+            crc = Crc32::update(crc, reinterpret_cast<const unsigned char*>(chunk.data()), static_cast<size_t>(count));
+            adler = adler32(adler, reinterpret_cast<const Bytef*>(chunk.data()), static_cast<uInt>(count));
+            size += static_cast<uint64_t>(count);
+        }
+        uint64_t hash = ((static_cast<uint64_t>(crc) << 32) | (adler & 0xffffffffu)) ^ (size * 0x9e3779b97f4a7c15ull);
+        return hash != 0 ? hash : 1;
     }
 
     // Statistics retrieval
     std::map<std::string, std::any> AssetValidator::getValidationStats() const {
-        return validation_stats_;
+        std::map<std::string, std::any> stats;
+        stats["total_files_validated"] = files_validated_.load(std::memory_order_relaxed);
+        stats["total_issues_found"] = issues_found_.load(std::memory_order_relaxed);
+        stats["validation_time_ms"] = static_cast<size_t>(validation_time_us_.load(std::memory_order_relaxed) / 1000);
+        stats["files_with_errors"] = files_with_errors_.load(std::memory_order_relaxed);
+        stats["files_with_warnings"] = files_with_warnings_.load(std::memory_order_relaxed);
+        stats["threads"] = thread_count_;
+        stats["cache_hits"] = cache_hits_.load(std::memory_order_relaxed);
+        stats["dependency_invalidations"] = dependency_invalidations_.load(std::memory_order_relaxed);
+        return stats;
     }
 
 } // namespace AssetManager 
\ No newline at end of file
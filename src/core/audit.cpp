@@ -129,7 +129,7 @@ void AssetAuditor::scanDirectory(const std::filesystem::path& directory) {
             stats.fileTypes[ext]++;
             
             // File size calculation and categorization
-            double sizeMB = getFileSizeMB(entry.path());
+            double sizeMB = getFileSizeMB(entry);
             stats.largestFiles.emplace_back(entry.path().lexically_relative(projectRoot).string(), sizeMB);
             
             // Reference integrity checking
@@ -283,15 +283,16 @@ void AssetAuditor::categorizeFileByType(const std::filesystem::path& filePath, c
 /**
  * @brief Calculates file size in megabytes
  * 
- * @param filePath Path to the file
+ * @param entry Directory entry of the file, as yielded by the scan
  * @return File size in megabytes, or 0.0 if size cannot be determined
  */
-double AssetAuditor::getFileSizeMB(const std::filesystem::path& filePath) const {
-    try {
-        return static_cast<double>(std::filesystem::file_size(filePath)) / (1024.0 * 1024.0);
-    } catch (...) {
+double AssetAuditor::getFileSizeMB(const std::filesystem::directory_entry& entry) const {
+    std::error_code ec;
+    const auto size = entry.file_size(ec);
+    if (ec) {
         return 0.0;
     }
+    return static_cast<double>(size) / (1024.0 * 1024.0);
 }
 
 /**
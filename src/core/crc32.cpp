@@ -0,0 +1,154 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: crc32.cpp
+ * Description: Implementation of Crc32, the shared standard CRC-32.
+ *
+ * Architecture:
+ * - update() folds the 16-byte-aligned bulk with PCLMULQDQ where available and finishes byte tails with
+ *   the slicing-by-8 tables, which also carry everything on CPUs without carry-less multiply
+ *
+ * Key Features:
+ * - The PCLMULQDQ path folds 64 bytes per iteration (Intel's "Fast CRC Computation Using PCLMULQDQ"
+ *   constants for the reflected polynomial 0xEDB88320)
+ * - Results match zlib's crc32(), so PNG chunks, journals and snapshots written by either still verify
+ */
+
+#include "crc32.hpp"
+#include <array>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif
+
+namespace AssetManager {
+
+uint32_t Crc32::update(uint32_t crc, const unsigned char* data, size_t size) {
+    uint32_t running = ~crc;
+    if (size >= 64 && hardwareAccelerated()) {
+        size_t bulk = size & ~static_cast<size_t>(15);
+        running = folded(running, data, bulk);
+        data += bulk;
+        size -= bulk;
+    }
+    return ~sliced(running, data, size);
+}
+
+bool Crc32::hardwareAccelerated() {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    static const bool supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+uint32_t Crc32::folded(uint32_t crc, const unsigned char* data, size_t size) {
+    /*
+     * Four 128-bit lanes fold 64 bytes per iteration, then collapse to one lane, fold the remaining
+     * 16-byte blocks, and Barrett-reduce to 32 bits. crc is the running register, i.e. already inverted.
+     */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+    __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    data += 64;
+    size -= 64;
+
+    while (size >= 64) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30)));
+        data += 64;
+        size -= 64;
+    }
+
+    // Four lanes into one
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    const __m128i lanes[3] = {x2, x3, x4};
+    for (const __m128i& lane : lanes) {
+        __m128i low = _mm_clmulepi64_si128(x1, k, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x11), lane), low);
+    }
+    while (size >= 16) {
+        __m128i low = _mm_clmulepi64_si128(x1, k, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x11),
+                                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(data))), low);
+        data += 16;
+        size -= 16;
+    }
+
+    // 128 to 64 bits
+    __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i folded = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), folded);
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    folded = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x00), folded);
+
+    // Barrett reduction to 32 bits
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    __m128i reduced = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x10);
+    reduced = _mm_clmulepi64_si128(_mm_and_si128(reduced, mask), k, 0x00);
+    return static_cast<uint32_t>(_mm_extract_epi32(_mm_xor_si128(x1, reduced), 1));
+#else
+    return sliced(crc, data, size);
+#endif
+}
+
+uint32_t Crc32::sliced(uint32_t crc, const unsigned char* data, size_t size) {
+    /*
+     * Slicing-by-8: table k advances a byte through k further zero bytes, so eight lookups consume
+     * eight input bytes. Words are assembled byte by byte, which keeps the result endian-independent.
+     */
+    static const std::array<std::array<uint32_t, 256>, 8> table = [] {
+        std::array<std::array<uint32_t, 256>, 8> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[0][i] = c;
+        }
+        for (size_t k = 1; k < 8; ++k) {
+            for (uint32_t i = 0; i < 256; ++i) {
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFFu];
+            }
+        }
+        return t;
+    }();
+
+    while (size >= 8) {
+        uint32_t low = crc ^ (static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+                              static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24);
+        uint32_t high = static_cast<uint32_t>(data[4]) | static_cast<uint32_t>(data[5]) << 8 |
+                        static_cast<uint32_t>(data[6]) << 16 | static_cast<uint32_t>(data[7]) << 24;
+        crc = table[7][low & 0xFFu] ^ table[6][(low >> 8) & 0xFFu] ^ table[5][(low >> 16) & 0xFFu] ^ table[4][low >> 24] ^
+              table[3][high & 0xFFu] ^ table[2][(high >> 8) & 0xFFu] ^ table[1][(high >> 16) & 0xFFu] ^ table[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = table[0][(crc ^ *data++) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+} // namespace AssetManager
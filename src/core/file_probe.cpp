@@ -0,0 +1,236 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: file_probe.cpp
+ * Description: Implementation of FileProbeService, the shared header-read cache for every subsystem that
+ *              sniffs file headers.
+ *
+ * Architecture:
+ * - probe() stats the file, answers from the cache when size and mtime still match, otherwise reads the
+ *   header region once and runs the texture parser and every registered probe on that buffer
+ * - Probe results are immutable once cached; callers hold shared pointers, so eviction never invalidates them
+ *
+ * Key Features:
+ * - Missing files and directories are reported but not cached
+ * - Registering a probe clears the cache, since cached results were produced without it
+ */
+
+#include "file_probe.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace AssetManager {
+
+FileProbeService::FileProbeService(size_t capacity)
+    : capacity_(std::max<size_t>(1, capacity)) {
+    probes_.emplace_back("fbx", &FileProbeService::probeFBX);
+    probes_.emplace_back("blend", &FileProbeService::probeBlend);
+}
+
+FileProbeService& FileProbeService::shared() {
+    static FileProbeService service;
+    return service;
+}
+
+std::shared_ptr<const FileProbe> FileProbeService::probe(const std::string& path) {
+    /**
+     * @brief Returns the header probe of a file, reading it only if it changed since the last probe.
+     *
+     * @param path File path; relative paths are resolved against the working directory.
+     * @return Never null; check exists/opened before using the header fields.
+     */
+    FileProbe stamp = stampFile(path);
+    std::vector<std::pair<std::string, FormatProbe>> probes;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.probes;
+        if (auto hit = lookup(stamp)) {
+            ++stats_.cache_hits;
+            return hit;
+        }
+        probes = probes_;
+    }
+    if (!stamp.exists || !stamp.is_regular) {
+        return std::make_shared<const FileProbe>(std::move(stamp));
+    }
+
+    size_t bytes_read = 0;
+    std::shared_ptr<const FileProbe> result = read(stamp, probes, bytes_read);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.files_read;
+    stats_.bytes_read += bytes_read;
+    if (result->opened && !result->read_failed) {
+        store(result);
+    }
+    return result;
+}
+
+std::shared_ptr<const FileProbe> FileProbeService::cached(const std::string& path) {
+    FileProbe stamp = stampFile(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lookup(stamp);
+}
+
+void FileProbeService::registerProbe(const std::string& name, FormatProbe probe) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto existing = std::find_if(probes_.begin(), probes_.end(),
+                                 [&name](const auto& entry) { return entry.first == name; });
+    if (existing != probes_.end()) {
+        existing->second = std::move(probe);
+    } else {
+        probes_.emplace_back(name, std::move(probe));
+    }
+    lru_.clear();
+    cache_.clear();
+}
+
+FileProbeStats FileProbeService::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void FileProbeService::clearCache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    cache_.clear();
+}
+
+std::shared_ptr<const FileProbe> FileProbeService::lookup(const FileProbe& stamp) {
+    /* Caller holds mutex_. Stale entries are dropped on the spot. */
+    auto found = cache_.find(stamp.path);
+    if (found == cache_.end()) {
+        return nullptr;
+    }
+    const FileProbe& entry = *found->second->second;
+    if (!stamp.exists || entry.size != stamp.size || entry.modified != stamp.modified) {
+        lru_.erase(found->second);
+        cache_.erase(found);
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, found->second);
+    return found->second->second;
+}
+
+std::shared_ptr<FileProbe> FileProbeService::read(const FileProbe& stamp,
+                                                  const std::vector<std::pair<std::string, FormatProbe>>& probes,
+                                                  size_t& bytes_read) {
+    /**
+     * @brief Reads the header region and runs every parser on it.
+     *
+     * JPEG frame headers can sit behind large EXIF/ICC segments, so a JPEG whose header was not found in the
+     * first window continues the same read up to kJpegReadBytes.
+     */
+    auto result = std::make_shared<FileProbe>(stamp);
+    std::ifstream file(stamp.path, std::ios::binary);
+    if (!file.is_open()) {
+        return result;
+    }
+    result->opened = true;
+
+    std::vector<unsigned char> buffer(kReadBytes);
+    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    size_t size = static_cast<size_t>(file.gcount());
+    result->read_failed = file.bad();
+    result->has_texture = TextureHeaderProbe::parse(buffer.data(), size, stamp.extension, result->texture);
+
+    bool is_jpeg = size >= 3 && buffer[0] == 0xFF && buffer[1] == 0xD8;
+    if (!result->has_texture && is_jpeg && size == buffer.size()) {
+        buffer.resize(kJpegReadBytes);
+        file.read(reinterpret_cast<char*>(buffer.data()) + size, static_cast<std::streamsize>(buffer.size() - size));
+        size += static_cast<size_t>(file.gcount());
+        result->has_texture = TextureHeaderProbe::parse(buffer.data(), size, stamp.extension, result->texture);
+    }
+    bytes_read = size;
+
+    for (const auto& [name, probe] : probes) {
+        std::map<std::string, std::any> fields;
+        if (probe(buffer.data(), size, *result, fields)) {
+            result->formats[name] = std::move(fields);
+        }
+    }
+    result->head.assign(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(std::min(size, kRetainedBytes)));
+    return result;
+}
+
+void FileProbeService::store(const std::shared_ptr<const FileProbe>& probe) {
+    /* Caller holds mutex_. A concurrent probe of the same file may have stored it first; the newer read wins. */
+    auto found = cache_.find(probe->path);
+    if (found != cache_.end()) {
+        lru_.erase(found->second);
+        cache_.erase(found);
+    }
+    lru_.emplace_front(probe->path, probe);
+    cache_[probe->path] = lru_.begin();
+    while (lru_.size() > capacity_) {
+        cache_.erase(lru_.back().first);
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+FileProbe FileProbeService::stampFile(const std::string& path) {
+    /* One stat through directory_entry, which caches type, size and mtime together. */
+    FileProbe stamp;
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    stamp.path = (error ? std::filesystem::path(path) : absolute).lexically_normal().string();
+    stamp.extension = std::filesystem::path(path).extension().string();
+    std::transform(stamp.extension.begin(), stamp.extension.end(), stamp.extension.begin(), ::tolower);
+
+    std::filesystem::directory_entry entry(stamp.path, error);
+    if (error || !entry.exists(error)) {
+        return stamp;
+    }
+    stamp.exists = true;
+    stamp.is_regular = entry.is_regular_file(error);
+    if (stamp.is_regular) {
+        stamp.size = entry.file_size(error);
+        stamp.modified = static_cast<int64_t>(entry.last_write_time(error).time_since_epoch().count());
+    }
+    return stamp;
+}
+
+bool FileProbeService::probeFBX(const unsigned char* data, size_t size, const FileProbe& file,
+                                std::map<std::string, std::any>& fields) {
+    /*
+     * Binary FBX: "Kaydara FBX Binary  \0" then a little-endian uint32 version at byte 23.
+     * - ASCII FBX has no fixed magic; it is recognised by extension and an "FBX" comment near the top
+     */
+    static const char kMagic[] = "Kaydara FBX Binary";
+    if (size >= sizeof(kMagic) - 1 && std::memcmp(data, kMagic, sizeof(kMagic) - 1) == 0) {
+        fields["binary"] = true;
+        if (size >= 27) {
+            fields["version"] = static_cast<unsigned int>(data[23] | (data[24] << 8) | (data[25] << 16) |
+                                                          (static_cast<uint32_t>(data[26]) << 24));
+        }
+        return true;
+    }
+    if (file.extension != ".fbx") {
+        return false;
+    }
+    std::string text(reinterpret_cast<const char*>(data), std::min<size_t>(size, 256));
+    if (text.find("FBX") == std::string::npos) {
+        return false;
+    }
+    fields["binary"] = false;
+    return true;
+}
+
+bool FileProbeService::probeBlend(const unsigned char* data, size_t size, const FileProbe& file,
+                                  std::map<std::string, std::any>& fields) {
+    /* "BLENDER", pointer size ('_' 32-bit, '-' 64-bit), endianness ('v' little, 'V' big), 3-digit version. */
+    (void)file;
+    if (size < 12 || std::memcmp(data, "BLENDER", 7) != 0) {
+        return false;
+    }
+    fields["pointer_size"] = data[7] == '_' ? 32 : 64;
+    fields["endianness"] = std::string(data[8] == 'v' ? "Little" : "Big");
+    fields["version"] = std::string(reinterpret_cast<const char*>(data) + 9, 3);
+    return true;
+}
+
+} // namespace AssetManager
@@ -0,0 +1,601 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: history_index.cpp
+ * Description: Implementation of the HistoryIndex time-ordered store and the HistoryIdGenerator.
+ *
+ * Architecture:
+ * - insert() appends when the timestamp is not older than the newest slot; older entries are merged
+ *   with the live slots in one pass and the ring is re-laid out. insertBatch() does the same for a
+ *   whole batch (tailed records), so a batch costs at most one re-layout
+ * - kill() clears the live bit and the id mapping; tombstones at the ring head are popped immediately,
+ *   asset/type sequence lists are trimmed from the front as slots leave the ring
+ * - relayout() writes entries linearly into a fresh power-of-two ring and re-derives every index
+ *
+ * Key Features:
+ * - O(1) eviction of the oldest entries: the ring head advances, nothing is moved
+ * - Amortized O(1) removal elsewhere: a compaction happens only after as many removals as live entries
+ * - Id generator is seeded once and keeps ids increasing even if the clock steps backwards
+ */
+
+#include "history_index.hpp"
+#include "import_history.hpp"
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <unistd.h>
+
+namespace AssetManager {
+
+void HistoryIndex::insert(ImportHistoryEntry entry) {
+    /**
+     * @brief Adds an entry at its place in time order.
+     *
+     * @param entry Entry to store; replaces any live entry with the same id.
+     */
+    auto existing = by_id_.find(entry.id);
+    if (existing != by_id_.end()) {
+        kill(static_cast<size_t>(existing->second - base_seq_));
+    }
+
+    rollup_.add(entry);
+    if (count_ == 0 || !(entry.timestamp < ring_[physical(count_ - 1)].timestamp)) {
+        pushBack(std::move(entry));
+        ++live_count_;
+        indexSlot(count_ - 1);
+    } else {
+        std::vector<ImportHistoryEntry> backdated;
+        backdated.push_back(std::move(entry));
+        mergeSorted(std::move(backdated));
+    }
+    compactIfSparse();
+}
+
+void HistoryIndex::insertBatch(std::vector<ImportHistoryEntry> entries) {
+    /**
+     * @brief Adds several entries at their places in time order with at most one re-layout.
+     *        Records tailed from other writers are often older than the local newest entry;
+     *        merging them together keeps a refresh O(n + k log k) instead of O(k * n).
+     *
+     * @param entries Entries in arrival order; later duplicates of an id win, and each replaces
+     *                any live entry with the same id.
+     */
+    keepLastById(entries);
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const ImportHistoryEntry& a, const ImportHistoryEntry& b) {
+                         return a.timestamp < b.timestamp;
+                     });
+    for (const auto& entry : entries) {
+        auto existing = by_id_.find(entry.id);
+        if (existing != by_id_.end()) {
+            kill(static_cast<size_t>(existing->second - base_seq_));
+        }
+        rollup_.add(entry);
+    }
+    if (entries.empty()) {
+        return;
+    }
+
+    if (count_ == 0 || !(entries.front().timestamp < ring_[physical(count_ - 1)].timestamp)) {
+        for (auto& entry : entries) {
+            pushBack(std::move(entry));
+            ++live_count_;
+            indexSlot(count_ - 1);
+        }
+    } else {
+        mergeSorted(std::move(entries));
+    }
+    compactIfSparse();
+}
+
+void HistoryIndex::assign(std::vector<ImportHistoryEntry> entries) {
+    /**
+     * @brief Replaces the whole store; entries are stably sorted by timestamp.
+     *
+     * @param entries New contents; later duplicates of an id win.
+     */
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const ImportHistoryEntry& a, const ImportHistoryEntry& b) {
+                         return a.timestamp < b.timestamp;
+                     });
+
+    // Resolve duplicate ids before indexing so the id index stays one-to-one
+    keepLastById(entries);
+
+    rollup_.clear();
+    for (const auto& entry : entries) {
+        rollup_.add(entry);
+    }
+    relayout(std::move(entries));
+}
+
+void HistoryIndex::clear() {
+    ring_.clear();
+    live_.clear();
+    head_ = 0;
+    count_ = 0;
+    live_count_ = 0;
+    by_id_.clear();
+    by_asset_.clear();
+    by_type_.clear();
+    rollup_.clear();
+}
+
+bool HistoryIndex::erase(const std::string& entry_id) {
+    /**
+     * @brief Removes an entry by id.
+     *
+     * @param entry_id Id to remove.
+     * @return True if the entry was present.
+     */
+    auto it = by_id_.find(entry_id);
+    if (it == by_id_.end()) {
+        return false;
+    }
+    kill(static_cast<size_t>(it->second - base_seq_));
+    compactIfSparse();
+    return true;
+}
+
+std::vector<std::string> HistoryIndex::eraseWhere(const Predicate& predicate) {
+    /**
+     * @brief Removes every live entry matching the predicate.
+     *
+     * @param predicate Returns true for entries to remove.
+     * @return Removed ids, oldest first.
+     */
+    std::vector<std::string> removed;
+    std::vector<uint64_t> sequences;
+    for (size_t i = 0; i < count_; ++i) {
+        size_t slot = physical(i);
+        if (live_[slot] && predicate(ring_[slot])) {
+            removed.push_back(ring_[slot].id);
+            sequences.push_back(base_seq_ + i);
+        }
+    }
+    // Killing may pop the ring head, so resolve by sequence number
+    for (uint64_t sequence : sequences) {
+        kill(static_cast<size_t>(sequence - base_seq_));
+    }
+    compactIfSparse();
+    return removed;
+}
+
+std::vector<std::string> HistoryIndex::eraseBefore(const std::chrono::system_clock::time_point& cutoff) {
+    /**
+     * @brief Removes entries strictly older than the cutoff by advancing the ring head.
+     *
+     * @param cutoff Oldest timestamp to keep.
+     * @return Removed ids, oldest first.
+     */
+    std::vector<std::string> removed;
+    while (count_ > 0 && ring_[physical(0)].timestamp < cutoff) {
+        removed.push_back(ring_[physical(0)].id);
+        kill(0);   // pops the head and any tombstones behind it
+    }
+    return removed;
+}
+
+std::vector<std::string> HistoryIndex::eraseOldest(size_t count) {
+    /**
+     * @brief Removes up to `count` of the oldest entries by advancing the ring head.
+     *
+     * @param count Number of entries to remove.
+     * @return Removed ids, oldest first.
+     */
+    std::vector<std::string> removed;
+    while (count_ > 0 && removed.size() < count) {
+        removed.push_back(ring_[physical(0)].id);
+        kill(0);
+    }
+    return removed;
+}
+
+const ImportHistoryEntry* HistoryIndex::find(const std::string& entry_id) const {
+    auto it = by_id_.find(entry_id);
+    return it == by_id_.end() ? nullptr : &ring_[physical(static_cast<size_t>(it->second - base_seq_))];
+}
+
+const ImportHistoryEntry* HistoryIndex::newest() const {
+    for (size_t i = count_; i > 0; --i) {
+        size_t slot = physical(i - 1);
+        if (live_[slot]) {
+            return &ring_[slot];
+        }
+    }
+    return nullptr;
+}
+
+const ImportHistoryEntry* HistoryIndex::oldest() const {
+    // The head is never a tombstone
+    return count_ == 0 ? nullptr : &ring_[physical(0)];
+}
+
+std::pair<const ImportHistoryEntry*, const ImportHistoryEntry*> HistoryIndex::boundsInRange(
+    const std::chrono::system_clock::time_point& start,
+    const std::chrono::system_clock::time_point& end) const {
+    /**
+     * @brief Finds the oldest and newest live entries with start <= timestamp <= end.
+     *
+     * @return Pointers to (oldest, newest), both null if the range is empty.
+     */
+    if (end < start) {
+        return {nullptr, nullptr};
+    }
+    size_t lower = lowerBound(start);
+    size_t upper = upperBound(end);
+    while (lower < upper && !live_[physical(lower)]) ++lower;
+    while (upper > lower && !live_[physical(upper - 1)]) --upper;
+    if (lower == upper) {
+        return {nullptr, nullptr};
+    }
+    return {&ring_[physical(lower)], &ring_[physical(upper - 1)]};
+}
+
+void HistoryIndex::forEach(const Visitor& visitor) const {
+    for (size_t i = count_; i > 0; --i) {
+        size_t slot = physical(i - 1);
+        if (live_[slot] && !visitor(ring_[slot])) {
+            return;
+        }
+    }
+}
+
+void HistoryIndex::forEachByAsset(const std::string& asset_path, const Visitor& visitor) const {
+    auto it = by_asset_.find(asset_path);
+    if (it != by_asset_.end()) {
+        walkSequences(it->second, visitor);
+    }
+}
+
+bool HistoryIndex::containsAsset(const std::string& asset_path) const {
+    bool found = false;
+    forEachByAsset(asset_path, [&found](const ImportHistoryEntry&) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+void HistoryIndex::forEachByType(const std::string& import_type, const Visitor& visitor) const {
+    auto it = by_type_.find(import_type);
+    if (it != by_type_.end()) {
+        walkSequences(it->second, visitor);
+    }
+}
+
+void HistoryIndex::forEachInRange(const std::chrono::system_clock::time_point& start,
+                                  const std::chrono::system_clock::time_point& end,
+                                  const Visitor& visitor) const {
+    /**
+     * @brief Visits entries with start <= timestamp <= end, newest first.
+     *        Both bounds are found by binary search.
+     */
+    if (end < start) {
+        return;
+    }
+    size_t lower = lowerBound(start);
+    for (size_t i = upperBound(end); i > lower; --i) {
+        size_t slot = physical(i - 1);
+        if (live_[slot] && !visitor(ring_[slot])) {
+            return;
+        }
+    }
+}
+
+std::vector<ImportHistoryEntry> HistoryIndex::page(size_t offset, size_t limit) const {
+    /**
+     * @brief Copies one page of entries, newest first.
+     *
+     * @param offset Number of newest entries to skip.
+     * @param limit Maximum number of entries to return.
+     */
+    std::vector<ImportHistoryEntry> result;
+    if (offset >= live_count_ || limit == 0) {
+        return result;
+    }
+    result.reserve(std::min(limit, live_count_ - offset));
+    size_t skipped = 0;
+    forEach([&](const ImportHistoryEntry& entry) {
+        if (skipped < offset) {
+            ++skipped;
+            return true;
+        }
+        result.push_back(entry);
+        return result.size() < limit;
+    });
+    return result;
+}
+
+std::vector<ImportHistoryEntry> HistoryIndex::entries() const {
+    std::vector<ImportHistoryEntry> result;
+    result.reserve(live_count_);
+    for (size_t i = 0; i < count_; ++i) {
+        size_t slot = physical(i);
+        if (live_[slot]) {
+            result.push_back(ring_[slot]);
+        }
+    }
+    return result;
+}
+
+size_t HistoryIndex::lowerBound(const std::chrono::system_clock::time_point& time) const {
+    size_t low = 0;
+    size_t high = count_;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (ring_[physical(middle)].timestamp < time) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+size_t HistoryIndex::upperBound(const std::chrono::system_clock::time_point& time) const {
+    size_t low = 0;
+    size_t high = count_;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (time < ring_[physical(middle)].timestamp) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
+void HistoryIndex::mergeSorted(std::vector<ImportHistoryEntry> entries) {
+    /**
+     * @brief Merges time-sorted, not yet stored entries with the live slots in one pass and re-lays out.
+     *        Stored entries stay ahead of new ones with the same timestamp.
+     */
+    std::vector<ImportHistoryEntry> merged;
+    merged.reserve(live_count_ + entries.size());
+    size_t next = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        size_t slot = physical(i);
+        while (next < entries.size() && entries[next].timestamp < ring_[slot].timestamp) {
+            merged.push_back(std::move(entries[next++]));
+        }
+        if (live_[slot]) {
+            merged.push_back(std::move(ring_[slot]));
+        }
+    }
+    for (; next < entries.size(); ++next) {
+        merged.push_back(std::move(entries[next]));
+    }
+    relayout(std::move(merged));
+}
+
+void HistoryIndex::keepLastById(std::vector<ImportHistoryEntry>& entries) {
+    /* Drops all but the last entry per id, keeping the order of the survivors. */
+    std::unordered_map<std::string, size_t> last_seen;
+    last_seen.reserve(entries.size());
+    std::vector<bool> keep(entries.size(), true);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto inserted = last_seen.emplace(entries[i].id, i);
+        if (!inserted.second) {
+            keep[inserted.first->second] = false;
+            inserted.first->second = i;
+        }
+    }
+    size_t write = 0;
+    for (size_t read = 0; read < entries.size(); ++read) {
+        if (!keep[read]) continue;
+        if (write != read) {
+            entries[write] = std::move(entries[read]);
+        }
+        ++write;
+    }
+    entries.resize(write);
+}
+
+void HistoryIndex::pushBack(ImportHistoryEntry entry) {
+    /**
+     * @brief Appends a live slot, doubling the ring when it is full.
+     */
+    if (count_ == ring_.size()) {
+        std::vector<ImportHistoryEntry> grown(std::max<size_t>(16, ring_.size() * 2));
+        std::vector<bool> grown_live(grown.size(), false);
+        for (size_t i = 0; i < count_; ++i) {
+            size_t slot = physical(i);
+            grown[i] = std::move(ring_[slot]);
+            grown_live[i] = live_[slot];
+        }
+        ring_ = std::move(grown);
+        live_ = std::move(grown_live);
+        head_ = 0;
+    }
+    size_t slot = physical(count_);
+    ring_[slot] = std::move(entry);
+    live_[slot] = true;
+    ++count_;
+}
+
+void HistoryIndex::trimFront() {
+    /**
+     * @brief Pops tombstoned slots off the ring head in O(1) each.
+     *        The popped sequence number is the oldest in its asset/type lists, so it is always at their front.
+     */
+    while (count_ > 0 && !live_[head_]) {
+        ImportHistoryEntry& entry = ring_[head_];
+        for (auto* index : {&by_asset_, &by_type_}) {
+            const std::string& key = index == &by_asset_ ? entry.asset_path : entry.import_type;
+            auto it = index->find(key);
+            if (it != index->end()) {
+                if (!it->second.empty() && it->second.front() == base_seq_) {
+                    it->second.pop_front();
+                }
+                if (it->second.empty()) {
+                    index->erase(it);
+                }
+            }
+        }
+        entry = ImportHistoryEntry{};   // release the slot's strings and maps now
+        head_ = (head_ + 1) & (ring_.size() - 1);
+        ++base_seq_;
+        --count_;
+    }
+}
+
+void HistoryIndex::relayout(std::vector<ImportHistoryEntry> entries) {
+    /**
+     * @brief Writes entries linearly into a fresh ring and re-derives all indices.
+     *
+     * @param entries Entries in time order, all live.
+     */
+    size_t size = entries.size();
+    size_t capacity = 16;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+    entries.resize(capacity);
+    ring_ = std::move(entries);
+    live_.assign(capacity, false);
+    std::fill(live_.begin(), live_.begin() + static_cast<std::ptrdiff_t>(size), true);
+    head_ = 0;
+    count_ = size;
+    live_count_ = size;
+
+    by_id_.clear();
+    by_asset_.clear();
+    by_type_.clear();
+    by_id_.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        indexSlot(i);
+    }
+}
+
+std::vector<ImportHistoryEntry> HistoryIndex::takeLive() {
+    std::vector<ImportHistoryEntry> entries;
+    entries.reserve(live_count_);
+    for (size_t i = 0; i < count_; ++i) {
+        size_t slot = physical(i);
+        if (live_[slot]) {
+            entries.push_back(std::move(ring_[slot]));
+        }
+    }
+    return entries;
+}
+
+void HistoryIndex::indexSlot(size_t logical) {
+    const ImportHistoryEntry& entry = ring_[physical(logical)];
+    uint64_t sequence = base_seq_ + logical;
+    by_id_[entry.id] = sequence;
+    by_asset_[entry.asset_path].push_back(sequence);
+    by_type_[entry.import_type].push_back(sequence);
+}
+
+void HistoryIndex::kill(size_t logical) {
+    size_t slot = physical(logical);
+    rollup_.remove(ring_[slot]);
+    live_[slot] = false;
+    --live_count_;
+    by_id_.erase(ring_[slot].id);
+    if (logical == 0) {
+        trimFront();
+    }
+    if (live_count_ == 0) {
+        rollup_.clear();   // also drops sketch counters that assets inherited through eviction
+    }
+}
+
+void HistoryIndex::compactIfSparse() {
+    // Tombstones never outnumber live entries (beyond a small floor), so walks stay O(live)
+    size_t dead = count_ - live_count_;
+    if (dead > 64 && dead > live_count_) {
+        relayout(takeLive());
+    }
+}
+
+void HistoryIndex::walkSequences(const std::deque<uint64_t>& sequences, const Visitor& visitor) const {
+    for (auto it = sequences.rbegin(); it != sequences.rend(); ++it) {
+        size_t slot = physical(static_cast<size_t>(*it - base_seq_));
+        if (live_[slot] && !visitor(ring_[slot])) {
+            return;
+        }
+    }
+}
+
+std::mt19937_64 HistoryIdGenerator::seededEngine() {
+    /**
+     * @brief Builds the generator's engine from a full-width seed.
+     *        random_device yields 32 bits per call, so one draw would leave most of the
+     *        mt19937_64 state predictable and let processes started together collide.
+     *        Eight draws plus the pid and both clocks go through a seed_seq instead.
+     *
+     * @return Seeded engine.
+     */
+    std::random_device device;
+    std::vector<uint32_t> material;
+    for (int i = 0; i < 8; ++i) {
+        material.push_back(device());
+    }
+    const uint64_t wall = static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    const uint64_t steady = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    material.push_back(static_cast<uint32_t>(::getpid()));
+    material.push_back(static_cast<uint32_t>(wall));
+    material.push_back(static_cast<uint32_t>(wall >> 32));
+    material.push_back(static_cast<uint32_t>(steady));
+    material.push_back(static_cast<uint32_t>(steady >> 32));
+    std::seed_seq seq(material.begin(), material.end());
+    return std::mt19937_64(seq);
+}
+
+std::string HistoryIdGenerator::next() {
+    /**
+     * @brief Returns the next monotonic ULID-style id.
+     *        Within one millisecond (or if the clock steps back) the 80-bit random part is
+     *        incremented instead of redrawn, so ids sort in generation order.
+     *
+     * @return "import_" followed by 26 Crockford base32 characters.
+     */
+    static const char* alphabet = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+    static std::mutex mutex;
+    static std::mt19937_64 rng = seededEngine();
+    static uint64_t last_ms = 0;
+    static uint64_t random_hi = 0;   // upper 16 of the 80 random bits
+    static uint64_t random_lo = 0;   // lower 64 bits
+
+    uint64_t now_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+
+    uint64_t time_ms;
+    uint64_t hi;
+    uint64_t lo;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (now_ms > last_ms) {
+            last_ms = now_ms;
+            random_hi = rng() & 0xFFFF;
+            random_lo = rng();
+        } else if (++random_lo == 0 && ++random_hi > 0xFFFF) {
+            // Random space exhausted within one millisecond; borrow the next one
+            ++last_ms;
+            random_hi = 0;
+        }
+        time_ms = last_ms;
+        hi = random_hi;
+        lo = random_lo;
+    }
+
+    std::string id = "import_";
+    id.resize(7 + 26);
+    char* out = &id[7];
+    for (int i = 9; i >= 0; --i) {
+        out[i] = alphabet[time_ms & 0x1F];
+        time_ms >>= 5;
+    }
+    // 80 random bits as 16 base32 digits, least significant first
+    for (int i = 25; i >= 10; --i) {
+        out[i] = alphabet[lo & 0x1F];
+        lo = (lo >> 5) | ((hi & 0x1F) << 59);
+        hi >>= 5;
+    }
+    return id;
+}
+
+} // namespace AssetManager
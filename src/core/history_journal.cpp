@@ -0,0 +1,745 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: history_journal.cpp
+ * Description: Implementation of the HistoryJournal append-only store for ImportHistory.
+ *              Appends checksummed records, seals and compacts the journal into a snapshot in the
+ *              background, and rebuilds history after restarts or crashes.
+ *
+ * Architecture:
+ * - Record framing: "<crc32 hex> <json>\n"; add records are {"op":"add","entry":{...}},
+ *   removals {"op":"remove","ids":[...]} and clears {"op":"clear"}
+ * - Snapshot uses the same framing (a header line followed by add records), written to
+ *   "<snapshot>.tmp", fsync'd and renamed over the previous snapshot
+ * - Sealing renames the active journal; if a failed compaction left a sealed journal behind,
+ *   the active journal is appended to it instead so no records are ever dropped
+ *
+ * - Locking: appends hold a shared flock on "<path>.lock" for one write(); sealing holds it exclusively,
+ *   so a sealed journal never has a record in flight. Compactions across processes are serialized by an
+ *   exclusive, non-blocking flock on "<path>.compact.lock"; recovery takes it shared
+ * - A writer whose journal was sealed by another process notices the inode change and reopens the path
+ *
+ * Key Features:
+ * - Replay keyed by entry id, so re-applying a sealed journal on top of a newer snapshot is harmless
+ * - Damaged records are skipped and replay resumes on the next line; only an incomplete final record
+ *   of the active journal is truncated
+ * - Compaction threshold scales with the live entry count, keeping compaction cost amortized O(1)
+ */
+
+#include "history_journal.hpp"
+#include "import_history.hpp"
+#include "crc32.hpp"
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+using json = nlohmann::json;
+
+namespace AssetManager {
+
+HistoryJournal::HistoryJournal(const std::string& history_path)
+    : journal_path_(history_path + ".journal"),
+      sealed_path_(history_path + ".journal.sealed"),
+      snapshot_path_(history_path + ".snapshot"),
+      lock_path_(history_path + ".lock"),
+      compact_lock_path_(history_path + ".compact.lock") {
+}
+
+HistoryJournal::~HistoryJournal() {
+    waitForCompaction();
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeJournalLocked();
+    for (int fd : {lock_fd_, compact_lock_fd_, tail_fd_}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+bool HistoryJournal::appendAdd(const ImportHistoryEntry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return appendRecordLocked("{\"op\":\"add\",\"entry\":" + encodeEntry(entry) + "}");
+}
+
+bool HistoryJournal::appendRemove(const std::vector<std::string>& entry_ids) {
+    if (entry_ids.empty()) {
+        return true;
+    }
+    json record;
+    record["op"] = "remove";
+    record["ids"] = entry_ids;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return appendRecordLocked(record.dump());
+}
+
+bool HistoryJournal::appendClear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return appendRecordLocked("{\"op\":\"clear\"}");
+}
+
+bool HistoryJournal::recover(std::vector<ImportHistoryEntry>& entries) {
+    /**
+     * @brief Rebuilds history from snapshot, sealed journal and active journal.
+     *        Includes every record appended by any process sharing the store.
+     *
+     * @param entries Receives the live entries in insertion order.
+     * @return False only if an existing file could not be read.
+     */
+    waitForCompaction();
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeJournalLocked();
+
+    ReplayState state;
+    bool ok = true;
+
+    // A compaction in another process must not replace the snapshot or drop the sealed journal mid-read
+    bool compact_locked = lockFile(compact_lock_fd_, compact_lock_path_, LOCK_SH);
+    for (const std::string* path : {&snapshot_path_, &sealed_path_}) {
+        std::error_code ec;
+        if (!std::filesystem::exists(*path, ec)) continue;
+        bool torn = false;
+        size_t damaged = 0;
+        size_t replayed_records = replayFile(*path, false, state, torn, damaged);
+        if (replayed_records == static_cast<size_t>(-1)) {
+            ok = false;
+            continue;
+        }
+        stats_.records_replayed += replayed_records;
+        stats_.torn_records_discarded += torn ? 1 : 0;
+        stats_.damaged_records_skipped += damaged;
+    }
+
+    // Exclusive append lock: no write is in flight, so a torn tail is a crash remnant and can be cut
+    bool append_locked = lockFile(lock_fd_, lock_path_, LOCK_EX);
+    if (tail_fd_ >= 0) {
+        ::close(tail_fd_);
+    }
+    tail_fd_ = ::open(journal_path_.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st{};
+    tail_inode_ = (tail_fd_ >= 0 && ::fstat(tail_fd_, &st) == 0) ? static_cast<uint64_t>(st.st_ino) : 0;
+    tail_offset_ = 0;
+    own_records_.clear();
+    if (tail_inode_ != 0) {
+        bool torn = false;
+        size_t damaged = 0;
+        size_t replayed_records = replayFile(journal_path_, append_locked, state, torn, damaged, &tail_offset_);
+        if (replayed_records == static_cast<size_t>(-1)) {
+            ok = false;
+        } else {
+            stats_.records_replayed += replayed_records;
+            stats_.torn_records_discarded += torn ? 1 : 0;
+            stats_.damaged_records_skipped += damaged;
+        }
+    }
+    tail_ready_ = ok;
+    if (append_locked) unlockFile(lock_fd_);
+    if (compact_locked) unlockFile(compact_lock_fd_);
+
+    entries.clear();
+    entries.reserve(state.positions.size());
+    for (size_t i = 0; i < state.entries.size(); ++i) {
+        if (state.live[i]) entries.push_back(std::move(state.entries[i]));
+    }
+    stats_.records_since_compaction = 0;
+    return ok;
+}
+
+bool HistoryJournal::tail(const std::function<void(const ImportHistoryEntry&)>& on_add,
+                          const std::function<void(const std::vector<std::string>&)>& on_remove,
+                          const std::function<void()>& on_clear) {
+    /**
+     * @brief Streams records appended to the active journal since the last recover()/tail().
+     *        Records this process appended are skipped: the caller applied them when it wrote them.
+     *
+     * @return False if the journal was sealed (or first created) since the last read; call recover().
+     */
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!tail_ready_) {
+        return false;
+    }
+    // Shared lock keeps the journal from being sealed while it is read
+    bool append_locked = lockFile(lock_fd_, lock_path_, LOCK_SH);
+    bool current = inodeOf(journal_path_) == tail_inode_;
+    if (current && tail_inode_ != 0) {
+        uint64_t good_offset = 0;
+        bool torn = false;   // a partial final record here is another writer's append in flight
+        size_t damaged = 0;
+        size_t delivered = 0;
+        size_t read = readRecords(journal_path_, tail_offset_,
+            [&](RecordOp op, uint64_t offset, ImportHistoryEntry& entry, const std::vector<std::string>& ids) {
+                if (own_records_.erase(offset) != 0) return;
+                if (op == RecordOp::Add) on_add(entry);
+                else if (op == RecordOp::Remove) on_remove(ids);
+                else on_clear();
+                ++delivered;
+            }, good_offset, torn, damaged);
+        if (read == static_cast<size_t>(-1)) {
+            current = false;
+        } else {
+            tail_offset_ += good_offset;
+            stats_.records_tailed += delivered;
+            stats_.damaged_records_skipped += damaged;
+        }
+    }
+    if (!current) {
+        own_records_.clear();
+    }
+    if (append_locked) unlockFile(lock_fd_);
+    return current;
+}
+
+bool HistoryJournal::shouldCompact(size_t live_entries) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.records_since_compaction >= std::max(compaction_threshold_, live_entries);
+}
+
+void HistoryJournal::compactAsync() {
+    /**
+     * @brief Seals the active journal and writes the snapshot on a background thread.
+     *        Appends made while the snapshot is being written go to a fresh journal.
+     *        Skipped if another process is already compacting the same store.
+     */
+    waitForCompaction();
+    if (!tryBeginCompaction()) {
+        return;
+    }
+    compaction_thread_ = std::thread([this]() {
+        bool ok = buildAndWriteSnapshot();
+        endCompaction();
+        std::lock_guard<std::mutex> lock(mutex_);
+        ok ? ++stats_.compactions : ++stats_.failed_compactions;
+    });
+}
+
+bool HistoryJournal::compact() {
+    waitForCompaction();
+    if (!tryBeginCompaction()) {
+        return false;
+    }
+    bool ok = buildAndWriteSnapshot();
+    endCompaction();
+    std::lock_guard<std::mutex> lock(mutex_);
+    ok ? ++stats_.compactions : ++stats_.failed_compactions;
+    return ok;
+}
+
+void HistoryJournal::waitForCompaction() {
+    if (compaction_thread_.joinable()) {
+        compaction_thread_.join();
+    }
+}
+
+void HistoryJournal::setDurableWrites(bool enable) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    durable_writes_ = enable;
+}
+
+void HistoryJournal::setCompactionThreshold(size_t records) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    compaction_threshold_ = records == 0 ? 1 : records;
+}
+
+HistoryJournalStats HistoryJournal::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::string HistoryJournal::getJournalPath() const {
+    return journal_path_;
+}
+
+std::string HistoryJournal::getSnapshotPath() const {
+    return snapshot_path_;
+}
+
+bool HistoryJournal::hasStore() const {
+    std::error_code ec;
+    for (const std::string* path : {&snapshot_path_, &sealed_path_, &journal_path_}) {
+        if (std::filesystem::exists(*path, ec)) return true;
+    }
+    return false;
+}
+
+std::string HistoryJournal::encodeEntry(const ImportHistoryEntry& entry) {
+    /**
+     * @brief Serializes an entry as compact single-line JSON (strings fully escaped).
+     *
+     * @param entry Entry to encode.
+     * @return JSON object text without a trailing newline.
+     */
+    json j;
+    j["id"] = entry.id;
+    j["asset_path"] = entry.asset_path;
+    j["import_type"] = entry.import_type;
+    j["timestamp_us"] = std::chrono::duration_cast<std::chrono::microseconds>(
+        entry.timestamp.time_since_epoch()).count();
+    j["options"] = entry.options;
+    j["imported_objects"] = entry.imported_objects;
+    j["success"] = entry.success;
+    j["message"] = entry.message;
+    j["collection_name"] = entry.collection_name;
+    j["metadata"] = entry.metadata;
+    return j.dump(-1, ' ', false, json::error_handler_t::replace);
+}
+
+bool HistoryJournal::decodeEntry(const std::string& json_text, ImportHistoryEntry& entry) {
+    /**
+     * @brief Parses an entry produced by encodeEntry().
+     *
+     * @param json_text JSON object text.
+     * @param entry Receives the decoded entry.
+     * @return False if the text is not a valid entry object.
+     */
+    try {
+        json j = json::parse(json_text);
+        if (!j.is_object() || !j.contains("id")) {
+            return false;
+        }
+        entry = ImportHistoryEntry{};
+        entry.id = j.value("id", "");
+        entry.asset_path = j.value("asset_path", "");
+        entry.import_type = j.value("import_type", "");
+        entry.timestamp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::microseconds(j.value("timestamp_us", int64_t{0}))));
+        entry.options = j.value("options", std::map<std::string, std::string>{});
+        entry.imported_objects = j.value("imported_objects", std::vector<std::string>{});
+        entry.success = j.value("success", false);
+        entry.message = j.value("message", "");
+        entry.collection_name = j.value("collection_name", "");
+        entry.metadata = j.value("metadata", std::map<std::string, std::string>{});
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool HistoryJournal::appendRecordLocked(const std::string& payload) {
+    /*
+     * Appends one framed record.
+     * - A single write() on an O_APPEND descriptor, so records never interleave, even across processes
+     * - A short write is not continued: other writers may already have appended behind the fragment.
+     *   The fragment is closed with '\n' (readers skip it as a damaged record) and the whole record is
+     *   written again; a failed write is closed the same way before giving up
+     */
+    if (!lockFile(lock_fd_, lock_path_, LOCK_SH)) {
+        std::cerr << "History journal lock failed: " << lock_path_ << std::endl;
+        return false;
+    }
+    // Another process may have sealed (renamed) the journal since it was opened
+    struct stat st{};
+    if (journal_fd_ >= 0 && (::fstat(journal_fd_, &st) != 0 ||
+                             static_cast<uint64_t>(st.st_ino) != inodeOf(journal_path_))) {
+        closeJournalLocked();
+    }
+    if (!openJournalLocked()) {
+        unlockFile(lock_fd_);
+        return false;
+    }
+    std::string record = frameRecord(payload);
+    bool written_whole = false;
+    for (int attempt = 0; attempt < kWriteAttempts && !written_whole;) {
+        ssize_t written = ::write(journal_fd_, record.data(), record.size());
+        if (written < 0 && errno == EINTR) continue;
+        ++attempt;
+        if (written == static_cast<ssize_t>(record.size())) {
+            written_whole = true;
+        } else if (written > 0) {
+            terminateFragmentLocked();
+        } else {
+            break;   // nothing reached the file
+        }
+    }
+    if (!written_whole) {
+        std::cerr << "History journal write failed: " << journal_path_ << std::endl;
+        unlockFile(lock_fd_);
+        return false;
+    }
+    // O_APPEND leaves the descriptor just past this record; remember where it starts so tail() skips it
+    off_t end = ::lseek(journal_fd_, 0, SEEK_CUR);
+    if (tail_ready_ && end >= 0 && ::fstat(journal_fd_, &st) == 0 &&
+        static_cast<uint64_t>(st.st_ino) == tail_inode_) {
+        own_records_.insert(static_cast<uint64_t>(end) - record.size());
+    }
+    unlockFile(lock_fd_);
+    if (durable_writes_) {
+        ::fdatasync(journal_fd_);
+    }
+    ++stats_.records_appended;
+    ++stats_.records_since_compaction;
+    stats_.bytes_appended += record.size();
+    return true;
+}
+
+void HistoryJournal::terminateFragmentLocked() {
+    /* Ends a partially written record's line, so the next record starts on a line of its own. */
+    while (::write(journal_fd_, "\n", 1) < 0 && errno == EINTR) {
+    }
+}
+
+bool HistoryJournal::openJournalLocked() {
+    if (journal_fd_ >= 0) {
+        return true;
+    }
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(journal_path_).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+    journal_fd_ = ::open(journal_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    return journal_fd_ >= 0;
+}
+
+void HistoryJournal::closeJournalLocked() {
+    if (journal_fd_ >= 0) {
+        ::close(journal_fd_);
+        journal_fd_ = -1;
+    }
+}
+
+bool HistoryJournal::sealJournalLocked() {
+    /*
+     * Moves the active journal aside for compaction.
+     * - Holds the append lock exclusively, so no process has a record half-written
+     * - Normal case: rename journal -> sealed
+     * - A sealed journal left by a failed compaction still holds records the old snapshot
+     *   lacks, so the active journal is appended to it rather than replacing it
+     */
+    closeJournalLocked();
+    if (!lockFile(lock_fd_, lock_path_, LOCK_EX)) {
+        return false;
+    }
+    bool ok = true;
+    std::error_code ec;
+    if (!std::filesystem::exists(journal_path_, ec)) {
+        // Nothing to seal
+    } else if (!std::filesystem::exists(sealed_path_, ec)) {
+        ok = std::rename(journal_path_.c_str(), sealed_path_.c_str()) == 0;
+    } else {
+        std::ifstream active(journal_path_, std::ios::binary);
+        std::ofstream sealed(sealed_path_, std::ios::binary | std::ios::app);
+        ok = active.is_open() && sealed.is_open();
+        if (ok) {
+            sealed << active.rdbuf();
+            sealed.close();
+            active.close();
+            ok = static_cast<bool>(sealed);
+        }
+        if (ok) {
+            std::filesystem::remove(journal_path_, ec);
+        }
+    }
+    unlockFile(lock_fd_);
+    if (ok) {
+        stats_.records_since_compaction = 0;
+    }
+    return ok;
+}
+
+bool HistoryJournal::tryBeginCompaction() {
+    /**
+     * @brief Takes the cross-process compaction lock and seals the active journal.
+     *
+     * @return False if another process is compacting (deferred) or sealing failed.
+     */
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!lockFile(compact_lock_fd_, compact_lock_path_, LOCK_EX | LOCK_NB)) {
+        // The other compactor will fold this process's records too; back off until the next threshold
+        ++stats_.deferred_compactions;
+        stats_.records_since_compaction = 0;
+        return false;
+    }
+    if (!sealJournalLocked()) {
+        ++stats_.failed_compactions;
+        unlockFile(compact_lock_fd_);
+        return false;
+    }
+    return true;
+}
+
+void HistoryJournal::endCompaction() {
+    unlockFile(compact_lock_fd_);
+}
+
+bool HistoryJournal::buildAndWriteSnapshot() {
+    /*
+     * Folds the previous snapshot and the sealed journal into a new snapshot.
+     * - Built from disk, so entries appended by every process sharing the store are kept
+     * - Runs under the compaction lock; the sealed journal can no longer change
+     */
+    ReplayState state;
+    for (const std::string* path : {&snapshot_path_, &sealed_path_}) {
+        std::error_code ec;
+        if (!std::filesystem::exists(*path, ec)) continue;
+        bool torn = false;
+        size_t damaged = 0;
+        if (replayFile(*path, false, state, torn, damaged) == static_cast<size_t>(-1)) {
+            return false;
+        }
+    }
+    std::vector<ImportHistoryEntry> entries;
+    entries.reserve(state.positions.size());
+    for (size_t i = 0; i < state.entries.size(); ++i) {
+        if (state.live[i]) entries.push_back(std::move(state.entries[i]));
+    }
+    return writeSnapshot(entries);
+}
+
+bool HistoryJournal::writeSnapshot(const std::vector<ImportHistoryEntry>& entries) {
+    /*
+     * Writes and publishes a snapshot.
+     * - tmp file + fsync + rename, so the previous snapshot stays valid until the new one is complete
+     * - The sealed journal is only deleted once the rename has succeeded
+     */
+    std::string tmp_path = snapshot_path_ + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        json header;
+        header["op"] = "snapshot";
+        header["version"] = 1;
+        header["entries"] = entries.size();
+        out << frameRecord(header.dump());
+        for (const auto& entry : entries) {
+            out << frameRecord("{\"op\":\"add\",\"entry\":" + encodeEntry(entry) + "}");
+        }
+        out.flush();
+        if (!out) {
+            return false;
+        }
+    }
+    int fd = ::open(tmp_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+    if (std::rename(tmp_path.c_str(), snapshot_path_.c_str()) != 0) {
+        return false;
+    }
+    std::filesystem::path parent = std::filesystem::path(snapshot_path_).parent_path();
+    int dir_fd = ::open(parent.empty() ? "." : parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+    std::error_code ec;
+    std::filesystem::remove(sealed_path_, ec);
+    return true;
+}
+
+size_t HistoryJournal::replayFile(const std::string& path, bool truncate_torn_tail, ReplayState& state,
+                                  bool& torn, size_t& damaged, uint64_t* end_offset) {
+    /**
+     * @brief Applies the records of one file to the replay state.
+     *
+     * @param path File to replay.
+     * @param truncate_torn_tail Cut an incomplete final record (active journal only); damaged records
+     *                           in the middle are skipped, never truncated, so later records survive.
+     * @param torn Set if the file ends in an incomplete record.
+     * @param damaged Receives the number of damaged records skipped.
+     * @param end_offset Optional; receives the offset just past the last complete record.
+     * @return Number of records applied, or size_t(-1) if the file could not be opened.
+     */
+    uint64_t good_offset = 0;
+    size_t applied = readRecords(path, 0,
+        [&state](RecordOp op, uint64_t, ImportHistoryEntry& entry, const std::vector<std::string>& ids) {
+            applyRecord(state, op, entry, ids);
+        }, good_offset, torn, damaged);
+    if (applied == static_cast<size_t>(-1)) {
+        return applied;
+    }
+    if (torn && truncate_torn_tail) {
+        std::error_code ec;
+        std::filesystem::resize_file(path, good_offset, ec);
+    }
+    if (end_offset) {
+        *end_offset = good_offset;
+    }
+    return applied;
+}
+
+size_t HistoryJournal::readRecords(const std::string& path, uint64_t start_offset, const RecordHandler& handler,
+                                   uint64_t& good_offset, bool& torn, size_t& damaged) {
+    /**
+     * @brief Decodes framed records from `start_offset` to the end of the file.
+     *
+     * Records are newline-framed and checksummed, so a damaged line (a fragment left by a failed write,
+     * possibly with another writer's record appended right behind it) is skipped and reading resumes on
+     * the next line. A record embedded at the end of a damaged line is still delivered.
+     *
+     * @param handler Receives each record with its offset in the file.
+     * @param good_offset Receives the number of bytes consumed, up to the last complete line.
+     * @param torn Set if the file ends in an incomplete record (a crash remnant or an append in flight).
+     * @param damaged Receives the number of damaged lines skipped.
+     * @return Number of records delivered, or size_t(-1) if the file could not be opened.
+     */
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return static_cast<size_t>(-1);
+    }
+    if (start_offset > 0) {
+        in.seekg(static_cast<std::streamoff>(start_offset));
+    }
+
+    static const std::string add_prefix = "{\"op\":\"add\",\"entry\":";
+    static const std::vector<std::string> no_ids;
+    // Validates and delivers one "<crc32 hex> <json>" record; false if it is damaged
+    auto deliver = [&handler](const char* data, size_t size, uint64_t offset) -> bool {
+        if (size < 10 || data[8] != ' ' ||
+            !std::all_of(data, data + 8, [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; })) {
+            return false;
+        }
+        const char* payload = data + 9;
+        size_t payload_size = size - 9;
+        uint32_t expected = static_cast<uint32_t>(std::strtoul(std::string(data, 8).c_str(), nullptr, 16));
+        if (Crc32::update(0, reinterpret_cast<const unsigned char*>(payload), payload_size) != expected) {
+            return false;
+        }
+
+        std::string body(payload, payload_size);
+        ImportHistoryEntry entry;
+        if (body.compare(0, add_prefix.size(), add_prefix) == 0) {
+            if (!decodeEntry(body.substr(add_prefix.size(), body.size() - add_prefix.size() - 1), entry)) {
+                return false;
+            }
+            handler(RecordOp::Add, offset, entry, no_ids);
+            return true;
+        }
+        json record = json::parse(body, nullptr, false);
+        if (record.is_discarded() || !record.is_object()) {
+            return false;
+        }
+        std::string op = record.value("op", "");
+        if (op == "remove" && record.contains("ids") && record["ids"].is_array()) {
+            std::vector<std::string> ids;
+            for (const auto& id : record["ids"]) {
+                if (id.is_string()) ids.push_back(id.get<std::string>());
+            }
+            handler(RecordOp::Remove, offset, entry, ids);
+        } else if (op == "clear") {
+            handler(RecordOp::Clear, offset, entry, no_ids);
+        }
+        return true;
+    };
+
+    size_t applied = 0;
+    good_offset = 0;
+    torn = false;
+    damaged = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (in.eof()) {
+            torn = true;   // the final line must end with '\n'
+            break;
+        }
+        uint64_t offset = start_offset + good_offset;
+        good_offset += line.size() + 1;
+        if (line.empty()) {
+            continue;   // the terminator of a fragment whose line was already closed by another record
+        }
+        if (deliver(line.data(), line.size(), offset)) {
+            ++applied;
+            continue;
+        }
+        ++damaged;
+        // Resynchronise inside the line: a whole record appended behind an unterminated fragment
+        for (size_t pos = 1; pos + 10 <= line.size(); ++pos) {
+            if (line[pos + 8] == ' ' && deliver(line.data() + pos, line.size() - pos, offset + pos)) {
+                ++applied;
+                break;
+            }
+        }
+    }
+    return applied;
+}
+
+void HistoryJournal::applyRecord(ReplayState& state, RecordOp op, ImportHistoryEntry& entry,
+                                 const std::vector<std::string>& ids) {
+    switch (op) {
+        case RecordOp::Add: {
+            auto it = state.positions.find(entry.id);
+            if (it != state.positions.end()) {
+                state.entries[it->second] = std::move(entry);
+            } else {
+                state.positions[entry.id] = state.entries.size();
+                state.entries.push_back(std::move(entry));
+                state.live.push_back(true);
+            }
+            break;
+        }
+        case RecordOp::Remove:
+            for (const auto& id : ids) {
+                auto it = state.positions.find(id);
+                if (it != state.positions.end()) {
+                    state.live[it->second] = false;
+                    state.positions.erase(it);
+                }
+            }
+            break;
+        case RecordOp::Clear:
+            std::fill(state.live.begin(), state.live.end(), false);
+            state.positions.clear();
+            break;
+    }
+}
+
+bool HistoryJournal::lockFile(int& fd, const std::string& path, int operation) {
+    /*
+     * flock() on a lazily opened lock file (created next to the history files).
+     * - Retries on EINTR; LOCK_NB failures return false immediately
+     */
+    if (fd < 0) {
+        std::error_code ec;
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent, ec);
+        }
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+    }
+    while (::flock(fd, operation) != 0) {
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void HistoryJournal::unlockFile(int fd) {
+    if (fd >= 0) {
+        ::flock(fd, LOCK_UN);
+    }
+}
+
+uint64_t HistoryJournal::inodeOf(const std::string& path) {
+    struct stat st{};
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_ino) : 0;
+}
+
+std::string HistoryJournal::frameRecord(const std::string& payload) {
+    char prefix[10];
+    uint32_t crc = Crc32::update(0, reinterpret_cast<const unsigned char*>(payload.data()), payload.size());
+    std::snprintf(prefix, sizeof(prefix), "%08x ", crc);
+    std::string record;
+    record.reserve(payload.size() + 10);
+    record.append(prefix, 9);
+    record.append(payload);
+    record.push_back('\n');
+    return record;
+}
+
+} // namespace AssetManager
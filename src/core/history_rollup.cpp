@@ -0,0 +1,246 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: history_rollup.cpp
+ * Description: Implementation of the HistoryRollup time-bucketed counters and the AssetHeavyHitters sketch.
+ *
+ * Architecture:
+ * - Every add/remove touches the totals, one hourly bucket, one daily bucket and the sketch
+ * - Window query sums daily buckets for whole days inside the window and hourly buckets for the rest
+ * - Sketch keeps counters ordered by count (multimap) with a hash map from asset path to counter
+ *
+ * Key Features:
+ * - Space-Saving eviction: an untracked asset replaces the minimum counter and inherits its count as error
+ * - Removal of a tracked asset decrements its counter; counters that reach zero are freed
+ */
+
+#include "history_rollup.hpp"
+#include "import_history.hpp"
+#include <algorithm>
+#include <filesystem>
+
+namespace AssetManager {
+
+AssetHeavyHitters::AssetHeavyHitters(size_t capacity)
+    : capacity_(std::max<size_t>(capacity, 1)) {
+}
+
+void AssetHeavyHitters::add(const std::string& asset_path) {
+    auto it = counters_.find(asset_path);
+    if (it != counters_.end()) {
+        setCount(it->second, asset_path, it->second.position->first + 1);
+        return;
+    }
+
+    if (counters_.size() < capacity_) {
+        Counter counter{by_count_.emplace(1, asset_path), 0};
+        counters_.emplace(asset_path, counter);
+        return;
+    }
+
+    // Full: the new asset takes over the smallest counter
+    auto minimum = by_count_.begin();
+    size_t inherited = minimum->first;
+    counters_.erase(minimum->second);
+    by_count_.erase(minimum);
+    Counter counter{by_count_.emplace(inherited + 1, asset_path), inherited};
+    counters_.emplace(asset_path, counter);
+    evicted_ = true;
+}
+
+void AssetHeavyHitters::remove(const std::string& asset_path) {
+    auto it = counters_.find(asset_path);
+    if (it == counters_.end()) {
+        return;
+    }
+    size_t count = it->second.position->first;
+    if (count <= 1) {
+        by_count_.erase(it->second.position);
+        counters_.erase(it);
+        return;
+    }
+    it->second.error = std::min(it->second.error, count - 1);
+    setCount(it->second, asset_path, count - 1);
+}
+
+void AssetHeavyHitters::clear() {
+    by_count_.clear();
+    counters_.clear();
+    evicted_ = false;
+}
+
+std::vector<std::pair<std::string, size_t>> AssetHeavyHitters::top(size_t count) const {
+    /**
+     * @brief Returns the `count` assets with the highest estimated import counts.
+     *        Ties are ordered by asset path so results are stable between calls.
+     *
+     * @param count Maximum number of assets (at most the sketch capacity).
+     * @return (asset path, estimated count) pairs, highest first.
+     */
+    std::vector<std::pair<std::string, size_t>> ranked;
+    ranked.reserve(by_count_.size());
+    for (const auto& counter : by_count_) {
+        ranked.emplace_back(counter.second, counter.first);
+    }
+    size_t keep = std::min(count, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(keep), ranked.end(),
+                      [](const auto& a, const auto& b) {
+                          return a.second != b.second ? a.second > b.second : a.first < b.first;
+                      });
+    ranked.resize(keep);
+    return ranked;
+}
+
+void AssetHeavyHitters::setCount(Counter& counter, const std::string& asset_path, size_t count) {
+    by_count_.erase(counter.position);
+    counter.position = by_count_.emplace(count, asset_path);
+}
+
+HistoryRollup::HistoryRollup(size_t heavy_hitter_capacity)
+    : heavy_hitters_(heavy_hitter_capacity) {
+}
+
+void HistoryRollup::add(const ImportHistoryEntry& entry) {
+    /**
+     * @brief Counts a new entry in the totals, its hour and day buckets and the sketch.
+     *
+     * @param entry Entry being added to the history.
+     */
+    std::string asset_type = assetType(entry.asset_path);
+    int64_t hour = hourOf(entry.timestamp);
+    apply(totals_, entry, asset_type, true);
+    applyBucket(hourly_, hour, entry, asset_type, true);
+    applyBucket(daily_, floorDiv(hour, 24), entry, asset_type, true);
+    heavy_hitters_.add(entry.asset_path);
+}
+
+void HistoryRollup::remove(const ImportHistoryEntry& entry) {
+    /**
+     * @brief Reverses add() for an entry leaving the history.
+     *
+     * @param entry Entry being removed (same timestamp it was added with).
+     */
+    std::string asset_type = assetType(entry.asset_path);
+    int64_t hour = hourOf(entry.timestamp);
+    apply(totals_, entry, asset_type, false);
+    applyBucket(hourly_, hour, entry, asset_type, false);
+    applyBucket(daily_, floorDiv(hour, 24), entry, asset_type, false);
+    heavy_hitters_.remove(entry.asset_path);
+}
+
+void HistoryRollup::clear() {
+    totals_ = HistoryRollupCounters{};
+    hourly_.clear();
+    daily_.clear();
+    heavy_hitters_.clear();
+}
+
+HistoryRollupCounters HistoryRollup::window(const std::chrono::system_clock::time_point& start,
+                                            const std::chrono::system_clock::time_point& end) const {
+    /**
+     * @brief Sums the counters of every hour overlapping [start, end].
+     *        Whole days inside the window are read from daily buckets, so the cost is
+     *        O(days + edge hours) regardless of how many entries the window holds.
+     *
+     * @param start Window start.
+     * @param end Window end (inclusive).
+     * @return Counters for the bucket-aligned window.
+     */
+    HistoryRollupCounters result;
+    if (end < start) {
+        return result;
+    }
+    int64_t first_hour = hourOf(start);
+    int64_t last_hour = hourOf(end);
+
+    auto sumHours = [&](int64_t from, int64_t to) {
+        for (auto it = hourly_.lower_bound(from); it != hourly_.end() && it->first <= to; ++it) {
+            merge(result, it->second);
+        }
+    };
+
+    int64_t first_full_day = floorDiv(first_hour + 23, 24);
+    int64_t last_full_day = floorDiv(last_hour + 1, 24) - 1;
+    if (first_full_day > last_full_day) {
+        sumHours(first_hour, last_hour);
+        return result;
+    }
+    sumHours(first_hour, first_full_day * 24 - 1);
+    for (auto it = daily_.lower_bound(first_full_day); it != daily_.end() && it->first <= last_full_day; ++it) {
+        merge(result, it->second);
+    }
+    sumHours((last_full_day + 1) * 24, last_hour);
+    return result;
+}
+
+std::string HistoryRollup::assetType(const std::string& asset_path) {
+    return std::filesystem::path(asset_path).extension().string();
+}
+
+void HistoryRollup::apply(HistoryRollupCounters& counters, const ImportHistoryEntry& entry,
+                          const std::string& asset_type, bool add) {
+    auto bump = [add](size_t& value) {
+        if (add) {
+            ++value;
+        } else if (value > 0) {
+            --value;
+        }
+    };
+    auto bumpKey = [add](std::map<std::string, size_t>& values, const std::string& key) {
+        if (add) {
+            ++values[key];
+            return;
+        }
+        auto it = values.find(key);
+        if (it != values.end() && --it->second == 0) {
+            values.erase(it);
+        }
+    };
+
+    bump(counters.total);
+    bump(entry.success ? counters.successful : counters.failed);
+    bumpKey(counters.import_types, entry.import_type);
+    if (!asset_type.empty()) {
+        bumpKey(counters.asset_types, asset_type);
+    }
+}
+
+void HistoryRollup::merge(HistoryRollupCounters& into, const HistoryRollupCounters& from) {
+    into.total += from.total;
+    into.successful += from.successful;
+    into.failed += from.failed;
+    for (const auto& type : from.import_types) {
+        into.import_types[type.first] += type.second;
+    }
+    for (const auto& type : from.asset_types) {
+        into.asset_types[type.first] += type.second;
+    }
+}
+
+void HistoryRollup::applyBucket(std::map<int64_t, HistoryRollupCounters>& buckets, int64_t key,
+                                const ImportHistoryEntry& entry, const std::string& asset_type, bool add) {
+    if (add) {
+        apply(buckets[key], entry, asset_type, true);
+        return;
+    }
+    auto it = buckets.find(key);
+    if (it == buckets.end()) {
+        return;
+    }
+    apply(it->second, entry, asset_type, false);
+    if (it->second.total == 0) {
+        buckets.erase(it);
+    }
+}
+
+int64_t HistoryRollup::hourOf(const std::chrono::system_clock::time_point& time) {
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    return floorDiv(static_cast<int64_t>(seconds), 3600);
+}
+
+int64_t HistoryRollup::floorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+
+} // namespace AssetManager
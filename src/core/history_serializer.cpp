@@ -0,0 +1,625 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: history_serializer.cpp
+ * Description: Implementation of the HistorySerializer JSON writer and streaming SAX reader for ImportHistory.
+ *
+ * Architecture:
+ * - Reader is a single-pass JSON tokenizer over a byte range that emits SAX events
+ *   (start/end object and array, key, scalar) without allocating a document
+ * - SaxHandler tracks nesting depth and the current field; only three shapes are accepted
+ *   below an entry (scalar field, string map, string array), everything else is skipped
+ * - parseFile() maps the file read-only and hands the byte range to the Reader, which drops the pages
+ *   it has finished with every kReleaseWindow bytes so large exports do not stay resident
+ *
+ * Key Features:
+ * - No intermediate DOM; each entry is appended as soon as its closing brace is seen
+ * - Accepts both {"history": [...]} and a bare top-level array of entries
+ * - Legacy exports (seconds timestamps stored as strings) load unchanged
+ */
+
+#include "history_serializer.hpp"
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace AssetManager {
+
+class HistorySerializer::SaxHandler {
+public:
+    explicit SaxHandler(std::vector<ImportHistoryEntry>& entries) : entries_(entries) {}
+
+    bool null() { std::string empty; return scalar(empty, false); }
+    bool boolean(bool value) { std::string text = value ? "true" : "false"; return scalar(text, value); }
+    bool number_float(std::string text) { return scalar(text, false); }
+    bool string(std::string& value) { return scalar(value, false); }
+
+    bool number_integer(int64_t value) {
+        if (entry_open_ && depth_ == entry_depth_) {
+            if (field_ == Field::TimestampUs) {
+                setTimestamp(std::chrono::microseconds(value), true);
+                return true;
+            }
+            if (field_ == Field::Timestamp) {
+                setTimestamp(std::chrono::seconds(value), false);
+                return true;
+            }
+        }
+        std::string text = std::to_string(value);
+        return scalar(text, value != 0);
+    }
+
+    bool key(std::string& value) {
+        if (entry_open_ && depth_ == entry_depth_) {
+            field_ = fieldFor(value);
+        } else if (entry_open_ && depth_ == entry_depth_ + 1) {
+            map_key_.swap(value);
+        } else if (depth_ == 1 && !root_is_array_) {
+            in_history_key_ = value == "history";
+        }
+        return true;
+    }
+
+    bool start_object() {
+        ++depth_;
+        if (depth_ == 1) {
+            return true;
+        }
+        if (!entry_open_ && depth_ == history_depth_ + 1 && history_depth_ > 0) {
+            entry_open_ = true;
+            entry_depth_ = depth_;
+            current_ = ImportHistoryEntry{};
+            current_.success = false;
+            has_timestamp_us_ = false;
+            field_ = Field::Other;
+            return true;
+        }
+        if (entry_open_ && depth_ == entry_depth_ + 1) {
+            container_ = (field_ == Field::Options || field_ == Field::Metadata) ? field_ : Field::Other;
+        }
+        return true;
+    }
+
+    bool end_object() {
+        if (entry_open_ && depth_ == entry_depth_) {
+            entry_open_ = false;
+            entries_.push_back(std::move(current_));
+        } else if (entry_open_ && depth_ == entry_depth_ + 1) {
+            container_ = Field::Other;
+        }
+        --depth_;
+        return true;
+    }
+
+    bool start_array() {
+        ++depth_;
+        if (depth_ == 1) {
+            root_is_array_ = true;
+            history_depth_ = 1;
+        } else if (depth_ == 2 && in_history_key_ && history_depth_ == 0) {
+            history_depth_ = 2;
+        } else if (entry_open_ && depth_ == entry_depth_ + 1) {
+            container_ = field_ == Field::ImportedObjects ? field_ : Field::Other;
+        }
+        return true;
+    }
+
+    bool end_array() {
+        if (depth_ == history_depth_) {
+            history_depth_ = -1;   // only the first history array is read
+        } else if (entry_open_ && depth_ == entry_depth_ + 1) {
+            container_ = Field::Other;
+        }
+        --depth_;
+        return true;
+    }
+
+private:
+    enum class Field {
+        Other, Id, AssetPath, ImportType, Timestamp, TimestampUs, Success,
+        Message, CollectionName, Options, ImportedObjects, Metadata
+    };
+
+    std::vector<ImportHistoryEntry>& entries_;
+    ImportHistoryEntry current_;
+    int depth_ = 0;
+    int history_depth_ = 0;
+    int entry_depth_ = 0;
+    bool root_is_array_ = false;
+    bool in_history_key_ = false;
+    bool entry_open_ = false;
+    bool has_timestamp_us_ = false;
+    Field field_ = Field::Other;
+    Field container_ = Field::Other;
+    std::string map_key_;
+
+    static Field fieldFor(const std::string& name) {
+        // Keyed on length first so the common case is one short compare per key
+        switch (name.size()) {
+            case 2: return name == "id" ? Field::Id : Field::Other;
+            case 7: return name == "success" ? Field::Success
+                         : name == "message" ? Field::Message
+                         : name == "options" ? Field::Options : Field::Other;
+            case 8: return name == "metadata" ? Field::Metadata : Field::Other;
+            case 9: return name == "timestamp" ? Field::Timestamp : Field::Other;
+            case 10: return name == "asset_path" ? Field::AssetPath : Field::Other;
+            case 11: return name == "import_type" ? Field::ImportType : Field::Other;
+            case 12: return name == "timestamp_us" ? Field::TimestampUs : Field::Other;
+            case 15: return name == "collection_name" ? Field::CollectionName : Field::Other;
+            case 16: return name == "imported_objects" ? Field::ImportedObjects : Field::Other;
+            default: return Field::Other;
+        }
+    }
+
+    // Scalars arrive in the reader's scratch buffer, so string fields take it by move
+    bool scalar(std::string& text, bool truthy) {
+        if (!entry_open_) {
+            return true;
+        }
+        if (depth_ == entry_depth_) {
+            switch (field_) {
+                case Field::Id: current_.id = std::move(text); break;
+                case Field::AssetPath: current_.asset_path = std::move(text); break;
+                case Field::ImportType: current_.import_type = std::move(text); break;
+                case Field::Message: current_.message = std::move(text); break;
+                case Field::CollectionName: current_.collection_name = std::move(text); break;
+                case Field::Success: current_.success = truthy || text == "true"; break;
+                case Field::Timestamp:
+                    // Legacy exports store whole seconds as a string
+                    if (!text.empty()) {
+                        setTimestamp(std::chrono::seconds(std::strtoll(text.c_str(), nullptr, 10)), false);
+                    }
+                    break;
+                default: break;
+            }
+        } else if (depth_ == entry_depth_ + 1) {
+            switch (container_) {
+                case Field::Options: current_.options[std::move(map_key_)] = std::move(text); break;
+                case Field::Metadata: current_.metadata[std::move(map_key_)] = std::move(text); break;
+                case Field::ImportedObjects: current_.imported_objects.push_back(std::move(text)); break;
+                default: break;
+            }
+        }
+        return true;
+    }
+
+    template <typename Duration>
+    void setTimestamp(Duration since_epoch, bool precise) {
+        if (has_timestamp_us_ && !precise) {
+            return;   // keep the microsecond value regardless of key order
+        }
+        has_timestamp_us_ = has_timestamp_us_ || precise;
+        current_.timestamp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(since_epoch));
+    }
+};
+
+class HistorySerializer::Reader {
+public:
+    Reader(const char* begin, const char* end, SaxHandler& handler, size_t release_window)
+        : begin_(begin), pos_(begin), end_(end), released_(begin), handler_(handler),
+          release_window_(release_window) {}
+
+    std::string error;
+
+    bool run() {
+        skipWhitespace();
+        if (pos_ == end_) {
+            return fail("empty document");
+        }
+        if (!value(0)) {
+            return false;
+        }
+        skipWhitespace();
+        return pos_ == end_ || fail("trailing characters after document");
+    }
+
+private:
+    static constexpr int kMaxDepth = 512;
+    const char* begin_;
+    const char* pos_;
+    const char* end_;
+    const char* released_;
+    SaxHandler& handler_;
+    size_t release_window_;
+    std::string text_;
+
+    bool fail(const char* message) {
+        error = "JSON parse error at byte " + std::to_string(pos_ - begin_) + ": " + message;
+        return false;
+    }
+
+    void releaseConsumed() {
+        /* Drops whole pages behind the cursor once a window has been parsed (mapped input only). */
+        if (release_window_ == 0 || static_cast<size_t>(pos_ - released_) < release_window_) {
+            return;
+        }
+        size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const char* release_end = begin_ + static_cast<size_t>(pos_ - begin_) / page * page;
+#ifdef MADV_DONTNEED
+        ::madvise(const_cast<char*>(released_), static_cast<size_t>(release_end - released_), MADV_DONTNEED);
+#endif
+        released_ = release_end;
+    }
+
+    void skipWhitespace() {
+        while (pos_ < end_ && (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t')) {
+            ++pos_;
+        }
+    }
+
+    bool literal(const char* word, size_t length) {
+        if (static_cast<size_t>(end_ - pos_) < length || std::memcmp(pos_, word, length) != 0) {
+            return fail("invalid literal");
+        }
+        pos_ += length;
+        return true;
+    }
+
+    bool value(int depth) {
+        if (depth > kMaxDepth) {
+            return fail("nesting too deep");
+        }
+        switch (*pos_) {
+            case '{': return object(depth);
+            case '[': return array(depth);
+            case '"':
+                return string(text_) && handler_.string(text_);
+            case 't': return literal("true", 4) && handler_.boolean(true);
+            case 'f': return literal("false", 5) && handler_.boolean(false);
+            case 'n': return literal("null", 4) && handler_.null();
+            default: return number();
+        }
+    }
+
+    bool object(int depth) {
+        ++pos_;
+        handler_.start_object();
+        skipWhitespace();
+        if (pos_ < end_ && *pos_ == '}') {
+            ++pos_;
+            return handler_.end_object();
+        }
+        while (true) {
+            skipWhitespace();
+            if (pos_ >= end_ || *pos_ != '"') return fail("expected object key");
+            if (!string(text_)) return false;
+            handler_.key(text_);
+            skipWhitespace();
+            if (pos_ >= end_ || *pos_ != ':') return fail("expected ':'");
+            ++pos_;
+            skipWhitespace();
+            if (pos_ >= end_) return fail("unexpected end of input");
+            if (!value(depth + 1)) return false;
+            skipWhitespace();
+            if (pos_ >= end_) return fail("unterminated object");
+            if (*pos_ == ',') { ++pos_; continue; }
+            if (*pos_ == '}') { ++pos_; return handler_.end_object(); }
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    bool array(int depth) {
+        ++pos_;
+        handler_.start_array();
+        skipWhitespace();
+        if (pos_ < end_ && *pos_ == ']') {
+            ++pos_;
+            return handler_.end_array();
+        }
+        while (true) {
+            skipWhitespace();
+            if (pos_ >= end_) return fail("unterminated array");
+            if (!value(depth + 1)) return false;
+            releaseConsumed();
+            skipWhitespace();
+            if (pos_ >= end_) return fail("unterminated array");
+            if (*pos_ == ',') { ++pos_; continue; }
+            if (*pos_ == ']') { ++pos_; return handler_.end_array(); }
+            return fail("expected ',' or ']'");
+        }
+    }
+
+    bool number() {
+        const char* start = pos_;
+        bool negative = pos_ < end_ && *pos_ == '-';
+        if (negative) ++pos_;
+        bool integral = true;
+        uint64_t magnitude = 0;
+        const char* digits = pos_;
+        while (pos_ < end_ && *pos_ >= '0' && *pos_ <= '9') {
+            magnitude = magnitude * 10 + static_cast<uint64_t>(*pos_ - '0');
+            ++pos_;
+        }
+        if (pos_ == digits) {
+            return fail("unexpected character");
+        }
+        if (pos_ < end_ && (*pos_ == '.' || *pos_ == 'e' || *pos_ == 'E')) {
+            integral = false;
+            while (pos_ < end_ && *pos_ != '\0' && std::strchr("0123456789.eE+-", *pos_) != nullptr) ++pos_;
+        }
+        if (integral && pos_ - digits <= 18) {
+            int64_t value = static_cast<int64_t>(magnitude);
+            return handler_.number_integer(negative ? -value : value);
+        }
+        return handler_.number_float(std::string(start, pos_));
+    }
+
+    bool string(std::string& out) {
+        /*
+         * Decodes a string literal.
+         * - Fast path copies runs between escapes in one append
+         * - \uXXXX escapes (with surrogate pairs) are re-encoded as UTF-8
+         */
+        ++pos_;
+        out.clear();
+        while (true) {
+            const char* run = pos_;
+            while (pos_ < end_ && *pos_ != '"' && *pos_ != '\\') {
+                if (static_cast<unsigned char>(*pos_) < 0x20) return fail("control character in string");
+                ++pos_;
+            }
+            out.append(run, pos_);
+            if (pos_ >= end_) return fail("unterminated string");
+            if (*pos_ == '"') {
+                ++pos_;
+                return true;
+            }
+            if (++pos_ >= end_) return fail("unterminated escape");
+            char escape = *pos_++;
+            switch (escape) {
+                case '"': out.push_back('"'); break;
+                case '\\': out.push_back('\\'); break;
+                case '/': out.push_back('/'); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u': {
+                    uint32_t code = 0;
+                    if (!hex4(code)) return false;
+                    if (code >= 0xD800 && code <= 0xDBFF) {
+                        uint32_t low = 0;
+                        if (end_ - pos_ < 6 || pos_[0] != '\\' || pos_[1] != 'u') return fail("unpaired surrogate");
+                        pos_ += 2;
+                        if (!hex4(low) || low < 0xDC00 || low > 0xDFFF) return fail("invalid surrogate pair");
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default: return fail("invalid escape");
+            }
+        }
+    }
+
+    bool hex4(uint32_t& code) {
+        if (end_ - pos_ < 4) return fail("truncated \\u escape");
+        for (int i = 0; i < 4; ++i) {
+            char c = *pos_++;
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') code |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') code |= static_cast<uint32_t>(c - 'A' + 10);
+            else return fail("invalid \\u escape");
+        }
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+};
+
+void HistorySerializer::write(std::ostream& out, const std::vector<ImportHistoryEntry>& entries) {
+    /**
+     * @brief Writes entries in the ImportHistory export layout with every string escaped.
+     *
+     * @param out Destination stream.
+     * @param entries Entries in the order they should appear.
+     */
+    out << "{\n  \"history\": [\n";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const auto& entry = entries[i];
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+            entry.timestamp.time_since_epoch()).count();
+
+        out << "    {\n";
+        out << "      \"id\": "; writeString(out, entry.id); out << ",\n";
+        out << "      \"asset_path\": "; writeString(out, entry.asset_path); out << ",\n";
+        out << "      \"import_type\": "; writeString(out, entry.import_type); out << ",\n";
+        out << "      \"timestamp\": \"" << micros / 1000000 << "\",\n";
+        out << "      \"timestamp_us\": " << micros << ",\n";
+        out << "      \"success\": " << (entry.success ? "true" : "false") << ",\n";
+        out << "      \"message\": "; writeString(out, entry.message); out << ",\n";
+        out << "      \"collection_name\": "; writeString(out, entry.collection_name); out << ",\n";
+        out << "      \"options\": "; writeStringMap(out, entry.options); out << ",\n";
+        out << "      \"imported_objects\": [";
+        for (size_t j = 0; j < entry.imported_objects.size(); ++j) {
+            if (j > 0) out << ", ";
+            writeString(out, entry.imported_objects[j]);
+        }
+        out << "],\n";
+        out << "      \"metadata\": "; writeStringMap(out, entry.metadata); out << "\n";
+        out << "    }" << (i + 1 < entries.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+std::string HistorySerializer::toJSON(const std::vector<ImportHistoryEntry>& entries) {
+    std::ostringstream out;
+    write(out, entries);
+    return out.str();
+}
+
+bool HistorySerializer::parse(const std::string& json_data, std::vector<ImportHistoryEntry>& entries,
+                              std::string* error) {
+    /**
+     * @brief Streams a JSON export into entries without building a document tree.
+     *
+     * @param json_data Export text.
+     * @param entries Replaced with the parsed entries on success, untouched on failure.
+     * @param error Optional parse error description.
+     * @return True if the document parsed.
+     */
+    return parseRange(json_data.data(), json_data.data() + json_data.size(), entries, error, 0);
+}
+
+bool HistorySerializer::parseFile(const std::string& file_path, std::vector<ImportHistoryEntry>& entries,
+                                  std::string* error) {
+    /**
+     * @brief Parses an export file through a read-only memory map.
+     *
+     * Pages are faulted in as the Reader reaches them (no MAP_POPULATE) and released again every
+     * kReleaseWindow bytes, so the resident set stays bounded however large the export is.
+     *
+     * @param file_path Export file.
+     * @param entries Replaced with the parsed entries on success, untouched on failure.
+     * @param error Optional error description.
+     * @return True if the file was read and parsed.
+     */
+    int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (error) *error = "Cannot open " + file_path;
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        if (error) *error = "Cannot stat " + file_path;
+        return false;
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        return parse(std::string(), entries, error);
+    }
+
+    size_t length = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        // Fall back to a buffered read (e.g. filesystems without mmap support)
+        std::ifstream in(file_path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        return parse(data, entries, error);
+    }
+#ifdef MADV_SEQUENTIAL
+    ::madvise(mapping, length, MADV_SEQUENTIAL);
+#endif
+
+    const char* begin = static_cast<const char*>(mapping);
+    bool ok = parseRange(begin, begin + length, entries, error, kReleaseWindow);
+    ::munmap(mapping, length);
+    return ok;
+}
+
+bool HistorySerializer::parseRange(const char* begin, const char* end,
+                                   std::vector<ImportHistoryEntry>& entries, std::string* error,
+                                   size_t release_window) {
+    // A written entry is never shorter than ~200 bytes, so this reserve stays below the final size
+    std::vector<ImportHistoryEntry> parsed;
+    parsed.reserve(static_cast<size_t>(end - begin) / 512);
+    SaxHandler handler(parsed);
+    Reader reader(begin, end, handler, release_window);
+    if (!reader.run()) {
+        if (error) *error = reader.error;
+        return false;
+    }
+    entries = std::move(parsed);
+    return true;
+}
+
+void HistorySerializer::writeString(std::ostream& out, const std::string& value) {
+    /*
+     * JSON string literal.
+     * - Escapes quote, backslash and C0 controls
+     * - Validates UTF-8 sequences; invalid bytes become U+FFFD so the output always parses
+     */
+    static const char* hex = "0123456789abcdef";
+    out.put('"');
+    const auto* bytes = reinterpret_cast<const unsigned char*>(value.data());
+    size_t size = value.size();
+    size_t i = 0;
+    while (i < size) {
+        unsigned char c = bytes[i];
+        if (c < 0x80) {
+            switch (c) {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\r': out << "\\r"; break;
+                case '\t': out << "\\t"; break;
+                case '\b': out << "\\b"; break;
+                case '\f': out << "\\f"; break;
+                default:
+                    if (c < 0x20) {
+                        out << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+                    } else {
+                        out.put(static_cast<char>(c));
+                    }
+            }
+            ++i;
+            continue;
+        }
+        size_t length = (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 0;
+        bool valid = length != 0 && i + length <= size && c != 0xC0 && c != 0xC1 && c <= 0xF4;
+        for (size_t k = 1; valid && k < length; ++k) {
+            valid = (bytes[i + k] & 0xC0) == 0x80;
+        }
+        if (valid && length == 3) {
+            // Reject overlong forms and UTF-16 surrogates
+            valid = !(c == 0xE0 && bytes[i + 1] < 0xA0) && !(c == 0xED && bytes[i + 1] >= 0xA0);
+        } else if (valid && length == 4) {
+            valid = !(c == 0xF0 && bytes[i + 1] < 0x90) && !(c == 0xF4 && bytes[i + 1] >= 0x90);
+        }
+        if (valid) {
+            out.write(value.data() + i, static_cast<std::streamsize>(length));
+            i += length;
+        } else {
+            out << "\xEF\xBF\xBD";
+            ++i;
+        }
+    }
+    out.put('"');
+}
+
+void HistorySerializer::writeStringMap(std::ostream& out, const std::map<std::string, std::string>& values) {
+    if (values.empty()) {
+        out << "{}";
+        return;
+    }
+    out << "{\n";
+    for (auto it = values.begin(); it != values.end(); ++it) {
+        out << "        ";
+        writeString(out, it->first);
+        out << ": ";
+        writeString(out, it->second);
+        out << (std::next(it) != values.end() ? ",\n" : "\n");
+    }
+    out << "      }";
+}
+
+} // namespace AssetManager
@@ -0,0 +1,593 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: hot_asset_cache.cpp
+ * Description: Implementation of the HotAssetCache local SSD tier and the NextImportPredictor.
+ *              Copies hot assets with their dependency closures into a mirrored tree, answers
+ *              import-time lookups, and evicts under a byte capacity with LRU or LFU ordering.
+ *
+ * Architecture:
+ * - Copies land in "<dest>.part" and are renamed into place, so readers never see partial files
+ * - Reflink via ioctl(FICLONE) when available, std::filesystem::copy_file otherwise
+ * - Manifest (tab separated) rewritten on admission/eviction; rebuilt entries are verified on load
+ * - Background worker drains queued admissions; all bookkeeping under one mutex, copies outside it
+ *
+ * Key Features:
+ * - Transparent resolve() with staleness detection against the source size and mtime
+ * - Reference-counted shared dependency files across cache entries
+ * - Frequency threshold + Markov successor admission on every recorded import
+ */
+
+#include "hot_asset_cache.hpp"
+#include "dependency_prefetcher.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
+namespace AssetManager {
+
+void NextImportPredictor::observe(const std::string& previous, const std::string& next) {
+    if (previous.empty() || next.empty() || previous == next) {
+        return;
+    }
+    ++transitions_[previous][next];
+}
+
+void NextImportPredictor::train(const std::vector<ImportHistoryEntry>& history) {
+    /**
+     * @brief Learns transitions from consecutive successful imports, oldest first.
+     *
+     * @param history History entries in any order.
+     */
+    std::vector<const ImportHistoryEntry*> ordered;
+    for (const auto& entry : history) {
+        if (entry.success) ordered.push_back(&entry);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const ImportHistoryEntry* a, const ImportHistoryEntry* b) {
+                         return a->timestamp < b->timestamp;
+                     });
+    for (size_t i = 1; i < ordered.size(); ++i) {
+        observe(ordered[i - 1]->asset_path, ordered[i]->asset_path);
+    }
+}
+
+std::vector<std::string> NextImportPredictor::predict(const std::string& current, size_t count) const {
+    /**
+     * @brief Most likely next imports after the given asset.
+     *
+     * @param current Asset that was just imported.
+     * @param count Maximum number of predictions.
+     * @return Successors ordered by observed transition count (ties by path).
+     */
+    std::vector<std::pair<std::string, size_t>> candidates;
+    auto it = transitions_.find(current);
+    if (it != transitions_.end()) {
+        candidates.assign(it->second.begin(), it->second.end());
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    std::vector<std::string> result;
+    for (size_t i = 0; i < std::min(count, candidates.size()); ++i) {
+        result.push_back(candidates[i].first);
+    }
+    return result;
+}
+
+void NextImportPredictor::clear() {
+    transitions_.clear();
+}
+
+HotAssetCache::HotAssetCache(const std::string& cache_root, uint64_t capacity_bytes, CacheEvictionPolicy policy)
+    : cache_root_(cache_root),
+      capacity_bytes_(capacity_bytes),
+      policy_(policy),
+      resolver_(&DependencyPrefetcher::defaultClosure) {
+    std::error_code ec;
+    std::filesystem::create_directories(cache_root_, ec);
+    if (ec) {
+        std::cerr << "Failed to create hot asset cache at " << cache_root_ << ": " << ec.message() << std::endl;
+    }
+    stats_.capacity_bytes = capacity_bytes_;
+    loadManifest();
+}
+
+HotAssetCache::~HotAssetCache() {
+    shutdown();
+}
+
+void HotAssetCache::setClosureResolver(ClosureResolver resolver) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resolver_ = resolver ? std::move(resolver) : ClosureResolver(&DependencyPrefetcher::defaultClosure);
+}
+
+void HotAssetCache::setAdmissionThreshold(size_t imports) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    admission_threshold_ = std::max<size_t>(1, imports);
+}
+
+void HotAssetCache::setPredictionFanout(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    prediction_fanout_ = count;
+}
+
+std::string HotAssetCache::getCacheRoot() const {
+    return cache_root_;
+}
+
+std::string HotAssetCache::normalize(const std::string& path) const {
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+    return (ec ? std::filesystem::path(path) : absolute).lexically_normal().string();
+}
+
+std::string HotAssetCache::mirrorPath(const std::string& source) const {
+    // Strip the root so "/mnt/nas/a.obj" becomes "<cache_root>/mnt/nas/a.obj"
+    std::filesystem::path normalized(normalize(source));
+    return (std::filesystem::path(cache_root_) / normalized.relative_path()).string();
+}
+
+bool HotAssetCache::statFile(const std::string& path, uint64_t& size, int64_t& mtime) {
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    size = static_cast<uint64_t>(st.st_size);
+    mtime = static_cast<int64_t>(st.st_mtime);
+    return true;
+}
+
+std::string HotAssetCache::resolve(const std::string& asset_path) {
+    /**
+     * @brief Returns the local copy of an asset when it is cached and unchanged.
+     *
+     * @param asset_path Source asset path as passed to the importer.
+     * @return Cached path on a hit, asset_path on a miss.
+     */
+    const std::string key = normalize(asset_path);
+    std::vector<CachedFile> files;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            ++stats_.misses;
+            return asset_path;
+        }
+        files = it->second.files;
+    }
+
+    // A changed MTL or texture is as stale as a changed model; sources are stat'ed outside the lock
+    bool fresh = true;
+    for (const auto& file : files) {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        if (!statFile(file.source, size, mtime) || size != file.size || mtime != file.mtime) {
+            fresh = false;
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        ++stats_.misses;
+        return asset_path;
+    }
+    if (!fresh) {
+        // Source changed (or vanished) since it was copied; drop the stale copy
+        releaseEntryLocked(it->second);
+        entries_.erase(it);
+        ++stats_.stale;
+        ++stats_.misses;
+        saveManifestLocked();
+        return asset_path;
+    }
+    it->second.last_access = ++access_tick_;
+    ++it->second.hits;
+    ++stats_.hits;
+    return it->second.files.front().cached;
+}
+
+bool HotAssetCache::contains(const std::string& asset_path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.count(normalize(asset_path)) > 0;
+}
+
+bool HotAssetCache::copyFile(const std::string& source, const std::string& destination) const {
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(destination).parent_path(), ec);
+    const std::string partial = destination + ".part";
+
+    bool copied = false;
+#if defined(__linux__) && defined(FICLONE)
+    int src_fd = ::open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src_fd >= 0) {
+        int dst_fd = ::open(partial.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (dst_fd >= 0) {
+            copied = ::ioctl(dst_fd, FICLONE, src_fd) == 0;
+            ::close(dst_fd);
+        }
+        ::close(src_fd);
+    }
+#endif
+    if (!copied) {
+        copied = std::filesystem::copy_file(source, partial,
+                                            std::filesystem::copy_options::overwrite_existing, ec);
+    }
+    if (copied) {
+        std::filesystem::rename(partial, destination, ec);
+        copied = !ec;
+    }
+    if (!copied) {
+        std::filesystem::remove(partial, ec);
+    }
+    return copied;
+}
+
+bool HotAssetCache::admit(const std::string& asset_path) {
+    /**
+     * @brief Copies an asset and its dependency closure into the cache, evicting as needed.
+     *
+     * @param asset_path Source asset path.
+     * @return true if the asset is cached afterwards.
+     */
+    const std::string key = normalize(asset_path);
+    ClosureResolver resolver;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.count(key)) {
+            return true;
+        }
+        resolver = resolver_;
+    }
+
+    Entry entry;
+    entry.source = key;
+    uint64_t asset_size = 0;
+    int64_t asset_mtime = 0;
+    if (!statFile(asset_path, asset_size, asset_mtime)) {
+        return false;
+    }
+    std::vector<std::string> closure;
+    try {
+        closure = resolver(asset_path);
+    } catch (const std::exception&) {
+        closure.clear();
+    }
+    if (closure.empty() || normalize(closure.front()) != key) {
+        closure.insert(closure.begin(), asset_path);
+    }
+
+    uint64_t total = 0;
+    std::set<std::string> seen;
+    for (const auto& file : closure) {
+        std::string source = normalize(file);
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        if (!seen.insert(source).second || !statFile(source, size, mtime)) {
+            continue;
+        }
+        entry.files.push_back({source, mirrorPath(source), size, mtime});
+        total += size;
+    }
+    if (entry.files.empty() || total > capacity_bytes_) {
+        return false;
+    }
+
+    /*
+     * Copies run outside the lock. A dependency shared with a cached entry lands on the same
+     * cached path, so the files are pinned: evicting or dropping that entry meanwhile releases
+     * its reference but leaves the file for this admission.
+     */
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& file : entry.files) {
+            ++pinned_[file.cached];
+        }
+    }
+    bool copied = true;
+    for (const auto& file : entry.files) {
+        if (!copyFile(file.source, file.cached)) {
+            std::cerr << "Hot cache copy failed: " << file.source << " -> " << file.cached << std::endl;
+            copied = false;
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& file : entry.files) {
+        auto pin = pinned_.find(file.cached);
+        if (--pin->second == 0) {
+            pinned_.erase(pin);
+        }
+    }
+    if (!copied) {
+        return false;
+    }
+    if (entries_.count(key)) {
+        return true;
+    }
+    for (const auto& file : entry.files) {
+        if (file_refs_[file.cached]++ == 0) {
+            uint64_t size = 0;
+            int64_t mtime = 0;
+            statFile(file.cached, size, mtime);
+            file_sizes_[file.cached] = size;
+            bytes_cached_ += size;
+        }
+    }
+    entry.last_access = ++access_tick_;
+    entries_.emplace(key, std::move(entry));
+    ++stats_.admissions;
+    evictLocked(key);
+    saveManifestLocked();
+    return entries_.count(key) > 0;
+}
+
+void HotAssetCache::releaseEntryLocked(const Entry& entry) {
+    for (const auto& file : entry.files) {
+        auto ref = file_refs_.find(file.cached);
+        if (ref == file_refs_.end()) continue;
+        if (--ref->second == 0) {
+            bytes_cached_ -= std::min(bytes_cached_, file_sizes_[file.cached]);
+            file_sizes_.erase(file.cached);
+            file_refs_.erase(ref);
+            if (!pinned_.count(file.cached)) {
+                std::error_code ec;
+                std::filesystem::remove(file.cached, ec);
+            }
+        }
+    }
+}
+
+void HotAssetCache::evictLocked(const std::string& keep) {
+    /*
+     * Evicts entries until the cache fits its capacity.
+     * - LRU: smallest last_access first
+     * - LFU: fewest hits first, then least recently used
+     * - The entry just admitted (keep) is never chosen
+     */
+    while (bytes_cached_ > capacity_bytes_ && entries_.size() > 1) {
+        auto victim = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->first == keep) continue;
+            if (victim == entries_.end()) {
+                victim = it;
+                continue;
+            }
+            const Entry& a = it->second;
+            const Entry& b = victim->second;
+            bool colder = policy_ == CacheEvictionPolicy::LFU
+                ? (a.hits != b.hits ? a.hits < b.hits : a.last_access < b.last_access)
+                : a.last_access < b.last_access;
+            if (colder) victim = it;
+        }
+        if (victim == entries_.end()) break;
+        releaseEntryLocked(victim->second);
+        entries_.erase(victim);
+        ++stats_.evictions;
+    }
+}
+
+void HotAssetCache::recordImport(const std::string& asset_path) {
+    /**
+     * @brief Updates frequency and sequence statistics after an import and queues admissions.
+     *
+     * @param asset_path Source path of the asset that was imported.
+     */
+    const std::string key = normalize(asset_path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = ++import_counts_[key];
+    predictor_.observe(last_imported_, key);
+    last_imported_ = key;
+    if (count >= admission_threshold_) {
+        scheduleLocked(key);
+    }
+    for (const auto& next : predictor_.predict(key, prediction_fanout_)) {
+        scheduleLocked(next);
+    }
+}
+
+void HotAssetCache::warmFromHistory(const std::vector<ImportHistoryEntry>& history, size_t top_n) {
+    /**
+     * @brief Seeds the predictor and frequency counters from past imports and queues the hottest assets.
+     *
+     * @param history Entries from ImportHistory::getHistory().
+     * @param top_n Number of most frequently imported assets to admit.
+     */
+    std::vector<ImportHistoryEntry> normalized;
+    normalized.reserve(history.size());
+    for (const auto& entry : history) {
+        if (!entry.success) continue;
+        ImportHistoryEntry copy;
+        copy.asset_path = normalize(entry.asset_path);
+        copy.timestamp = entry.timestamp;
+        copy.success = true;
+        normalized.push_back(std::move(copy));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    predictor_.train(normalized);
+    std::unordered_map<std::string, size_t> counts;
+    for (const auto& entry : normalized) {
+        ++counts[entry.asset_path];
+        ++import_counts_[entry.asset_path];
+    }
+    std::vector<std::pair<std::string, size_t>> ranked(counts.begin(), counts.end());
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    for (size_t i = 0; i < std::min(top_n, ranked.size()); ++i) {
+        scheduleLocked(ranked[i].first);
+    }
+}
+
+std::vector<std::string> HotAssetCache::predictNext(const std::string& asset_path, size_t count) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return predictor_.predict(normalize(asset_path), count);
+}
+
+void HotAssetCache::scheduleLocked(const std::string& key) {
+    if (stopping_ || entries_.count(key) || !queued_.insert(key).second) {
+        return;
+    }
+    pending_.push_back(key);
+    if (!worker_.joinable()) {
+        worker_ = std::thread(&HotAssetCache::workerLoop, this);
+    }
+    work_available_.notify_one();
+}
+
+void HotAssetCache::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_available_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+        if (stopping_) {
+            return;
+        }
+        std::string key = pending_.front();
+        pending_.pop_front();
+        worker_busy_ = true;
+        lock.unlock();
+
+        admit(key);
+
+        lock.lock();
+        queued_.erase(key);
+        worker_busy_ = false;
+        if (pending_.empty()) {
+            idle_.notify_all();
+        }
+    }
+}
+
+void HotAssetCache::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return (pending_.empty() && !worker_busy_) || !worker_.joinable(); });
+}
+
+void HotAssetCache::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        pending_.clear();
+        queued_.clear();
+        work_available_.notify_all();
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    idle_.notify_all();
+}
+
+void HotAssetCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [key, entry] : entries_) {
+        releaseEntryLocked(entry);
+    }
+    entries_.clear();
+    import_counts_.clear();
+    predictor_.clear();
+    last_imported_.clear();
+    saveManifestLocked();
+}
+
+HotCacheStats HotAssetCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HotCacheStats stats = stats_;
+    stats.entries = entries_.size();
+    stats.bytes_cached = bytes_cached_;
+    stats.capacity_bytes = capacity_bytes_;
+    size_t lookups = stats.hits + stats.misses;
+    stats.hit_rate = lookups ? static_cast<double>(stats.hits) / static_cast<double>(lookups) : 0.0;
+    return stats;
+}
+
+void HotAssetCache::saveManifestLocked() const {
+    /*
+     * Manifest format, one entry per line, tab separated:
+     *   source  hits  last_access  file_count  (source_file  cached_file  size  mtime)*
+     * Written to a temporary file and renamed so a crash leaves the previous manifest intact.
+     */
+    const std::filesystem::path manifest = std::filesystem::path(cache_root_) / "hot_cache_manifest.tsv";
+    const std::filesystem::path partial = manifest.string() + ".part";
+    std::ofstream out(partial, std::ios::trunc);
+    if (!out) {
+        return;
+    }
+    for (const auto& [key, entry] : entries_) {
+        out << entry.source << '\t' << entry.hits << '\t' << entry.last_access << '\t' << entry.files.size();
+        for (const auto& file : entry.files) {
+            out << '\t' << file.source << '\t' << file.cached << '\t' << file.size << '\t' << file.mtime;
+        }
+        out << '\n';
+    }
+    out.close();
+    std::error_code ec;
+    std::filesystem::rename(partial, manifest, ec);
+}
+
+void HotAssetCache::loadManifest() {
+    /*
+     * Rebuilds entries whose cached files all still exist. Recency carries over: the access
+     * counter resumes after the largest last_access loaded, so LRU order survives a restart.
+     */
+    const std::filesystem::path manifest = std::filesystem::path(cache_root_) / "hot_cache_manifest.tsv";
+    std::ifstream in(manifest);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, '\t')) fields.push_back(field);
+        if (fields.size() < 4) continue;
+
+        Entry entry;
+        size_t file_count = 0;
+        try {
+            entry.source = fields[0];
+            entry.hits = std::stoul(fields[1]);
+            entry.last_access = std::stoull(fields[2]);
+            file_count = std::stoul(fields[3]);
+            if (fields.size() != 4 + 4 * file_count || file_count == 0) continue;
+            for (size_t i = 0; i < file_count; ++i) {
+                const size_t base = 4 + 4 * i;
+                entry.files.push_back({fields[base], fields[base + 1], std::stoull(fields[base + 2]),
+                                       std::stoll(fields[base + 3])});
+            }
+        } catch (const std::exception&) {
+            continue;
+        }
+
+        bool complete = std::all_of(entry.files.begin(), entry.files.end(), [](const CachedFile& file) {
+            std::error_code ec;
+            return std::filesystem::exists(file.cached, ec);
+        });
+        if (!complete) continue;
+
+        for (const auto& file : entry.files) {
+            if (file_refs_[file.cached]++ == 0) {
+                uint64_t size = 0;
+                int64_t mtime = 0;
+                statFile(file.cached, size, mtime);
+                file_sizes_[file.cached] = size;
+                bytes_cached_ += size;
+            }
+        }
+        access_tick_ = std::max(access_tick_, entry.last_access);
+        entries_.emplace(entry.source, std::move(entry));
+    }
+    evictLocked("");
+}
+
+} // namespace AssetManager
@@ -0,0 +1,570 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: image_integrity.cpp
+ * Description: Implementation of ImageIntegrityChecker, structural validation of texture files.
+ *
+ * Architecture:
+ * - check() maps the file and hands the bytes to checkBuffer(), which dispatches on magic bytes
+ * - Each walker bounds-checks every field against the file size before reading it; a structure that needs
+ *   bytes past the end is reported as truncation, anything else as corruption
+ *
+ * Key Features:
+ * - No pixel data is decoded; PNG is the only format whose payload is read in full (for its CRCs, via Crc32)
+ */
+
+#include "image_integrity.hpp"
+#include "crc32.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace AssetManager {
+
+ImageIntegrityReport ImageIntegrityChecker::check(const std::string& path) {
+    /**
+     * @brief Walks the structure of an image file.
+     *
+     * @param path Image file.
+     * @return Report; opened is false if the file could not be read.
+     */
+    auto start = std::chrono::steady_clock::now();
+    std::string extension = path.substr(std::min(path.size(), path.find_last_of('.')));
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    ImageIntegrityReport report;
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return report;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return report;
+    }
+    size_t length = static_cast<size_t>(st.st_size);
+    void* mapping = length > 0 ? ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (mapping != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+        ::madvise(mapping, length, MADV_SEQUENTIAL);
+#endif
+        report = checkBuffer(static_cast<const unsigned char*>(mapping), length, extension);
+        ::munmap(mapping, length);
+    } else {
+        // Empty files, or filesystems without mmap support
+        std::ifstream in(path, std::ios::binary);
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        report = checkBuffer(data.data(), data.size(), extension);
+        report.opened = !in.bad();
+    }
+    report.scan_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+ImageIntegrityReport ImageIntegrityChecker::checkBuffer(const unsigned char* data, size_t size,
+                                                        const std::string& extension) {
+    /**
+     * @brief Dispatches on magic bytes.
+     *
+     * @param extension Lower-case extension; decides TGA (no magic) and files cut short inside their signature.
+     */
+    static const unsigned char kPNG[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    static const unsigned char kJPEG[3] = {0xFF, 0xD8, 0xFF};
+    static const unsigned char kEXR[4] = {0x76, 0x2F, 0x31, 0x01};
+    static const unsigned char kBMP[2] = {'B', 'M'};
+    struct Format {
+        const char* name;
+        const unsigned char* magic;
+        size_t magic_size;
+        void (*walk)(const unsigned char*, size_t, ImageIntegrityReport&);
+        const char* alias;
+    };
+    static const Format formats[] = {
+        {".png", kPNG, sizeof(kPNG), &ImageIntegrityChecker::checkPNG, ".png"},
+        {".jpg", kJPEG, sizeof(kJPEG), &ImageIntegrityChecker::checkJPEG, ".jpeg"},
+        {".exr", kEXR, sizeof(kEXR), &ImageIntegrityChecker::checkEXR, ".exr"},
+        {".bmp", kBMP, sizeof(kBMP), &ImageIntegrityChecker::checkBMP, ".bmp"},
+    };
+
+    ImageIntegrityReport report;
+    report.opened = true;
+    report.bytes = size;
+    for (const auto& format : formats) {
+        bool magic = size >= format.magic_size && std::memcmp(data, format.magic, format.magic_size) == 0;
+        bool named = extension == format.name || extension == format.alias;
+        if (magic) {
+            report.format = format.name;
+            report.checked = true;
+            format.walk(data, size, report);
+            return report;
+        }
+        if (named && size < format.magic_size && std::memcmp(data, format.magic, size) == 0) {
+            report.format = format.name;
+            report.checked = true;
+            truncated(report, "File signature", format.magic_size, size);
+            return report;
+        }
+    }
+    if (extension == ".tga") {
+        report.format = ".tga";
+        report.checked = true;
+        checkTGA(data, size, report);
+    }
+    return report;
+}
+
+void ImageIntegrityChecker::checkPNG(const unsigned char* data, size_t size, ImageIntegrityReport& report) {
+    /*
+     * Chunks: length (4, big-endian), type (4), data, CRC over type and data (4).
+     * - A CRC mismatch does not break the chunk list, so the walk continues past it
+     * - Missing IEND means the copy stopped early even if every chunk so far was whole
+     */
+    size_t pos = 8;
+    bool has_idat = false;
+    while (pos < size) {
+        if (size - pos < 12) {
+            truncated(report, "PNG chunk header at offset " + std::to_string(pos), pos + 12, size);
+            return;
+        }
+        uint32_t length = readBE(data + pos, 4);
+        const unsigned char* type = data + pos + 4;
+        std::string name(reinterpret_cast<const char*>(type), 4);
+        bool letters = std::all_of(type, type + 4, [](unsigned char c) {
+            return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+        });
+        if (length > 0x7FFFFFFFu || !letters) {
+            problem(report, "Invalid PNG chunk at offset " + std::to_string(pos));
+            return;
+        }
+        uint64_t end = static_cast<uint64_t>(pos) + 12 + length;
+        if (end > size) {
+            truncated(report, "PNG '" + name + "' chunk at offset " + std::to_string(pos), end, size);
+            return;
+        }
+        if (++report.segments == 1 && (name != "IHDR" || length != 13)) {
+            problem(report, "PNG does not start with an IHDR chunk");
+        }
+        uint32_t stored = readBE(data + pos + 8 + length, 4);
+        if (Crc32::update(0, type, static_cast<size_t>(length) + 4) != stored) {
+            problem(report, "CRC mismatch in PNG '" + name + "' chunk at offset " + std::to_string(pos));
+        }
+        has_idat |= name == "IDAT";
+        if (name == "IEND") {
+            if (!has_idat) {
+                problem(report, "PNG has no IDAT chunk");
+            }
+            return;
+        }
+        pos = static_cast<size_t>(end);
+    }
+    report.truncated = true;
+    problem(report, "PNG ends without an IEND chunk after " + std::to_string(report.segments) + " chunks");
+}
+
+void ImageIntegrityChecker::checkJPEG(const unsigned char* data, size_t size, ImageIntegrityReport& report) {
+    /*
+     * Marker segments from SOI to EOI.
+     * - Segments carry a 2-byte length; RSTn and TEM stand alone
+     * - After SOS the entropy-coded data runs to the next 0xFF that is not stuffing (FF00) or a restart marker
+     */
+    size_t pos = 2;
+    bool has_frame = false;
+    bool has_scan = false;
+    while (true) {
+        if (pos >= size) {
+            report.truncated = true;
+            problem(report, "JPEG ends before the EOI marker after " + std::to_string(report.segments) + " segments");
+            return;
+        }
+        if (data[pos] != 0xFF) {
+            problem(report, "Expected a JPEG marker at offset " + std::to_string(pos));
+            return;
+        }
+        size_t marker_pos = pos;
+        while (pos < size && data[pos] == 0xFF) ++pos;     // fill bytes
+        if (pos >= size) {
+            continue;
+        }
+        unsigned char marker = data[pos++];
+        ++report.segments;
+        if (marker == 0xD9) {
+            if (!has_scan) {
+                problem(report, "JPEG has no scan data");
+            }
+            return;
+        }
+        if ((marker >= 0xD0 && marker <= 0xD7) || marker == 0x01) {
+            continue;
+        }
+        if (marker == 0x00 || marker == 0xD8) {
+            problem(report, "Unexpected JPEG marker at offset " + std::to_string(marker_pos));
+            return;
+        }
+        if (size - pos < 2) {
+            truncated(report, "JPEG segment length at offset " + std::to_string(pos), pos + 2, size);
+            return;
+        }
+        uint32_t length = readBE(data + pos, 2);
+        if (length < 2) {
+            problem(report, "Invalid JPEG segment length at offset " + std::to_string(pos));
+            return;
+        }
+        if (pos + length > size) {
+            char hex[8];
+            std::snprintf(hex, sizeof(hex), "FF%02X", marker);
+            truncated(report, std::string("JPEG ") + hex + " segment at offset " + std::to_string(marker_pos),
+                      pos + length, size);
+            return;
+        }
+        has_frame |= marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+        pos += length;
+        if (marker != 0xDA) {
+            continue;
+        }
+        if (!has_frame) {
+            problem(report, "JPEG scan at offset " + std::to_string(marker_pos) + " comes before any frame header");
+        }
+        has_scan = true;
+        while (true) {
+            const void* found = std::memchr(data + pos, 0xFF, size - pos);
+            if (!found || static_cast<const unsigned char*>(found) + 1 >= data + size) {
+                report.truncated = true;
+                problem(report, "JPEG scan data at offset " + std::to_string(marker_pos) + " ends without EOI");
+                return;
+            }
+            pos = static_cast<size_t>(static_cast<const unsigned char*>(found) - data);
+            unsigned char next = data[pos + 1];
+            if (next == 0x00 || (next >= 0xD0 && next <= 0xD7)) {
+                pos += 2;
+            } else if (next == 0xFF) {
+                pos += 1;
+            } else {
+                break;
+            }
+        }
+    }
+}
+
+void ImageIntegrityChecker::checkEXR(const unsigned char* data, size_t size, ImageIntegrityReport& report) {
+    /*
+     * Header attributes (name\0 type\0 int32 size, value) up to an empty name, then one 64-bit offset per chunk.
+     * - Offsets must point past the table and their chunk (header plus int32 data size) must fit in the file
+     * - An offset of 0 is what writers leave for chunks they never got to
+     * - Multi-part and deep files only get their first header walked
+     */
+    if (size < 8) {
+        truncated(report, "EXR version field", 8, size);
+        return;
+    }
+    uint32_t flags = readLE(data + 4, 4);
+    bool tiled = (flags & 0x200) != 0;
+    bool multipart = (flags & 0x1000) != 0;
+    bool deep = (flags & 0x800) != 0;
+
+    size_t pos = 8;
+    int32_t window[4] = {0, 0, -1, -1};
+    bool has_window = false;
+    int compression = -1;
+    uint32_t tile_x = 0, tile_y = 0;
+    int tile_mode = 0;
+    int64_t chunk_count = -1;
+    while (true) {
+        if (pos >= size) {
+            truncated(report, "EXR header", pos + 1, size);
+            return;
+        }
+        if (data[pos] == 0) {
+            ++pos;
+            break;
+        }
+        const unsigned char* name_end = static_cast<const unsigned char*>(std::memchr(data + pos, 0, size - pos));
+        const unsigned char* type_end = name_end ? static_cast<const unsigned char*>(
+                                            std::memchr(name_end + 1, 0, static_cast<size_t>(data + size - name_end - 1)))
+                                                 : nullptr;
+        if (!type_end || static_cast<size_t>(data + size - type_end) < 5) {
+            truncated(report, "EXR header attribute at offset " + std::to_string(pos), size + 1, size);
+            return;
+        }
+        std::string name(reinterpret_cast<const char*>(data + pos), reinterpret_cast<const char*>(name_end));
+        size_t value = static_cast<size_t>(type_end + 5 - data);
+        uint32_t value_size = readLE(type_end + 1, 4);
+        if (value_size > 0x7FFFFFFFu) {
+            problem(report, "Invalid size for EXR attribute '" + name + "'");
+            return;
+        }
+        if (value + value_size > size) {
+            truncated(report, "EXR attribute '" + name + "'", value + value_size, size);
+            return;
+        }
+        if (name == "dataWindow" && value_size >= 16) {
+            for (int i = 0; i < 4; ++i) {
+                window[i] = static_cast<int32_t>(readLE(data + value + i * 4, 4));
+            }
+            has_window = true;
+        } else if (name == "compression" && value_size >= 1) {
+            compression = data[value];
+        } else if (name == "tiles" && value_size >= 9) {
+            tile_x = readLE(data + value, 4);
+            tile_y = readLE(data + value + 4, 4);
+            tile_mode = data[value + 8];
+        } else if (name == "chunkCount" && value_size >= 4) {
+            chunk_count = static_cast<int32_t>(readLE(data + value, 4));
+        }
+        pos = value + value_size;
+    }
+    if (multipart || deep) {
+        report.checked = false;
+        return;
+    }
+    if (!has_window || compression < 0 || window[2] < window[0] || window[3] < window[1]) {
+        problem(report, "EXR header has no valid dataWindow or compression attribute");
+        return;
+    }
+
+    // Chunks per image: scanline blocks of N lines, or tiles per level
+    int64_t width = static_cast<int64_t>(window[2]) - window[0] + 1;
+    int64_t height = static_cast<int64_t>(window[3]) - window[1] + 1;
+    if (chunk_count < 0 && !tiled) {
+        static const int kLinesPerChunk[] = {1, 1, 1, 16, 32, 16, 32, 32, 32, 256};
+        int lines = compression < 10 ? kLinesPerChunk[compression] : 1;
+        chunk_count = (height + lines - 1) / lines;
+    } else if (chunk_count < 0) {
+        if (tile_x == 0 || tile_y == 0) {
+            problem(report, "Tiled EXR has no valid tiles attribute");
+            return;
+        }
+        bool round_up = (tile_mode >> 4) & 1;
+        int level_mode = tile_mode & 0x0F;
+        auto levels = [round_up](int64_t extent) {
+            int count = 1;
+            while ((int64_t(1) << count) <= extent) ++count;     // floor(log2) + 1
+            if (round_up && (int64_t(1) << (count - 1)) < extent) ++count;
+            return count;
+        };
+        auto level_size = [round_up](int64_t extent, int level) {
+            int64_t scaled = round_up ? (extent + (int64_t(1) << level) - 1) >> level : extent >> level;
+            return std::max<int64_t>(1, scaled);
+        };
+        /*
+         * A dataWindow spans up to 2^32 pixels per axis, so with small tiles the products overflow int64.
+         * Counts saturate one past the most entries the file could hold; the table check below then
+         * reports the file as truncated.
+         */
+        int64_t limit = static_cast<int64_t>((size - pos) / 8) + 1;
+        auto tiles = [](int64_t extent, uint32_t tile) { return (extent + tile - 1) / tile; };
+        auto grid = [limit, &tiles](int64_t w, uint32_t tw, int64_t h, uint32_t th) {
+            int64_t across = tiles(w, tw);
+            int64_t down = tiles(h, th);
+            return across > limit / down ? limit : std::min(limit, across * down);
+        };
+        chunk_count = 0;
+        if (level_mode == 0) {
+            chunk_count = grid(width, tile_x, height, tile_y);
+        } else if (level_mode == 1) {
+            for (int level = 0; level < levels(std::max(width, height)) && chunk_count < limit; ++level) {
+                chunk_count += grid(level_size(width, level), tile_x, level_size(height, level), tile_y);
+            }
+        } else {
+            for (int lx = 0; lx < levels(width) && chunk_count < limit; ++lx) {
+                for (int ly = 0; ly < levels(height) && chunk_count < limit; ++ly) {
+                    chunk_count += grid(level_size(width, lx), tile_x, level_size(height, ly), tile_y);
+                }
+            }
+        }
+        if (chunk_count >= limit) {
+            truncated(report, "EXR offset table of more than " + std::to_string(limit - 1) + " tiles",
+                      pos + static_cast<uint64_t>(limit) * 8, size);
+            return;
+        }
+    }
+
+    if (static_cast<uint64_t>(chunk_count) > (size - pos) / 8) {
+        truncated(report, "EXR offset table of " + std::to_string(chunk_count) + " chunks",
+                  pos + static_cast<uint64_t>(chunk_count) * 8, size);
+        return;
+    }
+    uint64_t table_end = pos + static_cast<uint64_t>(chunk_count) * 8;
+    size_t chunk_header = tiled ? 20 : 8;   // tile x, y, level x, level y / scanline y, then int32 data size
+    for (int64_t chunk = 0; chunk < chunk_count && report.problems.size() < kMaxProblems; ++chunk) {
+        const unsigned char* entry = data + pos + chunk * 8;
+        uint64_t offset = readLE(entry, 4) | (static_cast<uint64_t>(readLE(entry + 4, 4)) << 32);
+        ++report.segments;
+        if (offset == 0) {
+            report.truncated = true;
+            problem(report, "EXR chunk " + std::to_string(chunk) + " was never written (offset 0)");
+        } else if (offset < table_end) {
+            problem(report, "EXR chunk " + std::to_string(chunk) + " offset points into the header");
+        } else if (size < chunk_header || offset > size - chunk_header) {
+            truncated(report, "EXR chunk " + std::to_string(chunk), offset + chunk_header, size);
+        } else {
+            uint64_t end = offset + chunk_header + readLE(data + offset + chunk_header - 4, 4);
+            if (end > size) {
+                truncated(report, "EXR chunk " + std::to_string(chunk), end, size);
+            }
+        }
+    }
+}
+
+void ImageIntegrityChecker::checkTGA(const unsigned char* data, size_t size, ImageIntegrityReport& report) {
+    /*
+     * 18-byte header, image ID, color map, then pixels.
+     * - Uncompressed pixel data must fit in the file
+     * - RLE packets are walked (headers only) until they cover width * height pixels
+     */
+    if (size < 18) {
+        truncated(report, "TGA header", 18, size);
+        return;
+    }
+    int colormap_type = data[1];
+    int image_type = data[2];
+    uint32_t colormap_length = readLE(data + 5, 2);
+    int colormap_bits = data[7];
+    uint64_t width = readLE(data + 12, 2);
+    uint64_t height = readLE(data + 14, 2);
+    int depth = data[16];
+    bool rle = image_type >= 9;
+    int base_type = rle ? image_type - 8 : image_type;
+    if (colormap_type > 1 || base_type < 1 || base_type > 3 || (base_type == 1 && colormap_type != 1)) {
+        problem(report, "Invalid TGA image or color map type");
+        return;
+    }
+    if (depth != 8 && depth != 15 && depth != 16 && depth != 24 && depth != 32) {
+        problem(report, "Invalid TGA pixel depth " + std::to_string(depth));
+        return;
+    }
+    if (width == 0 || height == 0) {
+        problem(report, "TGA image has zero width or height");
+        return;
+    }
+
+    uint64_t pos = 18 + static_cast<uint64_t>(data[0]);
+    if (colormap_type == 1) {
+        pos += static_cast<uint64_t>(colormap_length) * ((colormap_bits + 7) / 8);
+    }
+    uint64_t pixel_bytes = static_cast<uint64_t>((depth + 7) / 8);
+    uint64_t pixels = width * height;
+    if (!rle) {
+        uint64_t end = pos + pixels * pixel_bytes;
+        report.segments = 1;
+        if (end > size) {
+            truncated(report, "TGA pixel data", end, size);
+        }
+        return;
+    }
+    uint64_t covered = 0;
+    while (covered < pixels) {
+        if (pos >= size) {
+            truncated(report, "TGA RLE data (" + std::to_string(covered) + " of " + std::to_string(pixels) +
+                      " pixels)", pos + 1, size);
+            return;
+        }
+        unsigned char packet = data[pos++];
+        uint64_t count = static_cast<uint64_t>(packet & 0x7F) + 1;
+        pos += packet & 0x80 ? pixel_bytes : count * pixel_bytes;
+        covered += count;
+        ++report.segments;
+    }
+    if (pos > size) {
+        truncated(report, "TGA RLE data", pos, size);
+    } else if (covered > pixels) {
+        problem(report, "TGA RLE packets run past the last pixel");
+    }
+}
+
+void ImageIntegrityChecker::checkBMP(const unsigned char* data, size_t size, ImageIntegrityReport& report) {
+    /*
+     * 14-byte file header, DIB header, pixel array at the stored offset.
+     * - The stored file size (0 is allowed) and the pixel array of uncompressed images must fit in the file
+     */
+    if (size < 18) {
+        truncated(report, "BMP header", 18, size);
+        return;
+    }
+    uint32_t declared = readLE(data + 2, 4);
+    uint32_t offset = readLE(data + 10, 4);
+    uint32_t dib = readLE(data + 14, 4);
+    static const uint32_t kDibSizes[] = {12, 40, 52, 56, 64, 108, 124};
+    if (std::find(std::begin(kDibSizes), std::end(kDibSizes), dib) == std::end(kDibSizes)) {
+        problem(report, "Unknown BMP header size " + std::to_string(dib));
+        return;
+    }
+    if (size < 14 + dib) {
+        truncated(report, "BMP header", 14 + dib, size);
+        return;
+    }
+    int64_t width, height;
+    uint32_t planes, bits, compression = 0;
+    if (dib == 12) {
+        width = readLE(data + 18, 2);
+        height = static_cast<int16_t>(readLE(data + 20, 2));
+        planes = readLE(data + 22, 2);
+        bits = readLE(data + 24, 2);
+    } else {
+        width = static_cast<int32_t>(readLE(data + 18, 4));
+        height = static_cast<int32_t>(readLE(data + 22, 4));
+        planes = readLE(data + 26, 2);
+        bits = readLE(data + 28, 2);
+        compression = readLE(data + 30, 4);
+    }
+    report.segments = 1;
+    if (planes != 1 || width <= 0 || height == 0 ||
+        (bits != 1 && bits != 4 && bits != 8 && bits != 16 && bits != 24 && bits != 32)) {
+        problem(report, "Invalid BMP dimensions, planes or bit depth");
+        return;
+    }
+    if (declared != 0 && declared > size) {
+        truncated(report, "BMP file (size field)", declared, size);
+        return;
+    }
+    if (offset < 14 + dib) {
+        problem(report, "BMP pixel data offset points into the header");
+        return;
+    }
+    if (compression == 0 || compression == 3 || compression == 6) {
+        uint64_t stride = (static_cast<uint64_t>(width) * bits + 31) / 32 * 4;
+        uint64_t end = offset + stride * static_cast<uint64_t>(height < 0 ? -height : height);
+        if (end > size) {
+            truncated(report, "BMP pixel data", end, size);
+        }
+    } else if (offset >= size) {
+        truncated(report, "BMP pixel data", static_cast<uint64_t>(offset) + 1, size);
+    }
+}
+
+void ImageIntegrityChecker::problem(ImageIntegrityReport& report, const std::string& text) {
+    if (report.problems.size() < kMaxProblems) {
+        report.problems.push_back(text);
+    }
+}
+
+void ImageIntegrityChecker::truncated(ImageIntegrityReport& report, const std::string& what, uint64_t needed,
+                                      uint64_t size) {
+    report.truncated = true;
+    problem(report, what + " needs " + std::to_string(needed) + " bytes, file has " + std::to_string(size));
+}
+
+uint32_t ImageIntegrityChecker::readBE(const unsigned char* data, size_t bytes) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+uint32_t ImageIntegrityChecker::readLE(const unsigned char* data, size_t bytes) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint32_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace AssetManager
@@ -11,6 +11,7 @@
  * - Integration with ImportManager for automatic tracking
  * - Configurable history retention and cleanup policies
  * - Thread-safe operations for concurrent import tracking
+ * - Append-only journal persistence (HistoryJournal) with background snapshot compaction
  * - Extensible design for custom history operations
  *
  * Key Features:
@@ -24,9 +25,10 @@
  */
 
 #include "import_history.hpp"
+#include "python_literal.hpp"
+#include "history_serializer.hpp"
 #include <iostream>
 #include <algorithm>
-#include <random>
 #include <sstream>
 #include <fstream>
 #include <iomanip>
@@ -42,15 +44,17 @@ ImportHistory::ImportHistory()
     : max_history_size_(1000)
     , retention_period_(std::chrono::hours(24 * 30)) // 30 days default
     , auto_cleanup_enabled_(true)
-    , history_file_path_("import_history.json") {
-    // Constructor: Initialize with sensible defaults
+    , history_file_path_()
+    , compaction_threshold_(4096)
+    , durable_writes_(false)
+    , next_expiry_(std::chrono::system_clock::time_point::max()) {
+    // Constructor: Initialize with sensible defaults; persistence starts once setHistoryFilePath() opens a store
 }
 
 ImportHistory::~ImportHistory() {
-    // Destructor: Clean up resources if needed
-    if (auto_cleanup_enabled_ && !history_file_path_.empty()) {
-        saveHistory(history_file_path_);
-    }
+    // Destructor: flush batched evictions; the journal waits for any running compaction
+    flushEvictions();
+    journal_.reset();
 }
 
 void ImportHistory::addEntry(const ImportHistoryEntry& entry) {
@@ -72,78 +76,66 @@ void ImportHistory::addEntry(const ImportHistoryEntry& entry) {
         new_entry.timestamp = std::chrono::system_clock::now();
     }
     
-    // Add to history
-    history_.push_back(new_entry);
+    // Journal the addition (one appended record, not a full rewrite)
+    if (HistoryJournal* store = journal()) {
+        if (pending_eviction_ids_.count(new_entry.id) != 0) {
+            flushEvictions();   // the pending removal must not land after this re-add
+        }
+        store->appendAdd(new_entry);
+    }
     
-    // Apply cleanup policies
+    // Add to history (appended to the time-ordered ring)
+    next_expiry_ = std::min(next_expiry_, segmentExpiry(new_entry.timestamp));
+    history_.insert(std::move(new_entry));
+    
+    // Apply cleanup policies; expiry runs only once the oldest segment has aged out
     if (auto_cleanup_enabled_) {
-        cleanupOldEntries();
+        if (std::chrono::system_clock::now() >= next_expiry_) {
+            cleanupOldEntries();
+        }
         enforceMaxSize();
     }
     
-    // Auto-save if file path is set
-    if (!history_file_path_.empty()) {
-        saveHistory(history_file_path_);
-    }
+    maybeCompact();
 }
 
 std::vector<ImportHistoryEntry> ImportHistory::getHistory() const {
     /**
      * @brief Returns the complete import history, sorted by timestamp (newest first).
+     *        The store is already time-ordered, so this is a reverse copy without sorting.
      *
      * @return Vector of ImportHistoryEntry objects sorted by timestamp.
      */
-    std::vector<ImportHistoryEntry> sorted_history = history_;
-    std::sort(sorted_history.begin(), sorted_history.end(),
-              [](const ImportHistoryEntry& a, const ImportHistoryEntry& b) {
-                  return a.timestamp > b.timestamp;
-              });
-    return sorted_history;
+    return history_.page(0, history_.size());
 }
 
 std::vector<ImportHistoryEntry> ImportHistory::getHistoryByAsset(const std::string& asset_path) const {
     /**
-     * @brief Returns import history entries for a specific asset path.
+     * @brief Returns import history entries for a specific asset path (newest first).
      *
      * @param asset_path The asset path to filter by.
      * @return Vector of ImportHistoryEntry objects for the specified asset.
      */
     std::vector<ImportHistoryEntry> filtered_history;
-    for (const auto& entry : history_) {
-        if (entry.asset_path == asset_path) {
-            filtered_history.push_back(entry);
-        }
-    }
-    
-    // Sort by timestamp (newest first)
-    std::sort(filtered_history.begin(), filtered_history.end(),
-              [](const ImportHistoryEntry& a, const ImportHistoryEntry& b) {
-                  return a.timestamp > b.timestamp;
-              });
-    
+    history_.forEachByAsset(asset_path, [&filtered_history](const ImportHistoryEntry& entry) {
+        filtered_history.push_back(entry);
+        return true;
+    });
     return filtered_history;
 }
 
 std::vector<ImportHistoryEntry> ImportHistory::getHistoryByType(const std::string& import_type) const {
     /**
-     * @brief Returns import history entries for a specific import type.
+     * @brief Returns import history entries for a specific import type (newest first).
      *
      * @param import_type The import type to filter by ("import" or "link").
      * @return Vector of ImportHistoryEntry objects for the specified type.
      */
     std::vector<ImportHistoryEntry> filtered_history;
-    for (const auto& entry : history_) {
-        if (entry.import_type == import_type) {
-            filtered_history.push_back(entry);
-        }
-    }
-    
-    // Sort by timestamp (newest first)
-    std::sort(filtered_history.begin(), filtered_history.end(),
-              [](const ImportHistoryEntry& a, const ImportHistoryEntry& b) {
-                  return a.timestamp > b.timestamp;
-              });
-    
+    history_.forEachByType(import_type, [&filtered_history](const ImportHistoryEntry& entry) {
+        filtered_history.push_back(entry);
+        return true;
+    });
     return filtered_history;
 }
 
@@ -151,28 +143,55 @@ std::vector<ImportHistoryEntry> ImportHistory::getHistoryByTimeRange(
     const std::chrono::system_clock::time_point& start,
     const std::chrono::system_clock::time_point& end) const {
     /**
-     * @brief Returns import history entries within a specific time range.
+     * @brief Returns import history entries within a specific time range (newest first).
+     *        Range bounds are located by binary search.
      *
      * @param start Start time of the range.
      * @param end End time of the range.
      * @return Vector of ImportHistoryEntry objects within the time range.
      */
     std::vector<ImportHistoryEntry> filtered_history;
-    for (const auto& entry : history_) {
-        if (entry.timestamp >= start && entry.timestamp <= end) {
-            filtered_history.push_back(entry);
-        }
-    }
-    
-    // Sort by timestamp (newest first)
-    std::sort(filtered_history.begin(), filtered_history.end(),
-              [](const ImportHistoryEntry& a, const ImportHistoryEntry& b) {
-                  return a.timestamp > b.timestamp;
-              });
-    
+    history_.forEachInRange(start, end, [&filtered_history](const ImportHistoryEntry& entry) {
+        filtered_history.push_back(entry);
+        return true;
+    });
     return filtered_history;
 }
 
+std::vector<ImportHistoryEntry> ImportHistory::getHistoryPage(size_t offset, size_t limit) const {
+    /**
+     * @brief Returns one page of the history, newest first.
+     *
+     * @param offset Number of newest entries to skip.
+     * @param limit Maximum number of entries to return.
+     * @return Up to `limit` entries.
+     */
+    return history_.page(offset, limit);
+}
+
+void ImportHistory::forEachEntry(const std::function<bool(const ImportHistoryEntry&)>& visitor) const {
+    /**
+     * @brief Visits every entry newest first without copying; the visitor returns false to stop.
+     *
+     * @param visitor Called once per entry.
+     */
+    history_.forEach(visitor);
+}
+
+void ImportHistory::forEachEntryInRange(
+    const std::chrono::system_clock::time_point& start,
+    const std::chrono::system_clock::time_point& end,
+    const std::function<bool(const ImportHistoryEntry&)>& visitor) const {
+    /**
+     * @brief Visits entries with start <= timestamp <= end, newest first; the visitor returns false to stop.
+     *
+     * @param start Start time of the range.
+     * @param end End time of the range.
+     * @param visitor Called once per entry in range.
+     */
+    history_.forEachInRange(start, end, visitor);
+}
+
 UndoResult ImportHistory::undoLastImport() {
     /**
      * @brief Undoes the most recent import operation.
@@ -180,39 +199,44 @@ UndoResult ImportHistory::undoLastImport() {
      *
      * @return UndoResult with success status and details about the operation.
      */
-    if (history_.empty()) {
+    const ImportHistoryEntry* latest_entry = history_.newest();
+    if (!latest_entry) {
         return {false, "No imports to undo", {}, {}, {}};
     }
     
-    // Get the most recent entry
-    auto latest_entry = history_.back();
-    return undoImport(latest_entry.id);
+    // Copy the id: undoImport removes the entry it refers to
+    std::string latest_id = latest_entry->id;
+    return undoImport(latest_id);
 }
 
 UndoResult ImportHistory::undoImport(const std::string& entry_id) {
     /**
      * @brief Undoes a specific import operation by entry ID.
-     *        Removes the imported/linked objects from Blender and removes the entry from history.
+     *        Removes the imported/linked objects from the scene file they were imported into
+     *        (metadata "scene_file") and removes the entry from history.
      *
      * @param entry_id The unique identifier of the import entry to undo.
-     * @return UndoResult with success status and details about the operation.
+     * @return UndoResult with success status and details about the operation; entries whose objects
+     *         have no recorded scene file cannot be undone and are reported as unsupported.
      */
     UndoResult result;
     result.success = false;
     result.message = "";
     
     // Find the entry
-    auto it = std::find_if(history_.begin(), history_.end(),
-                          [&entry_id](const ImportHistoryEntry& entry) {
-                              return entry.id == entry_id;
-                          });
-    
-    if (it == history_.end()) {
+    const ImportHistoryEntry* found = history_.find(entry_id);
+    if (!found) {
         result.message = "Import entry not found: " + entry_id;
         return result;
     }
     
-    ImportHistoryEntry entry = *it;
+    ImportHistoryEntry entry = *found;
+    
+    if (!isUndoable(entry)) {
+        result.message = "Undo not supported for " + entry.asset_path + ": no scene file recorded";
+        result.metadata["unsupported"] = "true";
+        return result;
+    }
     
     // Remove objects from Blender
     if (removeEntryFromBlender(entry)) {
@@ -221,12 +245,12 @@ UndoResult ImportHistory::undoImport(const std::string& entry_id) {
         result.removed_objects = entry.imported_objects;
         
         // Remove entry from history
-        history_.erase(it);
+        history_.erase(entry.id);
         
-        // Auto-save if file path is set
-        if (!history_file_path_.empty()) {
-            saveHistory(history_file_path_);
+        if (HistoryJournal* store = journal()) {
+            store->appendRemove({entry.id});
         }
+        maybeCompact();
     } else {
         result.message = "Failed to remove objects from Blender for: " + entry.asset_path;
     }
@@ -236,8 +260,10 @@ UndoResult ImportHistory::undoImport(const std::string& entry_id) {
 
 UndoResult ImportHistory::undoImports(const std::vector<std::string>& entry_ids) {
     /**
-     * @brief Undoes multiple import operations by entry IDs.
-     *        Processes entries in reverse order to maintain consistency.
+     * @brief Undoes multiple import operations by entry IDs with one Blender run per scene file.
+     *        Each run removes the objects of every entry imported into that scene and purges the
+     *        meshes and materials those objects left orphaned; the history is updated with one
+     *        removal record.
      *
      * @param entry_ids Vector of unique identifiers of import entries to undo.
      * @return UndoResult with success status and details about the operations.
@@ -246,29 +272,67 @@ UndoResult ImportHistory::undoImports(const std::vector<std::string>& entry_ids)
     result.success = true;
     result.message = "";
     
-    std::vector<std::string> all_removed_objects;
+    struct SceneBatch {
+        std::vector<std::string> ids;
+        std::vector<std::string> objects;
+    };
+    std::map<std::string, SceneBatch> batches;   // scene file -> entries undone by one run
     std::vector<std::string> failed_entries;
+    size_t unsupported = 0;
+    std::unordered_set<std::string> seen;
     
-    // Process entries in reverse order to maintain consistency
+    // Newest first, matching the order single undos would run in
     for (auto it = entry_ids.rbegin(); it != entry_ids.rend(); ++it) {
-        UndoResult single_result = undoImport(*it);
-        if (single_result.success) {
-            all_removed_objects.insert(all_removed_objects.end(),
-                                     single_result.removed_objects.begin(),
-                                     single_result.removed_objects.end());
+        const ImportHistoryEntry* entry = history_.find(*it);
+        if (!entry || !seen.insert(*it).second) {
+            if (!entry) failed_entries.push_back(*it);
+            continue;
+        }
+        if (!isUndoable(*entry)) {
+            failed_entries.push_back(entry->id);
+            ++unsupported;
+            continue;
+        }
+        SceneBatch& batch = batches[entrySceneFile(*entry)];
+        batch.ids.push_back(entry->id);
+        batch.objects.insert(batch.objects.end(), entry->imported_objects.begin(), entry->imported_objects.end());
+    }
+    
+    std::vector<std::string> undone_ids;
+    for (auto& [scene_file, batch] : batches) {
+        // Objects shared by several entries are removed once
+        std::unordered_set<std::string> unique_objects;
+        batch.objects.erase(std::remove_if(batch.objects.begin(), batch.objects.end(),
+                                           [&unique_objects](const std::string& name) {
+                                               return !unique_objects.insert(name).second;
+                                           }),
+                            batch.objects.end());
+        
+        if (removeObjectsFromBlender(scene_file, batch.objects, true)) {
+            undone_ids.insert(undone_ids.end(), batch.ids.begin(), batch.ids.end());
+            result.removed_objects.insert(result.removed_objects.end(), batch.objects.begin(), batch.objects.end());
         } else {
-            failed_entries.push_back(*it);
-            result.success = false;
+            failed_entries.insert(failed_entries.end(), batch.ids.begin(), batch.ids.end());
         }
     }
     
-    result.removed_objects = all_removed_objects;
+    if (!undone_ids.empty()) {
+        for (const auto& id : undone_ids) {
+            history_.erase(id);
+        }
+        journalRemovals(undone_ids);
+        maybeCompact();
+    }
     
+    result.success = failed_entries.empty();
     if (result.success) {
-        result.message = "Successfully undone " + std::to_string(entry_ids.size()) + " imports";
+        result.message = "Successfully undone " + std::to_string(undone_ids.size()) + " imports";
     } else {
         result.message = "Partially undone imports. Failed entries: " + std::to_string(failed_entries.size());
     }
+    result.metadata["undone_entries"] = std::to_string(undone_ids.size());
+    result.metadata["failed_entries"] = std::to_string(failed_entries.size());
+    result.metadata["unsupported_entries"] = std::to_string(unsupported);
     
     return result;
 }
@@ -277,21 +341,32 @@ bool ImportHistory::canUndo() const {
     /**
      * @brief Checks if there are any imports that can be undone.
      *
-     * @return True if there are undoable imports, false otherwise.
+     * @return True if some entry passes the same check undoImport applies, false otherwise.
      */
-    return !history_.empty();
+    bool undoable = false;
+    history_.forEach([&undoable](const ImportHistoryEntry& entry) {
+        undoable = isUndoable(entry);
+        return !undoable;
+    });
+    return undoable;
 }
 
 std::vector<std::string> ImportHistory::getUndoableEntries() const {
     /**
      * @brief Returns a list of entry IDs that can be undone.
+     *        Entries whose objects have no recorded scene file are left out; undoImport rejects them.
      *
      * @return Vector of entry IDs that can be undone.
      */
     std::vector<std::string> undoable_entries;
-    for (const auto& entry : history_) {
-        undoable_entries.push_back(entry.id);
-    }
+    history_.forEach([&undoable_entries](const ImportHistoryEntry& entry) {
+        if (isUndoable(entry)) {
+            undoable_entries.push_back(entry.id);
+        }
+        return true;
+    });
+    // Oldest first, as before
+    std::reverse(undoable_entries.begin(), undoable_entries.end());
     return undoable_entries;
 }
 
@@ -301,11 +376,15 @@ void ImportHistory::clearHistory() {
      *        This is a destructive operation and cannot be undone.
      */
     history_.clear();
+    pending_evictions_.clear();
+    pending_eviction_ids_.clear();
+    next_expiry_ = std::chrono::system_clock::time_point::max();
     
-    // Auto-save if file path is set
-    if (!history_file_path_.empty()) {
-        saveHistory(history_file_path_);
+    // A single clear record; compaction later drops the records it supersedes
+    if (HistoryJournal* store = journal()) {
+        store->appendClear();
     }
+    maybeCompact();
 }
 
 void ImportHistory::clearHistoryByAsset(const std::string& asset_path) {
@@ -314,18 +393,16 @@ void ImportHistory::clearHistoryByAsset(const std::string& asset_path) {
      *
      * @param asset_path The asset path to clear history for.
      */
-    history_.erase(
-        std::remove_if(history_.begin(), history_.end(),
-                      [&asset_path](const ImportHistoryEntry& entry) {
-                          return entry.asset_path == asset_path;
-                      }),
-        history_.end()
-    );
-    
-    // Auto-save if file path is set
-    if (!history_file_path_.empty()) {
-        saveHistory(history_file_path_);
+    std::vector<std::string> ids;
+    history_.forEachByAsset(asset_path, [&ids](const ImportHistoryEntry& entry) {
+        ids.push_back(entry.id);
+        return true;
+    });
+    for (const auto& id : ids) {
+        history_.erase(id);
     }
+    journalRemovals(ids);
+    maybeCompact();
 }
 
 void ImportHistory::clearHistoryByType(const std::string& import_type) {
@@ -334,18 +411,16 @@ void ImportHistory::clearHistoryByType(const std::string& import_type) {
      *
      * @param import_type The import type to clear history for.
      */
-    history_.erase(
-        std::remove_if(history_.begin(), history_.end(),
-                      [&import_type](const ImportHistoryEntry& entry) {
-                          return entry.import_type == import_type;
-                      }),
-        history_.end()
-    );
-    
-    // Auto-save if file path is set
-    if (!history_file_path_.empty()) {
-        saveHistory(history_file_path_);
+    std::vector<std::string> ids;
+    history_.forEachByType(import_type, [&ids](const ImportHistoryEntry& entry) {
+        ids.push_back(entry.id);
+        return true;
+    });
+    for (const auto& id : ids) {
+        history_.erase(id);
     }
+    journalRemovals(ids);
+    maybeCompact();
 }
 
 void ImportHistory::clearHistoryByTimeRange(
@@ -357,59 +432,42 @@ void ImportHistory::clearHistoryByTimeRange(
      * @param start Start time of the range.
      * @param end End time of the range.
      */
-    history_.erase(
-        std::remove_if(history_.begin(), history_.end(),
-                      [&start, &end](const ImportHistoryEntry& entry) {
-                          return entry.timestamp >= start && entry.timestamp <= end;
-                      }),
-        history_.end()
-    );
-    
-    // Auto-save if file path is set
-    if (!history_file_path_.empty()) {
-        saveHistory(history_file_path_);
+    std::vector<std::string> ids;
+    history_.forEachInRange(start, end, [&ids](const ImportHistoryEntry& entry) {
+        ids.push_back(entry.id);
+        return true;
+    });
+    for (const auto& id : ids) {
+        history_.erase(id);
     }
+    journalRemovals(ids);
+    maybeCompact();
 }
 
 void ImportHistory::clearFailedImports() {
     /**
      * @brief Clears all failed import history entries.
      */
-    history_.erase(
-        std::remove_if(history_.begin(), history_.end(),
-                      [](const ImportHistoryEntry& entry) {
-                          return !entry.success;
-                      }),
-        history_.end()
-    );
-    
-    // Auto-save if file path is set
-    if (!history_file_path_.empty()) {
-        saveHistory(history_file_path_);
-    }
+    removeEntriesWhere([](const ImportHistoryEntry& entry) {
+        return !entry.success;
+    });
+    maybeCompact();
 }
 
 void ImportHistory::clearSuccessfulImports() {
     /**
      * @brief Clears all successful import history entries.
      */
-    history_.erase(
-        std::remove_if(history_.begin(), history_.end(),
-                      [](const ImportHistoryEntry& entry) {
-                          return entry.success;
-                      }),
-        history_.end()
-    );
-    
-    // Auto-save if file path is set
-    if (!history_file_path_.empty()) {
-        saveHistory(history_file_path_);
-    }
+    removeEntriesWhere([](const ImportHistoryEntry& entry) {
+        return entry.success;
+    });
+    maybeCompact();
 }
 
 HistoryStats ImportHistory::getStats() const {
     /**
      * @brief Generates comprehensive statistics about the import history.
+     *        Read from the incrementally maintained rollup; no entries are scanned.
      *
      * @return HistoryStats object with detailed statistics.
      */
@@ -419,74 +477,72 @@ HistoryStats ImportHistory::getStats() const {
         return stats;
     }
     
-    stats.total_imports = history_.size();
+    fillStats(stats, history_.rollup().totals());
+    stats.first_import = history_.oldest()->timestamp;
+    stats.last_import = history_.newest()->timestamp;
     
-    // Find first and last import times
-    auto first_time = history_[0].timestamp;
-    auto last_time = history_[0].timestamp;
+    return stats;
+}
+
+HistoryStats ImportHistory::getStatsInRange(
+    const std::chrono::system_clock::time_point& start,
+    const std::chrono::system_clock::time_point& end) const {
+    /**
+     * @brief Generates statistics for a time window from the hourly/daily rollup buckets.
+     *        Counts are bucket-aligned (every hour overlapping the window is included);
+     *        cost is O(buckets) regardless of history size.
+     *
+     * @param start Start time of the window.
+     * @param end End time of the window.
+     * @return HistoryStats for the window; first/last import are the exact in-window extremes.
+     */
+    HistoryStats stats = {};
+    fillStats(stats, history_.rollup().window(start, end));
     
-    for (const auto& entry : history_) {
-        // Count successful/failed imports
-        if (entry.success) {
-            stats.successful_imports++;
-        } else {
-            stats.failed_imports++;
-        }
-        
-        // Count import types
-        if (entry.import_type == "link") {
-            stats.linked_assets++;
-        } else {
-            stats.imported_assets++;
-        }
-        
-        // Track import type distribution
-        stats.import_types[entry.import_type]++;
-        
-        // Track asset type distribution
-        std::filesystem::path path(entry.asset_path);
-        std::string extension = path.extension().string();
-        if (!extension.empty()) {
-            stats.asset_types[extension]++;
-        }
-        
-        // Update time range
-        if (entry.timestamp < first_time) {
-            first_time = entry.timestamp;
-        }
-        if (entry.timestamp > last_time) {
-            last_time = entry.timestamp;
-        }
+    auto bounds = history_.boundsInRange(start, end);
+    if (bounds.first) {
+        stats.first_import = bounds.first->timestamp;
+        stats.last_import = bounds.second->timestamp;
     }
     
-    stats.first_import = first_time;
-    stats.last_import = last_time;
-    
     return stats;
 }
 
 std::vector<std::string> ImportHistory::getMostImportedAssets(size_t count) const {
     /**
      * @brief Returns the most frequently imported assets.
+     *        Served from the Space-Saving sketch while it has never evicted a counter; its counts
+     *        are exact then. After an eviction, a new asset inherits the evicted count and removals
+     *        of untracked assets are lost, so the sketch is ignored in favour of an exact count.
      *
      * @param count Maximum number of assets to return.
      * @return Vector of asset paths sorted by import frequency.
      */
-    std::map<std::string, size_t> asset_counts;
+    std::vector<std::string> result;
+    const AssetHeavyHitters& sketch = history_.rollup().heavyHitters();
     
-    for (const auto& entry : history_) {
-        asset_counts[entry.asset_path]++;
+    if (sketch.isExact() && count <= sketch.capacity()) {
+        for (const auto& asset : sketch.top(count)) {
+            // Only assets the index still holds entries for
+            if (history_.containsAsset(asset.first)) {
+                result.push_back(asset.first);
+            }
+        }
+        return result;
     }
     
-    // Convert to vector and sort by count
+    std::map<std::string, size_t> asset_counts;
+    history_.forEach([&asset_counts](const ImportHistoryEntry& entry) {
+        asset_counts[entry.asset_path]++;
+        return true;
+    });
+    
     std::vector<std::pair<std::string, size_t>> sorted_assets(asset_counts.begin(), asset_counts.end());
-    std::sort(sorted_assets.begin(), sorted_assets.end(),
-              [](const auto& a, const auto& b) {
-                  return a.second > b.second;
-              });
+    std::stable_sort(sorted_assets.begin(), sorted_assets.end(),
+                     [](const auto& a, const auto& b) {
+                         return a.second > b.second;
+                     });
     
-    // Extract asset paths
-    std::vector<std::string> result;
     for (size_t i = 0; i < std::min(count, sorted_assets.size()); ++i) {
         result.push_back(sorted_assets[i].first);
     }
@@ -501,21 +557,19 @@ std::vector<std::string> ImportHistory::getRecentlyImportedAssets(size_t count)
      * @param count Maximum number of assets to return.
      * @return Vector of asset paths sorted by import time (newest first).
      */
-    std::vector<ImportHistoryEntry> sorted_history = getHistory();
-    
     std::vector<std::string> result;
     std::set<std::string> seen_assets;
+    if (count == 0) {
+        return result;
+    }
     
-    for (const auto& entry : sorted_history) {
-        if (seen_assets.find(entry.asset_path) == seen_assets.end()) {
+    // Walk newest first and stop as soon as enough distinct assets are seen
+    history_.forEach([&](const ImportHistoryEntry& entry) {
+        if (seen_assets.insert(entry.asset_path).second) {
             result.push_back(entry.asset_path);
-            seen_assets.insert(entry.asset_path);
-            
-            if (result.size() >= count) {
-                break;
-            }
         }
-    }
+        return result.size() < count;
+    });
     
     return result;
 }
@@ -526,13 +580,7 @@ std::map<std::string, size_t> ImportHistory::getImportTypeDistribution() const {
      *
      * @return Map of import type to count.
      */
-    std::map<std::string, size_t> distribution;
-    
-    for (const auto& entry : history_) {
-        distribution[entry.import_type]++;
-    }
-    
-    return distribution;
+    return history_.rollup().totals().import_types;
 }
 
 std::map<std::string, size_t> ImportHistory::getAssetTypeDistribution() const {
@@ -541,34 +589,33 @@ std::map<std::string, size_t> ImportHistory::getAssetTypeDistribution() const {
      *
      * @return Map of asset type to count.
      */
-    std::map<std::string, size_t> distribution;
-    
-    for (const auto& entry : history_) {
-        std::filesystem::path path(entry.asset_path);
-        std::string extension = path.extension().string();
-        if (!extension.empty()) {
-            distribution[extension]++;
-        }
-    }
-    
-    return distribution;
+    return history_.rollup().totals().asset_types;
 }
 
 bool ImportHistory::saveHistory(const std::string& file_path) const {
     /**
      * @brief Saves the import history to a JSON file.
+     *        Written to a temporary file and renamed, so an interrupted save never
+     *        leaves a truncated export behind.
      *
      * @param file_path Path to the file to save to.
      * @return True if successful, false otherwise.
      */
     try {
-        std::ofstream file(file_path);
-        if (!file.is_open()) {
-            return false;
+        std::string tmp_path = file_path + ".tmp";
+        {
+            std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            HistorySerializer::write(file, history_.entries());
+            file.flush();
+            if (!file) {
+                std::remove(tmp_path.c_str());
+                return false;
+            }
         }
-        
-        file << exportHistoryAsJSON();
-        return true;
+        return std::rename(tmp_path.c_str(), file_path.c_str()) == 0;
     } catch (const std::exception& e) {
         return false;
     }
@@ -576,100 +623,48 @@ bool ImportHistory::saveHistory(const std::string& file_path) const {
 
 bool ImportHistory::loadHistory(const std::string& file_path) {
     /**
-     * @brief Loads import history from a JSON file.
+     * @brief Loads import history from a JSON file, replacing the current history.
+     *        The file is memory-mapped and streamed through a SAX parser, so memory use
+     *        follows the number of entries rather than the size of the file text.
      *
      * @param file_path Path to the file to load from.
-     * @return True if successful, false otherwise.
+     * @return True if successful, false otherwise (history is left unchanged).
      */
-    try {
-        std::ifstream file(file_path);
-        if (!file.is_open()) {
-            return false;
-        }
-        
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        
-        return importHistoryFromJSON(buffer.str());
-    } catch (const std::exception& e) {
+    std::vector<ImportHistoryEntry> entries;
+    std::string error;
+    if (!HistorySerializer::parseFile(file_path, entries, &error)) {
+        std::cerr << "Failed to load import history " << file_path << ": " << error << std::endl;
         return false;
     }
+    replaceHistory(std::move(entries));
+    return true;
 }
 
 std::string ImportHistory::exportHistoryAsJSON() const {
     /**
      * @brief Exports the import history as a JSON string.
+     *        All strings are escaped; options, imported objects and metadata are included.
      *
      * @return JSON string representation of the history.
      */
-    std::ostringstream json;
-    json << "{\n";
-    json << "  \"history\": [\n";
-    
-    for (size_t i = 0; i < history_.size(); ++i) {
-        const auto& entry = history_[i];
-        
-        json << "    {\n";
-        json << "      \"id\": \"" << entry.id << "\",\n";
-        json << "      \"asset_path\": \"" << entry.asset_path << "\",\n";
-        json << "      \"import_type\": \"" << entry.import_type << "\",\n";
-        json << "      \"timestamp\": \"" << std::chrono::duration_cast<std::chrono::seconds>(
-            entry.timestamp.time_since_epoch()).count() << "\",\n";
-        json << "      \"success\": " << (entry.success ? "true" : "false") << ",\n";
-        json << "      \"message\": \"" << entry.message << "\",\n";
-        json << "      \"collection_name\": \"" << entry.collection_name << "\",\n";
-        
-        // Export options
-        json << "      \"options\": {\n";
-        for (auto it = entry.options.begin(); it != entry.options.end(); ++it) {
-            json << "        \"" << it->first << "\": \"" << it->second << "\"";
-            if (std::next(it) != entry.options.end()) {
-                json << ",";
-            }
-            json << "\n";
-        }
-        json << "      },\n";
-        
-        // Export imported objects
-        json << "      \"imported_objects\": [";
-        for (size_t j = 0; j < entry.imported_objects.size(); ++j) {
-            json << "\"" << entry.imported_objects[j] << "\"";
-            if (j < entry.imported_objects.size() - 1) {
-                json << ", ";
-            }
-        }
-        json << "]\n";
-        
-        json << "    }";
-        if (i < history_.size() - 1) {
-            json << ",";
-        }
-        json << "\n";
-    }
-    
-    json << "  ]\n";
-    json << "}\n";
-    
-    return json.str();
+    return HistorySerializer::toJSON(history_.entries());
 }
 
 bool ImportHistory::importHistoryFromJSON(const std::string& json_data) {
     /**
-     * @brief Imports import history from a JSON string.
+     * @brief Imports import history from a JSON string, replacing the current history.
      *
      * @param json_data JSON string to import from.
-     * @return True if successful, false otherwise.
+     * @return True if successful, false otherwise (history is left unchanged).
      */
-    // This is a simplified implementation
-    // In a real implementation, you would use a proper JSON parser
-    try {
-        // For now, just clear the history and return true
-        // A proper implementation would parse the JSON and populate history_
-        history_.clear();
-        return true;
-    } catch (const std::exception& e) {
+    std::vector<ImportHistoryEntry> entries;
+    std::string error;
+    if (!HistorySerializer::parse(json_data, entries, &error)) {
+        std::cerr << "Failed to import history JSON: " << error << std::endl;
         return false;
     }
+    replaceHistory(std::move(entries));
+    return true;
 }
 
 void ImportHistory::setMaxHistorySize(size_t max_size) {
@@ -709,11 +704,178 @@ void ImportHistory::enableAutoCleanup(bool enable) {
 
 void ImportHistory::setHistoryFilePath(const std::string& file_path) {
     /**
-     * @brief Sets the file path for automatic history persistence.
+     * @brief Sets the file path for automatic history persistence and loads that store.
+     *        The in-memory history is replaced by what the store holds, so later changes
+     *        and compactions extend the persisted history instead of overwriting it.
      *
-     * @param file_path Path to the history file.
+     * @param file_path Path to the history file (empty disables persistence).
      */
+    // Close the previous store (finishing any compaction) before switching paths
+    flushEvictions();
+    journal_.reset();
     history_file_path_ = file_path;
+    if (!history_file_path_.empty()) {
+        recoverHistory();
+    }
+}
+
+bool ImportHistory::recoverHistory() {
+    /**
+     * @brief Restores history from the journal store at the history file path.
+     *        Replays the snapshot and any journaled changes since; torn trailing records
+     *        left by a crash are discarded. A store that was never written adopts the legacy
+     *        JSON history at the same path, if there is one. Retention and the size limit are then applied
+     *        and journaled, so entries that aged out while no process was running are
+     *        evicted from the store as well as from memory.
+     *
+     * @return True if the store was readable (an absent store recovers as empty history).
+     */
+    HistoryJournal* store = journal();
+    if (!store) {
+        return false;
+    }
+    std::vector<ImportHistoryEntry> recovered;
+    bool ok = store->recover(recovered);
+    if (ok && recovered.empty() && !store->hasStore()) {
+        ok = migrateLegacyHistory(*store, recovered);
+    }
+    history_.assign(std::move(recovered));
+    pending_evictions_.clear();
+    pending_eviction_ids_.clear();
+    rescheduleExpiry();
+    
+    // Entries may have aged out while no process had the store open
+    if (auto_cleanup_enabled_) {
+        cleanupOldEntries();
+    }
+    // Evictions are journaled in batches, so a crash can leave a few evicted entries behind
+    enforceMaxSize();
+    flushEvictions();
+    return ok;
+}
+
+bool ImportHistory::migrateLegacyHistory(HistoryJournal& store, std::vector<ImportHistoryEntry>& entries) {
+    /**
+     * @brief Imports the JSON file earlier versions rewrote at the history file path into an empty store.
+     *        The file is renamed to "<path>.migrated" before it is read, so only one process imports it
+     *        and later opens find the journal instead.
+     *
+     * @param store Freshly recovered store with no snapshot or journal.
+     * @param entries Receives the migrated entries.
+     * @return False if the legacy file could not be parsed (it is left in place).
+     */
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(history_file_path_, ec)) {
+        return true;
+    }
+    std::string migrated_path = history_file_path_ + ".migrated";
+    if (std::rename(history_file_path_.c_str(), migrated_path.c_str()) != 0) {
+        return true; // Another process is migrating it
+    }
+    std::string error;
+    if (!HistorySerializer::parseFile(migrated_path, entries, &error)) {
+        std::cerr << "Failed to migrate import history " << history_file_path_ << ": " << error << std::endl;
+        std::rename(migrated_path.c_str(), history_file_path_.c_str());
+        entries.clear();
+        return false;
+    }
+    for (auto& entry : entries) {
+        if (entry.id.empty()) {
+            entry.id = generateEntryId();
+        }
+        store.appendAdd(entry);
+    }
+    return true;
+}
+
+bool ImportHistory::compactHistory() {
+    /**
+     * @brief Synchronously compacts the journal into a snapshot of the current history.
+     *
+     * @return True if the snapshot was written.
+     */
+    HistoryJournal* store = journal();
+    flushEvictions();
+    return store && store->compact();
+}
+
+bool ImportHistory::refreshHistory() {
+    /**
+     * @brief Picks up changes other processes appended to the shared store since the last
+     *        recover or refresh. Falls back to a full recover when the journal was compacted meanwhile.
+     *
+     * @return True if the store was readable.
+     */
+    HistoryJournal* store = journal();
+    if (!store) {
+        return false;
+    }
+    flushEvictions();
+
+    // Added records are merged in batches; a remove or clear first applies the adds before it
+    std::vector<ImportHistoryEntry> added;
+    auto merge_added = [this, &added]() {
+        if (!added.empty()) {
+            history_.insertBatch(std::move(added));
+            added.clear();
+        }
+    };
+    bool tailed = store->tail(
+        [&added](const ImportHistoryEntry& entry) { added.push_back(entry); },
+        [this, &merge_added](const std::vector<std::string>& ids) {
+            merge_added();
+            for (const auto& id : ids) {
+                history_.erase(id);
+            }
+        },
+        [this, &added]() {
+            added.clear();
+            history_.clear();
+        });
+    merge_added();
+    if (!tailed) {
+        return recoverHistory();
+    }
+    rescheduleExpiry();
+    if (auto_cleanup_enabled_) {
+        enforceMaxSize();
+        flushEvictions();
+    }
+    return true;
+}
+
+void ImportHistory::setCompactionThreshold(size_t records) {
+    /**
+     * @brief Sets the minimum number of journal records between background compactions.
+     *        Compaction also waits for at least as many records as there are live entries.
+     *
+     * @param records Record count threshold.
+     */
+    compaction_threshold_ = records;
+    if (journal_) {
+        journal_->setCompactionThreshold(records);
+    }
+}
+
+void ImportHistory::setDurableWrites(bool enable) {
+    /**
+     * @brief Enables fdatasync after each journal record (survives power loss, slower).
+     *
+     * @param enable True to sync every record.
+     */
+    durable_writes_ = enable;
+    if (journal_) {
+        journal_->setDurableWrites(enable);
+    }
+}
+
+HistoryJournalStats ImportHistory::getJournalStats() const {
+    /**
+     * @brief Returns journal append/compaction/replay counters.
+     *
+     * @return HistoryJournalStats, empty if no store is open.
+     */
+    return journal_ ? journal_->getStats() : HistoryJournalStats{};
 }
 
 std::string ImportHistory::generateEntryId() const {
@@ -732,10 +894,7 @@ bool ImportHistory::entryExists(const std::string& entry_id) const {
      * @param entry_id The entry ID to check.
      * @return True if the entry exists, false otherwise.
      */
-    return std::any_of(history_.begin(), history_.end(),
-                      [&entry_id](const ImportHistoryEntry& entry) {
-                          return entry.id == entry_id;
-                      });
+    return history_.find(entry_id) != nullptr;
 }
 
 std::optional<ImportHistoryEntry> ImportHistory::getEntry(const std::string& entry_id) const {
@@ -745,13 +904,8 @@ std::optional<ImportHistoryEntry> ImportHistory::getEntry(const std::string& ent
      * @param entry_id The entry ID to look up.
      * @return Optional containing the entry if found.
      */
-    auto it = std::find_if(history_.begin(), history_.end(),
-                          [&entry_id](const ImportHistoryEntry& entry) {
-                              return entry.id == entry_id;
-                          });
-    
-    if (it != history_.end()) {
-        return *it;
+    if (const ImportHistoryEntry* entry = history_.find(entry_id)) {
+        return *entry;
     }
     
     return std::nullopt;
@@ -775,76 +929,238 @@ bool ImportHistory::isEmpty() const {
     return history_.empty();
 }
 
+HistoryJournal* ImportHistory::journal() {
+    /**
+     * @brief Returns the journal for the current history file path, opening it lazily.
+     *
+     * @return Journal pointer, or nullptr when persistence is disabled (empty path).
+     */
+    if (history_file_path_.empty()) {
+        return nullptr;
+    }
+    if (!journal_) {
+        journal_ = std::make_unique<HistoryJournal>(history_file_path_);
+        journal_->setCompactionThreshold(compaction_threshold_);
+        journal_->setDurableWrites(durable_writes_);
+    }
+    return journal_.get();
+}
+
+void ImportHistory::maybeCompact() {
+    /**
+     * @brief Starts a background compaction once enough records have accumulated.
+     */
+    if (journal_ && journal_->shouldCompact(history_.size())) {
+        flushEvictions();
+        journal_->compactAsync();
+    }
+}
+
+void ImportHistory::replaceHistory(std::vector<ImportHistoryEntry> entries) {
+    /**
+     * @brief Swaps in a loaded history and journals it as a clear followed by one add per entry.
+     *
+     * @param entries Parsed entries; missing IDs are generated.
+     */
+    for (auto& entry : entries) {
+        if (entry.id.empty()) {
+            entry.id = generateEntryId();
+        }
+    }
+    pending_evictions_.clear();
+    pending_eviction_ids_.clear();
+    if (HistoryJournal* store = journal()) {
+        store->appendClear();
+        for (const auto& entry : entries) {
+            store->appendAdd(entry);
+        }
+    }
+    history_.assign(std::move(entries));
+    rescheduleExpiry();
+    maybeCompact();
+}
+
+void ImportHistory::fillStats(HistoryStats& stats, const HistoryRollupCounters& counters) {
+    /**
+     * @brief Copies rollup counters into the public HistoryStats layout.
+     */
+    stats.total_imports = counters.total;
+    stats.successful_imports = counters.successful;
+    stats.failed_imports = counters.failed;
+    auto linked = counters.import_types.find("link");
+    stats.linked_assets = linked == counters.import_types.end() ? 0 : linked->second;
+    stats.imported_assets = counters.total - stats.linked_assets;
+    stats.import_types = counters.import_types;
+    stats.asset_types = counters.asset_types;
+}
+
+void ImportHistory::journalRemovals(const std::vector<std::string>& removed_ids) {
+    /**
+     * @brief Journals removed entries as one tombstone record.
+     *
+     * @param removed_ids IDs already erased from the in-memory store.
+     */
+    if (!removed_ids.empty()) {
+        if (HistoryJournal* store = journal()) {
+            store->appendRemove(removed_ids);
+        }
+    }
+}
+
+std::vector<std::string> ImportHistory::removeEntriesWhere(
+    const std::function<bool(const ImportHistoryEntry&)>& predicate) {
+    /**
+     * @brief Erases matching entries and journals their removal as one tombstone record.
+     *
+     * @param predicate Returns true for entries to remove.
+     * @return IDs of the removed entries.
+     */
+    std::vector<std::string> removed_ids = history_.eraseWhere(predicate);
+    journalRemovals(removed_ids);
+    return removed_ids;
+}
+
 void ImportHistory::cleanupOldEntries() {
     /**
-     * @brief Removes entries older than the retention period.
+     * @brief Removes expired entries a whole hour segment at a time.
+     *        Only segments that ended before the retention cutoff are dropped (entries may outlive
+     *        the retention period by up to one segment); they sit at the ring head, so removal is
+     *        O(1) per entry and the batch is journaled as one record.
      */
-    auto cutoff_time = std::chrono::system_clock::now() - retention_period_;
-    
-    history_.erase(
-        std::remove_if(history_.begin(), history_.end(),
-                      [&cutoff_time](const ImportHistoryEntry& entry) {
-                          return entry.timestamp < cutoff_time;
-                      }),
-        history_.end()
-    );
+    auto cutoff_time = segmentStart(std::chrono::system_clock::now() - retention_period_);
+    journalRemovals(history_.eraseBefore(cutoff_time));
+    rescheduleExpiry();
 }
 
 void ImportHistory::enforceMaxSize() {
     /**
-     * @brief Ensures the history doesn't exceed the maximum size.
+     * @brief Ensures the history doesn't exceed the maximum size by evicting the oldest entries.
+     *        Eviction pops the ring head; the journal records are batched (see flushEvictions).
      */
-    if (history_.size() > max_history_size_) {
-        // Sort by timestamp (oldest first) and remove excess entries
-        std::sort(history_.begin(), history_.end(),
-                  [](const ImportHistoryEntry& a, const ImportHistoryEntry& b) {
-                      return a.timestamp < b.timestamp;
-                  });
-        
-        history_.erase(history_.begin() + max_history_size_, history_.end());
+    if (history_.size() <= max_history_size_) {
+        return;
+    }
+    for (auto& id : history_.eraseOldest(history_.size() - max_history_size_)) {
+        pending_eviction_ids_.insert(id);
+        pending_evictions_.push_back(std::move(id));
+    }
+    if (pending_evictions_.size() >= kEvictionBatch) {
+        flushEvictions();
     }
+    if (history_.empty()) {
+        next_expiry_ = std::chrono::system_clock::time_point::max();
+    }
+}
+
+void ImportHistory::flushEvictions() {
+    /**
+     * @brief Journals pending size-based evictions as one tombstone record.
+     *        Losing unflushed evictions in a crash is harmless: recovery re-applies the size limit.
+     */
+    if (pending_evictions_.empty()) {
+        return;
+    }
+    journalRemovals(pending_evictions_);
+    pending_evictions_.clear();
+    pending_eviction_ids_.clear();
+}
+
+void ImportHistory::rescheduleExpiry() {
+    /**
+     * @brief Sets the next expiry check to when the oldest entry's segment fully ages out.
+     */
+    const ImportHistoryEntry* oldest = history_.oldest();
+    next_expiry_ = oldest ? segmentExpiry(oldest->timestamp) : std::chrono::system_clock::time_point::max();
+}
+
+std::chrono::system_clock::time_point ImportHistory::segmentStart(
+    const std::chrono::system_clock::time_point& time) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::floor<std::chrono::hours>(time.time_since_epoch()));
+}
+
+std::chrono::system_clock::time_point ImportHistory::segmentExpiry(
+    const std::chrono::system_clock::time_point& time) const {
+    return segmentStart(time) + std::chrono::hours(1) + retention_period_;
 }
 
 std::string ImportHistory::generateUniqueId() const {
     /**
-     * @brief Generates a unique identifier using timestamp and random components.
+     * @brief Generates a unique identifier from the shared monotonic ULID-style generator.
+     *        IDs sort lexicographically in generation order.
      *
      * @return Unique identifier string.
      */
-    auto now = std::chrono::system_clock::now();
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()).count();
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(1000, 9999);
-    
-    std::ostringstream oss;
-    oss << "import_" << timestamp << "_" << dis(gen);
-    return oss.str();
+    return HistoryIdGenerator::next();
+}
+
+std::string ImportHistory::entrySceneFile(const ImportHistoryEntry& entry) {
+    /**
+     * @brief Returns the .blend file an entry's objects were imported into.
+     *
+     * @param entry The ImportHistoryEntry to inspect.
+     * @return The "scene_file" metadata value, or an empty string if none was recorded.
+     */
+    auto it = entry.metadata.find("scene_file");
+    return it != entry.metadata.end() ? it->second : std::string();
+}
+
+bool ImportHistory::isUndoable(const ImportHistoryEntry& entry) {
+    /**
+     * @brief Checks whether undo can remove an entry's objects.
+     *        Objects can only be removed from the scene file they were saved into; an entry without
+     *        objects has nothing to remove, so undoing it only drops it from history.
+     *
+     * @param entry The ImportHistoryEntry to inspect.
+     * @return True if undoImport and undoImports accept the entry.
+     */
+    return entry.imported_objects.empty() || !entrySceneFile(entry).empty();
 }
 
 bool ImportHistory::removeEntryFromBlender(const ImportHistoryEntry& entry) {
     /**
-     * @brief Removes imported/linked objects from Blender using Python script.
+     * @brief Removes imported/linked objects from the entry's scene file using Python script.
      *
      * @param entry The ImportHistoryEntry containing objects to remove.
      * @return True if successful, false otherwise.
      */
-    if (entry.imported_objects.empty()) {
+    return removeObjectsFromBlender(entrySceneFile(entry), entry.imported_objects, false);
+}
+
+bool ImportHistory::removeObjectsFromBlender(const std::string& scene_file,
+                                             const std::vector<std::string>& object_names, bool purge_orphans) {
+    /**
+     * @brief Removes objects from a saved scene with one Python script run.
+     *        The script opens scene_file, removes the objects and saves the file again.
+     *
+     * @param scene_file The .blend file the objects were imported into.
+     * @param object_names Objects to remove; names missing from the scene are skipped.
+     * @param purge_orphans Also remove the meshes and materials of the removed objects once unused;
+     *                      other orphans in the file are left alone.
+     * @return True if successful (or nothing to remove), false otherwise (including no scene file).
+     */
+    if (object_names.empty()) {
         return true; // Nothing to remove
     }
+    if (scene_file.empty() || !std::filesystem::is_regular_file(scene_file)) {
+        return false;
+    }
+    std::string scene_path = std::filesystem::absolute(scene_file).string();
     
     // Generate Python script to remove objects
     std::ostringstream py_script;
     py_script << "import bpy\n";
     py_script << "try:\n";
+    py_script << "    scene_path = " << pythonStringLiteral(scene_path) << "\n";
+    py_script << "    bpy.ops.wm.open_mainfile(filepath=scene_path)\n";
     py_script << "    removed_objects = []\n";
+    py_script << "    meshes = []\n";
+    py_script << "    materials = []\n";
     py_script << "    for obj_name in [";
     
-    for (size_t i = 0; i < entry.imported_objects.size(); ++i) {
-        py_script << "\"" << entry.imported_objects[i] << "\"";
-        if (i < entry.imported_objects.size() - 1) {
+    for (size_t i = 0; i < object_names.size(); ++i) {
+        py_script << pythonStringLiteral(object_names[i]);
+        if (i < object_names.size() - 1) {
             py_script << ", ";
         }
     }
@@ -852,9 +1168,22 @@ bool ImportHistory::removeEntryFromBlender(const ImportHistoryEntry& entry) {
     py_script << "]:\n";
     py_script << "        obj = bpy.data.objects.get(obj_name)\n";
     py_script << "        if obj:\n";
+    py_script << "            if obj.type == 'MESH' and obj.data:\n";
+    py_script << "                meshes.append(obj.data.name)\n";
+    py_script << "            materials.extend(slot.material.name for slot in obj.material_slots if slot.material)\n";
     py_script << "            bpy.data.objects.remove(obj, do_unlink=True)\n";
     py_script << "            removed_objects.append(obj_name)\n";
-    py_script << "    print('REMOVED:', removed_objects)\n";
+    if (purge_orphans) {
+        // Meshes first: dropping a mesh releases the materials linked to it
+        py_script << "    for datablocks, names in ((bpy.data.meshes, meshes), (bpy.data.materials, materials)):\n";
+        py_script << "        for name in dict.fromkeys(names):\n";
+        py_script << "            block = datablocks.get(name)\n";
+        py_script << "            if block and block.users == 0:\n";
+        py_script << "                datablocks.remove(block)\n";
+    }
+    py_script << "    if removed_objects:\n";
+    py_script << "        bpy.ops.wm.save_mainfile(filepath=scene_path)\n";
+    py_script << "    print('REMOVED:', len(removed_objects))\n";
     py_script << "    print('SUCCESS')\n";
     py_script << "except Exception as e:\n";
     py_script << "    print('ERROR:', str(e))\n";
@@ -20,10 +20,14 @@
  * - Support for linking assets instead of importing
  * - Integration with material and collection management
  * - Detailed import result reporting and error handling
+ * - Per-stage import telemetry with rolling per-asset-type histograms
+ * - Dependency readahead as soon as imports are queued
+ * - Transparent local SSD hot-asset cache lookups
  * - Extensible design for new import patterns and asset types
  */
 
 #include "import_manager.hpp"
+#include "python_literal.hpp"
 #include "asset_manager.hpp"
 #include <iostream>
 #include <random>
@@ -37,10 +41,13 @@
 #include <array>       // For std::array
 #include <memory>      // For std::unique_ptr
 #include <stdexcept>   // For std::runtime_error
+#include <ctime>       // For clock_gettime(CLOCK_MONOTONIC)
+#include <iomanip>     // For std::setprecision
 
 namespace AssetManager {
 
-ImportManager::ImportManager() : asset_manager_(nullptr) {
+ImportManager::ImportManager()
+    : asset_manager_(nullptr), telemetry_(std::make_shared<ImportTelemetryRegistry>()), prefetcher_(nullptr), hot_cache_(nullptr) {
     // Constructor: Initialize internal state if needed
 }
 
@@ -52,44 +59,154 @@ void ImportManager::setAssetManager(std::shared_ptr<AssetManager> manager) {
     asset_manager_ = manager;
 }
 
-ImportResult ImportManager::importAsset(const std::string& asset_path, const ImportOptions& options) {
+void ImportManager::setPrefetcher(std::shared_ptr<DependencyPrefetcher> prefetcher) {
+    prefetcher_ = prefetcher;
+}
+
+std::shared_ptr<DependencyPrefetcher> ImportManager::getPrefetcher() const {
+    return prefetcher_;
+}
+
+void ImportManager::setHotAssetCache(std::shared_ptr<HotAssetCache> cache) {
+    hot_cache_ = cache;
+}
+
+std::shared_ptr<HotAssetCache> ImportManager::getHotAssetCache() const {
+    return hot_cache_;
+}
+
+ImportResult ImportManager::importAsset(const std::string& asset_path, const ImportOptions& options, bool queue_prefetch) {
+    return importSingle(asset_path, options, queue_prefetch);
+}
+
+ImportResult ImportManager::importSingle(const std::string& asset_path, const ImportOptions& options, bool queue_prefetch) {
     /**
      * @brief Imports or links an asset using Blender subprocess, applying all ImportOptions.
      *        Generates a Python script that sets location, rotation, scale, merge, auto-smooth, etc.
      *        Handles both linking and importing, with robust error handling and detailed reporting.
+     *        Every result carries ImportTelemetry in its metadata; runs whose script reported
+     *        TELEMETRY:start are also recorded in the per-asset-type telemetry histograms.
      *
      * @param asset_path Path to the asset file to import or link.
      * @param options ImportOptions struct with all import parameters.
-     * @return ImportResult with success status, message, and imported object names.
+     * @param queue_prefetch False when readahead was already queued (a bulk import's batch, a pipeline's prefetch stage).
+     * @return ImportResult with success status, message, imported object names and telemetry.
      */
+    const double call_start = monotonicSeconds();
     ImportResult result;
     result.asset_path = asset_path;
     result.success = false;
     result.message = "";
+    ImportTelemetry telemetry;
+    telemetry.asset_type = assetTypeFor(asset_path);
     if (asset_path.empty() || !std::filesystem::exists(asset_path)) {
         result.message = "Asset file does not exist: " + asset_path;
+        telemetry.total_ms = (monotonicSeconds() - call_start) * 1000.0;
+        telemetry.writeTo(result.metadata);
         return result;
     }
-    std::filesystem::path path(asset_path);
+    // Read from the local SSD copy when the asset is hot and unchanged. Not for a saved scene: its
+    // library links and image paths would point into the cache, which deletes the copy on eviction
+    const std::string import_path = hot_cache_ && options.scene_file.empty() ? hot_cache_->resolve(asset_path) : asset_path;
+    result.metadata["hot_cache_hit"] = import_path != asset_path;
+    if (prefetcher_ && queue_prefetch) {
+        // Warm the model, MTL and textures while Blender is still starting up
+        prefetcher_->enqueue(import_path);
+    }
+    std::filesystem::path path(import_path);
     // Helper lambdas for tuple to string
     auto tuple3_to_str = [](const std::tuple<float, float, float>& t) {
         std::ostringstream oss;
         oss << std::get<0>(t) << ", " << std::get<1>(t) << ", " << std::get<2>(t);
         return oss.str();
     };
-    // Prepare Python script with all options
+    const std::string asset_key = std::filesystem::absolute(asset_path).lexically_normal().string();
+    std::ostringstream substitutions;
+    auto planned = options.texture_substitutions.find(asset_key);
+    if (planned != options.texture_substitutions.end()) {
+        for (const auto& [source, replacement] : planned->second) {
+            substitutions << pythonStringLiteral(source) << ": " << pythonStringLiteral(replacement) << ", ";
+            if (import_path != asset_path) {
+                // A hot-cache copy resolves its relative image paths inside the mirrored tree
+                substitutions << pythonStringLiteral(hot_cache_->mirrorPath(source)) << ": "
+                              << pythonStringLiteral(replacement) << ", ";
+            }
+        }
+    }
+    std::ostringstream atlas;
+    auto remap = options.atlas_remaps.find(asset_key);
+    if (remap != options.atlas_remaps.end()) {
+        const AtlasRemap& placement = remap->second;
+        atlas << std::setprecision(9) << "{'material': " << pythonStringLiteral(placement.material_name)
+              << ", 'scale': (" << placement.u_scale << ", " << placement.v_scale << ")"
+              << ", 'offset': (" << placement.u_offset << ", " << placement.v_offset << ")";
+        for (const auto& [channel, texture] : placement.textures) {
+            atlas << ", " << pythonStringLiteral(channel) << ": " << pythonStringLiteral(texture);
+        }
+        atlas << "}";
+    } else {
+        atlas << "None";
+    }
+    const std::string scene_path = options.scene_file.empty()
+        ? std::string() : std::filesystem::absolute(options.scene_file).lexically_normal().string();
+    // Prepare Python script with all options. Stage boundaries are reported as
+    // TELEMETRY:key=value lines measured on CLOCK_MONOTONIC, the same clock used here.
     std::ostringstream py_script;
     py_script << "import bpy\n"
+              << "import os\n"
               << "import sys\n"
+              << "import time\n"
               << "import mathutils\n"
+              << "def _now():\n"
+              << "    return time.clock_gettime(time.CLOCK_MONOTONIC)\n"
+              << "def _rchar():\n"
+              << "    try:\n"
+              << "        with open('/proc/self/io') as f:\n"
+              << "            for line in f:\n"
+              << "                if line.startswith('rchar:'):\n"
+              << "                    return int(line.split()[1])\n"
+              << "    except Exception:\n"
+              << "        pass\n"
+              << "    return -1\n"
+              << "def _datablocks():\n"
+              << "    names = ('objects', 'meshes', 'materials', 'images', 'textures', 'collections', 'node_groups', 'actions', 'armatures', 'cameras', 'lights', 'curves')\n"
+              << "    return sum(len(getattr(bpy.data, n)) for n in names if hasattr(bpy.data, n))\n"
+              << "def _stage(name, start):\n"
+              << "    print('TELEMETRY:%s_ms=%.3f' % (name, (_now() - start) * 1000.0))\n"
+              << "print('TELEMETRY:start=%.6f' % _now())\n"
+              << "_scene = " << (scene_path.empty() ? std::string("None") : pythonStringLiteral(scene_path)) << "\n"
+              << "if _scene and os.path.exists(_scene):\n"
+              << "    bpy.ops.wm.open_mainfile(filepath=_scene)\n"
+              << "_blocks_before = _datablocks()\n"
+              << "imported = []\n"
               << "try:\n"
               << "    asset_path = sys.argv[-1]\n"
+              << "    _rchar_before = _rchar()\n"
+              << "    _t = _now()\n"
               << "    with bpy.data.libraries.load(asset_path, link=" << (options.link_instead_of_import ? "True" : "False") << ") as (data_from, data_to):\n"
               << "        if data_from.collections:\n"
               << "            data_to.collections = [data_from.collections[0]]\n"
               << "        elif data_from.objects:\n"
               << "            data_to.objects = [data_from.objects[0]]\n"
-              << "    imported = []\n"
+              << "    _stage('library_load', _t)\n"
+              << "    _rchar_after = _rchar()\n"
+              << "    if _rchar_before >= 0 and _rchar_after >= 0:\n"
+              << "        print('TELEMETRY:bytes_read=%d' % (_rchar_after - _rchar_before))\n"
+              << "    # Point this asset's images at their substitutes before anything reads the pixels\n"
+              << "    _subs = {" << substitutions.str() << "}\n"
+              << "    if _subs:\n"
+              << "        for img in bpy.data.images:\n"
+              << "            if img.source != 'FILE' or not img.filepath:\n"
+              << "                continue\n"
+              << "            _p = os.path.abspath(bpy.path.abspath(img.filepath, library=img.library))\n"
+              << "            _dst = _subs.get(_p)\n"
+              << "            if _dst:\n"
+              << "                try:\n"
+              << "                    img.filepath = _dst\n"
+              << "                    print('SUBSTITUTED:' + _p)\n"
+              << "                except Exception as e:\n"
+              << "                    print('SUBSTITUTE_FAILED:' + _p + ': ' + str(e))\n"
+              << "    _t = _now()\n"
               << "    for c in data_to.collections:\n"
               << "        bpy.context.scene.collection.children.link(c)\n"
               << "        for obj in c.objects:\n"
@@ -97,7 +214,66 @@ ImportResult ImportManager::importAsset(const std::string& asset_path, const Imp
               << "    for obj in data_to.objects:\n"
               << "        bpy.context.scene.collection.objects.link(obj)\n"
               << "        imported.append(obj)\n"
+              << "    _stage('link', _t)\n"
+              << "    # Atlas: point the UVs at the asset's atlas rectangle and share the page material\n"
+              << "    _atlas = " << atlas.str() << "\n"
+              << "    if _atlas:\n"
+              << "        _mat = bpy.data.materials.get(_atlas['material'])\n"
+              << "        if _mat is None:\n"
+              << "            _mat = bpy.data.materials.new(_atlas['material'])\n"
+              << "            _mat.use_nodes = True\n"
+              << "            _nodes = _mat.node_tree.nodes\n"
+              << "            _links = _mat.node_tree.links\n"
+              << "            _bsdf = _nodes.get('Principled BSDF')\n"
+              << "            def _atlas_image(key, non_color):\n"
+              << "                node = _nodes.new('ShaderNodeTexImage')\n"
+              << "                node.image = bpy.data.images.load(_atlas[key], check_existing=True)\n"
+              << "                if non_color:\n"
+              << "                    node.image.colorspace_settings.name = 'Non-Color'\n"
+              << "                return node\n"
+              << "            if _atlas.get('base_color'):\n"
+              << "                _n = _atlas_image('base_color', False)\n"
+              << "                _links.new(_n.outputs['Color'], _bsdf.inputs['Base Color'])\n"
+              << "                _links.new(_n.outputs['Alpha'], _bsdf.inputs['Alpha'])\n"
+              << "            if _atlas.get('normal'):\n"
+              << "                _n = _atlas_image('normal', True)\n"
+              << "                _m = _nodes.new('ShaderNodeNormalMap')\n"
+              << "                _links.new(_n.outputs['Color'], _m.inputs['Color'])\n"
+              << "                _links.new(_m.outputs['Normal'], _bsdf.inputs['Normal'])\n"
+              << "            if _atlas.get('orm'):\n"
+              << "                _n = _atlas_image('orm', True)\n"
+              << "                try:\n"
+              << "                    _sep = _nodes.new('ShaderNodeSeparateColor')\n"
+              << "                except RuntimeError:\n"
+              << "                    _sep = _nodes.new('ShaderNodeSeparateRGB')\n"
+              << "                _links.new(_n.outputs['Color'], _sep.inputs[0])\n"
+              << "                _links.new(_sep.outputs[1], _bsdf.inputs['Roughness'])\n"
+              << "                _links.new(_sep.outputs[2], _bsdf.inputs['Metallic'])\n"
+              << "        _su, _sv = _atlas['scale']\n"
+              << "        _ou, _ov = _atlas['offset']\n"
+              << "        _remapped = {}\n"
+              << "        for obj in imported:\n"
+              << "            if obj.type != 'MESH' or obj.data.library is not None:\n"
+              << "                continue\n"
+              << "            _mesh = obj.data\n"
+              << "            if _mesh.name not in _remapped:\n"
+              << "                _remapped[_mesh.name] = False\n"
+              << "                # Only the render UV layer samples the page. Tiling UVs would wrap into neighbouring\n"
+              << "                # rectangles and several slots cannot collapse into one material, so those keep their own\n"
+              << "                _layer = next((l for l in _mesh.uv_layers if l.active_render), _mesh.uv_layers.active)\n"
+              << "                if _layer is not None and len(_mesh.materials) <= 1 and len(obj.material_slots) <= 1:\n"
+              << "                    _uv = [0.0] * (len(_layer.data) * 2)\n"
+              << "                    _layer.data.foreach_get('uv', _uv)\n"
+              << "                    if all(-1e-5 <= c <= 1.0 + 1e-5 for c in _uv):\n"
+              << "                        _uv[0::2] = [u * _su + _ou for u in _uv[0::2]]\n"
+              << "                        _uv[1::2] = [v * _sv + _ov for v in _uv[1::2]]\n"
+              << "                        _layer.data.foreach_set('uv', _uv)\n"
+              << "                        _mesh.materials.clear()\n"
+              << "                        _mesh.materials.append(_mat)\n"
+              << "                        _remapped[_mesh.name] = True\n"
+              << "            print(('ATLAS_REMAPPED:' if _remapped[_mesh.name] else 'ATLAS_SKIPPED:') + obj.name)\n"
               << "    # Apply transform and options\n"
+              << "    _t = _now()\n"
               << "    for obj in imported:\n"
               << "        obj.location = mathutils.Vector([" << tuple3_to_str(options.location) << "])\n"
               << "        obj.rotation_euler = mathutils.Vector([" << tuple3_to_str(options.rotation) << "])\n"
@@ -109,6 +285,8 @@ ImportResult ImportManager::importAsset(const std::string& asset_path, const Imp
               << "            bpy.ops.object.select_all(action='DESELECT')\n"
               << "            obj.select_set(True)\n"
               << "            bpy.context.view_layer.objects.active = obj\n"
+              << "    _stage('transform', _t)\n"
+              << "    _t = _now()\n"
               << "    if " << (options.merge_objects ? "True" : "False") << ":\n"
               << "        bpy.ops.object.join()\n"
               << "    if '" << options.collection_name << "':\n"
@@ -117,31 +295,60 @@ ImportResult ImportManager::importAsset(const std::string& asset_path, const Imp
               << "            bpy.context.scene.collection.children.link(new_coll)\n"
               << "        for obj in imported:\n"
               << "            bpy.data.collections['" << options.collection_name << "'].objects.link(obj)\n"
+              << "    _stage('join', _t)\n"
+              << "    if _scene:\n"
+              << "        bpy.ops.wm.save_as_mainfile(filepath=_scene)\n"
               << "    print('IMPORTED:' if not " << (options.link_instead_of_import ? "True" : "False") << " else 'LINKED:', [o.name for o in imported])\n"
               << "    print('SUCCESS')\n"
               << "except Exception as e:\n"
-              << "    print('ERROR:', str(e))\n";
+              << "    print('ERROR:', str(e))\n"
+              << "finally:\n"
+              << "    print('TELEMETRY:objects_created=%d' % len(imported))\n"
+              << "    print('TELEMETRY:datablocks_created=%d' % max(0, _datablocks() - _blocks_before))\n"
+              << "    try:\n"
+              << "        import resource\n"
+              << "        print('TELEMETRY:peak_worker_rss_kb=%d' % resource.getrusage(resource.RUSAGE_SELF).ru_maxrss)\n"
+              << "    except Exception:\n"
+              << "        pass\n";
     // Write script to temp file
     char tmp_py_name[L_tmpnam];
     std::tmpnam(tmp_py_name);
     std::ofstream py_file(tmp_py_name);
     py_file << py_script.str();
     py_file.close();
-    std::string cmd = "blender --background --factory-startup --python " + std::string(tmp_py_name) + " -- " + asset_path + " 2>&1";
+    std::string cmd = "blender --background --factory-startup --python " + std::string(tmp_py_name) + " -- " + import_path + " 2>&1";
     std::array<char, 256> buffer;
     std::string output;
+    // Imports into the same scene run one at a time so every save includes the previous one's objects
+    std::shared_ptr<std::mutex> scene_lock = scene_path.empty() ? nullptr : sceneLock(scene_path);
+    std::unique_lock<std::mutex> scene_guard;
+    if (scene_lock) {
+        scene_guard = std::unique_lock<std::mutex>(*scene_lock);
+    }
+    const double spawn_start = monotonicSeconds();
     std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
     if (!pipe) {
         result.message = "Failed to launch Blender for import/link.";
+        telemetry.total_ms = (monotonicSeconds() - call_start) * 1000.0;
+        telemetry.writeTo(result.metadata);
         return result;
     }
     while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
         output += buffer.data();
     }
+    pipe.reset();
+    if (scene_guard.owns_lock()) {
+        scene_guard.unlock();
+    }
     std::remove(tmp_py_name);
+
+    const double parse_start = monotonicSeconds();
+    // A missing start marker means Blender never ran the script (not installed, crashed on startup)
+    const bool worker_started = parseTelemetry(output, spawn_start, telemetry);
     if (output.find("SUCCESS") != std::string::npos) {
         result.success = true;
         result.message = options.link_instead_of_import ? "Asset linked successfully." : "Asset imported successfully.";
+        result.scene_file = scene_path;
         // Parse imported/linked object names
         size_t pos = output.find(options.link_instead_of_import ? "LINKED:" : "IMPORTED:");
         if (pos != std::string::npos) {
@@ -161,6 +368,44 @@ ImportResult ImportManager::importAsset(const std::string& asset_path, const Imp
     } else {
         result.message = output;
     }
+    if (planned != options.texture_substitutions.end()) {
+        // Images Blender actually pointed at a substitute (a planned texture may not be in this asset)
+        std::vector<std::string> substituted;
+        std::istringstream lines(output);
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (line.rfind("SUBSTITUTED:", 0) == 0) {
+                substituted.push_back(line.substr(12));
+            }
+        }
+        result.metadata["substituted_textures"] = substituted;
+    }
+    if (remap != options.atlas_remaps.end()) {
+        // Linked (read-only) meshes keep their own UVs and materials; skipped ones tile or use several slots
+        std::vector<std::string> remapped;
+        std::vector<std::string> skipped;
+        std::istringstream lines(output);
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (line.rfind("ATLAS_REMAPPED:", 0) == 0) {
+                remapped.push_back(line.substr(15));
+            } else if (line.rfind("ATLAS_SKIPPED:", 0) == 0) {
+                skipped.push_back(line.substr(14));
+            }
+        }
+        result.metadata["atlas_remapped_objects"] = remapped;
+        result.metadata["atlas_skipped_objects"] = skipped;
+    }
+    if (result.success && hot_cache_) {
+        hot_cache_->recordImport(asset_path);
+    }
+    const double finished = monotonicSeconds();
+    telemetry.parse_ms = (finished - parse_start) * 1000.0;
+    telemetry.total_ms = (finished - call_start) * 1000.0;
+    telemetry.writeTo(result.metadata);
+    if (worker_started) {
+        telemetry_->record(telemetry);
+    }
     return result;
 }
 
@@ -186,6 +431,11 @@ std::vector<ImportResult> ImportManager::importAssetsGrid(const std::vector<std:
         cols = 1;
     }
 
+    // Queue readahead for the whole batch so later assets warm while earlier ones import
+    if (prefetcher_) {
+        prefetcher_->enqueue(asset_paths);
+    }
+
     // Calculate grid positions
     int asset_index = 0;
     for (int row = 0; row < rows && asset_index < static_cast<int>(asset_paths.size()); ++row) {
@@ -200,7 +450,7 @@ std::vector<ImportResult> ImportManager::importAssetsGrid(const std::vector<std:
             grid_options.location = {x, y, z};
 
             // Import asset at grid position
-            ImportResult result = importAsset(asset_paths[asset_index], grid_options);
+            ImportResult result = importSingle(asset_paths[asset_index], grid_options, false);
             results.push_back(result);
 
             ++asset_index;
@@ -230,6 +480,11 @@ std::vector<ImportResult> ImportManager::importAssetsCircle(const std::vector<st
         radius = 10.0f; // Default radius
     }
 
+    // Queue readahead for the whole batch so later assets warm while earlier ones import
+    if (prefetcher_) {
+        prefetcher_->enqueue(asset_paths);
+    }
+
     // Calculate circle positions
     const float angle_step = 2.0f * M_PI / static_cast<float>(asset_paths.size());
     
@@ -245,7 +500,7 @@ std::vector<ImportResult> ImportManager::importAssetsCircle(const std::vector<st
         circle_options.location = {x, y, z};
 
         // Import asset at circle position
-        ImportResult result = importAsset(asset_paths[i], circle_options);
+        ImportResult result = importSingle(asset_paths[i], circle_options, false);
         results.push_back(result);
     }
 
@@ -272,6 +527,11 @@ std::vector<ImportResult> ImportManager::importAssetsLine(const std::vector<std:
         spacing = 5.0f; // Default spacing
     }
 
+    // Queue readahead for the whole batch so later assets warm while earlier ones import
+    if (prefetcher_) {
+        prefetcher_->enqueue(asset_paths);
+    }
+
     // Calculate line positions
     for (size_t i = 0; i < asset_paths.size(); ++i) {
         // Calculate position along line
@@ -284,7 +544,7 @@ std::vector<ImportResult> ImportManager::importAssetsLine(const std::vector<std:
         line_options.location = {x, y, z};
 
         // Import asset at line position
-        ImportResult result = importAsset(asset_paths[i], line_options);
+        ImportResult result = importSingle(asset_paths[i], line_options, false);
         results.push_back(result);
     }
 
@@ -317,6 +577,11 @@ std::vector<ImportResult> ImportManager::importAssetsRandom(const std::vector<st
     // Limit count to available assets
     count = std::min(count, static_cast<int>(asset_paths.size()));
 
+    // Queue readahead for the assets that will actually be placed
+    if (prefetcher_) {
+        prefetcher_->enqueue(std::vector<std::string>(asset_paths.begin(), asset_paths.begin() + count));
+    }
+
     // Initialize random number generator
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -334,13 +599,101 @@ std::vector<ImportResult> ImportManager::importAssetsRandom(const std::vector<st
         random_options.location = {x, y, z};
 
         // Import asset at random position
-        ImportResult result = importAsset(asset_paths[i], random_options);
+        ImportResult result = importSingle(asset_paths[i], random_options, false);
         results.push_back(result);
     }
 
     return results;
 }
 
+std::shared_ptr<ImportTelemetryRegistry> ImportManager::getTelemetryRegistry() const {
+    return telemetry_;
+}
+
+TelemetrySummary ImportManager::getTelemetrySummary(const std::string& asset_type, const std::string& metric) const {
+    /**
+     * @brief Rolling summary of one telemetry metric (e.g. "library_load_ms") for an asset type.
+     *
+     * @param asset_type Lower-case extension without the dot, e.g. "blend".
+     * @param metric Metric name from ImportTelemetry::metrics().
+     * @return TelemetrySummary; count is 0 when no import of that type has run.
+     */
+    return telemetry_->getSummary(asset_type, metric);
+}
+
+std::shared_ptr<std::mutex> ImportManager::sceneLock(const std::string& scene_path) {
+    /**
+     * @brief Returns the lock serialising imports into one scene file, creating it on first use.
+     *
+     * @param scene_path Absolute, normalised scene path.
+     * @return Lock shared by every import targeting that scene.
+     */
+    std::lock_guard<std::mutex> lock(scene_locks_mutex_);
+    auto& scene_lock = scene_locks_[scene_path];
+    if (!scene_lock) {
+        scene_lock = std::make_shared<std::mutex>();
+    }
+    return scene_lock;
+}
+
+double ImportManager::monotonicSeconds() {
+    // CLOCK_MONOTONIC is shared with the worker's time.clock_gettime(), so the
+    // worker's start marker can be compared directly against our spawn time.
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+std::string ImportManager::assetTypeFor(const std::string& asset_path) const {
+    std::string ext = std::filesystem::path(asset_path).extension().string();
+    if (!ext.empty() && ext[0] == '.') ext.erase(0, 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext.empty() ? "unknown" : ext;
+}
+
+bool ImportManager::parseTelemetry(const std::string& output, double spawn_start, ImportTelemetry& telemetry) const {
+    /*
+     * Parses TELEMETRY:key=value lines emitted by the import script; returns whether "start" was seen.
+     * - "start" is the worker's CLOCK_MONOTONIC timestamp when the script began executing
+     * - bytes_read is only reported when the worker could read /proc/self/io
+     * - *_ms values are stage durations measured inside the worker
+     * - Counters and RSS are integers; malformed lines are ignored
+     */
+    static const std::string marker = "TELEMETRY:";
+    bool started = false;
+    size_t pos = 0;
+    while ((pos = output.find(marker, pos)) != std::string::npos) {
+        size_t line_end = output.find('\n', pos);
+        std::string line = output.substr(pos + marker.size(),
+            (line_end == std::string::npos ? output.size() : line_end) - pos - marker.size());
+        pos = line_end == std::string::npos ? output.size() : line_end;
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+        try {
+            if (key == "start") {
+                telemetry.spawn_ms = std::max(0.0, (std::stod(value) - spawn_start) * 1000.0);
+                started = true;
+            }
+            else if (key == "library_load_ms") telemetry.library_load_ms = std::stod(value);
+            else if (key == "link_ms") telemetry.link_ms = std::stod(value);
+            else if (key == "transform_ms") telemetry.transform_ms = std::stod(value);
+            else if (key == "join_ms") telemetry.join_ms = std::stod(value);
+            else if (key == "bytes_read") {
+                telemetry.bytes_read = std::stoull(value);
+                telemetry.bytes_read_measured = true;
+            }
+            else if (key == "objects_created") telemetry.objects_created = std::stoul(value);
+            else if (key == "datablocks_created") telemetry.datablocks_created = std::stoul(value);
+            else if (key == "peak_worker_rss_kb") telemetry.peak_worker_rss_kb = std::stol(value);
+        } catch (const std::exception&) {
+            // Ignore truncated or non-numeric values
+        }
+    }
+    return started;
+}
+
 bool ImportManager::canLinkAsset(const std::string& asset_path) const {
     /*
      * Full implementation: Checks if the asset is a valid .blend file with linkable data blocks.
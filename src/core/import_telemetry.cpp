@@ -0,0 +1,223 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: import_telemetry.cpp
+ * Description: Implementation of import telemetry flattening and rolling per-asset-type histograms.
+ *              Used by ImportManager to attach stage timings to ImportResult and to answer
+ *              "where did the time go" queries across many imports of the same asset type.
+ *
+ * Architecture:
+ * - Log2 buckets shared by every metric (1 .. 2^40, then overflow)
+ * - Rolling window evicts the oldest sample in O(1) and keeps bucket counts in sync
+ * - Percentiles computed from a sorted copy of the window on demand
+ *
+ * Key Features:
+ * - O(1) record path, no allocation once the window is warm
+ * - Exact rolling percentiles for the last N imports
+ * - Thread-safe registry for concurrent import tasks
+ */
+
+#include "import_telemetry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace AssetManager {
+
+void ImportTelemetry::writeTo(std::map<std::string, std::any>& metadata) const {
+    /**
+     * @brief Stores the telemetry both as a whole struct and as flat numeric keys.
+     *
+     * @param metadata ImportResult metadata map to populate.
+     */
+    metadata["telemetry"] = *this;
+    for (const auto& [name, value] : metrics()) {
+        metadata["telemetry." + name] = value;
+    }
+    metadata["telemetry.asset_type"] = asset_type;
+}
+
+std::map<std::string, double> ImportTelemetry::metrics() const {
+    /**
+     * @brief Returns every numeric telemetry field keyed by its metric name.
+     *        bytes_read is left out when it was not measured rather than reported as zero.
+     *
+     * @return Map of metric name to value.
+     */
+    std::map<std::string, double> values = {
+        {"spawn_ms", spawn_ms},
+        {"library_load_ms", library_load_ms},
+        {"link_ms", link_ms},
+        {"transform_ms", transform_ms},
+        {"join_ms", join_ms},
+        {"parse_ms", parse_ms},
+        {"total_ms", total_ms},
+        {"objects_created", static_cast<double>(objects_created)},
+        {"datablocks_created", static_cast<double>(datablocks_created)},
+        {"peak_worker_rss_kb", static_cast<double>(peak_worker_rss_kb)}
+    };
+    if (bytes_read_measured) {
+        values["bytes_read"] = static_cast<double>(bytes_read);
+    }
+    return values;
+}
+
+RollingHistogram::RollingHistogram(size_t window_size)
+    : window_size_(window_size == 0 ? 1 : window_size),
+      bucket_counts_(bucketBounds().size(), 0) {
+}
+
+const std::vector<double>& RollingHistogram::bucketBounds() {
+    /**
+     * @brief Exclusive upper bounds of the shared log2 buckets; the last bucket is unbounded.
+     *
+     * @return Reference to the static bound table.
+     */
+    static const std::vector<double> bounds = [] {
+        std::vector<double> b;
+        for (int i = 0; i <= 40; ++i) {
+            b.push_back(std::ldexp(1.0, i));
+        }
+        b.push_back(std::numeric_limits<double>::infinity());
+        return b;
+    }();
+    return bounds;
+}
+
+size_t RollingHistogram::bucketFor(double value) {
+    const auto& bounds = bucketBounds();
+    auto it = std::upper_bound(bounds.begin(), bounds.end(), value);
+    if (it == bounds.end()) {
+        return bounds.size() - 1;
+    }
+    return static_cast<size_t>(it - bounds.begin());
+}
+
+void RollingHistogram::add(double value) {
+    /**
+     * @brief Adds a sample, evicting the oldest one once the window is full.
+     *
+     * @param value Sample value (NaN is ignored).
+     */
+    if (std::isnan(value)) {
+        return;
+    }
+    if (window_.size() == window_size_) {
+        --bucket_counts_[bucketFor(window_.front())];
+        window_.pop_front();
+    }
+    window_.push_back(value);
+    ++bucket_counts_[bucketFor(value)];
+}
+
+size_t RollingHistogram::size() const {
+    return window_.size();
+}
+
+TelemetrySummary RollingHistogram::summarize() const {
+    /**
+     * @brief Computes count, mean, extrema and nearest-rank percentiles over the window.
+     *
+     * @return TelemetrySummary without asset_type/metric filled in.
+     */
+    TelemetrySummary summary;
+    summary.bucket_upper_bounds = bucketBounds();
+    summary.bucket_counts = bucket_counts_;
+    summary.count = window_.size();
+    if (window_.empty()) {
+        return summary;
+    }
+
+    std::vector<double> sorted(window_.begin(), window_.end());
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double v : sorted) {
+        sum += v;
+    }
+    auto percentile = [&sorted](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+        return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+    };
+    summary.mean = sum / static_cast<double>(sorted.size());
+    summary.min = sorted.front();
+    summary.max = sorted.back();
+    summary.p50 = percentile(0.50);
+    summary.p90 = percentile(0.90);
+    summary.p99 = percentile(0.99);
+    return summary;
+}
+
+ImportTelemetryRegistry::ImportTelemetryRegistry(size_t window_size) : window_size_(window_size) {
+}
+
+void ImportTelemetryRegistry::record(const ImportTelemetry& telemetry) {
+    /**
+     * @brief Adds every metric of an import to the histograms of its asset type.
+     *
+     * @param telemetry Telemetry captured for a single import.
+     */
+    const std::string type = telemetry.asset_type.empty() ? "unknown" : telemetry.asset_type;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& per_type = histograms_[type];
+    for (const auto& [name, value] : telemetry.metrics()) {
+        auto it = per_type.find(name);
+        if (it == per_type.end()) {
+            it = per_type.emplace(name, RollingHistogram(window_size_)).first;
+        }
+        it->second.add(value);
+    }
+}
+
+TelemetrySummary ImportTelemetryRegistry::getSummary(const std::string& asset_type, const std::string& metric) const {
+    /**
+     * @brief Returns the rolling summary of one metric for one asset type.
+     *
+     * @param asset_type Lower-case extension, e.g. "blend".
+     * @param metric Metric name as produced by ImportTelemetry::metrics().
+     * @return Summary with count == 0 when nothing has been recorded.
+     */
+    std::lock_guard<std::mutex> lock(mutex_);
+    TelemetrySummary summary;
+    auto type_it = histograms_.find(asset_type);
+    if (type_it != histograms_.end()) {
+        auto metric_it = type_it->second.find(metric);
+        if (metric_it != type_it->second.end()) {
+            summary = metric_it->second.summarize();
+        }
+    }
+    summary.asset_type = asset_type;
+    summary.metric = metric;
+    return summary;
+}
+
+std::vector<TelemetrySummary> ImportTelemetryRegistry::getSummaries(const std::string& asset_type) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<TelemetrySummary> summaries;
+    auto type_it = histograms_.find(asset_type);
+    if (type_it == histograms_.end()) {
+        return summaries;
+    }
+    for (const auto& [metric, histogram] : type_it->second) {
+        TelemetrySummary summary = histogram.summarize();
+        summary.asset_type = asset_type;
+        summary.metric = metric;
+        summaries.push_back(std::move(summary));
+    }
+    return summaries;
+}
+
+std::vector<std::string> ImportTelemetryRegistry::getAssetTypes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> types;
+    for (const auto& [type, _] : histograms_) {
+        types.push_back(type);
+    }
+    return types;
+}
+
+void ImportTelemetryRegistry::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    histograms_.clear();
+}
+
+} // namespace AssetManager
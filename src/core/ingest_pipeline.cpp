@@ -0,0 +1,354 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: ingest_pipeline.cpp
+ * Description: Implementation of the IngestPipeline job-graph executor.
+ *              Each stage owns a pool of worker threads that pop job indices from its input queue,
+ *              run the stage function, and push the index into the next stage's queue.
+ *
+ * Architecture:
+ * - Job state lives in a pre-sized vector; queues only carry indices
+ * - The last worker of a stage to finish closes the next stage's queue
+ * - Blocking push into a full queue is the backpressure signal and is timed per stage
+ * - Exceptions thrown by stage functions fail the job instead of tearing down the graph
+ *
+ * Key Features:
+ * - validate → prefetch → convert → import → materials → history with configurable parallelism
+ * - Failed imports are still recorded by the history stage
+ * - Per-stage metrics available after every run
+ */
+
+#include "ingest_pipeline.hpp"
+#include <thread>
+#include <atomic>
+#include <iostream>
+#include <sstream>
+
+namespace AssetManager {
+
+IngestPipeline::IngestPipeline()
+    : validator_(std::make_shared<AssetValidator>()),
+      import_manager_(std::make_shared<ImportManager>()),
+      material_manager_(nullptr),
+      import_history_(nullptr),
+      prefetcher_(std::make_shared<DependencyPrefetcher>()) {
+    for (IngestStage stage : stageOrder()) {
+        stage_configs_[stage] = StageConfig{};
+    }
+}
+
+IngestPipeline::~IngestPipeline() = default;
+
+void IngestPipeline::setValidator(std::shared_ptr<AssetValidator> validator) {
+    validator_ = validator;
+}
+
+void IngestPipeline::setImportManager(std::shared_ptr<ImportManager> import_manager) {
+    import_manager_ = import_manager;
+}
+
+void IngestPipeline::setMaterialManager(std::shared_ptr<MaterialManager> material_manager) {
+    material_manager_ = material_manager;
+}
+
+void IngestPipeline::setImportHistory(std::shared_ptr<ImportHistory> import_history) {
+    import_history_ = import_history;
+}
+
+void IngestPipeline::setPrefetcher(std::shared_ptr<DependencyPrefetcher> prefetcher) {
+    prefetcher_ = prefetcher;
+}
+
+void IngestPipeline::setStageFunction(IngestStage stage, StageFunction function) {
+    stage_functions_[stage] = std::move(function);
+}
+
+void IngestPipeline::setStageConfig(IngestStage stage, const StageConfig& config) {
+    StageConfig sanitized = config;
+    if (sanitized.concurrency == 0) sanitized.concurrency = 1;
+    if (sanitized.queue_capacity == 0) sanitized.queue_capacity = 1;
+    stage_configs_[stage] = sanitized;
+}
+
+StageConfig IngestPipeline::getStageConfig(IngestStage stage) const {
+    auto it = stage_configs_.find(stage);
+    return it != stage_configs_.end() ? it->second : StageConfig{};
+}
+
+std::string IngestPipeline::stageName(IngestStage stage) {
+    switch (stage) {
+        case IngestStage::Validate:  return "validate";
+        case IngestStage::Prefetch:  return "prefetch";
+        case IngestStage::Convert:   return "convert";
+        case IngestStage::Import:    return "import";
+        case IngestStage::Materials: return "materials";
+        case IngestStage::History:   return "history";
+    }
+    return "unknown";
+}
+
+std::vector<IngestStage> IngestPipeline::stageOrder() {
+    return {IngestStage::Validate, IngestStage::Prefetch, IngestStage::Convert, IngestStage::Import,
+            IngestStage::Materials, IngestStage::History};
+}
+
+std::vector<StageMetrics> IngestPipeline::getStageMetrics() const {
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    return last_metrics_;
+}
+
+IngestPipeline::StageFunction IngestPipeline::resolveStageFunction(IngestStage stage) {
+    auto it = stage_functions_.find(stage);
+    if (it != stage_functions_.end() && it->second) {
+        return it->second;
+    }
+    switch (stage) {
+        case IngestStage::Validate:  return [this](IngestJob& job) { return validateStage(job); };
+        case IngestStage::Prefetch:  return [this](IngestJob& job) { return prefetchStage(job); };
+        case IngestStage::Convert:   return [this](IngestJob& job) { return convertStage(job); };
+        case IngestStage::Import:    return [this](IngestJob& job) { return importStage(job); };
+        case IngestStage::Materials: return [this](IngestJob& job) { return materialsStage(job); };
+        case IngestStage::History:   return [this](IngestJob& job) { return historyStage(job); };
+    }
+    return [](IngestJob&) { return true; };
+}
+
+std::vector<IngestJob> IngestPipeline::run(const std::vector<std::string>& asset_paths, const ImportOptions& options) {
+    /**
+     * @brief Pushes a batch through every stage and waits for the graph to drain.
+     *
+     * @param asset_paths Assets to ingest, in the order results should be returned.
+     * @param options ImportOptions applied to every asset.
+     * @return One IngestJob per input path, in input order.
+     */
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<IngestJob> jobs(asset_paths.size());
+    for (size_t i = 0; i < asset_paths.size(); ++i) {
+        jobs[i].sequence = i;
+        jobs[i].asset_path = asset_paths[i];
+        jobs[i].converted_path = asset_paths[i];
+        jobs[i].options = options;
+    }
+
+    const std::vector<IngestStage> stages = stageOrder();
+    const size_t stage_count = stages.size();
+
+    struct StageState {
+        IngestStage stage;
+        StageConfig config;
+        StageFunction function;
+        std::unique_ptr<BoundedQueue<size_t>> input;
+        std::atomic<size_t> active_workers{0};
+        std::mutex stats_mutex;
+        StageMetrics metrics;
+        bool started = false;
+        Clock::time_point first_start;
+        Clock::time_point last_finish;
+    };
+
+    std::vector<std::unique_ptr<StageState>> states;
+    for (IngestStage stage : stages) {
+        auto state = std::make_unique<StageState>();
+        state->stage = stage;
+        state->config = getStageConfig(stage);
+        state->function = resolveStageFunction(stage);
+        state->input = std::make_unique<BoundedQueue<size_t>>(state->config.queue_capacity);
+        state->active_workers = state->config.concurrency;
+        state->metrics.name = stageName(stage);
+        state->metrics.concurrency = state->config.concurrency;
+        states.push_back(std::move(state));
+    }
+
+    auto worker = [&](size_t stage_index) {
+        StageState& state = *states[stage_index];
+        StageState* next = stage_index + 1 < stage_count ? states[stage_index + 1].get() : nullptr;
+        size_t index = 0;
+        while (state.input->pop(index)) {
+            IngestJob& job = jobs[index];
+            // History still records imports that were attempted but failed
+            bool skip = job.failed &&
+                !(state.stage == IngestStage::History && job.failed_stage == stageName(IngestStage::Import));
+            Clock::time_point start = Clock::now();
+            bool ok = true;
+            if (!skip) {
+                try {
+                    ok = state.function(job);
+                } catch (const std::exception& e) {
+                    ok = false;
+                    job.message = std::string("Stage threw: ") + e.what();
+                }
+                if (!ok && !job.failed) {
+                    job.failed = true;
+                    job.failed_stage = state.metrics.name;
+                }
+            }
+            Clock::time_point finish = Clock::now();
+            double backpressure = next ? next->input->push(index) : 0.0;
+
+            std::lock_guard<std::mutex> lock(state.stats_mutex);
+            if (skip) {
+                ++state.metrics.skipped;
+            } else {
+                ++state.metrics.processed;
+                if (!ok) ++state.metrics.failed;
+                state.metrics.busy_seconds += std::chrono::duration<double>(finish - start).count();
+                if (!state.started || start < state.first_start) state.first_start = start;
+                if (!state.started || finish > state.last_finish) state.last_finish = finish;
+                state.started = true;
+            }
+            state.metrics.backpressure_seconds += backpressure;
+        }
+        if (--state.active_workers == 0 && next) {
+            next->input->close();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t s = 0; s < stage_count; ++s) {
+        for (size_t w = 0; w < states[s]->config.concurrency; ++w) {
+            threads.emplace_back(worker, s);
+        }
+    }
+
+    // The caller feeds the first queue and is throttled by it like any other producer
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        states.front()->input->push(i);
+    }
+    states.front()->input->close();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<StageMetrics> metrics;
+    for (auto& state : states) {
+        StageMetrics m = state->metrics;
+        m.queue_high_water = state->input->highWater();
+        if (state->started) {
+            m.elapsed_seconds = std::chrono::duration<double>(state->last_finish - state->first_start).count();
+        }
+        m.throughput_per_second = m.elapsed_seconds > 0.0 ? static_cast<double>(m.processed) / m.elapsed_seconds : 0.0;
+        metrics.push_back(m);
+    }
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        last_metrics_ = std::move(metrics);
+    }
+    return jobs;
+}
+
+bool IngestPipeline::validateStage(IngestJob& job) {
+    /*
+     * Default validate stage.
+     * - Runs AssetValidator::validateAsset on the source path; the validator is thread-safe,
+     *   so every worker of the stage validates concurrently
+     * - Rejects the job when the validator reports errors
+     */
+    if (!validator_) {
+        return true;
+    }
+    job.validation = validator_->validateAsset(job.asset_path);
+    if (!job.validation.is_valid) {
+        std::ostringstream oss;
+        oss << "Validation failed with " << job.validation.error_count << " error(s)";
+        for (const auto& issue : job.validation.issues) {
+            if (issue.severity == ValidationSeverity::ERROR || issue.severity == ValidationSeverity::CRITICAL) {
+                oss << ": " << issue.description;
+                break;
+            }
+        }
+        job.message = oss.str();
+        return false;
+    }
+    return true;
+}
+
+bool IngestPipeline::prefetchStage(IngestJob& job) {
+    /*
+     * Default prefetch stage.
+     * - Queues readahead for the asset's dependency closure and returns immediately
+     * - The reads complete on the prefetcher's bounded pool while the job waits for the importer
+     */
+    if (prefetcher_) {
+        prefetcher_->enqueue(job.asset_path);
+    }
+    return true;
+}
+
+bool IngestPipeline::convertStage(IngestJob& job) {
+    /*
+     * Default convert stage.
+     * - No format conversion exists yet, so the importer receives the source file unchanged
+     * - Replace via setStageFunction(IngestStage::Convert, ...) to plug in a converter
+     */
+    job.converted_path = job.asset_path;
+    return true;
+}
+
+bool IngestPipeline::importStage(IngestJob& job) {
+    /*
+     * Default import stage.
+     * - Imports converted_path through ImportManager with the batch options
+     * - Keeps the original asset path on the result so history stays keyed by source
+     * - With a pipeline prefetcher the prefetch stage already queued the closure, so the importer does not
+     */
+    if (!import_manager_) {
+        job.message = "No ImportManager configured";
+        return false;
+    }
+    job.import_result = import_manager_->importAsset(job.converted_path, job.options, !prefetcher_);
+    job.import_result.asset_path = job.asset_path;
+    job.message = job.import_result.message;
+    return job.import_result.success;
+}
+
+bool IngestPipeline::materialsStage(IngestJob& job) {
+    /*
+     * Default materials stage.
+     * - Auto-assigns materials when import_materials is set and a MaterialManager is attached
+     * - Missing textures are not fatal; the outcome is kept on job.material_result
+     */
+    if (!material_manager_ || !job.options.import_materials) {
+        return true;
+    }
+    job.material_result = material_manager_->autoAssignMaterials(job.asset_path);
+    return true;
+}
+
+bool IngestPipeline::historyStage(IngestJob& job) {
+    /*
+     * Default history stage.
+     * - Records one ImportHistoryEntry per attempted import (successful or not)
+     * - Serialized because ImportHistory is a single-writer store
+     */
+    if (!import_history_) {
+        return true;
+    }
+    ImportHistoryEntry entry;
+    entry.asset_path = job.asset_path;
+    entry.import_type = job.options.link_instead_of_import ? "link" : "import";
+    entry.timestamp = std::chrono::system_clock::now();
+    entry.imported_objects = job.import_result.imported_objects;
+    entry.success = job.import_result.success;
+    entry.message = job.import_result.message;
+    entry.collection_name = job.options.collection_name;
+    entry.options["merge_objects"] = job.options.merge_objects ? "true" : "false";
+    entry.options["auto_smooth"] = job.options.auto_smooth ? "true" : "false";
+    entry.options["import_materials"] = job.options.import_materials ? "true" : "false";
+    if (job.converted_path != job.asset_path) {
+        entry.metadata["converted_path"] = job.converted_path;
+    }
+    if (!job.import_result.scene_file.empty()) {
+        // Undo reopens this scene to remove the objects
+        entry.metadata["scene_file"] = job.import_result.scene_file;
+    }
+    if (!job.material_result.material_name.empty()) {
+        entry.metadata["material"] = job.material_result.material_name;
+    }
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    import_history_->addEntry(entry);
+    return true;
+}
+
+} // namespace AssetManager
@@ -14,6 +14,7 @@
  * - Texture loading and assignment with automatic format detection
  * - PBR material creation with multiple map support (albedo, normal, roughness, etc.)
  * - Material validation and optimization
+ * - Batch creation: many materials in one Blender session, sharing image datablocks and texture nodes
  * - Thread-safe operations for concurrent material processing
  * 
  * Key Features:
@@ -29,6 +30,7 @@
 
 #include "material_manager.hpp"
 #include "asset_manager.hpp"
+#include "file_probe.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -40,10 +42,20 @@
 #include <array>
 #include <memory>
 #include <stdexcept>
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <climits>
+#include <tuple>
+#include <zlib.h>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
 
 namespace AssetManager {
 
-MaterialManager::MaterialManager() : asset_manager_(nullptr) {
+MaterialManager::MaterialManager()
+    : asset_manager_(nullptr), preview_renderer_(std::make_unique<MaterialPreviewRenderer>()) {
     initializeDefaultPresets();
 }
 
@@ -55,102 +67,20 @@ void MaterialManager::setAssetManager(std::shared_ptr<AssetManager> manager) {
     asset_manager_ = manager;
 }
 
+void MaterialManager::setTextureSetIndex(std::shared_ptr<const TextureSetIndex> texture_sets) {
+    texture_sets_ = std::move(texture_sets);
+}
+
 MaterialResult MaterialManager::createMaterial(const MaterialOptions& options) {
     /*
      * Full implementation: Creates a material with the specified options.
      * - Validates input parameters and texture paths
-     * - Generates Python script for Blender material creation
-     * - Calls Blender in background mode to create the material
+     * - Runs as a batch of one, so the material is instanced from its node-tree template
+     *   (appended from the template library when one is configured)
+     * - An identical material already registered for the scene is returned instead of creating another
      * - Returns detailed MaterialResult with creation status
      */
-    MaterialResult result;
-    result.material_name = options.name;
-    result.success = false;
-    result.message = "";
-
-    // Validate material name
-    if (options.name.empty()) {
-        result.message = "Material name cannot be empty";
-        return result;
-    }
-
-    // Prepare options for Python module
-    std::string options_json = "{";
-    options_json += "\"name\":\"" + options.name + "\",";
-    options_json += "\"use_nodes\":" + std::string(options.use_nodes ? "true" : "false") + ",";
-    options_json += "\"metallic\":" + std::to_string(options.metallic) + ",";
-    options_json += "\"roughness\":" + std::to_string(options.roughness) + ",";
-    options_json += "\"specular\":" + std::to_string(options.specular) + ",";
-    options_json += "\"clearcoat\":" + std::to_string(options.clearcoat) + ",";
-    options_json += "\"clearcoat_roughness\":" + std::to_string(options.clearcoat_roughness) + ",";
-    options_json += "\"ior\":" + std::to_string(options.ior) + ",";
-    options_json += "\"transmission\":" + std::to_string(options.transmission) + ",";
-    options_json += "\"transmission_roughness\":" + std::to_string(options.transmission_roughness) + ",";
-    options_json += "\"emission_strength\":" + std::to_string(options.emission_strength) + ",";
-    options_json += "\"alpha\":" + std::to_string(options.alpha) + ",";
-    options_json += "\"backface_culling\":" + std::string(options.backface_culling ? "true" : "false") + ",";
-    options_json += "\"blend_method\":" + std::string(options.blend_method ? "true" : "false");
-    
-    // Add texture paths if they exist
-    if (!options.albedo_texture.empty()) {
-        options_json += ",\"albedo_texture\":\"" + options.albedo_texture + "\"";
-    }
-    if (!options.normal_texture.empty()) {
-        options_json += ",\"normal_texture\":\"" + options.normal_texture + "\"";
-    }
-    if (!options.roughness_texture.empty()) {
-        options_json += ",\"roughness_texture\":\"" + options.roughness_texture + "\"";
-    }
-    if (!options.metallic_texture.empty()) {
-        options_json += ",\"metallic_texture\":\"" + options.metallic_texture + "\"";
-    }
-    if (!options.ao_texture.empty()) {
-        options_json += ",\"ao_texture\":\"" + options.ao_texture + "\"";
-    }
-    if (!options.emission_texture.empty()) {
-        options_json += ",\"emission_texture\":\"" + options.emission_texture + "\"";
-    }
-    if (!options.displacement_texture.empty()) {
-        options_json += ",\"displacement_texture\":\"" + options.displacement_texture + "\"";
-    }
-    options_json += "}";
-
-    // Execute Python module
-    std::string cmd = "blender --background --factory-startup --python src/python/material_utils.py -- create_material '" + options_json + "' 2>&1";
-    std::array<char, 256> buffer;
-    std::string output;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
-    
-    if (!pipe) {
-        result.message = "Failed to launch Blender for material creation";
-        return result;
-    }
-
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-        output += buffer.data();
-    }
-
-    // No temporary file to clean up (using direct Python module call)
-
-    // Parse output
-    if (output.find("SUCCESS") != std::string::npos) {
-        result.success = true;
-        result.message = "Material created successfully";
-        result.created_materials.push_back(options.name);
-        
-        // Extract texture assignments
-        if (!options.albedo_texture.empty()) result.assigned_textures.push_back(options.albedo_texture);
-        if (!options.normal_texture.empty()) result.assigned_textures.push_back(options.normal_texture);
-        if (!options.roughness_texture.empty()) result.assigned_textures.push_back(options.roughness_texture);
-        if (!options.metallic_texture.empty()) result.assigned_textures.push_back(options.metallic_texture);
-        if (!options.ao_texture.empty()) result.assigned_textures.push_back(options.ao_texture);
-        if (!options.emission_texture.empty()) result.assigned_textures.push_back(options.emission_texture);
-        if (!options.displacement_texture.empty()) result.assigned_textures.push_back(options.displacement_texture);
-    } else {
-        result.message = "Failed to create material: " + output;
-    }
-
-    return result;
+    return createMaterials({MaterialSpec{options, {}}}).front();
 }
 
 MaterialResult MaterialManager::createPBRMaterial(const std::string& name, const MaterialOptions& options) {
@@ -178,6 +108,461 @@ MaterialResult MaterialManager::createQuickMaterial(const std::string& name, con
     return createMaterial(options);
 }
 
+std::vector<MaterialResult> MaterialManager::createMaterials(const std::vector<MaterialSpec>& specs) {
+    /*
+     * Creates a batch of materials in a single Blender session.
+     * - Specs are validated up front; invalid ones fail without being sent to Blender
+     * - The batch is written as one JSON file, so names and paths need no shell quoting
+     * - Blender loads each distinct texture once and shares one texture node group
+     *   between materials with the same texture set
+     * - Each material reports its own result line, so one failure does not fail the batch
+     * - With a scene (setScene) the batch is created in that .blend and saved into it; specs identical to a
+     *   material registered for it are not sent again. Without one the session is discarded, so nothing is
+     *   reused across calls
+     * - Specs identical to an earlier spec of the batch are not sent again
+     * - Texture sharing within the batch is staged; the scene only records the textures and the
+     *   canonical spec of materials Blender reported as created and saved
+     * - Each node-graph shape is compiled into a template once per session and copied per material;
+     *   templates resident in the template library are appended instead of compiled
+     */
+    std::vector<MaterialResult> results(specs.size());
+    json batch = json::array();
+    std::vector<size_t> batch_indices;
+    std::vector<std::pair<uint64_t, bool>> batch_hashes;        // (parameter hash, hashable) per batched spec
+    std::unordered_map<uint64_t, size_t> first_with_hash;       // parameter hash -> spec index
+    std::vector<std::pair<size_t, size_t>> duplicates;          // (spec index, identical earlier spec index)
+    std::set<std::string> batch_names;
+    std::vector<MaterialSpec> batch_specs;                      // canonical spec per batched material
+    json templates = json::object();
+    SceneMaterials staged;
+    std::string scene_file;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        scene_file = scene_key_;
+        staged.textures = scene_materials_[scene_file].textures;
+    }
+
+    for (size_t i = 0; i < specs.size(); ++i) {
+        const MaterialOptions& options = specs[i].options;
+        MaterialResult& result = results[i];
+        result.material_name = options.name;
+        result.success = false;
+
+        if (options.name.empty()) {
+            result.message = "Material name cannot be empty";
+            continue;
+        }
+        std::vector<TextureAssignment> textures = collectTextureAssignments(specs[i]);
+        auto invalid = std::find_if(textures.begin(), textures.end(), [this](const TextureAssignment& texture) {
+            return !validateTexturePath(texture.texture_path);
+        });
+        if (invalid != textures.end()) {
+            result.message = "Invalid texture path: " + invalid->texture_path;
+            continue;
+        }
+
+        MaterialSpec spec;
+        uint64_t material_hash = 0;
+        bool hashable = false;
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            SceneMaterials& scene = scene_materials_[scene_file];
+            std::vector<std::string> shared;
+            spec = shareTextures(specs[i], staged, true, shared);
+            if (!shared.empty()) {
+                result.metadata["shared_textures"] = shared;
+            }
+            hashable = hashMaterial(spec, material_hash);
+            if (!hashable) {
+                ++registry_stats_.unhashable_requests;
+            }
+            auto existing = hashable && !scene_file.empty() ? scene.by_hash.find(material_hash) : scene.by_hash.end();
+            if (existing != scene.by_hash.end()) {
+                ++registry_stats_.materials_reused;
+                result.success = true;
+                result.material_name = existing->second;
+                result.message = "Reused identical material";
+                for (const auto& texture : collectTextureAssignments(spec)) {
+                    result.assigned_textures.push_back(texture.texture_path);
+                }
+                result.metadata["reused"] = true;
+                result.metadata["material_hash"] = material_hash;
+                continue;
+            }
+            if (hashable && !first_with_hash.emplace(material_hash, i).second) {
+                duplicates.emplace_back(i, first_with_hash[material_hash]);
+                continue;
+            }
+            spec.options.name = uniqueMaterialName(options.name, scene, batch_names);
+            batch_names.insert(spec.options.name);
+        }
+        const MaterialOptions& request = spec.options;
+        textures = collectTextureAssignments(spec);
+        result.material_name = request.name;
+
+        json material = {
+            {"name", request.name},
+            {"use_nodes", request.use_nodes},
+            {"metallic", request.metallic},
+            {"roughness", request.roughness},
+            {"specular", request.specular},
+            {"clearcoat", request.clearcoat},
+            {"clearcoat_roughness", request.clearcoat_roughness},
+            {"ior", request.ior},
+            {"transmission", request.transmission},
+            {"transmission_roughness", request.transmission_roughness},
+            {"emission_strength", request.emission_strength},
+            {"alpha", request.alpha},
+            {"backface_culling", request.backface_culling},
+            {"blend_method", request.blend_method},
+            {"textures", json::array()}
+        };
+        for (const auto& texture : textures) {
+            json texture_json = {{"path", texture.texture_path}, {"type", texture.texture_type}};
+            if (texture.tiled) {
+                texture_json["tiled"] = true;
+            }
+            material["textures"].push_back(texture_json);
+            result.assigned_textures.push_back(texture.texture_path);
+        }
+        std::string template_key = templateKey(spec);
+        if (!template_key.empty()) {
+            material["template"] = template_key;
+            if (!templates.contains(template_key)) {
+                // Channel types in the order the texture node group exposes them (sorted by type)
+                std::vector<std::string> channels;
+                for (const auto& texture : textures) {
+                    channels.push_back(texture.texture_type);
+                }
+                std::sort(channels.begin(), channels.end());
+                templates[template_key] = {{"channels", channels}};
+            }
+        }
+        batch.push_back(std::move(material));
+        batch_specs.push_back(spec);
+        batch_indices.push_back(i);
+        batch_hashes.emplace_back(material_hash, hashable);
+    }
+
+    if (batch_indices.empty()) {
+        return results;
+    }
+
+    // Write the batch for the Python module, with the templates it needs and which of them the library holds
+    json request = {{"materials", std::move(batch)}, {"templates", templates}};
+    std::string library;
+    {
+        std::lock_guard<std::mutex> lock(template_mutex_);
+        library = template_library_;
+        json resident = json::array();
+        if (!library.empty()) {
+            const std::set<std::string>& held = resident_templates_[library];
+            for (const auto& entry : templates.items()) {
+                if (held.count(entry.key())) {
+                    resident.push_back(entry.key());
+                }
+            }
+        }
+        request["template_library"] = library;
+        request["resident_templates"] = resident;
+    }
+    request["scene_file"] = scene_file;
+    char tmp_json_name[L_tmpnam];
+    std::tmpnam(tmp_json_name);
+    std::ofstream batch_file(tmp_json_name);
+    batch_file << request.dump();
+    batch_file.close();
+
+    // Execute Python module once for the whole batch
+    std::string cmd = "blender --background --factory-startup --python src/python/material_utils.py -- create_materials_batch '" + std::string(tmp_json_name) + "' 2>&1";
+    std::array<char, 256> buffer;
+    std::string output;
+    // Each batch opens and saves the whole scene, so batches into a scene run one at a time
+    std::unique_lock<std::mutex> scene_guard(scene_file_mutex_, std::defer_lock);
+    if (!scene_file.empty()) {
+        scene_guard.lock();
+    }
+    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
+    const bool launched = pipe != nullptr;
+
+    if (pipe) {
+        while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
+            output += buffer.data();
+        }
+    }
+    pipe.reset();
+    if (scene_guard.owns_lock()) {
+        scene_guard.unlock();
+    }
+    std::remove(tmp_json_name);
+
+    // Parse one "MATERIAL_RESULT: {json}" line per batched material
+    std::vector<bool> reported(batch_indices.size(), false);
+    std::istringstream iss(output);
+    std::string line;
+    const std::string prefix = "MATERIAL_RESULT: ";
+    std::vector<std::string> saved_templates;
+    MaterialTemplateStats session;
+    while (std::getline(iss, line)) {
+        if (line.rfind("TEMPLATE_RESIDENT: ", 0) == 0) {
+            saved_templates.push_back(line.substr(19));
+            continue;
+        }
+        if (line.rfind("TEMPLATE_STATS: ", 0) == 0) {
+            std::sscanf(line.c_str(), "TEMPLATE_STATS: compiled=%zu appended=%zu instanced=%zu",
+                        &session.templates_compiled, &session.templates_appended, &session.materials_instanced);
+            continue;
+        }
+        if (line.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        json reply = json::parse(line.substr(prefix.size()), nullptr, false);
+        if (reply.is_discarded() || !reply.contains("index") || !reply["index"].is_number_unsigned()) {
+            continue;
+        }
+        size_t batch_index = reply["index"].get<size_t>();
+        if (batch_index >= batch_indices.size()) {
+            continue;
+        }
+        MaterialResult& result = results[batch_indices[batch_index]];
+        reported[batch_index] = true;
+        result.success = reply.value("success", false);
+        result.message = reply.value("message", "");
+        if (result.success) {
+            result.material_name = reply.value("material_name", result.material_name);
+            result.created_materials.push_back(result.material_name);
+        }
+        result.metadata["batch_size"] = batch_indices.size();
+        result.metadata["instanced"] = reply.value("instanced", false);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(template_mutex_);
+        template_stats_.templates_compiled += session.templates_compiled;
+        template_stats_.templates_appended += session.templates_appended;
+        template_stats_.materials_instanced += session.materials_instanced;
+        if (!library.empty() && !saved_templates.empty()) {
+            resident_templates_[library].insert(saved_templates.begin(), saved_templates.end());
+            saveTemplateManifest(library);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    SceneMaterials& scene = scene_materials_[scene_file];
+    for (size_t i = 0; i < batch_indices.size(); ++i) {
+        MaterialResult& result = results[batch_indices[i]];
+        if (!reported[i]) {
+            result.message = launched ? "Failed to create material: " + output
+                                      : "Failed to launch Blender for batch material creation";
+            continue;
+        }
+        if (!result.success || scene_file.empty()) {
+            // Materials of a discarded session cannot be reused later
+            continue;
+        }
+        scene.by_name[result.material_name] = batch_hashes[i].first;
+        scene.specs[result.material_name] = batch_specs[i];
+        for (const auto& texture : collectTextureAssignments(batch_specs[i])) {
+            uint64_t content = 0;
+            if (textureContentHash(texture.texture_path, content)) {
+                scene.textures.emplace(content, texture.texture_path);
+            }
+        }
+        if (batch_hashes[i].second) {
+            scene.by_hash.emplace(batch_hashes[i].first, result.material_name);
+            result.metadata["material_hash"] = batch_hashes[i].first;
+            ++registry_stats_.materials_registered;
+        }
+    }
+
+    // Duplicates within the batch share the result of the first identical spec
+    for (const auto& [index, original] : duplicates) {
+        const MaterialResult& source = results[original];
+        MaterialResult& result = results[index];
+        result.success = source.success;
+        result.material_name = source.material_name;
+        result.assigned_textures = source.assigned_textures;
+        result.message = source.success ? "Reused identical material" : source.message;
+        if (source.success) {
+            result.metadata["reused"] = true;
+            ++registry_stats_.materials_reused;
+        }
+    }
+
+    return results;
+}
+
+void MaterialManager::setTemplateLibrary(const std::string& library_path) {
+    /*
+     * Keeps compiled node-tree templates in a .blend library shared by all Blender sessions.
+     * - The templates it holds are listed in a manifest next to it (<library>.json), so a session is only
+     *   asked to append templates that exist and to compile (and save) the rest; "" turns the library off
+     */
+    std::lock_guard<std::mutex> lock(template_mutex_);
+    template_library_ = library_path.empty() ? "" : std::filesystem::absolute(library_path).lexically_normal().string();
+    if (!template_library_.empty() && !resident_templates_.count(template_library_)) {
+        loadTemplateManifest(template_library_);
+    }
+}
+
+std::string MaterialManager::getTemplateLibrary() const {
+    std::lock_guard<std::mutex> lock(template_mutex_);
+    return template_library_;
+}
+
+std::set<std::string> MaterialManager::getResidentTemplates() const {
+    std::lock_guard<std::mutex> lock(template_mutex_);
+    auto it = resident_templates_.find(template_library_);
+    return it != resident_templates_.end() ? it->second : std::set<std::string>();
+}
+
+MaterialTemplateStats MaterialManager::getTemplateStats() const {
+    std::lock_guard<std::mutex> lock(template_mutex_);
+    return template_stats_;
+}
+
+std::shared_ptr<const MaterialPreview> MaterialManager::renderPreview(const MaterialSpec& spec, int size) {
+    /*
+     * Preview sphere of a material, rendered on the CPU.
+     * - Cached under the registry's parameter hash, so identical materials share one preview whatever their name
+     * - Specs that cannot be hashed (custom property types) are rendered every time
+     */
+    uint64_t hash = 0;
+    bool hashable = false;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        hashable = hashMaterial(spec, hash);
+    }
+    return hashable ? preview_renderer_->render(spec, size, hash) : preview_renderer_->renderUncached(spec, size);
+}
+
+std::shared_ptr<const MaterialPreview> MaterialManager::renderPresetPreview(const std::string& preset_name, int size) {
+    auto it = material_presets_.find(preset_name);
+    if (it == material_presets_.end()) {
+        return nullptr;
+    }
+    return renderPreview(MaterialSpec{it->second.options, {}}, size);
+}
+
+std::shared_ptr<const MaterialPreview> MaterialManager::renderMaterialPreview(const std::string& material_name, int size) {
+    // Materials created through this manager (or registered) in the current scene
+    MaterialSpec spec;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        auto scene = scene_materials_.find(scene_key_);
+        if (scene == scene_materials_.end()) {
+            return nullptr;
+        }
+        auto it = scene->second.specs.find(material_name);
+        if (it == scene->second.specs.end()) {
+            return nullptr;
+        }
+        spec = it->second;
+    }
+    return renderPreview(spec, size);
+}
+
+MaterialPreviewStats MaterialManager::getPreviewStats() const {
+    return preview_renderer_->getStats();
+}
+
+std::string MaterialManager::templateKey(const MaterialSpec& spec) {
+    /*
+     * Names the node-graph shape of a spec: which texture channels feed the Principled BSDF.
+     * - Parameter values, image files and names are set per instance and do not change the key
+     * - Short hex digest, so template material names stay within Blender's 63 characters
+     * @return Key, or "" for materials without nodes (nothing to instance)
+     */
+    if (!spec.options.use_nodes) {
+        return "";
+    }
+    std::vector<std::string> channels;
+    for (const auto& texture : collectTextureAssignments(spec)) {
+        channels.push_back(texture.texture_type);
+    }
+    std::sort(channels.begin(), channels.end());
+    std::string shape = "principled-v1";
+    for (const auto& channel : channels) {
+        shape += "|" + channel;
+    }
+    uint64_t hash = 1469598103934665603ull;
+    for (unsigned char c : shape) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+    return key;
+}
+
+void MaterialManager::setScene(const std::string& scene_key) {
+    /*
+     * Selects the scene later requests create materials in and whose registry they use.
+     * - scene_key is a .blend file: batches open it (if it exists) and save their materials into it, so a
+     *   reused material is one that really is in the file
+     * - "" selects no scene: each batch runs in a blank session that is discarded, and nothing is registered
+     */
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    scene_key_ = scene_key.empty() ? "" : std::filesystem::absolute(scene_key).lexically_normal().string();
+}
+
+std::string MaterialManager::getScene() const {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return scene_key_;
+}
+
+void MaterialManager::registerMaterial(const MaterialSpec& spec, const std::string& material_name) {
+    /*
+     * Records a material that already exists in the current scene (e.g. loaded with the .blend),
+     * so identical requests reuse it instead of creating a copy.
+     * - Ignored without a scene: there is no file the material could be in
+     */
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    if (scene_key_.empty()) {
+        return;
+    }
+    SceneMaterials& scene = scene_materials_[scene_key_];
+    std::vector<std::string> shared;
+    MaterialSpec canonical = shareTextures(spec, scene, true, shared);
+    uint64_t hash = 0;
+    bool hashable = hashMaterial(canonical, hash);
+    scene.by_name[material_name] = hash;
+    scene.specs[material_name] = canonical;
+    if (hashable && scene.by_hash.emplace(hash, material_name).second) {
+        ++registry_stats_.materials_registered;
+    }
+}
+
+std::string MaterialManager::findRegisteredMaterial(const MaterialSpec& spec) {
+    /*
+     * Looks up the material of the current scene identical to spec.
+     * @return Material name, or "" if none is registered (or spec cannot be hashed, or no scene is selected)
+     */
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    if (scene_key_.empty()) {
+        return "";
+    }
+    SceneMaterials& scene = scene_materials_[scene_key_];
+    std::vector<std::string> shared;
+    MaterialSpec canonical = shareTextures(spec, scene, false, shared);
+    uint64_t hash = 0;
+    if (!hashMaterial(canonical, hash)) {
+        return "";
+    }
+    auto it = scene.by_hash.find(hash);
+    return it != scene.by_hash.end() ? it->second : "";
+}
+
+void MaterialManager::clearMaterialRegistry() {
+    // Current scene only; file content hashes stay cached (they are keyed by size and mtime)
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    scene_materials_.erase(scene_key_);
+}
+
+MaterialRegistryStats MaterialManager::getMaterialRegistryStats() const {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return registry_stats_;
+}
+
 TextureInfo MaterialManager::loadTexture(const std::string& texture_path) {
     /*
      * Full implementation: Loads and analyzes texture information.
@@ -283,36 +668,91 @@ MaterialResult MaterialManager::assignTexture(const std::string& material_name,
 
 std::vector<TextureInfo> MaterialManager::discoverTextures(const std::string& directory_path) {
     /*
-     * Full implementation: Discovers all texture files in a directory.
-     * - Recursively scans directory for supported texture formats
-     * - Analyzes each texture for metadata
-     * - Returns vector of TextureInfo structures
+     * Full implementation: Discovers all texture files in a directory tree.
+     * - Lists files from the asset index when it covers the directory, else walks the file system
+     * - A directory whose listing summary (paths, sizes, mtimes) is unchanged is answered from cache
+     * - Otherwise only new or changed files are probed, on a pool of worker threads
+     * - Headers are parsed directly; Blender is only started for formats the probe cannot read
      */
     std::vector<TextureInfo> textures;
-    
+
     if (!std::filesystem::exists(directory_path)) {
         return textures;
     }
 
-    std::vector<std::string> supported_formats = getSupportedTextureFormats();
-    
-    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory_path)) {
-        if (entry.is_regular_file()) {
-            std::string extension = entry.path().extension().string();
-            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-            
-            if (std::find(supported_formats.begin(), supported_formats.end(), extension) != supported_formats.end()) {
-                TextureInfo info = loadTexture(entry.path().string());
-                if (info.width > 0 && info.height > 0) {
-                    textures.push_back(info);
-                }
+    std::filesystem::path directory = std::filesystem::absolute(directory_path).lexically_normal();
+    bool from_index = false;
+    std::vector<TextureFileRecord> files = listTextureFiles(directory, from_index);
+    uint64_t summary = summarizeTextureFiles(files);
+
+    std::vector<TextureInfo> results(files.size());
+    std::vector<size_t> to_probe;
+    {
+        std::lock_guard<std::mutex> lock(texture_cache_mutex_);
+        discovery_stats_.index_listings += from_index ? 1 : 0;
+        auto cached = directory_cache_.find(directory.string());
+        if (cached != directory_cache_.end() && cached->second.summary == summary) {
+            ++discovery_stats_.directory_cache_hits;
+            return cached->second.textures;
+        }
+        for (size_t i = 0; i < files.size(); ++i) {
+            auto probe = probe_cache_.find(files[i].path);
+            if (probe != probe_cache_.end() && probe->second.size == files[i].size &&
+                probe->second.modified == files[i].modified) {
+                results[i] = probe->second.info;
+                ++discovery_stats_.files_reused;
+            } else {
+                to_probe.push_back(i);
             }
         }
     }
 
+    // Probe changed files in parallel; each worker claims the next index
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t claimed = next++; claimed < to_probe.size(); claimed = next++) {
+            size_t i = to_probe[claimed];
+            results[i] = probeTexture(files[i].path);
+        }
+    };
+    size_t worker_count = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), to_probe.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < worker_count; ++i) {
+        workers.emplace_back(worker);
+    }
+    if (worker_count > 0) {
+        worker();
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    for (const auto& info : results) {
+        if (info.width > 0 && info.height > 0) {
+            textures.push_back(info);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(texture_cache_mutex_);
+    discovery_stats_.files_probed += to_probe.size();
+    for (size_t i : to_probe) {
+        probe_cache_[files[i].path] = CachedProbe{files[i].size, files[i].modified, results[i]};
+    }
+    directory_cache_[directory.string()] = CachedDirectory{summary, textures};
     return textures;
 }
 
+TextureDiscoveryStats MaterialManager::getTextureDiscoveryStats() const {
+    std::lock_guard<std::mutex> lock(texture_cache_mutex_);
+    return discovery_stats_;
+}
+
+void MaterialManager::clearTextureCache() {
+    std::lock_guard<std::mutex> lock(texture_cache_mutex_);
+    directory_cache_.clear();
+    probe_cache_.clear();
+}
+
 std::vector<MaterialPreset> MaterialManager::getAvailablePresets() const {
     std::vector<MaterialPreset> presets;
     for (const auto& pair : material_presets_) {
@@ -335,7 +775,8 @@ MaterialResult MaterialManager::autoAssignMaterials(const std::string& asset_pat
     /*
      * Full implementation: Automatically assigns materials based on asset type and naming conventions.
      * - Analyzes asset file and directory structure
-     * - Discovers associated textures
+     * - With a texture set index: one lookup, channels already resolved (no directory scan)
+     * - Without one: discovers associated textures
      * - Creates materials based on asset type and naming patterns
      * - Assigns textures to appropriate material slots
      */
@@ -352,6 +793,45 @@ MaterialResult MaterialManager::autoAssignMaterials(const std::string& asset_pat
     std::filesystem::path asset_dir = asset_file.parent_path();
     std::string asset_name = asset_file.stem().string();
 
+    if (texture_sets_) {
+        const TextureSet* texture_set = texture_sets_->findForAsset(
+            std::filesystem::absolute(asset_path).lexically_normal().string());
+        if (!texture_set) {
+            result.message = "No textures found for asset: " + asset_path;
+            return result;
+        }
+        MaterialSpec spec;
+        spec.options.name = generateMaterialName(asset_name);
+        const std::tuple<const char*, std::string MaterialOptions::*, const char*> slots[] = {
+            {"base_color", &MaterialOptions::albedo_texture, "albedo"},
+            {"normal", &MaterialOptions::normal_texture, "normal"},
+            {"roughness", &MaterialOptions::roughness_texture, "roughness"},
+            {"metallic", &MaterialOptions::metallic_texture, "metallic"},
+            {"ao", &MaterialOptions::ao_texture, "ao"},
+            {"emission", &MaterialOptions::emission_texture, "emission"},
+            {"height", &MaterialOptions::displacement_texture, "displacement"}
+        };
+        for (const auto& slot : slots) {
+            auto channel = texture_set->channels.find(std::get<0>(slot));
+            if (channel == texture_set->channels.end()) {
+                continue;
+            }
+            if (channel->second.udim_tiles.empty()) {
+                spec.options.*std::get<1>(slot) = channel->second.path;
+            } else {
+                // UDIM channels go in as tiled assignments on the lowest tile's file
+                spec.textures.push_back({channel->second.path, std::get<2>(slot), true});
+            }
+        }
+        MaterialResult create_result = createMaterials({spec}).front();
+        result.success = create_result.success;
+        result.message = create_result.success ? "Auto-assigned materials successfully"
+                                               : "Failed to auto-assign materials: " + create_result.message;
+        result.created_materials = create_result.created_materials;
+        result.assigned_textures = create_result.assigned_textures;
+        return result;
+    }
+
     // Discover textures in asset directory
     std::vector<TextureInfo> textures = discoverTextures(asset_dir.string());
     
@@ -688,6 +1168,341 @@ bool MaterialManager::validateTexturePath(const std::string& texture_path) const
     return isTextureFormatSupported(format);
 }
 
+std::vector<TextureAssignment> MaterialManager::collectTextureAssignments(const MaterialSpec& spec) {
+    // Option slots first, then the spec's extra assignments
+    std::vector<TextureAssignment> textures;
+    const MaterialOptions& options = spec.options;
+    const std::pair<const std::string*, const char*> slots[] = {
+        {&options.albedo_texture, "albedo"},
+        {&options.normal_texture, "normal"},
+        {&options.roughness_texture, "roughness"},
+        {&options.metallic_texture, "metallic"},
+        {&options.ao_texture, "ao"},
+        {&options.emission_texture, "emission"},
+        {&options.displacement_texture, "displacement"}
+    };
+    for (const auto& slot : slots) {
+        if (!slot.first->empty()) {
+            textures.push_back({*slot.first, slot.second});
+        }
+    }
+    textures.insert(textures.end(), spec.textures.begin(), spec.textures.end());
+    return textures;
+}
+
+void MaterialManager::loadTemplateManifest(const std::string& library_path) {
+    // Caller holds template_mutex_; a missing library or manifest means nothing is resident
+    std::set<std::string>& resident = resident_templates_[library_path];
+    std::ifstream file(library_path + ".json");
+    if (!file || !std::filesystem::exists(library_path)) {
+        return;
+    }
+    json manifest = json::parse(file, nullptr, false);
+    if (manifest.is_discarded() || !manifest.contains("templates") || !manifest["templates"].is_array()) {
+        return;
+    }
+    for (const auto& key : manifest["templates"]) {
+        if (key.is_string()) {
+            resident.insert(key.get<std::string>());
+        }
+    }
+}
+
+void MaterialManager::saveTemplateManifest(const std::string& library_path) const {
+    // Caller holds template_mutex_; written to a temp file and renamed so readers never see half a manifest
+    json manifest = {{"templates", resident_templates_.at(library_path)}};
+    std::string temp_path = library_path + ".json.tmp";
+    {
+        std::ofstream file(temp_path);
+        if (!file) {
+            return;
+        }
+        file << manifest.dump(2);
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, library_path + ".json", ec);
+}
+
+MaterialSpec MaterialManager::shareTextures(const MaterialSpec& spec, SceneMaterials& scene, bool record,
+                                           std::vector<std::string>& shared) {
+    /*
+     * Points every texture at the scene's first file with the same content, so Blender loads one image.
+     * - Paths are made absolute and normal; unreadable files keep their path
+     * - record: remember first-seen files and count redirections (false for pure lookups)
+     */
+    MaterialSpec canonical = spec;
+    auto share = [&](std::string& path) {
+        if (path.empty()) {
+            return;
+        }
+        path = std::filesystem::absolute(path).lexically_normal().string();
+        uint64_t hash = 0;
+        if (!textureContentHash(path, hash)) {
+            return;
+        }
+        auto it = scene.textures.find(hash);
+        if (it == scene.textures.end()) {
+            if (record) {
+                scene.textures.emplace(hash, path);
+            }
+            return;
+        }
+        if (it->second != path) {
+            if (record) {
+                shared.push_back(path);
+                ++registry_stats_.textures_shared;
+            }
+            path = it->second;
+        }
+    };
+    MaterialOptions& options = canonical.options;
+    for (std::string* path : {&options.albedo_texture, &options.normal_texture, &options.roughness_texture,
+                              &options.metallic_texture, &options.ao_texture, &options.emission_texture,
+                              &options.displacement_texture}) {
+        share(*path);
+    }
+    for (auto& texture : canonical.textures) {
+        if (texture.tiled) {
+            // Blender finds the other tiles next to this file, so a UDIM tile is never redirected
+            texture.texture_path = std::filesystem::absolute(texture.texture_path).lexically_normal().string();
+            continue;
+        }
+        share(texture.texture_path);
+    }
+    return canonical;
+}
+
+bool MaterialManager::hashMaterial(const MaterialSpec& spec, uint64_t& hash) {
+    /*
+     * Canonical hash of everything that makes two materials render the same.
+     * - The name and preset label are not part of it; floats are quantized to 1e-4
+     * - Textures count by (slot, content hash), sorted, so path spelling and order do not matter
+     * - Custom properties of types other than string/int/float/double/bool make the spec unhashable
+     */
+    hash = 1469598103934665603ull;
+    auto mix = [&hash](const void* data, size_t length) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    auto mixString = [&mix](const std::string& value) {
+        mix(value.data(), value.size() + 1);
+    };
+    auto mixFloat = [&mix](double value) {
+        int64_t quantized = std::isfinite(value) ? static_cast<int64_t>(std::llround(value * 10000.0)) : INT64_MIN;
+        mix(&quantized, sizeof(quantized));
+    };
+
+    const MaterialOptions& options = spec.options;
+    for (float value : {options.metallic, options.roughness, options.subsurface, options.subsurface_radius,
+                        options.specular, options.clearcoat, options.clearcoat_roughness, options.ior,
+                        options.transmission, options.transmission_roughness, options.emission_strength,
+                        options.alpha}) {
+        mixFloat(value);
+    }
+    for (int k = 0; k < 3; ++k) {
+        mixFloat(options.subsurface_color[k]);
+        mixFloat(options.emission_color[k]);
+    }
+    const unsigned char flags[] = {options.use_nodes, options.auto_smooth, options.backface_culling, options.blend_method};
+    mix(flags, sizeof(flags));
+
+    std::vector<std::pair<std::string, std::string>> textures;
+    for (const auto& texture : collectTextureAssignments(spec)) {
+        uint64_t content = 0;
+        if (texture.tiled) {
+            // A tile set is identified by where its tiles live, not by the first tile's content
+            textures.emplace_back(texture.texture_type,
+                                  "udim:" + std::filesystem::absolute(texture.texture_path).lexically_normal().string());
+            continue;
+        }
+        textures.emplace_back(texture.texture_type, textureContentHash(texture.texture_path, content)
+            ? std::to_string(content) : std::filesystem::absolute(texture.texture_path).lexically_normal().string());
+    }
+    std::sort(textures.begin(), textures.end());
+    for (const auto& texture : textures) {
+        mixString(texture.first);
+        mixString(texture.second);
+    }
+
+    for (const auto& [key, value] : options.custom_properties) {
+        mixString(key);
+        if (value.type() == typeid(std::string)) {
+            mixString(std::any_cast<std::string>(value));
+        } else if (value.type() == typeid(int)) {
+            mixFloat(std::any_cast<int>(value));
+        } else if (value.type() == typeid(float)) {
+            mixFloat(std::any_cast<float>(value));
+        } else if (value.type() == typeid(double)) {
+            mixFloat(std::any_cast<double>(value));
+        } else if (value.type() == typeid(bool)) {
+            mixFloat(std::any_cast<bool>(value) ? 1.0 : 0.0);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MaterialManager::textureContentHash(const std::string& texture_path, uint64_t& hash) {
+    /*
+     * 64-bit content hash of a file: CRC-32 and Adler-32 of the bytes, mixed with the size.
+     * - Cached per path and recomputed only when size or mtime change
+     */
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(texture_path, ec);
+    if (ec) {
+        return false;
+    }
+    auto modified = std::filesystem::last_write_time(texture_path, ec);
+    if (ec) {
+        return false;
+    }
+    int64_t stamp = static_cast<int64_t>(modified.time_since_epoch().count());
+    auto cached = content_hashes_.find(texture_path);
+    if (cached != content_hashes_.end() && cached->second.size == size && cached->second.modified == stamp) {
+        hash = cached->second.hash;
+        return true;
+    }
+
+    std::ifstream file(texture_path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    uLong crc = crc32(0L, Z_NULL, 0);
+    uLong adler = adler32(0L, Z_NULL, 0);
+    std::vector<char> chunk(1 << 20);
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        std::streamsize count = file.gcount();
+        if (count <= 0) {
+            break;
+        }
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(chunk.data()), static_cast<uInt>(count));
+        adler = adler32(adler, reinterpret_cast<const Bytef*>(chunk.data()), static_cast<uInt>(count));
+    }
+    hash = ((static_cast<uint64_t>(crc) << 32) | (adler & 0xffffffffu)) ^ (size * 0x9e3779b97f4a7c15ull);
+    content_hashes_[texture_path] = {size, stamp, hash};
+    return true;
+}
+
+std::string MaterialManager::uniqueMaterialName(const std::string& name, const SceneMaterials& scene,
+                                                const std::set<std::string>& reserved) {
+    // Another material already has this name in the scene: number it like Blender does (name.001)
+    auto taken = [&](const std::string& candidate) {
+        return scene.by_name.count(candidate) > 0 || reserved.count(candidate) > 0;
+    };
+    if (!taken(name)) {
+        return name;
+    }
+    for (int suffix = 1;; ++suffix) {
+        char number[16];
+        std::snprintf(number, sizeof(number), ".%03d", suffix);
+        if (!taken(name + number)) {
+            return name + number;
+        }
+    }
+}
+
+std::vector<MaterialManager::TextureFileRecord> MaterialManager::listTextureFiles(
+    const std::filesystem::path& directory, bool& from_index) const {
+    /*
+     * Lists supported texture files under a directory, sorted by path.
+     * - Inside a scanned asset root the index already holds every file with size and mtime;
+     *   texture sets are only built by a full scan, so a valid index cache also qualifies
+     * - Elsewhere the tree is walked (metadata only, no file contents are read)
+     * - Both branches report mtimes in file_time_type ticks, so the probe cache keys match
+     */
+    std::vector<TextureFileRecord> files;
+    from_index = false;
+
+    if (asset_manager_ && (asset_manager_->get_texture_sets() || asset_manager_->is_cache_valid())) {
+        // Fixed once per process, so an index entry always maps to the same tick value
+        using FileDuration = std::filesystem::file_time_type::duration;
+        static const FileDuration clock_offset =
+            std::filesystem::file_time_type::clock::now().time_since_epoch() -
+            std::chrono::duration_cast<FileDuration>(std::chrono::system_clock::now().time_since_epoch());
+        std::filesystem::path root = std::filesystem::absolute(asset_manager_->get_assets_root()).lexically_normal();
+        auto mismatch = std::mismatch(root.begin(), root.end(), directory.begin(), directory.end());
+        if (mismatch.first == root.end()) {
+            from_index = true;
+            std::string prefix = directory.string();
+            for (const auto& asset : asset_manager_->get_assets_by_type("Texture")) {
+                std::string path = (root / asset.path).lexically_normal().string();
+                bool inside = path.size() > prefix.size() && path.compare(0, prefix.size(), prefix) == 0 &&
+                              (prefix.back() == '/' || path[prefix.size()] == '/');
+                if (inside && isTextureFormatSupported(getTextureFormat(path))) {
+                    auto ticks = (std::chrono::duration_cast<FileDuration>(asset.last_modified.time_since_epoch()) +
+                                  clock_offset).count();
+                    files.push_back({path, asset.file_size, static_cast<int64_t>(ticks)});
+                }
+            }
+        }
+    }
+
+    if (!from_index) {
+        std::error_code ec;
+        for (std::filesystem::recursive_directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+            if (!it->is_regular_file(ec) || !isTextureFormatSupported(getTextureFormat(it->path().string()))) {
+                continue;
+            }
+            uint64_t size = it->file_size(ec);
+            int64_t modified = static_cast<int64_t>(it->last_write_time(ec).time_since_epoch().count());
+            files.push_back({it->path().string(), size, modified});
+        }
+    }
+
+    std::sort(files.begin(), files.end(), [](const TextureFileRecord& a, const TextureFileRecord& b) {
+        return a.path < b.path;
+    });
+    return files;
+}
+
+uint64_t MaterialManager::summarizeTextureFiles(const std::vector<TextureFileRecord>& files) {
+    // FNV-1a over every (path, size, mtime); any added, removed or touched file changes it
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](const void* data, size_t length) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    for (const auto& file : files) {
+        mix(file.path.data(), file.path.size() + 1);
+        mix(&file.size, sizeof(file.size));
+        mix(&file.modified, sizeof(file.modified));
+    }
+    return hash;
+}
+
+TextureInfo MaterialManager::probeTexture(const std::string& texture_path) {
+    /*
+     * Reads one texture's properties from its header.
+     * - Header comes from the shared file probe, so files the indexer or validator already read are not re-read
+     * - Falls back to loading through Blender (loadTexture) when the header is not understood;
+     *   discovery workers take turns so at most one Blender process runs at a time
+     */
+    auto probe = FileProbeService::shared().probe(texture_path);
+    if (probe->has_texture) {
+        const TextureHeader& header = probe->texture;
+        TextureInfo info;
+        info.path = texture_path;
+        info.format = getTextureFormat(texture_path);
+        info.width = header.width;
+        info.height = header.height;
+        info.channels = header.channels;
+        info.is_hdr = header.is_hdr;
+        return info;
+    }
+    {
+        std::lock_guard<std::mutex> lock(texture_cache_mutex_);
+        ++discovery_stats_.decoder_fallbacks;
+    }
+    std::lock_guard<std::mutex> lock(blender_fallback_mutex_);
+    return loadTexture(texture_path);
+}
+
 std::string MaterialManager::getTextureFormat(const std::string& texture_path) const {
     std::filesystem::path path(texture_path);
     std::string extension = path.extension().string();
@@ -0,0 +1,573 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: material_preview.cpp
+ * Description: Implementation of the MaterialPreviewRenderer class: sphere geometry, texture sampling and the
+ *              SSE2 shading kernel for material preview thumbnails.
+ *
+ * Architecture:
+ * - The view is orthographic along +Z, so V, L and H are the same for every pixel: V.H and its Fresnel factor
+ *   are per-material constants, and N.L, N.V, N.H depend only on the sphere (unless a normal map is sampled)
+ * - Shading runs outside the lock; only the cache, geometry and texture maps are guarded
+ *
+ * Key Features:
+ * - Tone mapping: extended Reinhard with a white point of 2, then a 4096-entry sRGB table
+ * - Textures are keyed by path and re-decoded when their size or mtime changes
+ */
+
+#include "material_preview.hpp"
+#include "material_manager.hpp"
+#include "texture_processor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace AssetManager {
+
+MaterialPreviewRenderer::MaterialPreviewRenderer(size_t cache_capacity)
+    : cache_capacity_(std::max<size_t>(1, cache_capacity)) {
+}
+
+std::shared_ptr<const MaterialPreview> MaterialPreviewRenderer::render(const MaterialSpec& spec, int size, uint64_t key) {
+    /**
+     * @brief Returns the preview of a material, rendering it only on a cache miss.
+     *
+     * @param spec Material options and extra texture assignments.
+     * @param size Edge length in pixels (clamped to [kMinSize, kMaxSize]).
+     * @param key Parameter hash of the material; equal keys must render the same.
+     * @return Shared, immutable preview.
+     */
+    size = clampSize(size);
+    const uint64_t cache_key = cacheKey(key, size);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(cache_key);
+        if (it != cache_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            ++stats_.cache_hits;
+            return it->second->second;
+        }
+    }
+
+    std::shared_ptr<MaterialPreview> preview = shade(spec, size);
+    preview->key = key;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(cache_key);
+    if (it != cache_.end()) {
+        // Another thread rendered the same material meanwhile; keep the cached one
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+    }
+    lru_.emplace_front(cache_key, preview);
+    cache_[cache_key] = lru_.begin();
+    while (lru_.size() > cache_capacity_) {
+        cache_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+    return preview;
+}
+
+std::shared_ptr<const MaterialPreview> MaterialPreviewRenderer::renderUncached(const MaterialSpec& spec, int size) {
+    return shade(spec, clampSize(size));
+}
+
+MaterialPreviewStats MaterialPreviewRenderer::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void MaterialPreviewRenderer::clearCache() {
+    // Previews handed out stay valid; they are shared and immutable
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    cache_.clear();
+    textures_.clear();
+}
+
+std::shared_ptr<MaterialPreview> MaterialPreviewRenderer::shade(const MaterialSpec& spec, int size) {
+    /**
+     * @brief Renders one preview sphere.
+     *
+     * Inputs are gathered per silhouette pixel (constants, or texture samples through the sphere UVs),
+     * shaded in linear light, tone mapped and written into a transparent RGBA8 image.
+     */
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const SphereGeometry> geometry = sphereGeometry(size);
+    const size_t count = geometry->pixels.size();
+    const MaterialOptions& options = spec.options;
+
+    // Material inputs, one entry per pixel
+    std::vector<float> albedo[3];
+    std::vector<float> roughness(count, std::clamp(options.roughness, 0.0f, 1.0f));
+    std::vector<float> metallic(count, std::clamp(options.metallic, 0.0f, 1.0f));
+    std::vector<float> ao(count, 1.0f);
+    std::shared_ptr<const PreviewTexture> albedo_texture = loadTexture(textureFor(spec, "albedo"), 3, true);
+    for (int c = 0; c < 3; ++c) {
+        albedo[c].assign(count, 0.8f);      // Principled BSDF default base color
+        if (albedo_texture) {
+            sampleTexture(*albedo_texture, *geometry, c, albedo[c].data());
+        }
+    }
+    if (auto texture = loadTexture(textureFor(spec, "roughness"), 1, false)) {
+        sampleTexture(*texture, *geometry, 0, roughness.data());
+    }
+    if (auto texture = loadTexture(textureFor(spec, "metallic"), 1, false)) {
+        sampleTexture(*texture, *geometry, 0, metallic.data());
+    }
+    if (auto texture = loadTexture(textureFor(spec, "ao"), 1, false)) {
+        sampleTexture(*texture, *geometry, 0, ao.data());
+    }
+
+    ShadingLanes lanes{};
+    lanes.ndotl = geometry->ndotl.data();
+    lanes.ndotv = geometry->ndotv.data();
+    lanes.ndoth = geometry->ndoth.data();
+    lanes.hemi_n = geometry->hemi_n.data();
+    lanes.hemi_r = geometry->hemi_r.data();
+    lanes.fresnel_v = geometry->fresnel_v.data();
+
+    // A normal map replaces the sphere's surface terms with per-pixel ones (tangent space, OpenGL green up)
+    std::vector<float> surface[6];
+    if (auto texture = loadTexture(textureFor(spec, "normal"), 3, false)) {
+        std::vector<float> tangent[3];
+        for (int c = 0; c < 3; ++c) {
+            tangent[c].resize(count);
+            sampleTexture(*texture, *geometry, c, tangent[c].data());
+        }
+        for (auto& terms : surface) {
+            terms.resize(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const float nx = geometry->nx[i], ny = geometry->ny[i], nz = geometry->nz[i];
+            const float phi = (geometry->u[i] - 0.5f) * 6.28318531f;
+            const float t[3] = {std::cos(phi), 0.0f, -std::sin(phi)};
+            const float b[3] = {ny * t[2], nz * t[0] - nx * t[2], -ny * t[0]};   // N x T, towards +v
+            const float sx = tangent[0][i] * 2.0f - 1.0f;
+            const float sy = tangent[1][i] * 2.0f - 1.0f;
+            const float sz = tangent[2][i] * 2.0f - 1.0f;
+            float px = t[0] * sx + b[0] * sy + nx * sz;
+            float py = t[1] * sx + b[1] * sy + ny * sz;
+            float pz = t[2] * sx + b[2] * sy + nz * sz;
+            float length = std::sqrt(px * px + py * py + pz * pz);
+            if (length < 1e-6f) {
+                px = nx, py = ny, pz = nz, length = 1.0f;
+            }
+            float terms[6];
+            surfaceTerms(px / length, py / length, pz / length, terms);
+            for (int k = 0; k < 6; ++k) {
+                surface[k][i] = terms[k];
+            }
+        }
+        lanes.ndotl = surface[0].data();
+        lanes.ndotv = surface[1].data();
+        lanes.ndoth = surface[2].data();
+        lanes.hemi_n = surface[3].data();
+        lanes.hemi_r = surface[4].data();
+        lanes.fresnel_v = surface[5].data();
+    }
+
+    std::vector<float> out[3];
+    for (int c = 0; c < 3; ++c) {
+        out[c].resize(count);
+        lanes.albedo[c] = albedo[c].data();
+        lanes.out[c] = out[c].data();
+    }
+    lanes.roughness = roughness.data();
+    lanes.metallic = metallic.data();
+    lanes.ao = ao.data();
+
+    float light[3], half[3];
+    lightVectors(light, half);
+    const float v_dot_h = std::clamp(half[2], 0.0f, 1.0f);
+    const float clearcoat_roughness = std::clamp(options.clearcoat_roughness, 0.045f, 1.0f);
+    const float clearcoat_alpha = clearcoat_roughness * clearcoat_roughness;
+    ShadingConstants constants{};
+    constants.fresnel_h = std::pow(1.0f - v_dot_h, 5.0f);
+    constants.dielectric_f0 = 0.08f * std::clamp(options.specular, 0.0f, 1.0f);
+    constants.diffuse_weight = 1.0f - std::clamp(options.transmission, 0.0f, 1.0f);
+    constants.clearcoat = std::clamp(options.clearcoat, 0.0f, 1.0f);
+    constants.clearcoat_a2 = clearcoat_alpha * clearcoat_alpha;
+    constants.clearcoat_k = (clearcoat_roughness + 1.0f) * (clearcoat_roughness + 1.0f) / 8.0f;
+    const float key_light[3] = {3.0f, 2.9f, 2.75f};
+    const float sky[3] = {0.42f, 0.47f, 0.55f};
+    const float ground[3] = {0.16f, 0.14f, 0.12f};
+    for (int c = 0; c < 3; ++c) {
+        constants.light[c] = key_light[c];
+        constants.sky[c] = sky[c];
+        constants.ground[c] = ground[c];
+        constants.emission[c] = std::max(0.0f, options.emission_color[c] * options.emission_strength);
+    }
+
+    shadeLanes(lanes, constants, count);
+
+    // Tone map (extended Reinhard, white point 2) and encode to sRGB through a table
+    static const std::vector<uint8_t> srgb = []() {
+        std::vector<uint8_t> table(4096);
+        for (size_t i = 0; i < table.size(); ++i) {
+            double linear = static_cast<double>(i) / (table.size() - 1);
+            double encoded = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            table[i] = static_cast<uint8_t>(std::lround(std::clamp(encoded, 0.0, 1.0) * 255.0));
+        }
+        return table;
+    }();
+
+    auto preview = std::make_shared<MaterialPreview>();
+    preview->size = size;
+    preview->rgba.assign(static_cast<size_t>(size) * size * 4, 0);
+    const float opacity = std::clamp(options.alpha, 0.0f, 1.0f);
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* pixel = preview->rgba.data() + static_cast<size_t>(geometry->pixels[i]) * 4;
+        for (int c = 0; c < 3; ++c) {
+            float value = std::max(0.0f, out[c][i]);
+            value = value * (1.0f + value * 0.25f) / (1.0f + value);
+            pixel[c] = srgb[static_cast<size_t>(std::min(value, 1.0f) * 4095.0f + 0.5f)];
+        }
+        pixel[3] = static_cast<uint8_t>(geometry->coverage[i] * opacity * 255.0f + 0.5f);
+    }
+
+    preview->render_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.previews_rendered;
+    stats_.render_ms += preview->render_ms;
+    return preview;
+}
+
+std::shared_ptr<const MaterialPreviewRenderer::SphereGeometry> MaterialPreviewRenderer::sphereGeometry(int size) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = geometry_.find(size);
+        if (it != geometry_.end()) {
+            return it->second;
+        }
+    }
+    std::shared_ptr<const SphereGeometry> geometry = buildGeometry(size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return geometry_.emplace(size, geometry).first->second;
+}
+
+std::shared_ptr<const MaterialPreviewRenderer::SphereGeometry> MaterialPreviewRenderer::buildGeometry(int size) {
+    /*
+     * Unit sphere filling the image with a one-pixel margin.
+     * - Coverage is the pixel center's distance inside the silhouette, clamped to one pixel of falloff
+     * - Rim pixels whose center lies outside use the normal at the silhouette
+     */
+    auto geometry = std::make_shared<SphereGeometry>();
+    geometry->size = size;
+    const float center = size * 0.5f;
+    const float radius = center - 1.0f;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float px = (x + 0.5f - center) / radius;
+            float py = (center - (y + 0.5f)) / radius;
+            const float distance = std::sqrt(px * px + py * py);
+            const float coverage = std::clamp(radius * (1.0f - distance) + 0.5f, 0.0f, 1.0f);
+            if (coverage <= 0.0f) {
+                continue;
+            }
+            float pz = 0.0f;
+            if (distance >= 1.0f) {
+                px /= distance;
+                py /= distance;
+            } else {
+                pz = std::sqrt(1.0f - distance * distance);
+            }
+            float terms[6];
+            surfaceTerms(px, py, pz, terms);
+            geometry->pixels.push_back(static_cast<uint32_t>(y * size + x));
+            geometry->coverage.push_back(coverage);
+            geometry->nx.push_back(px);
+            geometry->ny.push_back(py);
+            geometry->nz.push_back(pz);
+            geometry->ndotl.push_back(terms[0]);
+            geometry->ndotv.push_back(terms[1]);
+            geometry->ndoth.push_back(terms[2]);
+            geometry->hemi_n.push_back(terms[3]);
+            geometry->hemi_r.push_back(terms[4]);
+            geometry->fresnel_v.push_back(terms[5]);
+            geometry->u.push_back(0.5f + std::atan2(px, pz) / 6.28318531f);
+            geometry->v.push_back(std::acos(std::clamp(py, -1.0f, 1.0f)) / 3.14159265f);
+        }
+    }
+    return geometry;
+}
+
+void MaterialPreviewRenderer::lightVectors(float light[3], float half[3]) {
+    // Key light from the upper left, in front of the sphere; the view looks down -Z
+    const float direction[3] = {-0.45f, 0.6f, 0.66f};
+    const float view[3] = {0.0f, 0.0f, 1.0f};
+    const float light_length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] +
+                                         direction[2] * direction[2]);
+    for (int k = 0; k < 3; ++k) {
+        light[k] = direction[k] / light_length;
+        half[k] = light[k] + view[k];
+    }
+    const float half_length = std::sqrt(half[0] * half[0] + half[1] * half[1] + half[2] * half[2]);
+    for (int k = 0; k < 3; ++k) {
+        half[k] /= half_length;
+    }
+}
+
+void MaterialPreviewRenderer::surfaceTerms(float nx, float ny, float nz, float terms[6]) {
+    /*
+     * Shading terms of one unit normal: N.L, N.V, N.H, sky weight of N, sky weight of the reflection
+     * vector R = 2(N.V)N - V (so R.y = 2 N.z N.y), and (1 - N.V)^5.
+     */
+    float light[3], half[3];
+    lightVectors(light, half);
+    const float n_dot_v = std::max(nz, 1e-4f);
+    const float fresnel = 1.0f - n_dot_v;
+    terms[0] = std::max(0.0f, nx * light[0] + ny * light[1] + nz * light[2]);
+    terms[1] = n_dot_v;
+    terms[2] = std::max(0.0f, nx * half[0] + ny * half[1] + nz * half[2]);
+    terms[3] = 0.5f + 0.5f * ny;
+    terms[4] = std::clamp(0.5f + n_dot_v * ny, 0.0f, 1.0f);
+    terms[5] = fresnel * fresnel * fresnel * fresnel * fresnel;
+}
+
+std::shared_ptr<const MaterialPreviewRenderer::PreviewTexture> MaterialPreviewRenderer::loadTexture(
+    const std::string& path, int channels, bool srgb) {
+    /**
+     * @brief Decodes a texture for sampling, reduced to kTextureSize and converted to linear floats.
+     *
+     * @param path Texture file; empty means no texture.
+     * @param channels 1 keeps the first channel (data maps), 3 keeps RGB (grayscale is replicated).
+     * @param srgb Decode 8-bit values from sRGB (color maps) instead of reading them as linear.
+     * @return Texture, or nullptr if there is none or it cannot be decoded.
+     */
+    if (path.empty()) {
+        return nullptr;
+    }
+    std::error_code ec;
+    const uint64_t file_size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return nullptr;
+    }
+    const int64_t modified = static_cast<int64_t>(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+    const std::string key = path + (srgb ? "#srgb" : "#linear") + std::to_string(channels);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = textures_.find(key);
+        if (it != textures_.end() && it->second->file_size == file_size && it->second->modified == modified) {
+            return it->second;
+        }
+    }
+
+    ImageBuffer image;
+    std::string error;
+    if (!TextureProcessor::decode(path, image, error) || image.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.texture_failures;
+        return nullptr;
+    }
+    const int longest = std::max(image.width, image.height);
+    if (longest > kTextureSize) {
+        const double scale = static_cast<double>(kTextureSize) / longest;
+        image = TextureProcessor::resize(image, std::max(1, static_cast<int>(image.width * scale)),
+                                         std::max(1, static_cast<int>(image.height * scale)), ResampleFilter::Box);
+    }
+
+    auto texture = std::make_shared<PreviewTexture>();
+    texture->file_size = file_size;
+    texture->modified = modified;
+    texture->width = image.width;
+    texture->height = image.height;
+    texture->channels = channels;
+    texture->texels.resize(static_cast<size_t>(image.width) * image.height * channels);
+    float decode[256];
+    for (int i = 0; i < 256; ++i) {
+        const float value = i / 255.0f;
+        decode[i] = !srgb ? value : value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+    const size_t texel_count = static_cast<size_t>(image.width) * image.height;
+    for (size_t t = 0; t < texel_count; ++t) {
+        for (int c = 0; c < channels; ++c) {
+            const size_t source = t * image.channels + std::min(c, image.channels - 1);
+            texture->texels[t * channels + c] = image.is_float ? image.floats[source] : decode[image.bytes[source]];
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.textures_loaded;
+    textures_[key] = texture;
+    return texture;
+}
+
+std::string MaterialPreviewRenderer::textureFor(const MaterialSpec& spec, const std::string& type) {
+    // Option slot first, then the spec's extra assignments (same precedence as material creation)
+    const MaterialOptions& options = spec.options;
+    const std::string* slot = type == "albedo" ? &options.albedo_texture
+                            : type == "normal" ? &options.normal_texture
+                            : type == "roughness" ? &options.roughness_texture
+                            : type == "metallic" ? &options.metallic_texture
+                            : type == "ao" ? &options.ao_texture : nullptr;
+    if (slot && !slot->empty()) {
+        return *slot;
+    }
+    for (const auto& texture : spec.textures) {
+        if (texture.texture_type == type) {
+            return texture.texture_path;
+        }
+    }
+    return "";
+}
+
+void MaterialPreviewRenderer::sampleTexture(const PreviewTexture& texture, const SphereGeometry& geometry, int channel,
+                                            float* out) {
+    // Nearest texel; at thumbnail size the reduced texture is close to one texel per pixel already
+    const size_t count = geometry.pixels.size();
+    const int c = std::min(channel, texture.channels - 1);
+    for (size_t i = 0; i < count; ++i) {
+        const int x = std::min(texture.width - 1, static_cast<int>(geometry.u[i] * texture.width));
+        const int y = std::min(texture.height - 1, static_cast<int>(geometry.v[i] * texture.height));
+        out[i] = texture.texels[(static_cast<size_t>(y) * texture.width + x) * texture.channels + c];
+    }
+}
+
+void MaterialPreviewRenderer::shadeLanes(const ShadingLanes& lanes, const ShadingConstants& constants, size_t count) {
+    /**
+     * @brief Shades count pixels: four at a time with SSE2, the remainder (or everything) with shadePixel.
+     *
+     * Both paths evaluate the same expressions in the same order; see shadePixel for the model.
+     */
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 min_roughness = _mm_set1_ps(0.045f);
+    const __m128 eighth = _mm_set1_ps(0.125f);
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    const __m128 pi = _mm_set1_ps(3.14159265f);
+    const __m128 inv_pi = _mm_set1_ps(1.0f / 3.14159265f);
+    const __m128 fresnel_h = _mm_set1_ps(constants.fresnel_h);
+    const __m128 dielectric_f0 = _mm_set1_ps(constants.dielectric_f0);
+    const __m128 diffuse_weight = _mm_set1_ps(constants.diffuse_weight);
+    const __m128 coat_scale = _mm_set1_ps(constants.clearcoat * 0.25f * (0.04f + 0.96f * constants.fresnel_h));
+    const __m128 coat_a2 = _mm_set1_ps(constants.clearcoat_a2);
+    const __m128 coat_k = _mm_set1_ps(constants.clearcoat_k);
+    const __m128 coat_one_minus_k = _mm_set1_ps(1.0f - constants.clearcoat_k);
+    __m128 light[3], ground[3], sky_minus_ground[3], average[3], emission[3];
+    for (int c = 0; c < 3; ++c) {
+        light[c] = _mm_set1_ps(constants.light[c]);
+        ground[c] = _mm_set1_ps(constants.ground[c]);
+        sky_minus_ground[c] = _mm_set1_ps(constants.sky[c] - constants.ground[c]);
+        average[c] = _mm_set1_ps(0.5f * (constants.sky[c] + constants.ground[c]));
+        emission[c] = _mm_set1_ps(constants.emission[c]);
+    }
+    for (; i + 4 <= count; i += 4) {
+        const __m128 n_dot_l = _mm_loadu_ps(lanes.ndotl + i);
+        const __m128 n_dot_v = _mm_loadu_ps(lanes.ndotv + i);
+        const __m128 n_dot_h = _mm_loadu_ps(lanes.ndoth + i);
+        const __m128 n_dot_h2 = _mm_mul_ps(n_dot_h, n_dot_h);
+        const __m128 roughness = _mm_min_ps(one, _mm_max_ps(min_roughness, _mm_loadu_ps(lanes.roughness + i)));
+        const __m128 alpha = _mm_mul_ps(roughness, roughness);
+        const __m128 a2 = _mm_mul_ps(alpha, alpha);
+
+        // GGX distribution and Smith-Schlick visibility
+        const __m128 d = _mm_add_ps(_mm_mul_ps(n_dot_h2, _mm_sub_ps(a2, one)), one);
+        const __m128 distribution = _mm_div_ps(a2, _mm_mul_ps(pi, _mm_mul_ps(d, d)));
+        const __m128 roughness_plus_one = _mm_add_ps(roughness, one);
+        const __m128 k = _mm_mul_ps(_mm_mul_ps(roughness_plus_one, roughness_plus_one), eighth);
+        const __m128 one_minus_k = _mm_sub_ps(one, k);
+        const __m128 visibility = _mm_div_ps(one, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(n_dot_l, one_minus_k), k),
+                                                             _mm_add_ps(_mm_mul_ps(n_dot_v, one_minus_k), k)));
+        const __m128 specular = _mm_mul_ps(_mm_mul_ps(distribution, visibility), _mm_mul_ps(quarter, n_dot_l));
+
+        // Clearcoat: fixed-roughness GGX lobe with F0 = 0.04, white
+        const __m128 dc = _mm_add_ps(_mm_mul_ps(n_dot_h2, _mm_sub_ps(coat_a2, one)), one);
+        const __m128 coat_distribution = _mm_div_ps(coat_a2, _mm_mul_ps(pi, _mm_mul_ps(dc, dc)));
+        const __m128 coat_visibility = _mm_div_ps(one, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(n_dot_l, coat_one_minus_k), coat_k),
+                                                                  _mm_add_ps(_mm_mul_ps(n_dot_v, coat_one_minus_k), coat_k)));
+        const __m128 coat = _mm_mul_ps(_mm_mul_ps(coat_scale, coat_distribution), _mm_mul_ps(coat_visibility, n_dot_l));
+
+        const __m128 metallic = _mm_min_ps(one, _mm_max_ps(zero, _mm_loadu_ps(lanes.metallic + i)));
+        const __m128 diffuse = _mm_mul_ps(_mm_sub_ps(one, metallic), diffuse_weight);
+        const __m128 ao = _mm_loadu_ps(lanes.ao + i);
+        const __m128 hemi_n = _mm_loadu_ps(lanes.hemi_n + i);
+        const __m128 hemi_r = _mm_loadu_ps(lanes.hemi_r + i);
+        const __m128 fresnel_v = _mm_mul_ps(_mm_loadu_ps(lanes.fresnel_v + i), _mm_sub_ps(one, roughness));
+
+        for (int c = 0; c < 3; ++c) {
+            const __m128 base = _mm_loadu_ps(lanes.albedo[c] + i);
+            const __m128 f0 = _mm_add_ps(dielectric_f0, _mm_mul_ps(_mm_sub_ps(base, dielectric_f0), metallic));
+            const __m128 one_minus_f0 = _mm_sub_ps(one, f0);
+            const __m128 fresnel = _mm_add_ps(f0, _mm_mul_ps(one_minus_f0, fresnel_h));
+            const __m128 ambient_fresnel = _mm_add_ps(f0, _mm_mul_ps(one_minus_f0, fresnel_v));
+            const __m128 env_n = _mm_add_ps(ground[c], _mm_mul_ps(sky_minus_ground[c], hemi_n));
+            __m128 env_r = _mm_add_ps(ground[c], _mm_mul_ps(sky_minus_ground[c], hemi_r));
+            env_r = _mm_add_ps(env_r, _mm_mul_ps(_mm_sub_ps(average[c], env_r), roughness));
+
+            const __m128 lambert = _mm_mul_ps(_mm_mul_ps(diffuse, _mm_sub_ps(one, fresnel)),
+                                              _mm_mul_ps(_mm_mul_ps(base, inv_pi), n_dot_l));
+            const __m128 direct = _mm_mul_ps(_mm_add_ps(_mm_add_ps(lambert, _mm_mul_ps(fresnel, specular)), coat), light[c]);
+            const __m128 ambient = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(diffuse, base), env_n),
+                                                         _mm_mul_ps(ambient_fresnel, env_r)), ao);
+            _mm_storeu_ps(lanes.out[c] + i, _mm_add_ps(_mm_add_ps(direct, ambient), emission[c]));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        shadePixel(lanes, constants, i);
+    }
+}
+
+void MaterialPreviewRenderer::shadePixel(const ShadingLanes& lanes, const ShadingConstants& constants, size_t i) {
+    /*
+     * Direct: (kd (1 - F) albedo / pi + F D Vis / 4 + clearcoat) N.L light, with kd = (1 - metallic)(1 - transmission)
+     * Ambient: (kd albedo sky(N) + F_ambient sky(R) blurred towards the average by roughness) AO
+     * F0 = lerp(0.08 specular, albedo, metallic); F uses V.H, F_ambient uses N.V faded by roughness
+     */
+    const float n_dot_l = lanes.ndotl[i];
+    const float n_dot_v = lanes.ndotv[i];
+    const float n_dot_h2 = lanes.ndoth[i] * lanes.ndoth[i];
+    const float roughness = std::clamp(lanes.roughness[i], 0.045f, 1.0f);
+    const float alpha = roughness * roughness;
+    const float a2 = alpha * alpha;
+
+    const float d = n_dot_h2 * (a2 - 1.0f) + 1.0f;
+    const float distribution = a2 / (3.14159265f * (d * d));
+    const float k = (roughness + 1.0f) * (roughness + 1.0f) * 0.125f;
+    const float visibility = 1.0f / ((n_dot_l * (1.0f - k) + k) * (n_dot_v * (1.0f - k) + k));
+    const float specular = (distribution * visibility) * (0.25f * n_dot_l);
+
+    const float coat_k = constants.clearcoat_k;
+    const float dc = n_dot_h2 * (constants.clearcoat_a2 - 1.0f) + 1.0f;
+    const float coat_distribution = constants.clearcoat_a2 / (3.14159265f * (dc * dc));
+    const float coat_visibility = 1.0f / ((n_dot_l * (1.0f - coat_k) + coat_k) * (n_dot_v * (1.0f - coat_k) + coat_k));
+    const float coat = (constants.clearcoat * 0.25f * (0.04f + 0.96f * constants.fresnel_h) * coat_distribution) *
+                       (coat_visibility * n_dot_l);
+
+    const float metallic = std::clamp(lanes.metallic[i], 0.0f, 1.0f);
+    const float diffuse = (1.0f - metallic) * constants.diffuse_weight;
+    const float fresnel_v = lanes.fresnel_v[i] * (1.0f - roughness);
+
+    for (int c = 0; c < 3; ++c) {
+        const float base = lanes.albedo[c][i];
+        const float f0 = constants.dielectric_f0 + (base - constants.dielectric_f0) * metallic;
+        const float fresnel = f0 + (1.0f - f0) * constants.fresnel_h;
+        const float ambient_fresnel = f0 + (1.0f - f0) * fresnel_v;
+        const float sky_minus_ground = constants.sky[c] - constants.ground[c];
+        const float env_n = constants.ground[c] + sky_minus_ground * lanes.hemi_n[i];
+        float env_r = constants.ground[c] + sky_minus_ground * lanes.hemi_r[i];
+        env_r += (0.5f * (constants.sky[c] + constants.ground[c]) - env_r) * roughness;
+
+        const float lambert = (diffuse * (1.0f - fresnel)) * ((base * (1.0f / 3.14159265f)) * n_dot_l);
+        const float direct = (lambert + fresnel * specular + coat) * constants.light[c];
+        const float ambient = ((diffuse * base) * env_n + ambient_fresnel * env_r) * lanes.ao[i];
+        lanes.out[c][i] = direct + ambient + constants.emission[c];
+    }
+}
+
+uint64_t MaterialPreviewRenderer::cacheKey(uint64_t key, int size) {
+    return (key ^ static_cast<uint64_t>(size)) * 1099511628211ull + static_cast<uint64_t>(size);
+}
+
+int MaterialPreviewRenderer::clampSize(int size) {
+    return std::clamp(size, kMinSize, kMaxSize);
+}
+
+} // namespace AssetManager
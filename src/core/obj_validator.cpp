@@ -0,0 +1,549 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: obj_validator.cpp
+ * Description: Implementation of OBJStreamValidator, the streaming OBJ geometry checker.
+ *
+ * Architecture:
+ * - scan() maps the file (or reads it in chunks) and feeds one line at a time to a Scanner
+ * - The Scanner keeps running element counts and a used-vertex bitset; nothing else grows with the file
+ *
+ * Key Features:
+ * - Numbers are validated without conversion: syntax, nan/inf spellings and decimal exponents past the
+ *   double range
+ * - Issue descriptions are only formatted for the first occurrence of each kind
+ */
+
+#include "obj_validator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace AssetManager {
+
+class OBJStreamValidator::Scanner {
+public:
+    OBJScanReport report;
+
+    void line(const char* begin, const char* end);
+    void finish();
+
+private:
+    enum class Number { Ok, NonFinite, Malformed };
+
+    uint64_t line_number_ = 0;
+    std::vector<uint64_t> used_;            // one bit per vertex
+    std::vector<uint64_t> corners_;         // resolved vertex indices of the current face
+
+    void values(const char* p, const char* end, const char* element, size_t min_count, size_t max_count);
+    static bool plainValues(const char* p, const char* end, size_t min_count, size_t max_count);
+    void references(const char* p, const char* end, const char* element, size_t min_corners, bool face);
+    bool resolve(const char*& p, const char* end, const char* element, const char* kind, uint64_t defined,
+                 uint64_t& resolved);
+    void markUsed(uint64_t vertex);
+
+    template <typename Describe>
+    void record(OBJIssueSample& sample, Describe describe) {
+        if (sample.count++ == 0) {
+            sample.first = describe();
+        }
+        if (sample.lines.size() < kSampleLines) {
+            sample.lines.push_back(line_number_);
+        }
+    }
+
+    static Number checkNumber(const char*& p, const char* end);
+    static bool isSpace(char c) { return static_cast<unsigned char>(c) <= ' '; }   // blanks and control bytes
+    static const char* skipSpace(const char* p, const char* end) {
+        while (p < end && isSpace(*p)) ++p;
+        return p;
+    }
+    static const char* tokenEnd(const char* p, const char* end) {
+        while (p < end && !isSpace(*p)) ++p;
+        return p;
+    }
+};
+
+void OBJStreamValidator::Scanner::line(const char* begin, const char* end) {
+    ++line_number_;
+    if (const void* comment = std::memchr(begin, '#', static_cast<size_t>(end - begin))) {
+        end = static_cast<const char*>(comment);
+    }
+    while (end > begin && isSpace(end[-1])) --end;
+    const char* p = skipSpace(begin, end);
+    if (p == end) {
+        return;
+    }
+    const char* keyword_end = tokenEnd(p, end);
+    size_t length = static_cast<size_t>(keyword_end - p);
+    const char* rest = skipSpace(keyword_end, end);
+
+    if (length == 1 && p[0] == 'v') {
+        ++report.vertices;
+        if (used_.size() * 64 < report.vertices) {
+            used_.push_back(0);
+        }
+        values(rest, end, "v", 3, 7);   // x y z [w], or x y z r g b
+    } else if (length == 2 && p[0] == 'v' && p[1] == 't') {
+        ++report.texcoords;
+        values(rest, end, "vt", 1, 3);
+    } else if (length == 2 && p[0] == 'v' && p[1] == 'n') {
+        ++report.normals;
+        values(rest, end, "vn", 3, 3);
+    } else if (length == 1 && p[0] == 'f') {
+        ++report.faces;
+        references(rest, end, "f", 3, true);
+    } else if (length == 1 && p[0] == 'l') {
+        references(rest, end, "l", 2, false);
+    } else if (length == 1 && p[0] == 'p') {
+        references(rest, end, "p", 1, false);
+    } else if (length == 6 && std::memcmp(p, "mtllib", 6) == 0) {
+        // One statement may name several libraries, separated by whitespace
+        for (const char* name = rest; name < end; name = skipSpace(tokenEnd(name, end), end)) {
+            report.material_libraries.emplace_back(name, tokenEnd(name, end));
+        }
+    }
+}
+
+void OBJStreamValidator::Scanner::finish() {
+    for (uint64_t vertex = 0; vertex < report.vertices; ++vertex) {
+        if (!(used_[vertex / 64] >> (vertex % 64) & 1)) {
+            if (report.unused_vertices++ == 0) {
+                report.first_unused_vertex = vertex + 1;
+            }
+        }
+    }
+    report.lines = line_number_;
+}
+
+void OBJStreamValidator::Scanner::values(const char* p, const char* end, const char* element, size_t min_count,
+                                         size_t max_count) {
+    if (plainValues(p, end, min_count, max_count)) {
+        return;
+    }
+    size_t count = 0;
+    while (p < end) {
+        const char* token = p;
+        Number number = checkNumber(p, end);
+        if (p < end && !isSpace(*p)) {
+            number = Number::Malformed;
+        }
+        if (number != Number::Ok) {
+            const char* token_end = tokenEnd(p, end);
+            record(number == Number::NonFinite ? report.non_finite : report.malformed, [&]() {
+                return "'" + std::string(token, token_end) + "' in " + element + " element";
+            });
+            return;
+        }
+        ++count;
+        p = skipSpace(p, end);
+    }
+    if (count < min_count || count > max_count) {
+        record(report.malformed, [&]() {
+            return std::string(element) + " element with " + std::to_string(count) + " values";
+        });
+    }
+}
+
+bool OBJStreamValidator::Scanner::plainValues(const char* p, const char* end, size_t min_count, size_t max_count) {
+    /*
+     * SSE2 fast path for the common v/vt/vn line: plain decimals like "-0.25 1.5 3" in up to 63 bytes.
+     * - The line is classified into whitespace, digit, '.' and '-' bitmasks, 16 bytes per op
+     * - Token rules become mask tests: '-' only at a token start, a digit in every token, one '.' per token
+     * - Without exponents or letters such a number cannot be NaN/Inf or overflow
+     * - Returns false for anything else (or without SSE2); values() then checks and reports token by token
+     */
+#if defined(__SSE2__)
+    size_t length = static_cast<size_t>(end - p);
+    if (length > 63) {
+        return false;
+    }
+    // Bytes past the line read as blanks; keep[16 - n] masks all but the first n bytes of a block
+    alignas(16) static const unsigned char keep[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    const __m128i blank = _mm_set1_epi8(' ');
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i period = _mm_set1_epi8('.');
+    const __m128i hyphen = _mm_set1_epi8('-');
+    uint64_t space = ~uint64_t(0), digit = 0, dot = 0, minus = 0;
+    alignas(16) char tail[16];
+    for (size_t offset = 0; offset < length; offset += 16) {
+        size_t remaining = std::min<size_t>(length - offset, 16);
+        const char* source = p + offset;
+        if (remaining < 16 && (reinterpret_cast<uintptr_t>(source) & 4095) > 4096 - 16) {
+            std::memcpy(tail, source, remaining);   // a full load could cross into an unmapped page
+            source = tail;
+        }
+        __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keep + 16 - remaining));
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        bytes = _mm_or_si128(_mm_and_si128(mask, bytes), _mm_andnot_si128(mask, blank));
+        __m128i digits = _mm_sub_epi8(bytes, zero);
+        int shift = static_cast<int>(offset);
+        uint64_t block_space = static_cast<uint16_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(bytes, blank), bytes)));
+        space &= ~(uint64_t(0xFFFF) << shift) | (block_space << shift);
+        digit |= static_cast<uint64_t>(static_cast<uint16_t>(
+                     _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(digits, nine), digits)))) << shift;
+        dot |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, period)))) << shift;
+        minus |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, hyphen)))) << shift;
+    }
+    if ((space | digit | dot | minus) != ~uint64_t(0)) {
+        return false;
+    }
+    uint64_t token = ~space;
+    uint64_t starts = token & ((space << 1) | 1);
+    uint64_t ends = token & (space >> 1);       // byte 63 is always padding
+    uint64_t other = token & ~digit;            // '.' or '-'
+    if ((minus & ~starts) || (starts & other & ends) || (starts & other & ((other & ends) >> 1))) {
+        return false;
+    }
+    for (uint64_t dots = dot; dots; dots &= dots - 1) {
+        uint64_t first = dots & (~dots + 1);
+        uint64_t rest = dots & (dots - 1);
+        uint64_t next = rest & (~rest + 1);
+        if (next && !((next - 1) & ~((first << 1) - 1) & space)) {
+            return false;                       // two dots in one token
+        }
+    }
+    size_t count = 0;
+    for (; starts; starts &= starts - 1) {
+        ++count;
+    }
+    return count >= min_count && count <= max_count;
+#else
+    (void)p;
+    (void)end;
+    (void)min_count;
+    (void)max_count;
+    return false;
+#endif
+}
+
+void OBJStreamValidator::Scanner::references(const char* p, const char* end, const char* element,
+                                             size_t min_corners, bool face) {
+    /*
+     * Corners are v, v/vt, v//vn or v/vt/vn.
+     * - Every component is checked; only the vertex component feeds the used-vertex and degeneracy checks
+     */
+    corners_.clear();
+    size_t corner_count = 0;
+    uint64_t ignored = 0;
+    while (p < end) {
+        ++corner_count;
+        uint64_t vertex = 0;
+        if (resolve(p, end, element, "vertex", report.vertices, vertex)) {
+            corners_.push_back(vertex);
+            markUsed(vertex);
+        }
+        if (p < end && *p == '/') {
+            ++p;
+            if (p < end && *p != '/') {
+                resolve(p, end, element, "texture coordinate", report.texcoords, ignored);
+            }
+            if (p < end && *p == '/') {
+                ++p;
+                resolve(p, end, element, "normal", report.normals, ignored);
+            }
+        }
+        p = skipSpace(tokenEnd(p, end), end);
+    }
+
+    if (corner_count < min_corners) {
+        record(face ? report.short_faces : report.malformed, [&]() {
+            return std::string(face ? "face" : std::string(element) + " element") + " with " +
+                   std::to_string(corner_count) + (face ? " corners" : " indices");
+        });
+        return;
+    }
+    if (!face) {
+        return;
+    }
+    // Triangles and quads dominate; compare pairwise and only sort larger polygons
+    size_t count = corners_.size();
+    uint64_t repeated = 0;
+    if (count <= 4) {
+        for (size_t a = 0; a < count && !repeated; ++a) {
+            for (size_t b = a + 1; b < count; ++b) {
+                if (corners_[a] == corners_[b]) {
+                    repeated = corners_[a];
+                    break;
+                }
+            }
+        }
+    } else {
+        std::sort(corners_.begin(), corners_.end());
+        auto found = std::adjacent_find(corners_.begin(), corners_.end());
+        repeated = found != corners_.end() ? *found : 0;
+    }
+    if (repeated) {
+        record(report.degenerate_faces, [&]() {
+            return "face uses vertex " + std::to_string(repeated) + " more than once";
+        });
+    }
+}
+
+bool OBJStreamValidator::Scanner::resolve(const char*& p, const char* end, const char* element, const char* kind,
+                                          uint64_t defined, uint64_t& resolved) {
+    /**
+     * @brief Resolves one index component against the elements defined so far.
+     *
+     * @param p Start of the component; advanced to the following '/' or whitespace.
+     * @param resolved Receives the 1-based absolute index.
+     * @return False (and records the issue) for malformed, zero or out-of-range indices.
+     */
+    const char* token = p;
+    bool negative = p < end && *p == '-';
+    if (negative) ++p;
+    const char* digits = p;
+    uint64_t value = 0;
+    for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p) {
+        value = std::min<uint64_t>(value * 10 + static_cast<uint64_t>(*p - '0'), UINT64_MAX / 16);
+    }
+    if (p == digits || (p < end && *p != '/' && !isSpace(*p))) {
+        while (p < end && *p != '/' && !isSpace(*p)) ++p;
+        record(report.malformed, [&]() {
+            return "'" + std::string(token, p) + "' as " + kind + " index in " + element + " element";
+        });
+        return false;
+    }
+    if (value == 0) {
+        record(report.zero_index, [&]() { return std::string(kind) + " index 0 in " + element + " element"; });
+        return false;
+    }
+    if (value > defined) {
+        record(report.index_out_of_range, [&]() {
+            return std::string(kind) + " index " + std::string(token, p) + " with " + std::to_string(defined) +
+                   " defined";
+        });
+        return false;
+    }
+    resolved = negative ? defined - value + 1 : value;
+    return true;
+}
+
+void OBJStreamValidator::Scanner::markUsed(uint64_t vertex) {
+    uint64_t bit = vertex - 1;
+    used_[bit / 64] |= uint64_t(1) << (bit % 64);
+}
+
+OBJStreamValidator::Scanner::Number OBJStreamValidator::Scanner::checkNumber(const char*& p, const char* end) {
+    /*
+     * [+-]digits[.digits][(e|E)[+-]digits], or [+-]digits. / [+-].digits; p is left after the number.
+     * - nan and inf spellings (any case, with suffixes like "nan(ind)") are NonFinite
+     * - A decimal exponent past 308 would convert to infinity, so it is NonFinite too
+     */
+    if (p < end && (*p == '+' || *p == '-')) ++p;
+    if (p < end && (*p == 'n' || *p == 'N' || *p == 'i' || *p == 'I')) {
+        char word[3] = {0, 0, 0};
+        for (size_t i = 0; i < 3 && p + i < end; ++i) {
+            word[i] = static_cast<char>(p[i] | 0x20);
+        }
+        bool spelled = std::memcmp(word, "nan", 3) == 0 || std::memcmp(word, "inf", 3) == 0;
+        p = tokenEnd(p, end);
+        return spelled ? Number::NonFinite : Number::Malformed;
+    }
+
+    int64_t magnitude = 0;          // decimal exponent of the leading significant digit
+    bool significant = false;
+    const char* digits = p;
+    for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p) {
+        magnitude += significant;
+        significant |= *p != '0';
+    }
+    bool any_digit = p != digits;
+    if (p < end && *p == '.') {
+        ++p;
+        const char* fraction = p;
+        if (!significant) {
+            for (; p < end && *p == '0'; ++p) --magnitude;
+            significant = p < end && static_cast<unsigned>(*p - '0') < 10;
+            magnitude -= significant;
+        }
+        while (p < end && static_cast<unsigned>(*p - '0') < 10) ++p;
+        any_digit |= p != fraction;
+    }
+    if (!any_digit) {
+        return Number::Malformed;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negative = p < end && *p == '-';
+        if (p < end && (*p == '+' || *p == '-')) ++p;
+        const char* exponent_digits = p;
+        int64_t exponent = 0;
+        for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p) {
+            exponent = std::min<int64_t>(exponent * 10 + (*p - '0'), 100000);
+        }
+        if (p == exponent_digits) {
+            return Number::Malformed;
+        }
+        magnitude += negative ? -exponent : exponent;
+    }
+    return significant && magnitude > 308 ? Number::NonFinite : Number::Ok;
+}
+
+OBJScanReport OBJStreamValidator::scan(const std::string& path) {
+    /**
+     * @brief Checks an OBJ file in one pass.
+     *
+     * @param path OBJ file.
+     * @return Report; opened is false if the file could not be read.
+     */
+    auto start = std::chrono::steady_clock::now();
+    Scanner scanner;
+    scanner.report.opened = scanMapped(path, scanner) || scanBuffered(path, scanner);
+    scanner.finish();
+    scanner.report.scan_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return scanner.report;
+}
+
+OBJScanReport OBJStreamValidator::scanBuffer(const char* begin, const char* end) {
+    Scanner scanner;
+    scanner.report.opened = true;
+    scanner.report.bytes = static_cast<uint64_t>(end - begin);
+    for (const char* p = begin; p < end;) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        scanner.line(p, newline ? newline : end);
+        p = newline ? newline + 1 : end;
+    }
+    scanner.finish();
+    return scanner.report;
+}
+
+bool OBJStreamValidator::scanMapped(const std::string& path, Scanner& scanner) {
+    /*
+     * Read-only private mapping, scanned front to back.
+     * - No MAP_POPULATE: the file may be far larger than memory
+     * - Every kReleaseWindow bytes the pages already scanned are dropped, keeping the resident set bounded
+     */
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+    size_t length = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    ::madvise(mapping, length, MADV_SEQUENTIAL);
+#endif
+
+    const char* begin = static_cast<const char*>(mapping);
+    const char* end = begin + length;
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t released = 0;
+    for (const char* p = begin; p < end;) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        scanner.line(p, newline ? newline : end);
+        p = newline ? newline + 1 : end;
+
+        size_t offset = static_cast<size_t>(p - begin);
+        if (offset - released >= kReleaseWindow) {
+            size_t release_end = offset / page * page;
+#ifdef MADV_DONTNEED
+            ::madvise(const_cast<char*>(begin) + released, release_end - released, MADV_DONTNEED);
+#endif
+            released = release_end;
+        }
+    }
+    ::munmap(mapping, length);
+    scanner.report.bytes = length;
+    return true;
+}
+
+std::vector<std::string> OBJStreamValidator::materialLibraries(const std::string& path) {
+    /**
+     * @brief Reads the mtllib names an OBJ declares before its geometry.
+     *
+     * Exporters write mtllib ahead of the first vertex, so the rest of the file, which can be
+     * gigabytes, is never read; callers that need it in the page cache advise the kernel instead.
+     *
+     * @param path OBJ file.
+     * @return Library names in file order; empty if the file cannot be read.
+     */
+    std::vector<std::string> libraries;
+    std::ifstream file(path, std::ios::binary);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line.substr(0, line.find('#')));
+        std::string keyword;
+        iss >> keyword;
+        if (keyword == "v" || keyword == "vt" || keyword == "vn" || keyword == "vp" ||
+            keyword == "f" || keyword == "l" || keyword == "p") {
+            break;
+        }
+        if (keyword == "mtllib") {
+            // One statement may name several libraries, separated by whitespace
+            std::string name;
+            while (iss >> name) {
+                libraries.push_back(name);
+            }
+        }
+    }
+    return libraries;
+}
+
+bool OBJStreamValidator::scanBuffered(const std::string& path, Scanner& scanner) {
+    /* Fallback for files that cannot be mapped; a line split across chunks is carried over. */
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<char> chunk(kReadChunk);
+    std::string carry;
+    uint64_t bytes = 0;
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        size_t size = static_cast<size_t>(file.gcount());
+        if (size == 0) {
+            break;
+        }
+        bytes += size;
+        const char* p = chunk.data();
+        const char* end = p + size;
+        while (p < end) {
+            const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (!newline) {
+                carry.append(p, end);
+                break;
+            }
+            if (carry.empty()) {
+                scanner.line(p, newline);
+            } else {
+                carry.append(p, newline);
+                scanner.line(carry.data(), carry.data() + carry.size());
+                carry.clear();
+            }
+            p = newline + 1;
+        }
+    }
+    if (!carry.empty()) {
+        scanner.line(carry.data(), carry.data() + carry.size());
+    }
+    scanner.report.bytes = bytes;
+    return !file.bad();
+}
+
+} // namespace AssetManager
@@ -1105,6 +1105,7 @@ std::map<std::string, std::string> PythonBridge::convertImportOptionsToMap(const
     map["auto_smooth"] = options.auto_smooth ? "true" : "false";
     map["collection_name"] = options.collection_name;
     map["link_instead_of_import"] = options.link_instead_of_import ? "true" : "false";
+    map["scene_file"] = options.scene_file;
     return map;
 }
 
@@ -1150,6 +1151,9 @@ AssetManager::ImportOptions PythonBridge::convertMapToImportOptions(const std::m
     if (options.find("link_instead_of_import") != options.end()) {
         import_options.link_instead_of_import = options.at("link_instead_of_import") == "true";
     }
+    if (options.find("scene_file") != options.end()) {
+        import_options.scene_file = options.at("scene_file");
+    }
     
     return import_options;
 }
@@ -1165,6 +1169,7 @@ PythonResult PythonBridge::convertImportResultToMap(const AssetManager::ImportRe
     python_result.success = result.success;
     python_result.message = result.message;
     python_result.data["asset_path"] = result.asset_path;
+    python_result.data["scene_file"] = result.scene_file;
     python_result.list_data = result.imported_objects;
     return python_result;
 }
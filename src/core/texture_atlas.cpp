@@ -0,0 +1,399 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: texture_atlas.cpp
+ * Description: Implementation of the TextureAtlasBuilder class for baking texture sets into shared atlas pages.
+ *
+ * Architecture:
+ * - Pass 1 reads only the source headers to size every item and packs all rectangles into pages
+ * - Pass 2 bakes one page at a time, decoding each item's sources right before they are copied in,
+ *   so peak memory is one page per channel plus one item
+ *
+ * Key Features:
+ * - The padded rectangle, not just the item, is filled: gutters and alignment slack repeat the edge texels
+ * - Items that cannot be read are reported per placement and do not fail the rest of the group
+ */
+
+#include "texture_atlas.hpp"
+#include "texture_probe.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <nlohmann/json.hpp>
+
+// ImGui's skyline packer, compiled privately into this translation unit (imgui_draw.cpp does the same)
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "../../dependencies/imgui/imstb_rectpack.h"
+
+using json = nlohmann::json;
+
+namespace AssetManager {
+
+TextureAtlasBuilder::TextureAtlasBuilder(TextureAtlasOptions options)
+    : options_(std::move(options)) {
+    options_.mip_levels = std::clamp(options_.mip_levels, 0, 8);
+    options_.padding = std::max(options_.padding, 0);
+    options_.page_size = std::max(options_.page_size, 1 << options_.mip_levels);
+    options_.max_item_size = std::max(options_.max_item_size, 1);
+}
+
+const std::vector<std::string>& TextureAtlasBuilder::pageChannels() {
+    static const std::vector<std::string> channels = {"base_color", "normal", "orm"};
+    return channels;
+}
+
+TextureAtlasResult TextureAtlasBuilder::build(const std::vector<TextureAtlasItem>& items) const {
+    /**
+     * @brief Packs the items into atlas pages, bakes the pages and writes the UV remap table.
+     *
+     * @param items One entry per texture set of the group.
+     * @return Pages, one placement per item in input order, and the table path.
+     */
+    TextureAtlasResult result;
+    result.placements.resize(items.size());
+    if (options_.cache_root.empty()) {
+        result.message = "No atlas cache root configured";
+        return result;
+    }
+
+    // Padding rounded up to the mip block keeps every item's origin block-aligned
+    const int alignment = 1 << options_.mip_levels;
+    const int pad = alignUp(std::max(options_.padding, alignment), alignment);
+    const int max_edge = std::min(options_.max_item_size, options_.page_size - 2 * pad);
+    if (max_edge < 1) {
+        result.message = "Atlas page too small for the configured padding";
+        return result;
+    }
+
+    std::vector<stbrp_rect> pending;
+    for (size_t i = 0; i < items.size(); ++i) {
+        TextureAtlasPlacement& placement = result.placements[i];
+        placement.name = items[i].name;
+        int width = 0;
+        int height = 0;
+        if (!measureItem(items[i], width, height, placement.message)) {
+            continue;
+        }
+        if (std::max(width, height) > max_edge) {
+            double scale = static_cast<double>(max_edge) / std::max(width, height);
+            width = std::max(1, static_cast<int>(std::lround(width * scale)));
+            height = std::max(1, static_cast<int>(std::lround(height * scale)));
+        }
+        placement.width = width;
+        placement.height = height;
+        stbrp_rect rect{};
+        rect.id = static_cast<int>(i);
+        rect.w = alignUp(width + 2 * pad, alignment);
+        rect.h = alignUp(height + 2 * pad, alignment);
+        pending.push_back(rect);
+    }
+
+    // Fill one page at a time with whatever still fits, largest-height-first (the packer sorts internally)
+    std::vector<std::vector<stbrp_rect>> pages;
+    std::vector<stbrp_node> nodes(static_cast<size_t>(options_.page_size));
+    while (!pending.empty()) {
+        stbrp_context context;
+        stbrp_init_target(&context, options_.page_size, options_.page_size, nodes.data(), static_cast<int>(nodes.size()));
+        stbrp_setup_heuristic(&context, STBRP_HEURISTIC_Skyline_BF_sortHeight);
+        stbrp_pack_rects(&context, pending.data(), static_cast<int>(pending.size()));
+        std::vector<stbrp_rect> packed;
+        std::vector<stbrp_rect> remaining;
+        for (const auto& rect : pending) {
+            (rect.was_packed ? packed : remaining).push_back(rect);
+        }
+        if (packed.empty()) {
+            break;      // cannot happen with items capped to the page, but never loop forever
+        }
+        pages.push_back(std::move(packed));
+        pending.swap(remaining);
+    }
+
+    std::filesystem::path directory = std::filesystem::path(options_.cache_root) / options_.name;
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        result.message = "Cannot create " + directory.string() + ": " + ec.message();
+        return result;
+    }
+
+    std::set<std::string> source_files;
+    for (size_t p = 0; p < pages.size(); ++p) {
+        TextureAtlasPage page;
+        page.index = static_cast<int>(p);
+        page.material_name = options_.name + "_atlas_" + std::to_string(p);
+        int used_width = 0;
+        int used_height = 0;
+        for (const auto& rect : pages[p]) {
+            used_width = std::max(used_width, rect.x + rect.w);
+            used_height = std::max(used_height, rect.y + rect.h);
+        }
+        page.width = cropExtent(used_width, alignment, options_.page_size);
+        page.height = cropExtent(used_height, alignment, options_.page_size);
+
+        std::map<std::string, ImageBuffer> buffers;
+        for (const auto& channel : pageChannels()) {
+            ImageBuffer& buffer = buffers[channel];
+            buffer.width = page.width;
+            buffer.height = page.height;
+            buffer.channels = channelCount(channel);
+            buffer.bytes.resize(buffer.sampleCount());
+            const uint8_t* neutral = neutralTexel(channel);
+            for (size_t t = 0; t < buffer.bytes.size(); t += buffer.channels) {
+                std::copy(neutral, neutral + buffer.channels, buffer.bytes.begin() + t);
+            }
+        }
+
+        bool baked_any = false;
+        for (const auto& rect : pages[p]) {
+            TextureAtlasPlacement& placement = result.placements[rect.id];
+            std::map<std::string, ImageBuffer> images;
+            if (!loadItem(items[rect.id], placement.width, placement.height, images, placement.message)) {
+                continue;
+            }
+            placement.page = page.index;
+            placement.x = rect.x + pad;
+            placement.y = rect.y + pad;
+            for (const auto& channel : pageChannels()) {
+                blitWithGutter(images[channel], buffers[channel], placement.x, placement.y, rect.x, rect.y, rect.w, rect.h);
+            }
+            // Image rows run top-down, Blender's V runs bottom-up
+            placement.u_scale = static_cast<float>(placement.width) / page.width;
+            placement.v_scale = static_cast<float>(placement.height) / page.height;
+            placement.u_offset = static_cast<float>(placement.x) / page.width;
+            placement.v_offset = static_cast<float>(page.height - placement.y - placement.height) / page.height;
+            for (const auto& source : items[rect.id].channels) {
+                source_files.insert(source.second);
+            }
+            ++result.source_materials;
+            baked_any = true;
+        }
+        if (!baked_any) {
+            continue;
+        }
+
+        for (const auto& channel : pageChannels()) {
+            std::string path = (directory / ("page" + std::to_string(p) + "_" + channel + ".png")).string();
+            std::string error;
+            if (!TextureProcessor::encode(path, buffers[channel], error)) {
+                result.message = error;
+                return result;
+            }
+            page.textures[channel] = path;
+        }
+        result.pages.push_back(std::move(page));
+    }
+    result.source_textures = source_files.size();
+
+    if (result.pages.empty()) {
+        result.message = "No textures could be baked into the atlas";
+        return result;
+    }
+    result.table_path = (directory / "atlas.json").string();
+    if (!writeTable(result, result.table_path, result.message)) {
+        return result;
+    }
+    result.success = true;
+    result.message = "Baked " + std::to_string(result.source_materials) + " texture sets (" +
+                     std::to_string(result.source_textures) + " textures) into " +
+                     std::to_string(result.pages.size()) + " atlas pages";
+    return result;
+}
+
+bool TextureAtlasBuilder::measureItem(const TextureAtlasItem& item, int& width, int& height, std::string& error) const {
+    // The largest source sets the item size, like ORM packing does
+    width = 0;
+    height = 0;
+    for (const auto& source : item.channels) {
+        if (source.second.empty()) {
+            continue;
+        }
+        TextureHeader header;
+        if (!TextureHeaderProbe::probe(source.second, header) || header.width <= 0 || header.height <= 0) {
+            error = "Cannot read texture header: " + source.second;
+            return false;
+        }
+        if (static_cast<int64_t>(header.width) * header.height > static_cast<int64_t>(width) * height) {
+            width = header.width;
+            height = header.height;
+        }
+    }
+    if (width == 0) {
+        error = "No textures to bake";
+        return false;
+    }
+    return true;
+}
+
+bool TextureAtlasBuilder::loadItem(const TextureAtlasItem& item, int width, int height,
+                                   std::map<std::string, ImageBuffer>& images, std::string& error) const {
+    /**
+     * @brief Decodes an item's sources as 8-bit page channels of the planned size.
+     *
+     * @param item Source textures by channel.
+     * @param width Item width in the atlas.
+     * @param height Item height in the atlas.
+     * @param images Receives "base_color" (RGBA), "normal" (RGB) and "orm" (RGB).
+     * @param error Receives the first decode failure.
+     * @return True when every present source decoded.
+     */
+    auto load = [&](const std::string& key, int channels, ImageBuffer& image) {
+        auto it = item.channels.find(key);
+        if (it == item.channels.end() || it->second.empty()) {
+            return true;
+        }
+        ImageBuffer decoded;
+        if (!TextureProcessor::decode(it->second, decoded, error)) {
+            return false;
+        }
+        if (decoded.width != width || decoded.height != height) {
+            decoded = TextureProcessor::resize(decoded, width, height, ResampleFilter::Lanczos3);
+        }
+        image = toBytes(decoded, channels);
+        return true;
+    };
+
+    for (const auto& channel : pageChannels()) {
+        ImageBuffer& image = images[channel];
+        if (!load(channel, channelCount(channel), image)) {
+            return false;
+        }
+        if (!image.empty()) {
+            continue;
+        }
+        image.width = width;
+        image.height = height;
+        image.channels = channelCount(channel);
+        image.bytes.resize(image.sampleCount());
+        const uint8_t* neutral = neutralTexel(channel);
+        for (size_t t = 0; t < image.bytes.size(); t += image.channels) {
+            std::copy(neutral, neutral + image.channels, image.bytes.begin() + t);
+        }
+    }
+
+    // No packed ORM: build it from whichever grey maps exist, the rest stay neutral
+    if (!item.channels.count("orm") || item.channels.at("orm").empty()) {
+        const char* maps[3] = {"ao", "roughness", "metallic"};
+        ImageBuffer& orm = images["orm"];
+        for (int k = 0; k < 3; ++k) {
+            ImageBuffer grey;
+            if (!load(maps[k], 1, grey)) {
+                return false;
+            }
+            if (grey.empty()) {
+                continue;
+            }
+            const size_t pixels = static_cast<size_t>(width) * height;
+            for (size_t t = 0; t < pixels; ++t) {
+                orm.bytes[t * 3 + k] = grey.bytes[t];
+            }
+        }
+    }
+    return true;
+}
+
+ImageBuffer TextureAtlasBuilder::toBytes(const ImageBuffer& image, int channels) {
+    // Grey expands to RGB, missing alpha is opaque, float samples are clamped to [0, 1]
+    ImageBuffer out;
+    out.width = image.width;
+    out.height = image.height;
+    out.channels = channels;
+    out.bytes.resize(out.sampleCount());
+    const size_t pixels = static_cast<size_t>(image.width) * image.height;
+    const int source_channels = image.channels;
+    auto sample = [&image](size_t index) -> uint8_t {
+        if (image.is_float) {
+            return static_cast<uint8_t>(std::clamp(image.floats[index], 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+        return image.bytes[index];
+    };
+    for (size_t t = 0; t < pixels; ++t) {
+        const size_t source = t * source_channels;
+        uint8_t* target = &out.bytes[t * channels];
+        const bool grey = source_channels < 3;
+        for (int c = 0; c < std::min(channels, 3); ++c) {
+            target[c] = sample(source + (grey ? 0 : c));
+        }
+        if (channels == 4) {
+            const int alpha = grey ? 1 : 3;
+            target[3] = alpha < source_channels ? sample(source + alpha) : 255;
+        }
+    }
+    return out;
+}
+
+void TextureAtlasBuilder::blitWithGutter(const ImageBuffer& image, ImageBuffer& page, int x, int y,
+                                         int rect_x, int rect_y, int rect_width, int rect_height) {
+    // Every texel of the padded rectangle takes the nearest item texel, so filtering and mips see edge colours
+    const int channels = page.channels;
+    const int rect_right = std::min(rect_x + rect_width, page.width);
+    const int rect_bottom = std::min(rect_y + rect_height, page.height);
+    for (int py = rect_y; py < rect_bottom; ++py) {
+        const int sy = std::clamp(py - y, 0, image.height - 1);
+        const uint8_t* source_row = &image.bytes[static_cast<size_t>(sy) * image.width * channels];
+        uint8_t* target_row = &page.bytes[static_cast<size_t>(py) * page.width * channels];
+        for (int px = rect_x; px < rect_right; ++px) {
+            const int sx = std::clamp(px - x, 0, image.width - 1);
+            std::copy(source_row + sx * channels, source_row + (sx + 1) * channels, target_row + px * channels);
+        }
+    }
+}
+
+int TextureAtlasBuilder::channelCount(const std::string& channel) {
+    return channel == "base_color" ? 4 : 3;
+}
+
+const uint8_t* TextureAtlasBuilder::neutralTexel(const std::string& channel) {
+    static const uint8_t white[4] = {255, 255, 255, 255};
+    static const uint8_t flat_normal[3] = {128, 128, 255};
+    static const uint8_t orm[3] = {255, 128, 0};
+    if (channel == "normal") {
+        return flat_normal;
+    }
+    return channel == "orm" ? orm : white;
+}
+
+int TextureAtlasBuilder::alignUp(int value, int alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+int TextureAtlasBuilder::cropExtent(int used, int alignment, int limit) {
+    // Smallest power of two (at least one mip block) that holds the used extent
+    int extent = alignment;
+    while (extent < used && extent < limit) {
+        extent *= 2;
+    }
+    return std::min(extent, limit);
+}
+
+bool TextureAtlasBuilder::writeTable(const TextureAtlasResult& result, const std::string& path, std::string& error) const {
+    json table;
+    table["name"] = options_.name;
+    table["pages"] = json::array();
+    for (const auto& page : result.pages) {
+        table["pages"].push_back({{"index", page.index}, {"width", page.width}, {"height", page.height},
+                                  {"material", page.material_name}, {"textures", page.textures}});
+    }
+    table["items"] = json::array();
+    for (const auto& placement : result.placements) {
+        if (placement.page < 0) {
+            continue;
+        }
+        table["items"].push_back({{"name", placement.name}, {"page", placement.page},
+                                  {"x", placement.x}, {"y", placement.y},
+                                  {"width", placement.width}, {"height", placement.height},
+                                  {"u_scale", placement.u_scale}, {"v_scale", placement.v_scale},
+                                  {"u_offset", placement.u_offset}, {"v_offset", placement.v_offset}});
+    }
+    std::ofstream file(path);
+    if (!file) {
+        error = "Cannot write atlas table: " + path;
+        return false;
+    }
+    file << table.dump(2);
+    return static_cast<bool>(file);
+}
+
+} // namespace AssetManager
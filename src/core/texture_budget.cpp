@@ -0,0 +1,180 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: texture_budget.cpp
+ * Description: Implementation of the TextureBudgetPlanner class for texture-memory estimates of import batches.
+ *
+ * Architecture:
+ * - One pass over the batch's dependency closures collects unique textures (absolute, normalized paths)
+ * - A max-heap keyed by current footprint drives the downgrade loop; each pop steps one texture down one variant
+ *
+ * Key Features:
+ * - Deterministic: equal footprints are broken by discovery order, so the same batch always plans the same way
+ * - Never picks a variant that is not smaller than what is already planned
+ */
+
+#include "texture_budget.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <queue>
+#include <set>
+#include <unordered_map>
+
+namespace AssetManager {
+
+TextureBudgetPlanner::TextureBudgetPlanner(ClosureResolver closure, TextureDescriber describe, VariantResolver variants)
+    : closure_(std::move(closure)), describe_(std::move(describe)), variants_(std::move(variants)) {
+}
+
+void TextureBudgetPlanner::setMemoryModel(const TextureMemoryModel& model) {
+    model_ = model;
+}
+
+const TextureMemoryModel& TextureBudgetPlanner::getMemoryModel() const {
+    return model_;
+}
+
+uint64_t TextureBudgetPlanner::estimateBytes(const TextureFootprint& texture) const {
+    /**
+     * @brief Estimates the memory one loaded texture occupies.
+     *
+     * Blender promotes HDR and more-than-8-bit images to float buffers, so those cost 4 bytes per channel.
+     *
+     * @param texture Dimensions, channels and bit depth.
+     * @return Estimated bytes, 0 if the dimensions are unknown.
+     */
+    if (texture.width <= 0 || texture.height <= 0) {
+        return 0;
+    }
+    const uint64_t channels = model_.pad_to_rgba ? 4 : static_cast<uint64_t>(std::max(1, texture.channels));
+    const uint64_t bytes_per_channel = (texture.is_hdr || texture.bit_depth > 8) ? 4 : 1;
+    uint64_t bytes = static_cast<uint64_t>(texture.width) * static_cast<uint64_t>(texture.height) *
+                     channels * bytes_per_channel;
+    if (model_.include_mipmaps) {
+        bytes += bytes / 3;
+    }
+    return bytes;
+}
+
+TextureBudgetPlan TextureBudgetPlanner::plan(const std::vector<std::string>& asset_paths, uint64_t budget_bytes) const {
+    /**
+     * @brief Estimates a batch's texture memory and substitutes variants until it fits the budget.
+     *
+     * @param asset_paths Assets of the import batch (duplicates are counted once).
+     * @param budget_bytes Texture-memory budget; 0 only estimates.
+     * @return Plan with estimates, substitutions and downgraded assets.
+     */
+    struct Candidate {
+        TextureBudgetEntry entry;
+        std::vector<TextureFootprint> variants;     // largest first, all smaller than the source
+        size_t next_variant = 0;
+    };
+
+    TextureBudgetPlan plan;
+    plan.budget_bytes = budget_bytes;
+    std::vector<Candidate> candidates;
+    std::unordered_map<std::string, size_t> by_path;
+    std::set<std::string> unknown;
+    std::set<std::string> seen_assets;
+
+    for (const auto& asset_path : asset_paths) {
+        if (!seen_assets.insert(asset_path).second) {
+            continue;
+        }
+        std::vector<std::string> closure = closure_ ? closure_(asset_path) : std::vector<std::string>{asset_path};
+        for (const auto& file : closure) {
+            std::string key = std::filesystem::absolute(file).lexically_normal().string();
+            TextureFootprint texture;
+            if (!describe_ || !describe_(key, texture)) {
+                continue;
+            }
+            if (texture.width <= 0 || texture.height <= 0) {
+                unknown.insert(key);
+                continue;
+            }
+
+            auto inserted = by_path.emplace(key, candidates.size());
+            if (inserted.second) {
+                Candidate candidate;
+                candidate.entry.texture_path = key;
+                candidate.entry.planned_path = key;
+                candidate.entry.width = candidate.entry.planned_width = texture.width;
+                candidate.entry.height = candidate.entry.planned_height = texture.height;
+                candidate.entry.estimated_bytes = candidate.entry.planned_bytes = estimateBytes(texture);
+                if (variants_) {
+                    for (auto variant : variants_(key)) {
+                        if (estimateBytes(variant) > 0 && estimateBytes(variant) < candidate.entry.estimated_bytes) {
+                            // Blender resolves relative paths against its own working directory
+                            variant.path = std::filesystem::absolute(variant.path).lexically_normal().string();
+                            candidate.variants.push_back(variant);
+                        }
+                    }
+                    std::stable_sort(candidate.variants.begin(), candidate.variants.end(),
+                                     [this](const TextureFootprint& a, const TextureFootprint& b) {
+                                         return estimateBytes(a) > estimateBytes(b);
+                                     });
+                }
+                plan.estimated_bytes += candidate.entry.estimated_bytes;
+                candidates.push_back(std::move(candidate));
+            }
+            std::vector<std::string>& used_by = candidates[inserted.first->second].entry.used_by;
+            if (used_by.empty() || used_by.back() != asset_path) {
+                used_by.push_back(asset_path);
+            }
+        }
+    }
+
+    // Step the largest texture down one variant at a time until the batch fits
+    plan.planned_bytes = plan.estimated_bytes;
+    if (budget_bytes > 0 && plan.planned_bytes > budget_bytes) {
+        auto order = [](const std::pair<uint64_t, size_t>& a, const std::pair<uint64_t, size_t>& b) {
+            return a.first != b.first ? a.first < b.first : a.second > b.second;
+        };
+        std::priority_queue<std::pair<uint64_t, size_t>, std::vector<std::pair<uint64_t, size_t>>, decltype(order)> queue(order);
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (!candidates[i].variants.empty()) {
+                queue.emplace(candidates[i].entry.planned_bytes, i);
+            }
+        }
+        while (plan.planned_bytes > budget_bytes && !queue.empty()) {
+            Candidate& candidate = candidates[queue.top().second];
+            queue.pop();
+            while (candidate.next_variant < candidate.variants.size()) {
+                const TextureFootprint& variant = candidate.variants[candidate.next_variant++];
+                uint64_t bytes = estimateBytes(variant);
+                if (bytes >= candidate.entry.planned_bytes) {
+                    continue;
+                }
+                plan.planned_bytes -= candidate.entry.planned_bytes - bytes;
+                candidate.entry.planned_bytes = bytes;
+                candidate.entry.planned_path = variant.path;
+                candidate.entry.planned_width = variant.width;
+                candidate.entry.planned_height = variant.height;
+                break;
+            }
+            if (candidate.next_variant < candidate.variants.size()) {
+                queue.emplace(candidate.entry.planned_bytes, static_cast<size_t>(&candidate - candidates.data()));
+            }
+        }
+    }
+    plan.within_budget = budget_bytes == 0 || plan.planned_bytes <= budget_bytes;
+
+    for (auto& candidate : candidates) {
+        const TextureBudgetEntry& entry = candidate.entry;
+        if (entry.planned_path != entry.texture_path) {
+            plan.substitutions[entry.texture_path] = entry.planned_path;
+            for (const auto& asset : entry.used_by) {
+                plan.downgraded_assets[asset].push_back(entry.texture_path);
+            }
+        }
+        plan.textures.push_back(std::move(candidate.entry));
+    }
+    std::stable_sort(plan.textures.begin(), plan.textures.end(),
+                     [](const TextureBudgetEntry& a, const TextureBudgetEntry& b) {
+                         return a.estimated_bytes > b.estimated_bytes;
+                     });
+    plan.unknown_textures.assign(unknown.begin(), unknown.end());
+    return plan;
+}
+
+} // namespace AssetManager
@@ -0,0 +1,349 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: texture_probe.cpp
+ * Description: Implementation of TextureHeaderProbe, header-only parsing of common texture formats.
+ *
+ * Architecture:
+ * - probe() reads a bounded prefix of the file and hands it to parse()
+ * - parse() dispatches on magic bytes; every parser bounds-checks against the prefix it was given
+ *
+ * Key Features:
+ * - No pixel data is decoded; a probe costs one small read
+ * - Dimensions that are zero or negative are rejected as damaged headers
+ */
+
+#include "texture_probe.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace AssetManager {
+
+bool TextureHeaderProbe::probe(const std::string& path, TextureHeader& header) {
+    /**
+     * @brief Reads a texture's dimensions and channel count from its header.
+     *
+     * @param path Texture file path.
+     * @param header Receives format, size, channels and HDR flag.
+     * @return False if the file cannot be read or the header is not understood.
+     */
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    std::vector<unsigned char> buffer(64 * 1024);
+    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    size_t size = static_cast<size_t>(file.gcount());
+    if (parse(buffer.data(), size, extension, header)) {
+        return true;
+    }
+
+    // JPEG frame headers can sit behind large EXIF/ICC segments
+    bool is_jpeg = size >= 3 && buffer[0] == 0xFF && buffer[1] == 0xD8;
+    if (!is_jpeg || size < buffer.size()) {
+        return false;
+    }
+    buffer.resize(1024 * 1024);
+    file.read(reinterpret_cast<char*>(buffer.data()) + size, static_cast<std::streamsize>(buffer.size() - size));
+    size += static_cast<size_t>(file.gcount());
+    return parse(buffer.data(), size, extension, header);
+}
+
+bool TextureHeaderProbe::parse(const unsigned char* data, size_t size, const std::string& extension,
+                               TextureHeader& header) {
+    /**
+     * @brief Parses an in-memory file prefix.
+     *
+     * @param extension Lower-case extension; only consulted for TGA, which has no magic bytes.
+     */
+    bool parsed = false;
+    if (size >= 8 && std::memcmp(data, "\x89PNG\r\n\x1a\n", 8) == 0) {
+        parsed = parsePNG(data, size, header);
+    } else if (size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF) {
+        parsed = parseJPEG(data, size, header);
+    } else if (size >= 2 && data[0] == 'B' && data[1] == 'M') {
+        parsed = parseBMP(data, size, header);
+    } else if (size >= 4 && std::memcmp(data, "DDS ", 4) == 0) {
+        parsed = parseDDS(data, size, header);
+    } else if (size >= 2 && data[0] == '#' && data[1] == '?') {
+        parsed = parseHDR(data, size, header);
+    } else if (size >= 4 && readLE(data, 4) == 20000630) {
+        parsed = parseEXR(data, size, header);
+    } else if (size >= 4 && (std::memcmp(data, "II*\0", 4) == 0 || std::memcmp(data, "MM\0*", 4) == 0)) {
+        parsed = parseTIFF(data, size, header);
+    } else if (extension == ".tga") {
+        parsed = parseTGA(data, size, header);
+    }
+    return parsed && header.width > 0 && header.height > 0;
+}
+
+bool TextureHeaderProbe::parsePNG(const unsigned char* data, size_t size, TextureHeader& header) {
+    // Signature, then the IHDR chunk: length, "IHDR", width, height, bit depth, colour type
+    if (size < 26 || std::memcmp(data + 12, "IHDR", 4) != 0) {
+        return false;
+    }
+    static const int channels_by_colour_type[] = {1, 0, 3, 3, 2, 0, 4};
+    uint8_t colour_type = data[25];
+    header.format = ".png";
+    header.width = static_cast<int>(readBE(data + 16, 4));
+    header.height = static_cast<int>(readBE(data + 20, 4));
+    header.channels = colour_type <= 6 ? channels_by_colour_type[colour_type] : 0;
+    header.bit_depth = colour_type == 3 ? 8 : data[24];   // palette indices expand to 8-bit samples
+    header.is_hdr = false;
+    return header.channels > 0;
+}
+
+bool TextureHeaderProbe::parseJPEG(const unsigned char* data, size_t size, TextureHeader& header) {
+    // Walk marker segments until a start-of-frame (SOF0-SOF15 except DHT, JPG and DAC)
+    size_t pos = 2;
+    while (pos + 4 <= size) {
+        if (data[pos] != 0xFF) {
+            return false;
+        }
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            ++pos;   // fill byte
+            continue;
+        }
+        if (marker == 0xD8 || marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+            pos += 2;   // markers without a length
+            continue;
+        }
+        uint32_t length = readBE(data + pos + 2, 2);
+        if (length < 2) {
+            return false;
+        }
+        bool is_frame = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+        if (is_frame) {
+            if (pos + 10 > size) {
+                return false;
+            }
+            header.format = ".jpg";
+            header.height = static_cast<int>(readBE(data + pos + 5, 2));
+            header.width = static_cast<int>(readBE(data + pos + 7, 2));
+            header.channels = data[pos + 9];
+            header.bit_depth = data[pos + 4];
+            header.is_hdr = false;
+            return true;
+        }
+        if (marker == 0xDA || marker == 0xD9) {
+            return false;   // scan data or end of image before any frame header
+        }
+        pos += 2 + length;
+    }
+    return false;
+}
+
+bool TextureHeaderProbe::parseTGA(const unsigned char* data, size_t size, TextureHeader& header) {
+    if (size < 18) {
+        return false;
+    }
+    uint8_t image_type = data[2];
+    bool known_type = image_type == 1 || image_type == 2 || image_type == 3 ||
+                      image_type == 9 || image_type == 10 || image_type == 11;
+    uint8_t bits_per_pixel = data[16];
+    if (!known_type || bits_per_pixel == 0 || bits_per_pixel > 32) {
+        return false;
+    }
+    header.format = ".tga";
+    header.width = static_cast<int>(readLE(data + 12, 2));
+    header.height = static_cast<int>(readLE(data + 14, 2));
+    header.channels = (image_type == 3 || image_type == 11) ? 1 : (bits_per_pixel == 32 ? 4 : 3);
+    header.bit_depth = 8;
+    header.is_hdr = false;
+    return true;
+}
+
+bool TextureHeaderProbe::parseBMP(const unsigned char* data, size_t size, TextureHeader& header) {
+    if (size < 30) {
+        return false;
+    }
+    // Height is negative for top-down bitmaps
+    int32_t width = static_cast<int32_t>(readLE(data + 18, 4));
+    int32_t height = static_cast<int32_t>(readLE(data + 22, 4));
+    uint32_t bits_per_pixel = readLE(data + 28, 2);
+    header.format = ".bmp";
+    header.width = width;
+    header.height = height < 0 ? -height : height;
+    header.channels = bits_per_pixel == 32 ? 4 : (bits_per_pixel <= 8 ? 1 : 3);
+    header.bit_depth = 8;
+    header.is_hdr = false;
+    return true;
+}
+
+bool TextureHeaderProbe::parseDDS(const unsigned char* data, size_t size, TextureHeader& header) {
+    // "DDS ", then DDS_HEADER: size, flags, height, width ... pixel format at offset 76
+    if (size < 128 || readLE(data + 4, 4) != 124) {
+        return false;
+    }
+    uint32_t pixel_flags = readLE(data + 80, 4);
+    uint32_t four_cc = readLE(data + 84, 4);
+    bool float_format = four_cc == 113 || four_cc == 116;   // D3DFMT_A16B16G16R16F, D3DFMT_A32B32G32R32F
+    header.format = ".dds";
+    header.height = static_cast<int>(readLE(data + 12, 4));
+    header.width = static_cast<int>(readLE(data + 16, 4));
+    header.channels = (pixel_flags & 0x1) || float_format ? 4 : 3;
+    header.bit_depth = four_cc == 113 ? 16 : (four_cc == 116 ? 32 : 8);
+    header.is_hdr = float_format;
+    return true;
+}
+
+bool TextureHeaderProbe::parseHDR(const unsigned char* data, size_t size, TextureHeader& header) {
+    // Text header lines, a blank line, then the resolution line ("-Y 512 +X 1024")
+    std::string text(reinterpret_cast<const char*>(data), std::min<size_t>(size, 4096));
+    if (text.compare(0, 10, "#?RADIANCE") != 0 && text.compare(0, 6, "#?RGBE") != 0) {
+        return false;
+    }
+    size_t blank = text.find("\n\n");
+    if (blank == std::string::npos) {
+        return false;
+    }
+    size_t line_end = text.find('\n', blank + 2);
+    std::string resolution = text.substr(blank + 2, line_end == std::string::npos ? std::string::npos
+                                                                                  : line_end - blank - 2);
+    char y_axis[3] = {0};
+    char x_axis[3] = {0};
+    int rows = 0;
+    int columns = 0;
+    if (std::sscanf(resolution.c_str(), "%2s %d %2s %d", y_axis, &rows, x_axis, &columns) != 4) {
+        return false;
+    }
+    bool rows_first = y_axis[1] == 'Y';
+    header.format = ".hdr";
+    header.width = rows_first ? columns : rows;
+    header.height = rows_first ? rows : columns;
+    header.channels = 3;
+    header.bit_depth = 32;   // RGBE decodes to float
+    header.is_hdr = true;
+    return true;
+}
+
+bool TextureHeaderProbe::parseEXR(const unsigned char* data, size_t size, TextureHeader& header) {
+    // Magic, version, then attributes: name\0 type\0 int32 size, value; an empty name ends the header
+    size_t pos = 8;
+    bool have_window = false;
+    int channels = 0;
+    int bit_depth = 16;
+    while (pos < size) {
+        const char* name = reinterpret_cast<const char*>(data + pos);
+        size_t name_length = strnlen(name, size - pos);
+        if (name_length == 0) {
+            break;
+        }
+        size_t type_pos = pos + name_length + 1;
+        if (type_pos >= size) {
+            return false;
+        }
+        const char* type = reinterpret_cast<const char*>(data + type_pos);
+        size_t type_length = strnlen(type, size - type_pos);
+        size_t value_pos = type_pos + type_length + 1 + 4;
+        if (value_pos > size) {
+            return false;
+        }
+        uint32_t value_size = readLE(data + value_pos - 4, 4);
+        if (value_size > size - value_pos) {
+            return false;
+        }
+
+        if (std::strcmp(name, "dataWindow") == 0 && value_size == 16) {
+            int32_t x_min = static_cast<int32_t>(readLE(data + value_pos, 4));
+            int32_t y_min = static_cast<int32_t>(readLE(data + value_pos + 4, 4));
+            int32_t x_max = static_cast<int32_t>(readLE(data + value_pos + 8, 4));
+            int32_t y_max = static_cast<int32_t>(readLE(data + value_pos + 12, 4));
+            header.width = x_max - x_min + 1;
+            header.height = y_max - y_min + 1;
+            have_window = true;
+        } else if (std::strcmp(name, "channels") == 0) {
+            // chlist: name\0 followed by 16 bytes per channel, terminated by an empty name
+            size_t channel_pos = value_pos;
+            size_t end = value_pos + value_size;
+            while (channel_pos < end && data[channel_pos] != 0) {
+                channel_pos += strnlen(reinterpret_cast<const char*>(data + channel_pos), end - channel_pos) + 1;
+                if (channel_pos + 4 <= end && readLE(data + channel_pos, 4) != 1) {
+                    bit_depth = 32;   // UINT or FLOAT rather than HALF
+                }
+                channel_pos += 16;
+                ++channels;
+            }
+        }
+        pos = value_pos + value_size;
+    }
+    header.format = ".exr";
+    header.channels = channels;
+    header.bit_depth = bit_depth;
+    header.is_hdr = true;
+    return have_window && channels > 0;
+}
+
+bool TextureHeaderProbe::parseTIFF(const unsigned char* data, size_t size, TextureHeader& header) {
+    // First IFD only; an IFD outside the read window is left to a full decoder
+    bool big_endian = data[0] == 'M';
+    auto read = [&](size_t offset, size_t bytes) {
+        return big_endian ? readBE(data + offset, bytes) : readLE(data + offset, bytes);
+    };
+    if (size < 8) {
+        return false;
+    }
+    size_t ifd = read(4, 4);
+    if (ifd + 2 > size) {
+        return false;
+    }
+    size_t entries = read(ifd, 2);
+    if (ifd + 2 + entries * 12 > size) {
+        return false;
+    }
+    int samples_per_pixel = 1;
+    int sample_format = 1;
+    int bits_per_sample = 1;
+    for (size_t i = 0; i < entries; ++i) {
+        size_t entry = ifd + 2 + i * 12;
+        uint32_t tag = read(entry, 2);
+        uint32_t type = read(entry + 2, 2);
+        uint32_t value = type == 3 ? read(entry + 8, 2) : read(entry + 8, 4);   // SHORT or LONG
+        switch (tag) {
+            case 256: header.width = static_cast<int>(value); break;
+            case 257: header.height = static_cast<int>(value); break;
+            case 258: {
+                // Several samples store their (equal) sizes behind an offset
+                uint32_t count = read(entry + 4, 4);
+                size_t offset = read(entry + 8, 4);
+                bits_per_sample = static_cast<int>(count <= 2 ? value : (offset + 2 <= size ? read(offset, 2) : 8));
+                break;
+            }
+            case 277: samples_per_pixel = static_cast<int>(value); break;
+            case 339: sample_format = static_cast<int>(value); break;
+            default: break;
+        }
+    }
+    header.format = ".tiff";
+    header.channels = samples_per_pixel;
+    header.bit_depth = bits_per_sample;
+    header.is_hdr = sample_format == 3;   // IEEE floating point samples
+    return true;
+}
+
+uint32_t TextureHeaderProbe::readBE(const unsigned char* data, size_t bytes) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+uint32_t TextureHeaderProbe::readLE(const unsigned char* data, size_t bytes) {
+    uint32_t value = 0;
+    for (size_t i = bytes; i > 0; --i) {
+        value = (value << 8) | data[i - 1];
+    }
+    return value;
+}
+
+} // namespace AssetManager
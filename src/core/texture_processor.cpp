@@ -0,0 +1,1271 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: texture_processor.cpp
+ * Description: Implementation of the TextureProcessor class: texture codecs, SIMD resampling and the variant cache.
+ *
+ * Architecture:
+ * - resize() filters rows horizontally on demand (one SSE2 multiply-add per tap on 4-lane pixels) into a ring
+ *   sized to the vertical kernel, then sums the ring rows with SSE2 into each output row
+ * - downsample2x() sums row pairs as 16-bit (8-bit images) or float lanes before halving horizontally
+ * - EXR blocks use the OpenEXR byte split + delta predictor around zlib/RLE; pixel data is little-endian on disk
+ *   and the supported hosts are little-endian too
+ *
+ * Key Features:
+ * - Every decoder bounds-checks the file it was given and reports a message instead of throwing
+ * - The manifest is written atomically (temp file + rename) after each batch
+ */
+
+#include "texture_processor.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <png.h>
+#include <jpeglib.h>
+#include <zlib.h>
+#include <nlohmann/json.hpp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace AssetManager {
+
+TextureProcessor::TextureProcessor(TextureVariantOptions options)
+    : options_(std::move(options)) {
+    if (options_.threads == 0) {
+        options_.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    auto& sizes = options_.max_sizes;
+    sizes.erase(std::remove_if(sizes.begin(), sizes.end(), [](int size) { return size <= 0; }), sizes.end());
+    std::sort(sizes.begin(), sizes.end(), std::greater<int>());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+
+    // Outputs recorded under other options are regenerated rather than reused
+    std::ostringstream signature;
+    signature << (options_.filter == ResampleFilter::Lanczos3 ? "lanczos3" : "box")
+              << ";mips=" << (options_.mip_chain ? 1 : 0) << ";sizes=";
+    for (int size : sizes) {
+        signature << size << ',';
+    }
+    signature_ = signature.str();
+}
+
+std::vector<TextureJobResult> TextureProcessor::generateVariants(const std::vector<std::string>& texture_paths) {
+    /**
+     * @brief Writes downscaled variants (and optionally mip chains) for every texture.
+     *
+     * @param texture_paths Source textures (PNG, JPEG, TGA or EXR).
+     * @return One result per input, in input order; unchanged sources are answered from the manifest.
+     */
+    std::vector<TextureJobResult> results(texture_paths.size());
+    if (options_.cache_root.empty()) {
+        for (size_t i = 0; i < texture_paths.size(); ++i) {
+            results[i].source_path = texture_paths[i];
+            results[i].message = "No variant cache root configured";
+        }
+        return results;
+    }
+
+    loadManifest();
+    runParallel(texture_paths.size(), [&](size_t i) {
+        try {
+            results[i] = processTexture(texture_paths[i]);
+        } catch (const std::exception& e) {
+            results[i].source_path = texture_paths[i];
+            results[i].message = std::string("Texture processing failed: ") + e.what();
+        }
+    });
+    saveManifest();
+    return results;
+}
+
+std::vector<TextureJobResult> TextureProcessor::packORM(const std::vector<OrmSources>& sets) {
+    /**
+     * @brief Packs AO (R), roughness (G) and metallic (B) of each set into one 8-bit RGB texture.
+     *
+     * @param sets Channel sources per texture set; missing channels use AO 1.0, roughness 0.5, metallic 0.0.
+     * @return One result per set, in input order, each with a single "orm" variant on success.
+     */
+    std::vector<TextureJobResult> results(sets.size());
+    if (options_.cache_root.empty()) {
+        for (size_t i = 0; i < sets.size(); ++i) {
+            results[i].source_path = sets[i].name;
+            results[i].message = "No variant cache root configured";
+        }
+        return results;
+    }
+
+    loadManifest();
+    runParallel(sets.size(), [&](size_t i) {
+        try {
+            results[i] = processORM(sets[i]);
+        } catch (const std::exception& e) {
+            results[i].source_path = sets[i].name;
+            results[i].message = std::string("ORM packing failed: ") + e.what();
+        }
+    });
+    saveManifest();
+    return results;
+}
+
+TextureJobResult TextureProcessor::processTexture(const std::string& source_path) {
+    TextureJobResult result;
+    result.source_path = source_path;
+    std::string stamp = sourceStamp({source_path});
+    if (lookupManifest(source_path, stamp, result)) {
+        return result;
+    }
+
+    ImageBuffer image;
+    std::string error;
+    if (!decode(source_path, image, error)) {
+        result.message = error;
+        return result;
+    }
+
+    std::filesystem::path directory = outputDirectory(source_path, std::filesystem::path(source_path).stem().string());
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const std::string extension = image.is_float ? ".exr" : ".png";
+
+    // Each variant is filtered from the next larger one, so an 8K source is read at full size only once
+    const int longest = std::max(image.width, image.height);
+    ImageBuffer previous;
+    for (int size : options_.max_sizes) {
+        if (size >= longest) {
+            continue;
+        }
+        double ratio = static_cast<double>(size) / longest;
+        int width = std::max(1, static_cast<int>(std::lround(image.width * ratio)));
+        int height = std::max(1, static_cast<int>(std::lround(image.height * ratio)));
+        ImageBuffer variant = resize(previous.empty() ? image : previous, width, height, options_.filter);
+
+        std::string path = (directory / (std::to_string(width) + "x" + std::to_string(height) + extension)).string();
+        if (!encode(path, variant, error)) {
+            result.message = error;
+            return result;
+        }
+        result.variants.push_back({path, "variant", width, height, variant.channels});
+        previous = std::move(variant);
+    }
+
+    if (options_.mip_chain && (image.width > 1 || image.height > 1)) {
+        ImageBuffer level = downsample2x(image);
+        for (int index = 1;; ++index) {
+            std::string path = (directory / ("mip" + std::to_string(index) + extension)).string();
+            if (!encode(path, level, error)) {
+                result.message = error;
+                return result;
+            }
+            result.variants.push_back({path, "mip", level.width, level.height, level.channels});
+            if (level.width == 1 && level.height == 1) {
+                break;
+            }
+            level = downsample2x(level);
+        }
+    }
+
+    result.success = true;
+    result.message = "Wrote " + std::to_string(result.variants.size()) + " variants";
+    storeManifest(source_path, stamp, result);
+    return result;
+}
+
+TextureJobResult TextureProcessor::processORM(const OrmSources& sources) {
+    TextureJobResult result;
+    result.source_path = sources.name;
+    const std::string* paths[3] = {&sources.ao, &sources.roughness, &sources.metallic};
+    const uint8_t defaults[3] = {255, 128, 0};
+    std::string key = "orm:" + sources.ao + "|" + sources.roughness + "|" + sources.metallic;
+    std::string stamp = sourceStamp({sources.ao, sources.roughness, sources.metallic});
+    if (lookupManifest(key, stamp, result)) {
+        return result;
+    }
+
+    // The largest input sets the output size
+    ImageBuffer inputs[3];
+    int width = 0;
+    int height = 0;
+    for (int k = 0; k < 3; ++k) {
+        if (paths[k]->empty()) {
+            continue;
+        }
+        std::string error;
+        if (!decode(*paths[k], inputs[k], error)) {
+            result.message = error;
+            return result;
+        }
+        if (static_cast<int64_t>(inputs[k].width) * inputs[k].height > static_cast<int64_t>(width) * height) {
+            width = inputs[k].width;
+            height = inputs[k].height;
+        }
+    }
+    if (width == 0) {
+        result.message = "No AO, roughness or metallic texture to pack";
+        return result;
+    }
+
+    ImageBuffer packed;
+    packed.width = width;
+    packed.height = height;
+    packed.channels = 3;
+    packed.bytes.resize(packed.sampleCount());
+    const size_t pixels = static_cast<size_t>(width) * height;
+    for (int k = 0; k < 3; ++k) {
+        ImageBuffer& input = inputs[k];
+        if (input.empty()) {
+            for (size_t p = 0; p < pixels; ++p) {
+                packed.bytes[p * 3 + k] = defaults[k];
+            }
+            continue;
+        }
+        if (input.width != width || input.height != height) {
+            input = resize(input, width, height, ResampleFilter::Lanczos3);
+        }
+        // Grey maps are read from their first channel
+        const size_t stride = static_cast<size_t>(input.channels);
+        for (size_t p = 0; p < pixels; ++p) {
+            if (input.is_float) {
+                float value = std::clamp(input.floats[p * stride], 0.0f, 1.0f);
+                packed.bytes[p * 3 + k] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+            } else {
+                packed.bytes[p * 3 + k] = input.bytes[p * stride];
+            }
+        }
+    }
+
+    std::string stem = sources.name.empty() ? "orm" : sources.name;
+    std::replace_if(stem.begin(), stem.end(), [](char c) { return c == '/' || c == '\\'; }, '_');
+    std::filesystem::path directory = outputDirectory(key, stem);
+    std::filesystem::create_directories(directory);
+    std::string path = (directory / "orm.png").string();
+    std::string error;
+    if (!encode(path, packed, error)) {
+        result.message = error;
+        return result;
+    }
+    result.variants.push_back({path, "orm", width, height, 3});
+    result.success = true;
+    result.message = "Packed ORM texture";
+    storeManifest(key, stamp, result);
+    return result;
+}
+
+void TextureProcessor::runParallel(size_t count, const std::function<void(size_t)>& job) const {
+    /*
+     * Runs job(0..count-1) on up to options_.threads workers.
+     * - Workers claim the next index from a shared counter, so one huge texture does not hold up a queue
+     * - A single worker (or a single job) runs inline on the calling thread
+     */
+    size_t workers = std::min(options_.threads, count);
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            job(i);
+        }
+        return;
+    }
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (size_t w = 0; w < workers; ++w) {
+        threads.emplace_back([&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                job(i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+std::string TextureProcessor::manifestPath() const {
+    return (std::filesystem::path(options_.cache_root) / "variants.json").string();
+}
+
+void TextureProcessor::loadManifest() {
+    std::lock_guard<std::mutex> lock(manifest_mutex_);
+    if (manifest_loaded_) {
+        return;
+    }
+    manifest_loaded_ = true;
+    std::ifstream file(manifestPath());
+    if (!file.is_open()) {
+        return;
+    }
+    try {
+        json document = json::parse(file);
+        for (const auto& [key, value] : document.at("entries").items()) {
+            ManifestEntry entry;
+            entry.stamp = value.value("stamp", "");
+            entry.signature = value.value("signature", "");
+            for (const auto& variant : value.value("variants", json::array())) {
+                entry.variants.push_back({variant.value("path", ""), variant.value("kind", ""),
+                                          variant.value("width", 0), variant.value("height", 0),
+                                          variant.value("channels", 0)});
+            }
+            manifest_[key] = std::move(entry);
+        }
+    } catch (const std::exception&) {
+        // A damaged manifest only costs a regeneration
+        manifest_.clear();
+    }
+}
+
+void TextureProcessor::saveManifest() {
+    std::lock_guard<std::mutex> lock(manifest_mutex_);
+    json entries = json::object();
+    for (const auto& [key, entry] : manifest_) {
+        json variants = json::array();
+        for (const auto& variant : entry.variants) {
+            variants.push_back({{"path", variant.path}, {"kind", variant.kind}, {"width", variant.width},
+                                {"height", variant.height}, {"channels", variant.channels}});
+        }
+        entries[key] = {{"stamp", entry.stamp}, {"signature", entry.signature}, {"variants", variants}};
+    }
+    json document = {{"version", 1}, {"entries", entries}};
+
+    std::error_code error;
+    std::filesystem::create_directories(options_.cache_root, error);
+    std::string path = manifestPath();
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file.is_open()) {
+            return;
+        }
+        file << document.dump(2);
+    }
+    std::filesystem::rename(temporary, path, error);
+}
+
+bool TextureProcessor::lookupManifest(const std::string& key, const std::string& stamp, TextureJobResult& result) {
+    std::lock_guard<std::mutex> lock(manifest_mutex_);
+    auto it = manifest_.find(key);
+    if (it == manifest_.end() || it->second.stamp != stamp || it->second.signature != signature_) {
+        return false;
+    }
+    for (const auto& variant : it->second.variants) {
+        if (!std::filesystem::exists(variant.path)) {
+            return false;
+        }
+    }
+    result.variants = it->second.variants;
+    result.success = true;
+    result.from_cache = true;
+    result.message = "Variants up to date";
+    return true;
+}
+
+void TextureProcessor::storeManifest(const std::string& key, const std::string& stamp, const TextureJobResult& result) {
+    std::lock_guard<std::mutex> lock(manifest_mutex_);
+    manifest_[key] = {stamp, signature_, result.variants};
+}
+
+std::string TextureProcessor::sourceStamp(const std::vector<std::string>& paths) {
+    std::string stamp;
+    for (const auto& path : paths) {
+        if (!stamp.empty()) stamp += '|';
+        std::error_code error;
+        auto size = path.empty() ? 0 : std::filesystem::file_size(path, error);
+        auto modified = path.empty() ? std::filesystem::file_time_type() : std::filesystem::last_write_time(path, error);
+        if (path.empty() || error) {
+            stamp += '-';
+            continue;
+        }
+        stamp += std::to_string(size) + ':' + std::to_string(modified.time_since_epoch().count());
+    }
+    return stamp;
+}
+
+std::string TextureProcessor::outputDirectory(const std::string& key, const std::string& stem) const {
+    // The hash keeps same-named textures from different folders apart
+    return (std::filesystem::path(options_.cache_root) / (stem + "_" + hashKey(key))).string();
+}
+
+std::string TextureProcessor::hashKey(const std::string& key) {
+    uint64_t hash = 1469598103934665603ull;     // FNV-1a
+    for (unsigned char c : key) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+TextureProcessor::FilterTaps TextureProcessor::computeTaps(int source_size, int target_size, ResampleFilter filter) {
+    /*
+     * Precomputes normalized weights for one axis.
+     * - Downscaling widens the kernel by the scale factor so every source texel contributes (no aliasing)
+     * - Taps past the edge are clamped to the border texel
+     */
+    FilterTaps taps;
+    taps.offsets.reserve(static_cast<size_t>(target_size) + 1);
+    const double scale = static_cast<double>(source_size) / target_size;
+    const double filter_scale = std::max(1.0, scale);
+    const double radius = (filter == ResampleFilter::Lanczos3 ? 3.0 : 0.5) * filter_scale;
+    auto kernel = [filter](double x) {
+        if (filter == ResampleFilter::Box) {
+            return (x >= -0.5 && x < 0.5) ? 1.0 : 0.0;
+        }
+        if (x == 0.0) return 1.0;
+        if (x <= -3.0 || x >= 3.0) return 0.0;
+        const double pi_x = M_PI * x;
+        return 3.0 * std::sin(pi_x) * std::sin(pi_x / 3.0) / (pi_x * pi_x);
+    };
+
+    for (int i = 0; i < target_size; ++i) {
+        taps.offsets.push_back(taps.indices.size());
+        const size_t first = taps.weights.size();
+        const double center = (i + 0.5) * scale;
+        const int left = static_cast<int>(std::floor(center - radius));
+        const int right = static_cast<int>(std::ceil(center + radius));
+        double total = 0.0;
+        for (int j = left; j <= right; ++j) {
+            double weight = kernel((j + 0.5 - center) / filter_scale);
+            if (weight == 0.0) {
+                continue;
+            }
+            taps.indices.push_back(std::clamp(j, 0, source_size - 1));
+            taps.weights.push_back(static_cast<float>(weight));
+            total += weight;
+        }
+        if (total == 0.0) {
+            taps.indices.push_back(std::clamp(static_cast<int>(center), 0, source_size - 1));
+            taps.weights.push_back(1.0f);
+            continue;
+        }
+        for (size_t t = first; t < taps.weights.size(); ++t) {
+            taps.weights[t] = static_cast<float>(taps.weights[t] / total);
+        }
+    }
+    taps.offsets.push_back(taps.indices.size());
+    return taps;
+}
+
+void TextureProcessor::filterRow(const ImageBuffer& image, int row, const FilterTaps& taps, int target_width,
+                                 std::vector<float>& scratch, float* out) {
+    // Widen the row to 4 float lanes per pixel so each tap is one vector multiply-add whatever the channel count
+    const int channels = image.channels;
+    const size_t row_offset = static_cast<size_t>(row) * image.width * channels;
+    scratch.assign(static_cast<size_t>(image.width) * 4, 0.0f);
+    for (int x = 0; x < image.width; ++x) {
+        for (int c = 0; c < channels; ++c) {
+            const size_t source = row_offset + static_cast<size_t>(x) * channels + c;
+            scratch[static_cast<size_t>(x) * 4 + c] = image.is_float ? image.floats[source] : image.bytes[source];
+        }
+    }
+
+    for (int x = 0; x < target_width; ++x) {
+        alignas(16) float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+#if defined(__SSE2__)
+        __m128 total = _mm_setzero_ps();
+        for (size_t t = taps.offsets[x]; t < taps.offsets[x + 1]; ++t) {
+            const __m128 texel = _mm_loadu_ps(scratch.data() + static_cast<size_t>(taps.indices[t]) * 4);
+            total = _mm_add_ps(total, _mm_mul_ps(texel, _mm_set1_ps(taps.weights[t])));
+        }
+        _mm_store_ps(sum, total);
+#else
+        for (size_t t = taps.offsets[x]; t < taps.offsets[x + 1]; ++t) {
+            const float* texel = scratch.data() + static_cast<size_t>(taps.indices[t]) * 4;
+            for (int c = 0; c < 4; ++c) {
+                sum[c] += texel[c] * taps.weights[t];
+            }
+        }
+#endif
+        for (int c = 0; c < channels; ++c) {
+            out[static_cast<size_t>(x) * channels + c] = sum[c];
+        }
+    }
+}
+
+void TextureProcessor::accumulateRow(float* accumulator, const float* row, float weight, size_t count) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 factor = _mm_set1_ps(weight);
+    for (; i + 4 <= count; i += 4) {
+        __m128 sum = _mm_loadu_ps(accumulator + i);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(row + i), factor));
+        _mm_storeu_ps(accumulator + i, sum);
+    }
+#endif
+    for (; i < count; ++i) {
+        accumulator[i] += row[i] * weight;
+    }
+}
+
+ImageBuffer TextureProcessor::resize(const ImageBuffer& image, int width, int height, ResampleFilter filter) {
+    /**
+     * @brief Resamples an image with a separable filter.
+     *
+     * Source rows are filtered horizontally once, into a ring holding just the rows the vertical kernel spans,
+     * so an 8K source never needs a full-size float intermediate.
+     *
+     * @param image Source image (8-bit or float).
+     * @param width Target width.
+     * @param height Target height.
+     * @param filter Lanczos3 (sharp, for downscaling) or Box.
+     * @return Resampled image of the same type and channel count; empty for empty input or target.
+     */
+    ImageBuffer result;
+    if (image.empty() || width <= 0 || height <= 0) {
+        return result;
+    }
+    result.width = width;
+    result.height = height;
+    result.channels = image.channels;
+    result.is_float = image.is_float;
+    if (result.is_float) {
+        result.floats.resize(result.sampleCount());
+    } else {
+        result.bytes.resize(result.sampleCount());
+    }
+
+    const FilterTaps horizontal = computeTaps(image.width, width, filter);
+    const FilterTaps vertical = computeTaps(image.height, height, filter);
+    size_t window = 1;
+    for (int y = 0; y < height; ++y) {
+        auto begin = vertical.indices.begin() + static_cast<std::ptrdiff_t>(vertical.offsets[y]);
+        auto end = vertical.indices.begin() + static_cast<std::ptrdiff_t>(vertical.offsets[y + 1]);
+        auto range = std::minmax_element(begin, end);
+        window = std::max(window, static_cast<size_t>(*range.second - *range.first + 1));
+    }
+
+    const size_t row_samples = static_cast<size_t>(width) * image.channels;
+    std::vector<float> ring(window * row_samples);
+    std::vector<int> ring_rows(window, -1);
+    std::vector<float> accumulator(row_samples);
+    std::vector<float> scratch;
+    for (int y = 0; y < height; ++y) {
+        std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+        for (size_t t = vertical.offsets[y]; t < vertical.offsets[y + 1]; ++t) {
+            const int source_row = vertical.indices[t];
+            const size_t slot = static_cast<size_t>(source_row) % window;
+            float* filtered = ring.data() + slot * row_samples;
+            if (ring_rows[slot] != source_row) {
+                filterRow(image, source_row, horizontal, width, scratch, filtered);
+                ring_rows[slot] = source_row;
+            }
+            accumulateRow(accumulator.data(), filtered, vertical.weights[t], row_samples);
+        }
+
+        const size_t out = static_cast<size_t>(y) * row_samples;
+        if (result.is_float) {
+            std::copy(accumulator.begin(), accumulator.end(), result.floats.begin() + static_cast<std::ptrdiff_t>(out));
+        } else {
+            for (size_t i = 0; i < row_samples; ++i) {
+                result.bytes[out + i] = static_cast<uint8_t>(std::clamp(accumulator[i] + 0.5f, 0.0f, 255.0f));
+            }
+        }
+    }
+    return result;
+}
+
+ImageBuffer TextureProcessor::downsample2x(const ImageBuffer& image) {
+    /**
+     * @brief Halves an image with a 2x2 box filter (one mip level).
+     *
+     * Odd edges drop their last row/column; 1-pixel edges stay 1 pixel.
+     *
+     * @param image Source image.
+     * @return Next mip level.
+     */
+    ImageBuffer result;
+    if (image.empty()) {
+        return result;
+    }
+    result.width = std::max(1, image.width / 2);
+    result.height = std::max(1, image.height / 2);
+    result.channels = image.channels;
+    result.is_float = image.is_float;
+    const int channels = image.channels;
+    const size_t source_row = static_cast<size_t>(image.width) * channels;
+    const size_t target_row = static_cast<size_t>(result.width) * channels;
+
+    if (image.is_float) {
+        result.floats.resize(result.sampleCount());
+        std::vector<float> sums(source_row);
+        for (int y = 0; y < result.height; ++y) {
+            const float* top = image.floats.data() + static_cast<size_t>(std::min(2 * y, image.height - 1)) * source_row;
+            const float* bottom = image.floats.data() + static_cast<size_t>(std::min(2 * y + 1, image.height - 1)) * source_row;
+            size_t i = 0;
+#if defined(__SSE2__)
+            for (; i + 4 <= source_row; i += 4) {
+                _mm_storeu_ps(sums.data() + i, _mm_add_ps(_mm_loadu_ps(top + i), _mm_loadu_ps(bottom + i)));
+            }
+#endif
+            for (; i < source_row; ++i) {
+                sums[i] = top[i] + bottom[i];
+            }
+            float* out = result.floats.data() + static_cast<size_t>(y) * target_row;
+            for (int x = 0; x < result.width; ++x) {
+                const size_t left = static_cast<size_t>(std::min(2 * x, image.width - 1)) * channels;
+                const size_t right = static_cast<size_t>(std::min(2 * x + 1, image.width - 1)) * channels;
+                for (int c = 0; c < channels; ++c) {
+                    out[static_cast<size_t>(x) * channels + c] = (sums[left + c] + sums[right + c]) * 0.25f;
+                }
+            }
+        }
+        return result;
+    }
+
+    result.bytes.resize(result.sampleCount());
+    std::vector<uint16_t> sums(source_row);
+    for (int y = 0; y < result.height; ++y) {
+        const uint8_t* top = image.bytes.data() + static_cast<size_t>(std::min(2 * y, image.height - 1)) * source_row;
+        const uint8_t* bottom = image.bytes.data() + static_cast<size_t>(std::min(2 * y + 1, image.height - 1)) * source_row;
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= source_row; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + i));
+            __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums.data() + i), low);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums.data() + i + 8), high);
+        }
+#endif
+        for (; i < source_row; ++i) {
+            sums[i] = static_cast<uint16_t>(top[i] + bottom[i]);
+        }
+        uint8_t* out = result.bytes.data() + static_cast<size_t>(y) * target_row;
+        for (int x = 0; x < result.width; ++x) {
+            const size_t left = static_cast<size_t>(std::min(2 * x, image.width - 1)) * channels;
+            const size_t right = static_cast<size_t>(std::min(2 * x + 1, image.width - 1)) * channels;
+            for (int c = 0; c < channels; ++c) {
+                out[static_cast<size_t>(x) * channels + c] = static_cast<uint8_t>((sums[left + c] + sums[right + c] + 2) >> 2);
+            }
+        }
+    }
+    return result;
+}
+
+bool TextureProcessor::decode(const std::string& path, ImageBuffer& image, std::string& error) {
+    /**
+     * @brief Decodes a texture into 8-bit (PNG, JPEG, TGA) or float (EXR) samples.
+     *
+     * @param path Texture file path; the format is chosen by extension.
+     * @param image Receives 1-4 interleaved channels.
+     * @param error Receives a message on failure.
+     * @return True if the image was decoded.
+     */
+    image = ImageBuffer();
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    bool decoded = false;
+    if (extension == ".png") {
+        decoded = decodePNG(path, image, error);
+    } else if (extension == ".jpg" || extension == ".jpeg") {
+        decoded = decodeJPEG(path, image, error);
+    } else if (extension == ".tga") {
+        decoded = decodeTGA(path, image, error);
+    } else if (extension == ".exr") {
+        decoded = decodeEXR(path, image, error);
+    } else {
+        error = "Unsupported texture format: " + extension;
+        return false;
+    }
+    if (decoded && (image.empty() || image.channels > 4)) {
+        error = "Decoded image has no usable pixels: " + path;
+        return false;
+    }
+    return decoded;
+}
+
+bool TextureProcessor::encode(const std::string& path, const ImageBuffer& image, std::string& error) {
+    if (image.empty() || image.channels > 4) {
+        error = "Cannot encode an empty image: " + path;
+        return false;
+    }
+    return image.is_float ? encodeEXR(path, image, error) : encodePNG(path, image, error);
+}
+
+bool TextureProcessor::readFile(const std::string& path, std::vector<uint8_t>& data) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    data.resize(static_cast<size_t>(std::max<std::streamsize>(size, 0)));
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), size));
+}
+
+bool TextureProcessor::decodePNG(const std::string& path, ImageBuffer& image, std::string& error) {
+    png_image png;
+    std::memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_file(&png, path.c_str())) {
+        error = "Cannot read PNG " + path + ": " + png.message;
+        return false;
+    }
+    // 16-bit sources are reduced to 8-bit; variants of 8-bit textures do not need more
+    const bool color = (png.format & PNG_FORMAT_FLAG_COLOR) != 0;
+    const bool alpha = (png.format & PNG_FORMAT_FLAG_ALPHA) != 0;
+    png.format = color ? (alpha ? PNG_FORMAT_RGBA : PNG_FORMAT_RGB) : (alpha ? PNG_FORMAT_GA : PNG_FORMAT_GRAY);
+    image.width = static_cast<int>(png.width);
+    image.height = static_cast<int>(png.height);
+    image.channels = static_cast<int>(PNG_IMAGE_SAMPLE_CHANNELS(png.format));
+    image.bytes.resize(PNG_IMAGE_SIZE(png));
+    if (!png_image_finish_read(&png, nullptr, image.bytes.data(), 0, nullptr)) {
+        error = "Cannot decode PNG " + path + ": " + png.message;
+        png_image_free(&png);
+        return false;
+    }
+    return true;
+}
+
+bool TextureProcessor::encodePNG(const std::string& path, const ImageBuffer& image, std::string& error) {
+    static const png_uint_32 formats[] = {PNG_FORMAT_GRAY, PNG_FORMAT_GA, PNG_FORMAT_RGB, PNG_FORMAT_RGBA};
+    png_image png;
+    std::memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    png.width = static_cast<png_uint_32>(image.width);
+    png.height = static_cast<png_uint_32>(image.height);
+    png.format = formats[image.channels - 1];
+    if (!png_image_write_to_file(&png, path.c_str(), 0, image.bytes.data(), 0, nullptr)) {
+        error = "Cannot write PNG " + path + ": " + png.message;
+        png_image_free(&png);
+        return false;
+    }
+    return true;
+}
+
+bool TextureProcessor::decodeJPEG(const std::string& path, ImageBuffer& image, std::string& error) {
+    // libjpeg reports fatal errors through error_exit; jump back here instead of letting it exit()
+    struct ErrorManager {
+        jpeg_error_mgr base;
+        jmp_buf jump;
+        char message[JMSG_LENGTH_MAX];
+    };
+
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "Cannot open JPEG " + path;
+        return false;
+    }
+    jpeg_decompress_struct info;
+    ErrorManager manager;
+    info.err = jpeg_std_error(&manager.base);
+    manager.base.error_exit = [](j_common_ptr common) {
+        ErrorManager* errors = reinterpret_cast<ErrorManager*>(common->err);
+        (*common->err->format_message)(common, errors->message);
+        std::longjmp(errors->jump, 1);
+    };
+    manager.base.output_message = [](j_common_ptr) {};   // warnings (e.g. truncated data) are not fatal
+    if (setjmp(manager.jump)) {
+        jpeg_destroy_decompress(&info);
+        std::fclose(file);
+        error = "Cannot decode JPEG " + path + ": " + manager.message;
+        return false;
+    }
+
+    jpeg_create_decompress(&info);
+    jpeg_stdio_src(&info, file);
+    jpeg_read_header(&info, TRUE);
+    // CMYK/YCCK cannot be converted by libjpeg and ends in error_exit
+    info.out_color_space = info.num_components == 1 ? JCS_GRAYSCALE : JCS_RGB;
+    jpeg_start_decompress(&info);
+    image.width = static_cast<int>(info.output_width);
+    image.height = static_cast<int>(info.output_height);
+    image.channels = info.output_components;
+    image.bytes.resize(image.sampleCount());
+    const size_t stride = static_cast<size_t>(image.width) * image.channels;
+    while (info.output_scanline < info.output_height) {
+        JSAMPROW row = image.bytes.data() + info.output_scanline * stride;
+        jpeg_read_scanlines(&info, &row, 1);
+    }
+    jpeg_finish_decompress(&info);
+    jpeg_destroy_decompress(&info);
+    std::fclose(file);
+    return true;
+}
+
+bool TextureProcessor::decodeTGA(const std::string& path, ImageBuffer& image, std::string& error) {
+    /*
+     * Truecolor and greyscale TGA, raw (types 2, 3) or RLE (types 10, 11).
+     * - 8 (grey), 16 (grey + alpha), 24 and 32 bits per pixel; BGR(A) is swapped to RGB(A)
+     * - Bottom-up files (descriptor bit 5 clear) are flipped to top-down
+     */
+    std::vector<uint8_t> data;
+    if (!readFile(path, data) || data.size() < 18) {
+        error = "Cannot read TGA " + path;
+        return false;
+    }
+    const int image_type = data[2];
+    const int width = data[12] | (data[13] << 8);
+    const int height = data[14] | (data[15] << 8);
+    const int bits = data[16];
+    const bool top_down = (data[17] & 0x20) != 0;
+    const bool grey = image_type == 3 || image_type == 11;
+    const bool rle = image_type == 10 || image_type == 11;
+    if (data[1] != 0 || (image_type != 2 && image_type != 3 && image_type != 10 && image_type != 11)) {
+        error = "Unsupported TGA type (colour-mapped or unknown): " + path;
+        return false;
+    }
+    if ((grey && bits != 8 && bits != 16) || (!grey && bits != 24 && bits != 32) || width == 0 || height == 0) {
+        error = "Unsupported TGA pixel depth: " + path;
+        return false;
+    }
+
+    const size_t pixel_size = static_cast<size_t>(bits / 8);
+    const size_t pixels = static_cast<size_t>(width) * height;
+    size_t position = 18 + data[0];
+    std::vector<uint8_t> raw(pixels * pixel_size);
+    if (!rle) {
+        if (position + raw.size() > data.size()) {
+            error = "Truncated TGA: " + path;
+            return false;
+        }
+        std::memcpy(raw.data(), data.data() + position, raw.size());
+    } else {
+        size_t written = 0;
+        while (written < raw.size()) {
+            if (position >= data.size()) {
+                error = "Truncated TGA: " + path;
+                return false;
+            }
+            const uint8_t header = data[position++];
+            const size_t count = static_cast<size_t>(header & 0x7f) + 1;
+            const size_t bytes = count * pixel_size;
+            if (written + bytes > raw.size()) {
+                error = "Corrupt TGA run: " + path;
+                return false;
+            }
+            if (header & 0x80) {
+                if (position + pixel_size > data.size()) {
+                    error = "Truncated TGA: " + path;
+                    return false;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    std::memcpy(raw.data() + written + i * pixel_size, data.data() + position, pixel_size);
+                }
+                position += pixel_size;
+            } else {
+                if (position + bytes > data.size()) {
+                    error = "Truncated TGA: " + path;
+                    return false;
+                }
+                std::memcpy(raw.data() + written, data.data() + position, bytes);
+                position += bytes;
+            }
+            written += bytes;
+        }
+    }
+
+    image.width = width;
+    image.height = height;
+    image.channels = static_cast<int>(pixel_size);
+    image.bytes.resize(raw.size());
+    const size_t stride = static_cast<size_t>(width) * pixel_size;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* source = raw.data() + static_cast<size_t>(top_down ? y : height - 1 - y) * stride;
+        uint8_t* target = image.bytes.data() + static_cast<size_t>(y) * stride;
+        std::memcpy(target, source, stride);
+        if (!grey) {
+            for (size_t x = 0; x < stride; x += pixel_size) {
+                std::swap(target[x], target[x + 2]);
+            }
+        }
+    }
+    return true;
+}
+
+float TextureProcessor::halfToFloat(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1f;
+    const uint32_t mantissa = half & 0x3ff;
+    if (exponent == 0) {
+        float value = std::ldexp(static_cast<float>(mantissa), -24);   // zero or subnormal
+        return sign ? -value : value;
+    }
+    uint32_t bits = exponent == 31 ? (sign | 0x7f800000u | (mantissa << 13))
+                                   : (sign | ((exponent + 112) << 23) | (mantissa << 13));
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool TextureProcessor::unpackEXRBlock(int compression, const uint8_t* data, size_t size, size_t expected,
+                                      std::vector<uint8_t>& out) {
+    /*
+     * Undoes RLE (1) or ZIP/ZIPS (3/2) compression of one EXR block.
+     * - Both store bytes split into even/odd halves with a delta predictor, which is reversed after inflating
+     */
+    std::vector<uint8_t> packed(expected);
+    if (compression == 1) {
+        size_t in = 0;
+        size_t written = 0;
+        while (in < size) {
+            const int count = static_cast<int8_t>(data[in++]);
+            if (count < 0) {
+                const size_t length = static_cast<size_t>(-count);
+                if (in + length > size || written + length > expected) return false;
+                std::memcpy(packed.data() + written, data + in, length);
+                in += length;
+                written += length;
+            } else {
+                const size_t length = static_cast<size_t>(count) + 1;
+                if (in >= size || written + length > expected) return false;
+                std::memset(packed.data() + written, data[in++], length);
+                written += length;
+            }
+        }
+        if (written != expected) return false;
+    } else {
+        uLongf length = static_cast<uLongf>(expected);
+        if (uncompress(packed.data(), &length, data, static_cast<uLong>(size)) != Z_OK || length != expected) {
+            return false;
+        }
+    }
+
+    for (size_t i = 1; i < packed.size(); ++i) {
+        packed[i] = static_cast<uint8_t>(packed[i - 1] + packed[i] - 128);
+    }
+    out.resize(expected);
+    const size_t half = (expected + 1) / 2;
+    for (size_t i = 0; i < expected; ++i) {
+        out[i] = (i % 2 == 0) ? packed[i / 2] : packed[half + i / 2];
+    }
+    return true;
+}
+
+void TextureProcessor::packEXRBlock(const std::vector<uint8_t>& raw, std::vector<uint8_t>& out) {
+    // Inverse of unpackEXRBlock for ZIP: split, delta-encode, deflate; stored raw when deflate does not help
+    std::vector<uint8_t> split(raw.size());
+    const size_t half = (raw.size() + 1) / 2;
+    for (size_t i = 0; i < raw.size(); ++i) {
+        split[(i % 2 == 0) ? i / 2 : half + i / 2] = raw[i];
+    }
+    for (size_t i = split.size(); i-- > 1;) {
+        split[i] = static_cast<uint8_t>(split[i] - split[i - 1] + 128);
+    }
+    uLongf length = compressBound(static_cast<uLong>(split.size()));
+    out.resize(length);
+    if (compress2(out.data(), &length, split.data(), static_cast<uLong>(split.size()), Z_DEFAULT_COMPRESSION) != Z_OK ||
+        length >= raw.size()) {
+        out = raw;
+        return;
+    }
+    out.resize(length);
+}
+
+bool TextureProcessor::decodeEXR(const std::string& path, ImageBuffer& image, std::string& error) {
+    /*
+     * Single-part scanline OpenEXR with NONE, RLE, ZIPS or ZIP compression.
+     * - HALF, FLOAT and UINT channels; R/G/B/A (or Y/A) are kept, layer prefixes like "diffuse." are ignored
+     * - Tiled, deep, multi-part, subsampled and PIZ/PXR24/B44/DWA files are rejected with a message
+     */
+    std::vector<uint8_t> data;
+    if (!readFile(path, data) || data.size() < 8 ||
+        data[0] != 0x76 || data[1] != 0x2f || data[2] != 0x31 || data[3] != 0x01) {
+        error = "Not an OpenEXR file: " + path;
+        return false;
+    }
+    if (data[5] & 0x1a) {   // version flags: tiled 0x200, deep 0x800, multi-part 0x1000 (long names are fine)
+        error = "Unsupported OpenEXR layout (tiled, deep or multi-part): " + path;
+        return false;
+    }
+    auto read32 = [&](size_t offset) {
+        int32_t value;
+        std::memcpy(&value, data.data() + offset, 4);
+        return value;
+    };
+
+    struct Channel {
+        std::string name;
+        int type = 0;           // 0 UINT, 1 HALF, 2 FLOAT
+        int slot = -1;
+    };
+    std::vector<Channel> channels;
+    int compression = 0;
+    int32_t window[4] = {0, 0, -1, -1};
+    size_t position = 8;
+    auto readString = [&](std::string& value) {
+        size_t end = position;
+        while (end < data.size() && data[end] != 0) ++end;
+        if (end >= data.size()) return false;
+        value.assign(reinterpret_cast<const char*>(data.data()) + position, end - position);
+        position = end + 1;
+        return true;
+    };
+    while (true) {
+        std::string name;
+        std::string type;
+        if (!readString(name)) {
+            error = "Truncated OpenEXR header: " + path;
+            return false;
+        }
+        if (name.empty()) {
+            break;
+        }
+        if (!readString(type) || position + 4 > data.size()) {
+            error = "Truncated OpenEXR header: " + path;
+            return false;
+        }
+        const size_t size = static_cast<size_t>(static_cast<uint32_t>(read32(position)));
+        position += 4;
+        if (position + size > data.size()) {
+            error = "Truncated OpenEXR header: " + path;
+            return false;
+        }
+        const size_t value_end = position + size;
+        if (name == "channels") {
+            size_t cursor = position;
+            while (cursor < value_end && data[cursor] != 0) {
+                Channel channel;
+                size_t end = cursor;
+                while (end < value_end && data[end] != 0) ++end;
+                if (end + 17 > value_end) break;
+                channel.name.assign(reinterpret_cast<const char*>(data.data()) + cursor, end - cursor);
+                channel.type = read32(end + 1);
+                if (read32(end + 9) != 1 || read32(end + 13) != 1) {
+                    error = "Subsampled OpenEXR channels are not supported: " + path;
+                    return false;
+                }
+                channels.push_back(channel);
+                cursor = end + 17;
+            }
+        } else if (name == "compression" && size >= 1) {
+            compression = data[position];
+        } else if (name == "dataWindow" && size >= 16) {
+            for (int i = 0; i < 4; ++i) window[i] = read32(position + 4 * i);
+        }
+        position = value_end;
+    }
+
+    const int width = window[2] - window[0] + 1;
+    const int height = window[3] - window[1] + 1;
+    if (width <= 0 || height <= 0 || channels.empty()) {
+        error = "OpenEXR file has no pixels: " + path;
+        return false;
+    }
+    if (compression > 3) {
+        error = "Unsupported OpenEXR compression " + std::to_string(compression) + ": " + path;
+        return false;
+    }
+
+    // Map channels to output slots: R G B A, or Y A for luminance-only files
+    auto suffix = [](const std::string& name) {
+        size_t dot = name.rfind('.');
+        return dot == std::string::npos ? name : name.substr(dot + 1);
+    };
+    bool has_color = false, has_luma = false, has_alpha = false;
+    for (const auto& channel : channels) {
+        std::string base = suffix(channel.name);
+        has_color |= base == "R" || base == "G" || base == "B";
+        has_luma |= base == "Y";
+        has_alpha |= base == "A";
+    }
+    if (!has_color && !has_luma) {
+        error = "OpenEXR file has no R/G/B or Y channels: " + path;
+        return false;
+    }
+    const int alpha_slot = has_color ? 3 : 1;
+    std::vector<bool> claimed(4, false);
+    for (auto& channel : channels) {
+        std::string base = suffix(channel.name);
+        int slot = -1;
+        if (has_color && base == "R") slot = 0;
+        else if (has_color && base == "G") slot = 1;
+        else if (has_color && base == "B") slot = 2;
+        else if (!has_color && base == "Y") slot = 0;
+        else if (base == "A") slot = alpha_slot;
+        if (slot >= 0 && !claimed[static_cast<size_t>(slot)]) {
+            channel.slot = slot;
+            claimed[static_cast<size_t>(slot)] = true;
+        }
+    }
+
+    image.width = width;
+    image.height = height;
+    image.channels = (has_color ? 3 : 1) + (has_alpha ? 1 : 0);
+    image.is_float = true;
+    image.floats.assign(image.sampleCount(), 0.0f);
+
+    size_t line_bytes = 0;
+    for (const auto& channel : channels) {
+        line_bytes += static_cast<size_t>(width) * (channel.type == 1 ? 2 : 4);
+    }
+    const int lines_per_block = compression == 3 ? 16 : 1;
+    const size_t blocks = static_cast<size_t>((height + lines_per_block - 1) / lines_per_block);
+    if (position + blocks * 8 > data.size()) {
+        error = "Truncated OpenEXR offset table: " + path;
+        return false;
+    }
+
+    std::vector<uint8_t> unpacked;
+    for (size_t block = 0; block < blocks; ++block) {
+        uint64_t offset;
+        std::memcpy(&offset, data.data() + position + block * 8, 8);
+        if (offset + 8 > data.size()) {
+            error = "Corrupt OpenEXR block offset: " + path;
+            return false;
+        }
+        const int first_line = read32(static_cast<size_t>(offset)) - window[1];
+        const size_t size = static_cast<size_t>(static_cast<uint32_t>(read32(static_cast<size_t>(offset) + 4)));
+        const uint8_t* payload = data.data() + offset + 8;
+        if (first_line < 0 || first_line >= height || offset + 8 + size > data.size()) {
+            error = "Corrupt OpenEXR block: " + path;
+            return false;
+        }
+        const int lines = std::min(lines_per_block, height - first_line);
+        const size_t expected = line_bytes * static_cast<size_t>(lines);
+        const uint8_t* pixels = payload;
+        if (compression != 0 && size != expected) {
+            if (!unpackEXRBlock(compression, payload, size, expected, unpacked)) {
+                error = "Corrupt OpenEXR block data: " + path;
+                return false;
+            }
+            pixels = unpacked.data();
+        } else if (size < expected) {
+            error = "Truncated OpenEXR block: " + path;
+            return false;
+        }
+
+        for (int line = 0; line < lines; ++line) {
+            const uint8_t* cursor = pixels + static_cast<size_t>(line) * line_bytes;
+            float* row = image.floats.data() + static_cast<size_t>(first_line + line) * width * image.channels;
+            for (const auto& channel : channels) {
+                const size_t sample_size = channel.type == 1 ? 2 : 4;
+                if (channel.slot >= 0) {
+                    for (int x = 0; x < width; ++x) {
+                        const uint8_t* sample = cursor + static_cast<size_t>(x) * sample_size;
+                        float value;
+                        if (channel.type == 1) {
+                            uint16_t half;
+                            std::memcpy(&half, sample, 2);
+                            value = halfToFloat(half);
+                        } else if (channel.type == 2) {
+                            std::memcpy(&value, sample, 4);
+                        } else {
+                            uint32_t integer;
+                            std::memcpy(&integer, sample, 4);
+                            value = static_cast<float>(integer);
+                        }
+                        row[static_cast<size_t>(x) * image.channels + channel.slot] = value;
+                    }
+                }
+                cursor += static_cast<size_t>(width) * sample_size;
+            }
+        }
+    }
+    return true;
+}
+
+bool TextureProcessor::encodeEXR(const std::string& path, const ImageBuffer& image, std::string& error) {
+    /*
+     * Writes a scanline OpenEXR with FLOAT channels and ZIP compression (16 lines per block).
+     * - Channels are stored in the alphabetical order OpenEXR requires (A, B, G, R or A, Y)
+     */
+    std::vector<std::pair<std::string, int>> channels;   // name, slot in the image
+    if (image.channels >= 3) {
+        if (image.channels == 4) channels.emplace_back("A", 3);
+        channels.emplace_back("B", 2);
+        channels.emplace_back("G", 1);
+        channels.emplace_back("R", 0);
+    } else {
+        if (image.channels == 2) channels.emplace_back("A", 1);
+        channels.emplace_back("Y", 0);
+    }
+
+    std::vector<uint8_t> out;
+    auto put32 = [&out](int32_t value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + 4);
+    };
+    auto putFloat = [&out](float value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + 4);
+    };
+    auto putString = [&out](const std::string& value) {
+        out.insert(out.end(), value.begin(), value.end());
+        out.push_back(0);
+    };
+    auto attribute = [&](const std::string& name, const std::string& type, int32_t size) {
+        putString(name);
+        putString(type);
+        put32(size);
+    };
+
+    put32(20000630);
+    put32(2);
+    attribute("channels", "chlist", static_cast<int32_t>(channels.size() * 18 + 1));
+    for (const auto& channel : channels) {
+        putString(channel.first);   // single-letter names: 2 bytes + 16 bytes of channel data
+        put32(2);
+        out.insert(out.end(), {0, 0, 0, 0});
+        put32(1);
+        put32(1);
+    }
+    out.push_back(0);
+    attribute("compression", "compression", 1);
+    out.push_back(3);
+    for (const char* name : {"dataWindow", "displayWindow"}) {
+        attribute(name, "box2i", 16);
+        put32(0);
+        put32(0);
+        put32(image.width - 1);
+        put32(image.height - 1);
+    }
+    attribute("lineOrder", "lineOrder", 1);
+    out.push_back(0);
+    attribute("pixelAspectRatio", "float", 4);
+    putFloat(1.0f);
+    attribute("screenWindowCenter", "v2f", 8);
+    putFloat(0.0f);
+    putFloat(0.0f);
+    attribute("screenWindowWidth", "float", 4);
+    putFloat(1.0f);
+    out.push_back(0);
+
+    const int lines_per_block = 16;
+    const size_t blocks = static_cast<size_t>((image.height + lines_per_block - 1) / lines_per_block);
+    const size_t table = out.size();
+    out.resize(out.size() + blocks * 8);
+
+    std::vector<uint8_t> raw;
+    std::vector<uint8_t> packed;
+    for (size_t block = 0; block < blocks; ++block) {
+        const int first_line = static_cast<int>(block) * lines_per_block;
+        const int lines = std::min(lines_per_block, image.height - first_line);
+        raw.clear();
+        for (int line = first_line; line < first_line + lines; ++line) {
+            const float* row = image.floats.data() + static_cast<size_t>(line) * image.width * image.channels;
+            for (const auto& channel : channels) {
+                for (int x = 0; x < image.width; ++x) {
+                    const float value = row[static_cast<size_t>(x) * image.channels + channel.second];
+                    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+                    raw.insert(raw.end(), bytes, bytes + 4);
+                }
+            }
+        }
+        packEXRBlock(raw, packed);
+
+        const uint64_t offset = out.size();
+        std::memcpy(out.data() + table + block * 8, &offset, 8);
+        put32(first_line);
+        put32(static_cast<int32_t>(packed.size()));
+        out.insert(out.end(), packed.begin(), packed.end());
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open() || !file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()))) {
+        error = "Cannot write OpenEXR " + path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace AssetManager
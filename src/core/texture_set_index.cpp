@@ -0,0 +1,274 @@
+/*
+ * Author: KleaSCM
+ * Email: KleaSCM@gmail.com
+ * Name: texture_set_index.cpp
+ * Description: Implementation of the TextureSetIndex class grouping library textures into PBR texture sets.
+ *
+ * Architecture:
+ * - Names are normalized (lower case, '-', '.' and ' ' become '_') and split into '_' tokens
+ * - A trailing 1001-1999 token is a UDIM tile; "2k"/"4k" or power-of-two tokens are resolution variants
+ * - The remaining name must end with a channel suffix, compared with separators stripped so it may span
+ *   several tokens ("base_color", "ambient_occlusion"); the longest suffix wins and what precedes it is the stem
+ *
+ * Key Features:
+ * - Single pass, no file access: only the indexed paths are inspected
+ * - Files without a known channel suffix are ignored rather than guessed
+ */
+
+#include "texture_set_index.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <cctype>
+
+namespace AssetManager {
+
+TextureSetIndex::TextureSetIndex()
+    : TextureSetIndex(defaultSuffixMappings()) {
+}
+
+TextureSetIndex::TextureSetIndex(std::map<std::string, std::vector<std::string>> suffix_mappings) {
+    for (const auto& mapping : suffix_mappings) {
+        for (const auto& suffix : mapping.second) {
+            std::string normalized = normalizeStem(suffix);
+            normalized.erase(std::remove(normalized.begin(), normalized.end(), '_'), normalized.end());
+            if (!normalized.empty()) {
+                suffixes_.emplace_back(normalized, mapping.first);
+            }
+        }
+    }
+    // "roughness" must be tried before "rough", "basecolor" before "color"...
+    std::stable_sort(suffixes_.begin(), suffixes_.end(), [](const auto& a, const auto& b) {
+        return a.first.size() > b.first.size();
+    });
+}
+
+void TextureSetIndex::build(const std::vector<std::string>& texture_paths) {
+    /**
+     * @brief Groups texture paths into sets in one pass.
+     *
+     * @param texture_paths Paths of every texture in the library (e.g. the index's "Texture" assets).
+     */
+    clear();
+    std::unordered_map<std::string, std::string> udim_patterns;   // tile file -> "<UDIM>" pattern
+    for (const auto& texture_path : texture_paths) {
+        std::filesystem::path path(texture_path);
+        std::string filename = path.filename().string();
+        ParsedName parsed;
+        if (!parseName(filename, parsed)) {
+            continue;
+        }
+
+        std::string directory = path.parent_path().string();
+        std::string key = setKey(directory, parsed.stem);
+        auto inserted = sets_.try_emplace(key);
+        TextureSet& set = inserted.first->second;
+        if (inserted.second) {
+            set.directory = directory;
+            set.stem = parsed.stem;
+        }
+        TextureChannel& channel = set.channels[parsed.channel];
+
+        auto variant = channel.resolutions.emplace(parsed.resolution, texture_path);
+        if (parsed.udim_tile != 0) {
+            // All tiles of a resolution share one "<UDIM>" pattern; the variant is its lowest tile's file
+            std::string tile = std::to_string(parsed.udim_tile);
+            size_t position = filename.rfind(tile);
+            udim_patterns[texture_path] = (path.parent_path() / (filename.substr(0, position) + "<UDIM>" +
+                                                                 filename.substr(position + tile.size()))).string();
+            if (texture_path < variant.first->second) {
+                variant.first->second = texture_path;
+            }
+            channel.udim_tiles.push_back(parsed.udim_tile);
+        }
+    }
+
+    // Resolve preferred variants and the per-directory fallback
+    std::unordered_map<std::string, size_t> sets_per_directory;
+    for (auto& entry : sets_) {
+        for (auto& channel : entry.second.channels) {
+            TextureChannel& texture = channel.second;
+            std::sort(texture.udim_tiles.begin(), texture.udim_tiles.end());
+            texture.udim_tiles.erase(std::unique(texture.udim_tiles.begin(), texture.udim_tiles.end()),
+                                     texture.udim_tiles.end());
+            auto best = std::max_element(texture.resolutions.begin(), texture.resolutions.end(),
+                                         [](const auto& a, const auto& b) {
+                                             return resolutionRank(a.first) < resolutionRank(b.first);
+                                         });
+            texture.path = best->second;
+            if (!texture.udim_tiles.empty()) {
+                texture.udim_pattern = udim_patterns[texture.path];
+            }
+        }
+        const std::string& directory = entry.second.directory;
+        if (++sets_per_directory[directory] == 1) {
+            by_directory_[directory] = entry.first;
+        } else {
+            by_directory_[directory].clear();
+        }
+    }
+}
+
+void TextureSetIndex::clear() {
+    sets_.clear();
+    by_directory_.clear();
+}
+
+const TextureSet* TextureSetIndex::find(const std::string& directory, const std::string& stem) const {
+    auto it = sets_.find(setKey(directory, normalizeStem(stem)));
+    return it != sets_.end() ? &it->second : nullptr;
+}
+
+const TextureSet* TextureSetIndex::findForAsset(const std::string& asset_path) const {
+    /**
+     * @brief Finds the texture set of an asset in O(1).
+     *        Matches the set named like the asset in its directory, or else the only set in that directory.
+     *
+     * @param asset_path Path of a model file.
+     * @return Texture set, or nullptr if none matches unambiguously.
+     */
+    std::filesystem::path path(asset_path);
+    std::string directory = path.parent_path().string();
+    if (const TextureSet* set = find(directory, path.stem().string())) {
+        return set;
+    }
+    auto it = by_directory_.find(directory);
+    if (it == by_directory_.end() || it->second.empty()) {
+        return nullptr;
+    }
+    return &sets_.at(it->second);
+}
+
+std::vector<const TextureSet*> TextureSetIndex::getSets() const {
+    std::vector<const TextureSet*> sets;
+    sets.reserve(sets_.size());
+    for (const auto& entry : sets_) {
+        sets.push_back(&entry.second);
+    }
+    std::sort(sets.begin(), sets.end(), [](const TextureSet* a, const TextureSet* b) {
+        return a->directory != b->directory ? a->directory < b->directory : a->stem < b->stem;
+    });
+    return sets;
+}
+
+std::map<std::string, std::vector<std::string>> TextureSetIndex::defaultSuffixMappings() {
+    // Same conventions AssetManager::initialize_pbr_mappings sets up
+    return {
+        {"base_color", {"_diffuse", "_albedo", "_basecolor", "_color"}},
+        {"normal", {"_normal", "_norm", "_nrm"}},
+        {"roughness", {"_roughness", "_rough", "_rgh"}},
+        {"metallic", {"_metallic", "_metal", "_mtl"}},
+        {"emission", {"_emission", "_emissive", "_glow"}},
+        {"ao", {"_ao", "_ambientocclusion", "_occlusion"}},
+        {"height", {"_height", "_displacement", "_disp"}},
+        {"specular", {"_specular", "_spec"}}
+    };
+}
+
+std::string TextureSetIndex::normalizeStem(const std::string& stem) {
+    /**
+     * @brief Lower-cases a name and unifies separators to single '_' (no leading or trailing '_').
+     *
+     * @param stem File stem or suffix.
+     * @return Normalized name.
+     */
+    std::string normalized;
+    normalized.reserve(stem.size());
+    for (char c : stem) {
+        if (c == '-' || c == '.' || c == ' ' || c == '_') {
+            if (!normalized.empty() && normalized.back() != '_') {
+                normalized += '_';
+            }
+        } else {
+            normalized += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    if (!normalized.empty() && normalized.back() == '_') {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+bool TextureSetIndex::parseName(const std::string& filename, ParsedName& parsed) const {
+    /*
+     * Splits "Rock_Albedo_4K.1001.png" into stem "rock", channel "base_color", resolution "4k", tile 1001.
+     * - The extension is dropped first, so UDIM tiles separated by '.' become a trailing token
+     * - Resolution tokens are removed wherever they appear after the first token
+     */
+    std::string name = normalizeStem(std::filesystem::path(filename).stem().string());
+    std::vector<std::string> tokens;
+    size_t start = 0;
+    while (start <= name.size() && !name.empty()) {
+        size_t end = name.find('_', start);
+        if (end == std::string::npos) end = name.size();
+        tokens.push_back(name.substr(start, end - start));
+        start = end + 1;
+    }
+    if (tokens.empty()) {
+        return false;
+    }
+
+    auto isDigits = [](const std::string& token) {
+        return !token.empty() && std::all_of(token.begin(), token.end(),
+                                             [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+    };
+    if (tokens.size() > 1 && tokens.back().size() == 4 && isDigits(tokens.back())) {
+        int tile = std::stoi(tokens.back());
+        if (tile >= 1001 && tile <= 1999) {
+            parsed.udim_tile = tile;
+            tokens.pop_back();
+        }
+    }
+    for (size_t i = 1; i < tokens.size(); ++i) {
+        if (resolutionRank(tokens[i]) > 0) {
+            parsed.resolution = tokens[i];
+            tokens.erase(tokens.begin() + static_cast<std::ptrdiff_t>(i));
+            break;
+        }
+    }
+
+    // tails[i]: tokens i.. joined without separators, so "Base_Color" is compared as "basecolor"
+    std::vector<std::string> tails(tokens.size());
+    std::string tail;
+    for (size_t i = tokens.size(); i > 0; --i) {
+        tail.insert(0, tokens[i - 1]);
+        tails[i - 1] = tail;
+    }
+    for (const auto& suffix : suffixes_) {
+        for (size_t i = 0; i < tails.size(); ++i) {
+            if (tails[i] != suffix.first) {
+                continue;
+            }
+            parsed.channel = suffix.second;
+            parsed.stem.clear();
+            for (size_t j = 0; j < i; ++j) {
+                if (j > 0) parsed.stem += '_';
+                parsed.stem += tokens[j];
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string TextureSetIndex::setKey(const std::string& directory, const std::string& stem) {
+    return directory + '\n' + stem;
+}
+
+size_t TextureSetIndex::resolutionRank(const std::string& resolution) {
+    // "2k" -> 2048, "4096" -> 4096; anything else (including no token) ranks 0
+    if (resolution.size() >= 2 && resolution.size() <= 3 && resolution.back() == 'k' &&
+        std::all_of(resolution.begin(), resolution.end() - 1, [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+        return static_cast<size_t>(std::stoi(resolution.substr(0, resolution.size() - 1))) * 1024;
+    }
+    if (resolution.size() >= 3 && resolution.size() <= 5 &&
+        std::all_of(resolution.begin(), resolution.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+        size_t value = static_cast<size_t>(std::stoul(resolution));
+        // Only power-of-two sizes, so "rock_001" or "plank_750" stay part of the stem
+        if (value >= 256 && (value & (value - 1)) == 0) {
+            return value;
+        }
+    }
+    return 0;
+}
+
+} // namespace AssetManager
@@ -16,6 +16,8 @@
  * 
  * Key Features:
  * - Command-line interface with audit mode support
+ * - Parallel asset validation with a configurable thread count
+ * - Incremental validation: results persist between runs and only changed files are revalidated
  * - Asset discovery and categorization
  * - Search functionality with multiple filter criteria
  * - Material preset system demonstration
@@ -44,6 +46,8 @@
  * @return 0 on success, 1 on error
  * 
  * @note Use --audit flag to run in audit mode for library analysis
+ * @note Use --validate [--threads N] [--no-cache] [--hash-contents] to validate the Assets directory
+ *       (N = 0 uses every core, the default; unchanged files reuse results from validation_cache.json)
  */
 int main(int argc, char* argv[]) {
     // Check if audit mode is requested via command-line argument
@@ -88,6 +92,22 @@ int main(int argc, char* argv[]) {
             options["check_texture_dependencies"] = true;
             options["check_format_specific"] = true;
             options["max_file_size_mb"] = size_t(1000);
+            options["threads"] = size_t(0);  // one worker per core unless --threads says otherwise
+            options["cache_path"] = std::string("validation_cache.json");
+            for (int i = 2; i < argc; ++i) {
+                if (std::string(argv[i]) == "--no-cache") {
+                    options["cache_path"] = std::string();
+                } else if (std::string(argv[i]) == "--hash-contents") {
+                    options["hash_contents"] = true;
+                } else if (std::string(argv[i]) == "--threads" && i + 1 < argc) {
+                    try {
+                        options["threads"] = static_cast<size_t>(std::stoul(argv[++i]));
+                    } catch (const std::exception&) {
+                        std::cerr << "❌ Invalid thread count: " << argv[i] << std::endl;
+                        return 1;
+                    }
+                }
+            }
             validator.setValidationOptions(options);
             
             // Validate Assets directory if it exists
@@ -102,7 +122,15 @@ int main(int argc, char* argv[]) {
                 auto validation_duration = std::chrono::duration_cast<std::chrono::milliseconds>(validation_end - validation_start);
                 
                 std::cout << "✅ Validation completed in " << validation_duration.count() << "ms" << std::endl;
-                std::cout << "📊 Validated " << results.size() << " assets" << std::endl;
+                std::cout << "📊 Validated " << results.size() << " assets on "
+                          << (validator.getThreadCount() == 0 ? std::string("all") : std::to_string(validator.getThreadCount()))
+                          << " thread(s)" << std::endl;
+                auto stats = validator.getValidationStats();
+                if (!validator.getCachePath().empty()) {
+                    std::cout << "♻️  Reused " << std::any_cast<size_t>(stats["cache_hits"]) << " cached result(s), "
+                              << std::any_cast<size_t>(stats["dependency_invalidations"])
+                              << " revalidated for changed references" << std::endl;
+                }
                 
                 // Generate and display validation report
                 std::string report = validator.generateReport(results);
@@ -135,6 +163,7 @@ int main(int argc, char* argv[]) {
                 bad_obj.close();
                 
                 std::cout << "🔍 Validating test assets..." << std::endl;
+                validator.setCachePath("");  // throwaway files; keep them out of the cache
                 std::vector<AssetManager::ValidationResult> results = validator.validateDirectory("test_assets");
                 
                 std::string report = validator.generateReport(results);
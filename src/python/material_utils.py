@@ -64,7 +64,7 @@ def create_material(options: Dict[str, Any]) -> Dict[str, Any]:
             if options.get('albedo_texture'):
                 tex = nodes.new('ShaderNodeTexImage')
                 tex.location = (-300, 200)
-                tex.image = bpy.data.images.load(options['albedo_texture'])
+                tex.image = bpy.data.images.load(options['albedo_texture'], check_existing=True)
                 links.new(tex.outputs['Color'], principled.inputs['Base Color'])
                 texture_nodes['albedo'] = tex
             
@@ -72,7 +72,7 @@ def create_material(options: Dict[str, Any]) -> Dict[str, Any]:
             if options.get('normal_texture'):
                 tex = nodes.new('ShaderNodeTexImage')
                 tex.location = (-300, 0)
-                tex.image = bpy.data.images.load(options['normal_texture'])
+                tex.image = bpy.data.images.load(options['normal_texture'], check_existing=True)
                 normal_map = nodes.new('ShaderNodeNormalMap')
                 normal_map.location = (-100, 0)
                 links.new(tex.outputs['Color'], normal_map.inputs['Color'])
@@ -83,7 +83,7 @@ def create_material(options: Dict[str, Any]) -> Dict[str, Any]:
             if options.get('roughness_texture'):
                 tex = nodes.new('ShaderNodeTexImage')
                 tex.location = (-300, -200)
-                tex.image = bpy.data.images.load(options['roughness_texture'])
+                tex.image = bpy.data.images.load(options['roughness_texture'], check_existing=True)
                 links.new(tex.outputs['Color'], principled.inputs['Roughness'])
                 texture_nodes['roughness'] = tex
             
@@ -91,7 +91,7 @@ def create_material(options: Dict[str, Any]) -> Dict[str, Any]:
             if options.get('metallic_texture'):
                 tex = nodes.new('ShaderNodeTexImage')
                 tex.location = (-300, -400)
-                tex.image = bpy.data.images.load(options['metallic_texture'])
+                tex.image = bpy.data.images.load(options['metallic_texture'], check_existing=True)
                 links.new(tex.outputs['Color'], principled.inputs['Metallic'])
                 texture_nodes['metallic'] = tex
             
@@ -99,7 +99,7 @@ def create_material(options: Dict[str, Any]) -> Dict[str, Any]:
             if options.get('ao_texture'):
                 tex = nodes.new('ShaderNodeTexImage')
                 tex.location = (-300, -600)
-                tex.image = bpy.data.images.load(options['ao_texture'])
+                tex.image = bpy.data.images.load(options['ao_texture'], check_existing=True)
                 mix_rgb = nodes.new('ShaderNodeMixRGB')
                 mix_rgb.location = (-100, 200)
                 mix_rgb.blend_type = 'MULTIPLY'
@@ -113,7 +113,7 @@ def create_material(options: Dict[str, Any]) -> Dict[str, Any]:
             if options.get('emission_texture'):
                 tex = nodes.new('ShaderNodeTexImage')
                 tex.location = (-300, -800)
-                tex.image = bpy.data.images.load(options['emission_texture'])
+                tex.image = bpy.data.images.load(options['emission_texture'], check_existing=True)
                 links.new(tex.outputs['Color'], principled.inputs['Emission Color'])
                 texture_nodes['emission'] = tex
             
@@ -121,7 +121,7 @@ def create_material(options: Dict[str, Any]) -> Dict[str, Any]:
             if options.get('displacement_texture'):
                 tex = nodes.new('ShaderNodeTexImage')
                 tex.location = (-300, -1000)
-                tex.image = bpy.data.images.load(options['displacement_texture'])
+                tex.image = bpy.data.images.load(options['displacement_texture'], check_existing=True)
                 disp = nodes.new('ShaderNodeDisplacement')
                 disp.location = (-100, -1000)
                 links.new(tex.outputs['Color'], disp.inputs['Height'])
@@ -146,6 +146,285 @@ def create_material(options: Dict[str, Any]) -> Dict[str, Any]:
             'message': f'Failed to create material: {str(e)}'
         }
 
+# Texture channels in link order: AO multiplies whatever feeds Base Color, so it follows albedo
+CHANNEL_ORDER = ['albedo', 'normal', 'roughness', 'metallic', 'ao', 'emission', 'displacement']
+
+def _group_output(group, name: str):
+    """
+    Add a color output socket to a node group (Blender 4.x interface API, or the 3.x outputs list)
+    """
+    if hasattr(group, 'interface'):
+        group.interface.new_socket(name=name, in_out='OUTPUT', socket_type='NodeSocketColor')
+    else:
+        group.outputs.new('NodeSocketColor', name)
+
+def _connect_channel(nodes, links, principled, output, texture_type: str, color_socket, location):
+    """
+    Link one texture channel into a Principled BSDF material
+    """
+    x, y = location
+    if texture_type == 'albedo':
+        links.new(color_socket, principled.inputs['Base Color'])
+    elif texture_type == 'normal':
+        normal_map = nodes.new('ShaderNodeNormalMap')
+        normal_map.location = (x + 200, y)
+        links.new(color_socket, normal_map.inputs['Color'])
+        links.new(normal_map.outputs['Normal'], principled.inputs['Normal'])
+    elif texture_type == 'roughness':
+        links.new(color_socket, principled.inputs['Roughness'])
+    elif texture_type == 'metallic':
+        links.new(color_socket, principled.inputs['Metallic'])
+    elif texture_type == 'ao':
+        base_links = [link for link in links
+                      if link.to_node == principled and link.to_socket.name == 'Base Color']
+        if base_links:
+            mix_rgb = nodes.new('ShaderNodeMixRGB')
+            mix_rgb.location = (x + 200, y)
+            mix_rgb.blend_type = 'MULTIPLY'
+            links.new(base_links[0].from_socket, mix_rgb.inputs[1])
+            links.new(color_socket, mix_rgb.inputs[2])
+            links.new(mix_rgb.outputs['Color'], principled.inputs['Base Color'])
+    elif texture_type == 'emission':
+        links.new(color_socket, principled.inputs['Emission Color'])
+    elif texture_type == 'displacement':
+        disp = nodes.new('ShaderNodeDisplacement')
+        disp.location = (x + 200, y)
+        links.new(color_socket, disp.inputs['Height'])
+        links.new(disp.outputs['Displacement'], output.inputs['Displacement'])
+
+TEMPLATE_PREFIX = '.template_'
+
+def _set_principled_values(principled, options: Dict[str, Any]):
+    """
+    Write a material's parameter values into its Principled BSDF
+    """
+    principled.inputs['Metallic'].default_value = options.get('metallic', 0.0)
+    principled.inputs['Roughness'].default_value = options.get('roughness', 0.5)
+    principled.inputs['IOR'].default_value = options.get('ior', 1.45)
+    principled.inputs['Alpha'].default_value = options.get('alpha', 1.0)
+    for socket, key in (('Specular', 'specular'), ('Clearcoat', 'clearcoat'),
+                        ('Clearcoat Roughness', 'clearcoat_roughness'),
+                        ('Transmission', 'transmission'),
+                        ('Transmission Roughness', 'transmission_roughness'),
+                        ('Emission Strength', 'emission_strength')):
+        if socket in principled.inputs:
+            principled.inputs[socket].default_value = options.get(key, 0.0)
+
+def _compile_template(key: str, channels: List[str]):
+    """
+    Build one node-graph shape as a template material: Principled BSDF, output, and a texture
+    group node whose placeholder group exposes the channels in texture-group order
+    """
+    mat = bpy.data.materials.new(name=TEMPLATE_PREFIX + key)
+    mat.use_fake_user = True
+    mat.use_nodes = True
+    nodes = mat.node_tree.nodes
+    links = mat.node_tree.links
+    nodes.clear()
+    
+    principled = nodes.new('ShaderNodeBsdfPrincipled')
+    principled.name = 'Principled'
+    principled.location = (0, 0)
+    output = nodes.new('ShaderNodeOutputMaterial')
+    output.name = 'Output'
+    output.location = (300, 0)
+    links.new(principled.outputs['BSDF'], output.inputs['Surface'])
+    
+    if channels:
+        group = bpy.data.node_groups.new(TEMPLATE_PREFIX + key, 'ShaderNodeTree')
+        group.nodes.new('NodeGroupOutput')
+        for i, texture_type in enumerate(channels):
+            _group_output(group, f'{texture_type}_{i}')
+        group_node = nodes.new('ShaderNodeGroup')
+        group_node.name = 'Textures'
+        group_node.node_tree = group
+        group_node.location = (-500, 0)
+        ordered = sorted(enumerate(channels), key=lambda item: CHANNEL_ORDER.index(item[1])
+                         if item[1] in CHANNEL_ORDER else len(CHANNEL_ORDER))
+        for i, texture_type in ordered:
+            _connect_channel(nodes, links, principled, output, texture_type,
+                             group_node.outputs[f'{texture_type}_{i}'], (-300, -200 * i))
+    return mat
+
+def create_materials_batch(batch) -> List[Dict[str, Any]]:
+    """
+    Create many materials in one Blender session
+    
+    Each distinct texture file is loaded as one image datablock, and materials with the
+    same texture set share one node group holding the image texture nodes.
+    
+    Materials are instanced from node-tree templates: each node-graph shape is compiled
+    once (or appended from the template library) and every material is a copy of it with
+    only its parameter values and texture group set. Newly compiled templates are saved
+    back to the library for later sessions.
+    
+    With a scene file the materials are created in that .blend (opened first if it exists)
+    and saved into it; without one they only live as long as this session.
+    
+    Args:
+        batch: {'materials': [...], 'templates': {key: {'channels': [...]}}, 'template_library': path,
+               'resident_templates': [keys], 'scene_file': path}; a plain list of material
+               dictionaries is also accepted
+        
+    Returns:
+        List of result dictionaries, one per spec, in spec order
+    """
+    if isinstance(batch, list):
+        batch = {'materials': batch}
+    specs = batch.get('materials', [])
+    template_specs = batch.get('templates', {})
+    library = batch.get('template_library', '')
+    scene_file = batch.get('scene_file', '')
+    if scene_file and os.path.exists(scene_file):
+        bpy.ops.wm.open_mainfile(filepath=scene_file)
+    images = {}
+    tiled = {os.path.abspath(t['path']) for spec in specs for t in spec.get('textures', []) if t.get('tiled')}
+    texture_groups = {}
+    templates = {}
+    results = []
+    stats = {'compiled': 0, 'appended': 0, 'instanced': 0}
+    
+    # Templates the library already holds are appended ready-made
+    resident = [TEMPLATE_PREFIX + key for key in batch.get('resident_templates', []) if key in template_specs]
+    if library and resident and os.path.exists(library):
+        try:
+            with bpy.data.libraries.load(library, link=False) as (data_from, data_to):
+                data_to.materials = [name for name in data_from.materials if name in resident]
+            stats['appended'] = len([name for name in resident if name in bpy.data.materials])
+        except Exception as e:
+            print(f'TEMPLATE_LIBRARY_ERROR: {e}')
+    
+    def template_for(key: str):
+        if key not in templates:
+            mat = bpy.data.materials.get(TEMPLATE_PREFIX + key)
+            if mat is None:
+                mat = _compile_template(key, template_specs.get(key, {}).get('channels', []))
+                stats['compiled'] += 1
+            templates[key] = mat
+        return templates[key]
+    
+    def load_image(path: str):
+        key = os.path.abspath(path)
+        if key not in images:
+            images[key] = bpy.data.images.load(key, check_existing=True)
+            if key in tiled:
+                # First tile of a UDIM set: Blender picks up the sibling tiles from the file name
+                images[key].source = 'TILED'
+        return images[key]
+    
+    def texture_group(textures: List[Dict[str, str]]):
+        key = tuple(sorted((t['type'], os.path.abspath(t['path'])) for t in textures))
+        if key in texture_groups:
+            return texture_groups[key]
+        group = bpy.data.node_groups.new('TextureSet', 'ShaderNodeTree')
+        group_output = group.nodes.new('NodeGroupOutput')
+        group_output.location = (300, 0)
+        for i, (texture_type, path) in enumerate(key):
+            name = f'{texture_type}_{i}'
+            _group_output(group, name)
+            tex = group.nodes.new('ShaderNodeTexImage')
+            tex.location = (0, -300 * i)
+            tex.image = load_image(path)
+            if texture_type != 'albedo' and texture_type != 'emission':
+                tex.image.colorspace_settings.name = 'Non-Color'
+            group.links.new(tex.outputs['Color'], group_output.inputs[name])
+        texture_groups[key] = (group, key)
+        return texture_groups[key]
+    
+    for index, options in enumerate(specs):
+        try:
+            textures = options.get('textures', [])
+            template_key = options.get('template')
+            instanced = bool(template_key) and options.get('use_nodes', True)
+            
+            if instanced:
+                mat = template_for(template_key).copy()
+                mat.name = options.get('name', 'NewMaterial')
+                mat.use_fake_user = False
+                nodes = mat.node_tree.nodes
+                _set_principled_values(nodes['Principled'], options)
+                if textures:
+                    group, _ = texture_group(textures)
+                    nodes['Textures'].node_tree = group
+                stats['instanced'] += 1
+            else:
+                mat = bpy.data.materials.new(name=options.get('name', 'NewMaterial'))
+                mat.use_nodes = options.get('use_nodes', True)
+                if mat.use_nodes:
+                    nodes = mat.node_tree.nodes
+                    links = mat.node_tree.links
+                    nodes.clear()
+                    
+                    principled = nodes.new('ShaderNodeBsdfPrincipled')
+                    principled.location = (0, 0)
+                    _set_principled_values(principled, options)
+                    
+                    output = nodes.new('ShaderNodeOutputMaterial')
+                    output.location = (300, 0)
+                    links.new(principled.outputs['BSDF'], output.inputs['Surface'])
+                    
+                    if textures:
+                        group, key = texture_group(textures)
+                        group_node = nodes.new('ShaderNodeGroup')
+                        group_node.node_tree = group
+                        group_node.location = (-500, 0)
+                        channels = sorted(enumerate(key), key=lambda item: CHANNEL_ORDER.index(item[1][0])
+                                          if item[1][0] in CHANNEL_ORDER else len(CHANNEL_ORDER))
+                        for i, (texture_type, _) in channels:
+                            _connect_channel(nodes, links, principled, output, texture_type,
+                                             group_node.outputs[f'{texture_type}_{i}'], (-300, -200 * i))
+            
+            if scene_file:
+                # Nothing uses the material yet; without a fake user the save would drop it
+                mat.use_fake_user = True
+            mat.use_backface_culling = options.get('backface_culling', False)
+            if options.get('blend_method', False):
+                mat.blend_method = 'BLEND'
+            
+            results.append({
+                'index': index,
+                'success': True,
+                'material_name': mat.name,
+                'instanced': instanced,
+                'message': 'Material created successfully'
+            })
+        except Exception as e:
+            results.append({
+                'index': index,
+                'success': False,
+                'message': f'Failed to create material: {str(e)}'
+            })
+    
+    # Save newly compiled templates with everything the library already held
+    if library and stats['compiled']:
+        try:
+            if os.path.exists(library):
+                with bpy.data.libraries.load(library, link=False) as (data_from, data_to):
+                    data_to.materials = [name for name in data_from.materials
+                                         if name.startswith(TEMPLATE_PREFIX) and name not in bpy.data.materials]
+            held = {mat for mat in bpy.data.materials if mat.name.startswith(TEMPLATE_PREFIX)}
+            bpy.data.libraries.write(library, held, fake_user=True)
+            for mat in held:
+                print('TEMPLATE_RESIDENT: ' + mat.name[len(TEMPLATE_PREFIX):])
+        except Exception as e:
+            print(f'TEMPLATE_LIBRARY_ERROR: {e}')
+    print('TEMPLATE_STATS: compiled=%d appended=%d instanced=%d' % (stats['compiled'], stats['appended'], stats['instanced']))
+    
+    if scene_file and any(result['success'] for result in results):
+        # Templates belong in the library, not the scene
+        for mat in bpy.data.materials:
+            if mat.name.startswith(TEMPLATE_PREFIX):
+                mat.use_fake_user = False
+        try:
+            bpy.ops.wm.save_as_mainfile(filepath=scene_file)
+        except Exception as e:
+            for result in results:
+                if result['success']:
+                    result['success'] = False
+                    result['message'] = f'Failed to save scene: {str(e)}'
+    
+    return results
+
 def assign_texture(material_name: str, texture_path: str, texture_type: str) -> Dict[str, Any]:
     """
     Assign a texture to a specific material and texture type
@@ -390,35 +669,43 @@ def optimize_material(material_name: str) -> Dict[str, Any]:
         }
 
 if __name__ == "__main__":
-    # Handle command line arguments for C++ integration
-    if len(sys.argv) > 1:
-        command = sys.argv[1]
+    # Handle command line arguments for C++ integration (Blender passes script arguments after "--")
+    args = sys.argv[sys.argv.index('--') + 1:] if '--' in sys.argv else sys.argv[1:]
+    if len(args) > 0:
+        command = args[0]
         
         if command == "create_material":
             # Read options from stdin or file
-            options_str = sys.argv[2] if len(sys.argv) > 2 else "{}"
+            options_str = args[1] if len(args) > 1 else "{}"
             options = json.loads(options_str)
             result = create_material(options)
             print(json.dumps(result))
             
+        elif command == "create_materials_batch":
+            with open(args[1]) as batch_file:
+                batch = json.load(batch_file)
+            for result in create_materials_batch(batch):
+                print('MATERIAL_RESULT: ' + json.dumps(result))
+            print('BATCH_STATS: images=%d texture_sets=%d' % (len(bpy.data.images), len(bpy.data.node_groups)))
+            
         elif command == "assign_texture":
-            material_name = sys.argv[2]
-            texture_path = sys.argv[3]
-            texture_type = sys.argv[4]
+            material_name = args[1]
+            texture_path = args[2]
+            texture_type = args[3]
             result = assign_texture(material_name, texture_path, texture_type)
             print(json.dumps(result))
             
         elif command == "load_texture":
-            texture_path = sys.argv[2]
+            texture_path = args[1]
             result = load_texture_info(texture_path)
             print(json.dumps(result))
             
         elif command == "validate_material":
-            material_name = sys.argv[2]
+            material_name = args[1]
             result = validate_material(material_name)
             print(json.dumps(result))
             
         elif command == "optimize_material":
-            material_name = sys.argv[2]
+            material_name = args[1]
             result = optimize_material(material_name)
             print(json.dumps(result)) 
\ No newline at end of file